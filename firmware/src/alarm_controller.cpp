@@ -16,6 +16,8 @@
  */
 
 #include "alarm_controller.h"
+#include "task_manager.h"
+#include "perf_stats.h"
 
 // ===============================================================
 // GLOBAL INSTANCE
@@ -36,6 +38,8 @@ AlarmController::AlarmController() {
     hardwareChecksEnabled = true;
     testMode = false;
     lastHardwareError = "";
+    lastHealthCheck = 0;
+    updateTimerId = Scheduler::INVALID_TIMER;
 
     // Initialize statistics
     lastStatistics.startTime = 0;
@@ -62,6 +66,13 @@ bool AlarmController::begin() {
     // Ensure all buzzers are off
     hardware.stopAllBuzzers();
 
+    // Register our timer: update() runs exactly when the next stage
+    // transition, safety timeout or health check is due
+    updateTimerId = alarmScheduler.createTimer("alarm", [this]() {
+        PerfScope scope(PERF_ALARM_UPDATE);
+        update();
+    });
+
     currentState = ALARM_IDLE;
     DEBUG_PRINTLN("[Alarm] Initialization complete");
 
@@ -78,22 +89,38 @@ bool AlarmController::start() {
         return false;
     }
 
+    // A real alarm always wins over a buzzer test
+    if (isTesting()) {
+        abortTest();
+    }
+
     DEBUG_PRINTLN("[Alarm] Starting alarm sequence...");
 
+    // Let the SILENCE interrupt cut the buzzers from now on
+    hardware.armHardSilence();
+
     // Reset state
     alarmStartTime = millis();
+    lastHealthCheck = alarmStartTime;
     testMode = false;
 
     // Transition to TRIGGERED state (3-second delay before WARNING)
     transitionToState(ALARM_TRIGGERED);
+    scheduleNextUpdate();
 
     // Send initial notification
-    sendTelegramNotification(MSG_WAKE_RECEIVED);
+    sendTelegramNotification(MSG_WAKE_RECEIVED, NOTIFY_LIVE_START);
 
     return true;
 }
 
 bool AlarmController::stop(AlarmStopSource source) {
+    // Stopping during a buzzer test just ends the test
+    if (isTesting()) {
+        abortTest();
+        return true;
+    }
+
     if (!isActive()) {
         DEBUG_PRINTLN("[Alarm] Cannot stop - alarm not active");
         return false;
@@ -101,8 +128,10 @@ bool AlarmController::stop(AlarmStopSource source) {
 
     DEBUG_PRINTF("[Alarm] Stopping alarm (source: %d)...\n", source);
 
-    // Turn off all buzzers immediately
+    // Turn off all buzzers immediately (the SILENCE interrupt may
+    // already have done this - see Hardware::armHardSilence())
     hardware.stopAllBuzzers();
+    hardware.disarmHardSilence();
 
     // Calculate statistics
     calculateStatistics(source);
@@ -112,22 +141,29 @@ bool AlarmController::stop(AlarmStopSource source) {
     switch (source) {
         case STOP_SAFETY_TIMEOUT:
             stopState = ALARM_STOPPED_TIMEOUT;
-            sendTelegramNotification(MSG_ALARM_TIMEOUT);
+            sendTelegramNotification(MSG_ALARM_TIMEOUT, NOTIFY_LIVE_END);
             break;
 
-        case STOP_HARDWARE_ERROR:
+        case STOP_HARDWARE_ERROR: {
             stopState = ALARM_STOPPED_ERROR;
+            // Also ends the live status (removes the STOP button); the
+            // buzzer error itself went out as its own urgent message
+            char msg[128];
+            snprintf(msg, sizeof(msg), MSG_ALARM_HARDWARE_STOP, lastStatistics.duration);
+            sendTelegramNotification(msg, NOTIFY_LIVE_END);
             break;
+        }
 
         default:
             stopState = ALARM_STOPPED_USER;
             // Format stop message with duration and source
             char msg[128];
             const char* sourceStr = (source == STOP_TELEGRAM_COMMAND) ? "Telegram" :
+                                   (source == STOP_TELEGRAM_BUTTON) ? "Telegram button" :
                                    (source == STOP_SILENCE_BUTTON) ? "Button" : "Unknown";
             snprintf(msg, sizeof(msg), MSG_ALARM_STOPPED,
                     lastStatistics.duration, sourceStr);
-            sendTelegramNotification(msg);
+            sendTelegramNotification(msg, NOTIFY_LIVE_END);
             break;
     }
 
@@ -137,14 +173,19 @@ bool AlarmController::stop(AlarmStopSource source) {
     // Return to idle
     transitionToState(ALARM_IDLE);
 
+    // Nothing left to time - disarm our timer
+    scheduleNextUpdate();
+
     return true;
 }
 
 bool AlarmController::isActive() const {
+    // Buzzer test states are not an active alarm (see isTesting())
     return (currentState != ALARM_IDLE &&
             currentState != ALARM_STOPPED_USER &&
             currentState != ALARM_STOPPED_TIMEOUT &&
-            currentState != ALARM_STOPPED_ERROR);
+            currentState != ALARM_STOPPED_ERROR &&
+            currentState < ALARM_TEST_START);
 }
 
 void AlarmController::update() {
@@ -171,7 +212,10 @@ void AlarmController::update() {
             break;
 
         default:
-            // Stopped states - do nothing
+            // Test sequence steps forward, stopped states do nothing
+            if (isTesting()) {
+                updateTestState();
+            }
             break;
     }
 
@@ -183,15 +227,17 @@ void AlarmController::update() {
 
     // Perform periodic hardware checks (if enabled)
     if (isActive() && hardwareChecksEnabled) {
-        static unsigned long lastCheck = 0;
-        if (millis() - lastCheck >= 10000) {  // Check every 10 seconds
-            lastCheck = millis();
+        if (millis() - lastHealthCheck >= ALARM_HEALTH_CHECK_INTERVAL_MS) {
+            lastHealthCheck = millis();
             if (!checkHardwareHealth()) {
                 DEBUG_PRINTLN("[Alarm] Hardware check failed!");
                 stop(STOP_HARDWARE_ERROR);
             }
         }
     }
+
+    // Tell the scheduler when we need to run next
+    scheduleNextUpdate();
 }
 
 // ===============================================================
@@ -241,6 +287,16 @@ String AlarmController::getStateString() const {
             result = "Stopped due to error";
             break;
 
+        case ALARM_TEST_START:
+        case ALARM_TEST_SMALL_COUNTDOWN:
+        case ALARM_TEST_SMALL_BUZZER:
+        case ALARM_TEST_SMALL_PAUSE:
+        case ALARM_TEST_LARGE_COUNTDOWN:
+        case ALARM_TEST_LARGE_BUZZER:
+        case ALARM_TEST_LARGE_PAUSE:
+            result = "Testing buzzers";
+            break;
+
         default:
             result = "Unknown";
     }
@@ -301,37 +357,29 @@ bool AlarmController::testAlarm() {
         return false;
     }
 
+    if (isTesting()) {
+        DEBUG_PRINTLN("[Alarm] Test already running");
+        return false;
+    }
+
     DEBUG_PRINTLN("[Alarm] Starting test mode...");
 
     testMode = true;
 
-    // Send notification
-    sendTelegramNotification(MSG_TEST_START);
-    delay(1000);
-
-    // Test small buzzer
-    sendTelegramNotification(MSG_TEST_SMALL);
-    delay(3000);
-
-    hardware.testBuzzer(PIN_SMALL_BUZZER, 1000);  // 1 second
-    delay(2000);
+    // SILENCE button cuts the test buzzers just like a real alarm
+    hardware.armHardSilence();
 
-    // Test large buzzer (warn user it's loud!)
-    sendTelegramNotification(MSG_TEST_LARGE);
-    delay(3000);
+    // First step - update() takes it from here
+    transitionToState(ALARM_TEST_START);
+    scheduleNextUpdate();
 
-    hardware.testBuzzer(PIN_LARGE_BUZZER, 500);  // 0.5 second (shorter for loud buzzer)
-    delay(1000);
-
-    // Test complete
-    sendTelegramNotification(MSG_TEST_COMPLETE);
-
-    testMode = false;
-
-    DEBUG_PRINTLN("[Alarm] Test complete");
     return true;
 }
 
+bool AlarmController::isTesting() const {
+    return testMode;
+}
+
 String AlarmController::getLastHardwareError() const {
     return lastHardwareError;
 }
@@ -382,18 +430,53 @@ void AlarmController::transitionToState(AlarmState newState) {
             break;
 
         case ALARM_WARNING:
-            sendTelegramNotification(MSG_WARNING_STARTED);
+            updateBuzzerOutput();
             hardware.blinkAlarmLED(LED_BLINK_SLOW);
+            sendTelegramNotification(MSG_WARNING_STARTED, NOTIFY_LIVE);
             break;
 
         case ALARM_ALERT:
-            sendTelegramNotification(MSG_ALERT_STARTED);
+            updateBuzzerOutput();
             hardware.blinkAlarmLED(LED_BLINK_MEDIUM);
+            sendTelegramNotification(MSG_ALERT_STARTED, NOTIFY_LIVE);
             break;
 
         case ALARM_EMERGENCY:
-            sendTelegramNotification(MSG_EMERGENCY_STARTED);
+            updateBuzzerOutput();
             hardware.blinkAlarmLED(LED_BLINK_FAST);
+            sendTelegramNotification(MSG_EMERGENCY_STARTED, NOTIFY_LIVE);
+            break;
+
+        // ---------------------------------------------------------------
+        // Buzzer test steps
+        // ---------------------------------------------------------------
+        case ALARM_TEST_START:
+            sendTelegramNotification(MSG_TEST_START);
+            break;
+
+        case ALARM_TEST_SMALL_COUNTDOWN:
+            sendTelegramNotification(MSG_TEST_SMALL);
+            break;
+
+        case ALARM_TEST_SMALL_BUZZER:
+            hardware.setSmallBuzzer(BUZZER_ON);
+            break;
+
+        case ALARM_TEST_SMALL_PAUSE:
+            hardware.setSmallBuzzer(BUZZER_OFF);
+            break;
+
+        case ALARM_TEST_LARGE_COUNTDOWN:
+            // Warn user it's loud!
+            sendTelegramNotification(MSG_TEST_LARGE);
+            break;
+
+        case ALARM_TEST_LARGE_BUZZER:
+            hardware.setLargeBuzzer(BUZZER_ON);
+            break;
+
+        case ALARM_TEST_LARGE_PAUSE:
+            hardware.setLargeBuzzer(BUZZER_OFF);
             break;
 
         default:
@@ -420,12 +503,13 @@ bool AlarmController::isSafetyTimeoutReached() const {
 void AlarmController::updateBuzzerOutput() {
     switch (currentState) {
         case ALARM_WARNING:
-            // Pulsing pattern (handled by hardware module)
-            hardware.pulseSmallBuzzer();
+            // Pulsing pattern (timed by hardware module)
+            hardware.startSmallBuzzerPulse();
             break;
 
         case ALARM_ALERT:
             // Continuous small buzzer
+            hardware.stopSmallBuzzerPulse();
             hardware.setSmallBuzzer(BUZZER_ON);
             break;
 
@@ -447,7 +531,7 @@ bool AlarmController::checkHardwareHealth() {
     if (currentState == ALARM_WARNING || currentState == ALARM_ALERT) {
         if (hwState.smallBuzzer == HW_STATUS_FAILED) {
             lastHardwareError = "Small buzzer circuit failure";
-            sendTelegramNotification(MSG_ERROR_BUZZER_SMALL);
+            sendTelegramNotification(MSG_ERROR_BUZZER_SMALL, NOTIFY_URGENT);
             return false;
         }
     }
@@ -456,7 +540,7 @@ bool AlarmController::checkHardwareHealth() {
     if (currentState == ALARM_EMERGENCY) {
         if (hwState.largeBuzzer == HW_STATUS_FAILED) {
             lastHardwareError = "Large buzzer circuit failure";
-            sendTelegramNotification(MSG_ERROR_BUZZER_LARGE);
+            sendTelegramNotification(MSG_ERROR_BUZZER_LARGE, NOTIFY_URGENT);
             return false;
         }
     }
@@ -465,24 +549,22 @@ bool AlarmController::checkHardwareHealth() {
     if (hwState.smallBuzzer == HW_STATUS_FAILED &&
         hwState.largeBuzzer == HW_STATUS_FAILED) {
         lastHardwareError = "Both buzzer circuits failed";
-        sendTelegramNotification(MSG_ERROR_BOTH_BUZZERS);
+        sendTelegramNotification(MSG_ERROR_BOTH_BUZZERS, NOTIFY_URGENT);
         return false;
     }
 
     return true;
 }
 
-void AlarmController::sendTelegramNotification(const String& message) {
+void AlarmController::sendTelegramNotification(const char* message,
+                                               NotificationPriority priority) {
     if (!telegramNotificationsEnabled) {
         return;
     }
 
-    if (!telegramBot.isOnline()) {
-        DEBUG_PRINTLN("[Alarm] Cannot send notification - Telegram bot offline");
-        return;
-    }
-
-    telegramBot.sendMessage(message);
+    // Never talk to Telegram from the alarm task - a TLS request can
+    // take seconds. Queue it for the network task instead.
+    taskManager.postNotification(message, priority);
 }
 
 // ===============================================================
@@ -503,8 +585,7 @@ void AlarmController::updateTriggeredState() {
 }
 
 void AlarmController::updateWarningState() {
-    // Update buzzer (pulsing pattern)
-    updateBuzzerOutput();
+    // Buzzer pulse pattern runs on its own timer (see hardware.cpp)
 
     // Check if WARNING stage duration exceeded
     if (isStageDurationExceeded()) {
@@ -514,8 +595,7 @@ void AlarmController::updateWarningState() {
 }
 
 void AlarmController::updateAlertState() {
-    // Update buzzer (continuous)
-    updateBuzzerOutput();
+    // Buzzer was switched on continuously when ALERT started
 
     // Check if ALERT stage duration exceeded
     if (isStageDurationExceeded()) {
@@ -524,9 +604,53 @@ void AlarmController::updateAlertState() {
     }
 }
 
+void AlarmController::updateTestState() {
+    if (!isStageDurationExceeded()) {
+        return;
+    }
+
+    AlarmState nextState = getNextTestState(currentState);
+
+    if (nextState != ALARM_IDLE) {
+        transitionToState(nextState);
+        return;
+    }
+
+    // Last step done
+    sendTelegramNotification(MSG_TEST_COMPLETE);
+    testMode = false;
+    hardware.disarmHardSilence();
+    transitionToState(ALARM_IDLE);
+
+    DEBUG_PRINTLN("[Alarm] Test complete");
+}
+
+AlarmState AlarmController::getNextTestState(AlarmState state) const {
+    switch (state) {
+        case ALARM_TEST_START:           return ALARM_TEST_SMALL_COUNTDOWN;
+        case ALARM_TEST_SMALL_COUNTDOWN: return ALARM_TEST_SMALL_BUZZER;
+        case ALARM_TEST_SMALL_BUZZER:    return ALARM_TEST_SMALL_PAUSE;
+        case ALARM_TEST_SMALL_PAUSE:     return ALARM_TEST_LARGE_COUNTDOWN;
+        case ALARM_TEST_LARGE_COUNTDOWN: return ALARM_TEST_LARGE_BUZZER;
+        case ALARM_TEST_LARGE_BUZZER:    return ALARM_TEST_LARGE_PAUSE;
+        default:                         return ALARM_IDLE;
+    }
+}
+
+void AlarmController::abortTest() {
+    DEBUG_PRINTLN("[Alarm] Test aborted");
+
+    testMode = false;
+    hardware.stopAllBuzzers();
+    hardware.disarmHardSilence();
+    transitionToState(ALARM_IDLE);
+    scheduleNextUpdate();
+
+    sendTelegramNotification(MSG_TEST_ABORTED, NOTIFY_URGENT);
+}
+
 void AlarmController::updateEmergencyState() {
-    // Update buzzer (large buzzer)
-    updateBuzzerOutput();
+    // Large buzzer was switched on when EMERGENCY started
 
     // EMERGENCY stage runs until:
     // 1. User stops it manually, OR
@@ -550,11 +674,66 @@ unsigned long AlarmController::getStateDuration(AlarmState state) const {
             // No fixed duration - runs until stopped
             return UINT32_MAX;
 
+        case ALARM_TEST_START:
+            return TEST_START_DELAY_MS;
+
+        case ALARM_TEST_SMALL_COUNTDOWN:
+        case ALARM_TEST_LARGE_COUNTDOWN:
+            return TEST_COUNTDOWN_MS;
+
+        case ALARM_TEST_SMALL_BUZZER:
+            return TEST_SMALL_BUZZER_MS;
+
+        case ALARM_TEST_SMALL_PAUSE:
+            return TEST_SMALL_PAUSE_MS;
+
+        case ALARM_TEST_LARGE_BUZZER:
+            return TEST_LARGE_BUZZER_MS;
+
+        case ALARM_TEST_LARGE_PAUSE:
+            return TEST_LARGE_PAUSE_MS;
+
         default:
             return 0;
     }
 }
 
+void AlarmController::scheduleNextUpdate() {
+    // Buzzer test: only the end of the current step matters
+    if (isTesting()) {
+        alarmScheduler.scheduleAt(updateTimerId,
+                                  stageStartTime + getStateDuration(currentState));
+        return;
+    }
+
+    if (!isActive()) {
+        alarmScheduler.cancel(updateTimerId);
+        return;
+    }
+
+    // Safety timeout always applies while active
+    unsigned long nextDeadline = alarmStartTime + ALARM_SAFETY_TIMEOUT_MS;
+
+    // End of current stage (EMERGENCY has no fixed end)
+    unsigned long stageDuration = getStateDuration(currentState);
+    if (stageDuration != UINT32_MAX) {
+        unsigned long stageEnd = stageStartTime + stageDuration;
+        if ((long)(stageEnd - nextDeadline) < 0) {
+            nextDeadline = stageEnd;
+        }
+    }
+
+    // Next periodic hardware check
+    if (hardwareChecksEnabled) {
+        unsigned long checkDue = lastHealthCheck + ALARM_HEALTH_CHECK_INTERVAL_MS;
+        if ((long)(checkDue - nextDeadline) < 0) {
+            nextDeadline = checkDue;
+        }
+    }
+
+    alarmScheduler.scheduleAt(updateTimerId, nextDeadline);
+}
+
 void AlarmController::calculateStatistics(AlarmStopSource source) {
     lastStatistics.startTime = alarmStartTime;
     lastStatistics.stopTime = millis();
@@ -578,7 +757,7 @@ void AlarmController::calculateStatistics(AlarmStopSource source) {
  * STATE MACHINE DESIGN:
  * This implementation uses a simple switch-based state machine.
  * Each state has:
- * - An update function (called every loop iteration)
+ * - An update function (called by alarmScheduler when a deadline is due)
  * - Entry actions (performed in transitionToState())
  * - Duration check (isStageDurationExceeded())
  *
@@ -600,6 +779,14 @@ void AlarmController::calculateStatistics(AlarmStopSource source) {
  *
  * ===============================================================
  *
+ * SCHEDULING:
+ * update() is not polled. After every update, scheduleNextUpdate()
+ * arms one alarmScheduler timer for the earliest of: end of stage,
+ * safety timeout, next hardware check. The alarm task sleeps until
+ * then (or until a button/command wakes it).
+ *
+ * ===============================================================
+ *
  * HARDWARE FAILURE HANDLING:
  * The controller checks hardware health periodically:
  * - WARNING/ALERT: Check small buzzer every 10s
@@ -27,6 +27,8 @@
 #include "config.h"
 #include "hardware.h"
 #include "telegram_bot.h"
+#include "scheduler.h"
+#include "task_manager.h"
 
 // ===============================================================
 // ALARM STATE ENUMERATION
@@ -41,7 +43,16 @@ enum AlarmState {
     ALARM_EMERGENCY,         // Stage 3: Large buzzer (until stopped)
     ALARM_STOPPED_USER,      // Stopped by user (silence button or Telegram)
     ALARM_STOPPED_TIMEOUT,   // Stopped by safety timeout (5 minutes)
-    ALARM_STOPPED_ERROR      // Stopped due to hardware error
+    ALARM_STOPPED_ERROR,     // Stopped due to hardware error
+
+    // Buzzer test sequence (/test) - NOT counted as active alarm
+    ALARM_TEST_START,            // "Testing buzzers..." (1s)
+    ALARM_TEST_SMALL_COUNTDOWN,  // "Small buzzer test in 3..." (3s)
+    ALARM_TEST_SMALL_BUZZER,     // Small buzzer on (1s)
+    ALARM_TEST_SMALL_PAUSE,      // Small buzzer off (2s)
+    ALARM_TEST_LARGE_COUNTDOWN,  // "Large buzzer test in 3..." (3s)
+    ALARM_TEST_LARGE_BUZZER,     // Large buzzer on (0.5s)
+    ALARM_TEST_LARGE_PAUSE       // Large buzzer off (1s), then IDLE
 };
 
 // ===============================================================
@@ -52,6 +63,7 @@ enum AlarmState {
 enum AlarmStopSource {
     STOP_NONE,                    // Not stopped
     STOP_TELEGRAM_COMMAND,        // User sent /stop via Telegram
+    STOP_TELEGRAM_BUTTON,         // User tapped STOP under the live status
     STOP_SILENCE_BUTTON,          // Physical silence button pressed
     STOP_SAFETY_TIMEOUT,          // 5-minute safety timeout expired
     STOP_HARDWARE_ERROR,          // Hardware failure detected
@@ -100,14 +112,15 @@ public:
     // Start alarm sequence
     // This initiates the state machine: IDLE → TRIGGERED
     // Actual alarm starts after 3-second delay
+    // A running buzzer test is aborted first
     //
     // RETURNS: true if started, false if already running
     bool start();
 
-    // Stop alarm immediately
+    // Stop alarm immediately (also aborts a running buzzer test)
     // source: How the alarm was stopped (for statistics)
     //
-    // RETURNS: true if stopped, false if not running
+    // RETURNS: true if stopped, false if nothing was running
     bool stop(AlarmStopSource source);
 
     // Check if alarm is currently active (any state except IDLE)
@@ -115,7 +128,9 @@ public:
     bool isActive() const;
 
     // Update alarm state machine
-    // MUST be called frequently in loop()
+    // Called automatically by alarmScheduler when the next stage
+    // transition, safety timeout or health check is due.
+    // Safe to call at any other time as well.
     //
     // This handles:
     // - Stage transitions (WARNING → ALERT → EMERGENCY)
@@ -168,13 +183,18 @@ public:
     // TESTING & DIAGNOSTICS
     // ---------------------------------------------------------------
 
-    // Test alarm system (gentle test, small buzzer only)
-    // Runs for 3 seconds, doesn't trigger full alarm
-    // Used for /test command
+    // Test alarm system (both buzzers, briefly)
+    // Starts the ALARM_TEST_* sequence (~11.5 seconds) and returns
+    // immediately. update() steps through it like the alarm stages,
+    // and stop() / start() abort it at any time.
+    // Used for /test command and TEST button
     //
-    // RETURNS: true if test started
+    // RETURNS: true if test started, false if alarm or test running
     bool testAlarm();
 
+    // Check if the buzzer test sequence is running
+    bool isTesting() const;
+
     // Get last hardware error message (if any)
     // RETURNS: Error description, empty if no error
     String getLastHardwareError() const;
@@ -202,6 +222,9 @@ private:
 
     bool testMode;                     // Is this a test run?
 
+    unsigned long lastHealthCheck;     // Last hardware check (millis)
+    int updateTimerId;                 // alarmScheduler timer for update()
+
     // ---------------------------------------------------------------
     // PRIVATE HELPER FUNCTIONS
     // ---------------------------------------------------------------
@@ -226,8 +249,14 @@ private:
     bool checkHardwareHealth();
 
     // Send notification via Telegram (if enabled)
+    // The message is queued for the network task, this never blocks
     // message: Text to send
-    void sendTelegramNotification(const String& message);
+    // priority: NOTIFY_URGENT for hardware errors (sent ahead of
+    //           normal messages), NOTIFY_LIVE_START / NOTIFY_LIVE /
+    //           NOTIFY_LIVE_END for lines of the alarm's live status
+    //           message
+    void sendTelegramNotification(const char* message,
+                                  NotificationPriority priority = NOTIFY_NORMAL);
 
     // Handle state-specific update logic
     void updateIdleState();
@@ -235,11 +264,23 @@ private:
     void updateWarningState();
     void updateAlertState();
     void updateEmergencyState();
+    void updateTestState();
+
+    // Next step of the buzzer test sequence
+    // RETURNS: Next test state, ALARM_IDLE after the last step
+    AlarmState getNextTestState(AlarmState state) const;
+
+    // Stop the buzzer test and return to IDLE
+    void abortTest();
 
     // Get duration of current state (for configuration lookup)
     // RETURNS: Duration in milliseconds
     unsigned long getStateDuration(AlarmState state) const;
 
+    // Arm alarmScheduler for the earliest upcoming deadline
+    // (stage end, safety timeout, health check), or disarm if idle
+    void scheduleNextUpdate();
+
     // Calculate alarm statistics when stopping
     void calculateStatistics(AlarmStopSource source);
 };
@@ -276,30 +317,14 @@ extern AlarmController alarmController;
  *     alarmController.setTelegramNotificationsEnabled(true);
  *     alarmController.setHardwareChecksEnabled(true);
  *
- *     // Register Telegram command handlers
- *     telegramBot.onCommand("/wake", [](TelegramMessage msg) {
- *         if (!alarmController.isActive()) {
- *             alarmController.start();
- *         } else {
- *             telegramBot.sendMessage("⚠️ Alarm already running!");
- *         }
- *     });
- *
- *     telegramBot.onCommand("/stop", [](TelegramMessage msg) {
- *         if (alarmController.isActive()) {
- *             alarmController.stop(STOP_TELEGRAM_COMMAND);
- *             telegramBot.sendMessage("✅ Alarm stopped");
- *         }
- *     });
- *
- *     telegramBot.onCommand("/test", [](TelegramMessage msg) {
- *         alarmController.testAlarm();
- *     });
+ *     // Register Telegram command handlers (see command_table.h)
+ *     telegramBot.setCommandTable(COMMANDS, COMMAND_COUNT);
  * }
  *
  * void loop() {
- *     // Update alarm state machine (CRITICAL - must be in loop!)
- *     alarmController.update();
+ *     // Run due timers - this calls alarmController.update() exactly
+ *     // when the next stage transition is due
+ *     alarmScheduler.runDueTimers();
  *
  *     // Check physical silence button
  *     hardware.updateButtons();
@@ -0,0 +1,90 @@
+/*
+ * ===============================================================
+ * WakeAssist - Boot Timing Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the boot phase report declared in
+ * boot_timing.h
+ *
+ * ===============================================================
+ */
+
+#include "boot_timing.h"
+
+// ===============================================================
+// GLOBAL INSTANCE
+// ===============================================================
+
+BootTiming bootTiming;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+BootTiming::BootTiming() {
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        phaseDoneTime[i] = 0;
+    }
+}
+
+// ===============================================================
+// RECORDING
+// ===============================================================
+
+void BootTiming::mark(BootPhase phase) {
+    if (isDone(phase)) {
+        return;  // Keep the first time (e.g. WiFi reconnects later)
+    }
+
+    // millis() is never 0 here (serial output alone takes longer),
+    // but make sure a mark is never mistaken for "not yet"
+    unsigned long now = millis();
+    phaseDoneTime[phase] = (now > 0) ? now : 1;
+
+    DEBUG_PRINTF("[Boot] %s after %lums\n", phaseName(phase), phaseDoneTime[phase]);
+}
+
+bool BootTiming::isDone(BootPhase phase) const {
+    return phaseDoneTime[phase] != 0;
+}
+
+// ===============================================================
+// REPORTING
+// ===============================================================
+
+String BootTiming::getReportString() const {
+    String result = "";
+    char line[64];
+    unsigned long previous = 0;
+
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        unsigned long doneTime = phaseDoneTime[i];
+
+        if (doneTime == 0) {
+            snprintf(line, sizeof(line), "%-12s   pending\n", phaseName((BootPhase)i));
+            result += line;
+            continue;
+        }
+
+        snprintf(line, sizeof(line), "%-12s %6lums  (+%lu)\n",
+                 phaseName((BootPhase)i), doneTime, doneTime - previous);
+        result += line;
+        previous = doneTime;
+    }
+
+    return result;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+const char* BootTiming::phaseName(BootPhase phase) {
+    switch (phase) {
+        case BOOT_PHASE_HARDWARE:    return "hardware";
+        case BOOT_PHASE_ALARM_READY: return "alarm ready";
+        case BOOT_PHASE_WIFI:        return "wifi";
+        case BOOT_PHASE_TELEGRAM:    return "telegram";
+        default:                     return "unknown";
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * ===============================================================
+ * WakeAssist - Boot Timing Module (Header File)
+ * ===============================================================
+ *
+ * This module records how long each phase of the boot took:
+ * - Hardware:    GPIO, PWM, button interrupts, buzzer self-test
+ * - Alarm ready: Alarm task running, buttons and buzzers usable
+ * - WiFi:        Connected to the stored network (network task)
+ * - Telegram:    Bot online (network task)
+ *
+ * WHY?
+ * The device must react to the SILENCE button and to /wake as soon
+ * as possible after power returns. Only the first two phases run in
+ * setup(); WiFi and Telegram come up later in the network task.
+ * This report shows that "alarm ready" really happens in a few
+ * milliseconds, no matter how slow the network is.
+ *
+ * ===============================================================
+ */
+
+#ifndef BOOT_TIMING_H
+#define BOOT_TIMING_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===============================================================
+// BOOT PHASES
+// ===============================================================
+// In the order they normally finish
+
+enum BootPhase {
+    BOOT_PHASE_HARDWARE,     // hardware.begin() done (setup)
+    BOOT_PHASE_ALARM_READY,  // Alarm and network tasks started (setup)
+    BOOT_PHASE_WIFI,         // WiFi connected (network task)
+    BOOT_PHASE_TELEGRAM,     // Telegram bot online (network task)
+    BOOT_PHASE_COUNT         // Number of phases (not a phase)
+};
+
+// ===============================================================
+// BOOT TIMING CLASS
+// ===============================================================
+
+class BootTiming {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    BootTiming();
+
+    // ---------------------------------------------------------------
+    // RECORDING
+    // ---------------------------------------------------------------
+
+    // Record that a phase has finished (now)
+    // Only the first call per phase counts
+    void mark(BootPhase phase);
+
+    // Check if a phase has finished
+    bool isDone(BootPhase phase) const;
+
+    // ---------------------------------------------------------------
+    // REPORTING
+    // ---------------------------------------------------------------
+
+    // Get per-phase report, one line per phase
+    // RETURNS: String like "hardware       48ms  (+48)\n..."
+    String getReportString() const;
+
+private:
+    // millis() when each phase finished, 0 = not yet
+    volatile unsigned long phaseDoneTime[BOOT_PHASE_COUNT];
+
+    // Short name of a phase
+    static const char* phaseName(BootPhase phase);
+};
+
+// ===============================================================
+// GLOBAL BOOT TIMING INSTANCE
+// ===============================================================
+
+extern BootTiming bootTiming;
+
+#endif // BOOT_TIMING_H
+
+/*
+ * ===============================================================
+ * EXAMPLE REPORT (/boot):
+ * ===============================================================
+ *
+ * hardware        31ms  (+31)
+ * alarm ready     38ms  (+7)
+ * wifi          2710ms  (+2672)
+ * telegram      3954ms  (+1244)
+ *
+ * Times are since power-on. The number in brackets is how long the
+ * phase itself took.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,425 @@
+/*
+ * ===============================================================
+ * WakeAssist - Bot API Transport Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the request path declared in
+ * bot_transport.h
+ *
+ * KEY CONCEPTS:
+ * - Keep-alive: one connection carries request after request, so
+ *   the TLS handshake is paid once, not per request
+ * - Streaming: the answer goes through HttpResponse straight into
+ *   the caller's parser, never into a String
+ * - Interrupt: a long poll cut short is not a failure for the
+ *   circuit breaker, and its connection stays open for resume()
+ *
+ * ===============================================================
+ */
+
+#include "bot_transport.h"
+#include "http_response.h"
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+BotTransport::BotTransport(RandomFunction randomFunction)
+    : randomFunction(randomFunction) {
+    connection = nullptr;
+    host[0] = '\0';
+    port = 0;
+    tls = false;
+    token[0] = '\0';
+
+    lastRequestTime = 0;
+    reusedCount = 0;
+    interrupted = false;
+    holding = false;
+    holdingReused = false;
+    waitStart = 0;
+    waitLimitMs = 0;
+    longPollInterrupts = 0;
+    lastStatusCode = 0;
+    lastResponseBytes = 0;
+
+    ownBreaker.configure(TELEGRAM_BREAKER_FAILURES, TELEGRAM_BREAKER_BASE_MS,
+                         TELEGRAM_BREAKER_MAX_MS, TELEGRAM_BREAKER_JITTER_PERCENT);
+    breaker = &ownBreaker;
+}
+
+// ===============================================================
+// CONFIGURATION
+// ===============================================================
+
+bool BotTransport::setServer(Client& client, const char* serverHost, uint16_t serverPort,
+                             bool useTls) {
+    if (strlen(serverHost) >= sizeof(host)) {
+        return false;
+    }
+
+    // The open connection (if any) goes to the old server
+    close();
+
+    connection = &client;
+    strcpy(host, serverHost);
+    port = serverPort;
+    tls = useTls;
+    return true;
+}
+
+bool BotTransport::setToken(const char* botToken) {
+    if (strlen(botToken) >= sizeof(token)) {
+        return false;
+    }
+
+    // A held long poll asks for the old bot's updates
+    if (strcmp(token, botToken) != 0) {
+        close();
+    }
+
+    strcpy(token, botToken);
+    return true;
+}
+
+void BotTransport::shareBreaker(BotTransport& other) {
+    breaker = other.breaker;
+}
+
+void BotTransport::onLongPollInterrupt(std::function<bool()> callback) {
+    callbackLongPollInterrupt = callback;
+}
+
+// ===============================================================
+// REQUESTS
+// ===============================================================
+
+bool BotTransport::request(const char* method, const char* endpoint, const char* params,
+                           const char* body, BodyParser parseBody, unsigned long waitMs) {
+    interrupted = false;
+
+    // The held long poll's answer would be read as this one's
+    if (holding) {
+        close();
+    }
+
+    // Telegram unreachable lately: fail at once instead of blocking
+    // the network task on another connect timeout
+    if (!breaker->allowRequest(millis())) {
+        DEBUG_PRINTF("[Telegram] %s skipped - circuit open, retry in %lus\n",
+                    endpoint, breaker->getRemainingMs(millis()) / 1000);
+        return false;
+    }
+
+    bool success = performRequest(method, endpoint, params, body, parseBody, waitMs);
+    return recordResult(success);
+}
+
+bool BotTransport::resume(BodyParser parseBody) {
+    interrupted = false;
+
+    if (!holding) {
+        return false;
+    }
+
+    holding = false;
+
+    // Already sent and (maybe) answered: no breaker check, no retry
+    bool success = false;
+    if (waitForLongPoll()) {
+        bool anyData = false;
+        success = readAnswer(parseBody, holdingReused, anyData);
+    }
+
+    return recordResult(success);
+}
+
+void BotTransport::close() {
+    holding = false;
+
+    if (connection != nullptr) {
+        connection->stop();
+    }
+}
+
+// ===============================================================
+// STATUS & INFORMATION
+// ===============================================================
+
+bool BotTransport::wasInterrupted() const {
+    return interrupted;
+}
+
+bool BotTransport::isHolding() const {
+    return holding;
+}
+
+int BotTransport::getLastStatusCode() const {
+    return lastStatusCode;
+}
+
+size_t BotTransport::getLastResponseBytes() const {
+    return lastResponseBytes;
+}
+
+uint32_t BotTransport::getReusedCount() const {
+    return reusedCount;
+}
+
+uint32_t BotTransport::getLongPollInterrupts() const {
+    return longPollInterrupts;
+}
+
+CircuitBreaker& BotTransport::getBreaker() {
+    return *breaker;
+}
+
+const CircuitBreaker& BotTransport::getBreaker() const {
+    return *breaker;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+bool BotTransport::performRequest(const char* method, const char* endpoint,
+                                  const char* params, const char* body,
+                                  BodyParser& parseBody, unsigned long waitMs) {
+    lastStatusCode = 0;
+    lastResponseBytes = 0;
+
+    if (connection == nullptr) {
+        return false;
+    }
+
+    DEBUG_PRINTF("[Telegram] %s %s\n", method, endpoint);
+
+    size_t bodyLength = strlen(body);
+    char head[TELEGRAM_REQUEST_HEAD_BYTES];
+    int headLen = buildHead(head, sizeof(head), method, endpoint, params, bodyLength);
+
+    if (headLen == 0) {
+        DEBUG_PRINTLN("[Telegram] ERROR: Request too long");
+        return false;
+    }
+
+    // ---------------------------------------------------------------
+    // Try the open connection first. If the server closed it while we
+    // were idle, nothing was processed - retry once on a new one
+    // ---------------------------------------------------------------
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = false;
+
+        if (!openConnection(reused)) {
+            return false;
+        }
+
+        // Scatter write: headers from the stack buffer, body straight
+        // from the caller's text (never copied into one request)
+        bool sent = (connection->write((const uint8_t*)head, headLen) == (size_t)headLen);
+
+        if (sent && bodyLength > 0) {
+            sent = (connection->write((const uint8_t*)body, bodyLength) == bodyLength);
+        }
+
+        // Long poll: the server holds the answer back on purpose
+        if (sent && waitMs > 0) {
+            waitStart = millis();
+            waitLimitMs = waitMs + TELEGRAM_API_TIMEOUT_MS;
+            holdingReused = reused;
+
+            if (!waitForLongPoll()) {
+                return false;
+            }
+        }
+
+        // Parse the body while it arrives (no copy of the body)
+        bool anyData = false;
+        if (sent && readAnswer(parseBody, reused, anyData)) {
+            return true;
+        }
+
+        if (!sent) {
+            close();
+        }
+
+        // Only a dead reused connection is worth a second try
+        if (!reused || anyData) {
+            break;
+        }
+
+        DEBUG_PRINTLN("[Telegram] Kept-alive connection was closed - reconnecting");
+    }
+
+    return false;
+}
+
+bool BotTransport::recordResult(bool success) {
+    if (success) {
+        breaker->recordSuccess();
+    } else if (!interrupted) {
+        // Cut short on purpose says nothing about the server
+        breaker->recordFailure(millis(), randomFunction());
+        if (breaker->getState() == CIRCUIT_OPEN) {
+            DEBUG_PRINTF("[Telegram] Circuit open after %d failures, retry in %lus\n",
+                        breaker->getConsecutiveFailures(),
+                        breaker->getRemainingMs(millis()) / 1000);
+        }
+    }
+
+    return success;
+}
+
+bool BotTransport::readAnswer(BodyParser& parseBody, bool reused, bool& anyData) {
+    HttpResponse http(*connection, TELEGRAM_API_TIMEOUT_MS, TELEGRAM_MAX_RESPONSE_BYTES);
+    bool complete = false;
+
+    if (http.begin()) {
+        lastStatusCode = http.getStatusCode();
+        bool parsed = parseBody(http);
+
+        // finish() even after a parse error, so a complete but
+        // invalid body does not cost the connection
+        complete = http.finish() && parsed;
+        lastResponseBytes = http.getBodyBytesRead();
+    }
+
+    anyData = http.hasData();
+
+    if (!complete) {
+        close();
+        return false;
+    }
+
+    lastRequestTime = millis();
+
+    if (reused) {
+        reusedCount++;
+    }
+
+    // Server said "Connection: close" - don't reuse
+    if (!http.isKeepAlive()) {
+        close();
+    }
+
+    return true;
+}
+
+int BotTransport::buildHead(char* head, size_t size, const char* method,
+                            const char* endpoint, const char* params,
+                            size_t bodyLength) const {
+    // The port is only part of the Host header if it is not the
+    // scheme's default
+    char portText[8] = "";
+    if (port != (tls ? 443 : 80)) {
+        snprintf(portText, sizeof(portText), ":%u", port);
+    }
+
+    // GET /bot<TOKEN>/<endpoint>?<params> HTTP/1.1
+    int length = snprintf(head, size,
+                          "%s /bot%s/%s%s%s HTTP/1.1\r\n"
+                          "Host: %s%s\r\n"
+                          "User-Agent: ESP32\r\n"
+                          "Connection: keep-alive\r\n",
+                          method, token, endpoint,
+                          params[0] != '\0' ? "?" : "", params,
+                          host, portText);
+
+    if (bodyLength > 0 && length > 0 && length < (int)size) {
+        length += snprintf(head + length, size - length,
+                           "Content-Type: application/json\r\n"
+                           "Content-Length: %u\r\n",
+                           (unsigned)bodyLength);
+    }
+
+    if (length > 0 && length < (int)size) {
+        length += snprintf(head + length, size - length, "\r\n");
+    }
+
+    if (length <= 0 || length >= (int)size) {
+        return 0;
+    }
+
+    return length;
+}
+
+bool BotTransport::openConnection(bool& reused) {
+    // Reuse the connection if it is open and was used recently
+    if (connection->connected() && millis() - lastRequestTime < TELEGRAM_KEEPALIVE_IDLE_MS) {
+        reused = true;
+        return true;
+    }
+
+    reused = false;
+    close();  // Clean up a half-closed connection
+
+    // New TCP connection (+ TLS handshake, resumed if possible -
+    // TlsClient keeps the statistics)
+    if (!connection->connect(host, port)) {
+        DEBUG_PRINTLN("[Telegram] ERROR: Connection failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool BotTransport::waitForLongPoll() {
+    while (connection->available() == 0) {
+        // Closed by the server - HttpResponse reports the error
+        if (!connection->connected()) {
+            return true;
+        }
+
+        // Something more urgent is waiting (e.g. alarm notifications).
+        // The request stays open: its answer waits in the socket until
+        // resume(), so no new connection (and TLS handshake) is needed.
+        // Not logged: with MQTT on this happens every few ms (see
+        // getLongPollInterrupts())
+        if (callbackLongPollInterrupt && callbackLongPollInterrupt()) {
+            interrupted = true;
+            holding = true;
+            longPollInterrupts++;
+            return false;
+        }
+
+        if (millis() - waitStart > waitLimitMs) {
+            DEBUG_PRINTLN("[Telegram] ERROR: Long poll timeout");
+            close();
+            return false;
+        }
+
+        delay(TELEGRAM_LONG_POLL_CHECK_MS);
+    }
+
+    return true;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * WHY A SEPARATE MODULE?
+ * The request path used to live inside TelegramBot, next to the TLS
+ * client, NVS storage and WiFi, none of which build on a PC. Here it
+ * only needs a Client, so the host tests run this exact code against
+ * the mock server instead of a copy of it.
+ *
+ * WHEN IS A REQUEST SENT TWICE?
+ * Only when a reused connection turns out to be dead and not a
+ * single byte of the answer arrived: the server closed the idle
+ * connection before it saw the request. Once any byte arrived the
+ * request may have been carried out (a sendMessage would be sent
+ * twice), so it fails instead.
+ *
+ * WHY HOLD AN INTERRUPTED LONG POLL?
+ * The interrupt callback fires whenever other network work is due
+ * (notifications, timers). Closing the connection each time would
+ * cost a TLS handshake per interrupt. Instead the getUpdates request
+ * stays open: whatever Telegram answers waits in the socket, and
+ * resume() reads it. Other requests need a second connection for
+ * that time (TelegramBot keeps one for sends). Nothing can be lost:
+ * updates count as delivered only once the next offset confirms them.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,219 @@
+/*
+ * ===============================================================
+ * WakeAssist - Bot API Transport Module (Header File)
+ * ===============================================================
+ *
+ * This module sends Telegram Bot API requests over one kept-alive
+ * HTTP/1.1 connection and hands the answer body to a parser while
+ * it arrives:
+ * - Request line and headers from a stack buffer, body written
+ *   straight from the caller's text
+ * - The open connection is reused; if the server closed it while
+ *   idle, the request is sent once more on a new connection
+ * - Long poll: while the server holds the answer back, a callback
+ *   can cut the wait short. The request stays open ("held") and
+ *   resume() goes on waiting for its answer later - no new
+ *   connection, no new TLS handshake
+ * - Circuit breaker: fails at once while Telegram is unreachable
+ *
+ * TelegramBot owns the transport and decides WHAT to send. The
+ * connection itself (TLS or plain TCP) is passed in, so the same
+ * code runs on the PC against tools/mock_telegram_api.py
+ * (test/test_transport, test/test_long_poll).
+ *
+ * ===============================================================
+ */
+
+#ifndef BOT_TRANSPORT_H
+#define BOT_TRANSPORT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <functional>
+#include "config.h"
+#include "circuit_breaker.h"
+
+// ===============================================================
+// BOT TRANSPORT CLASS
+// ===============================================================
+
+class BotTransport {
+public:
+    // Reads an answer body, RETURNS: false if it is invalid
+    typedef std::function<bool(Stream&)> BodyParser;
+
+    // Random numbers for the breaker's back-off jitter
+    typedef uint32_t (*RandomFunction)();
+
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    // randomFunction: esp_random() on the device, anything on the PC
+    explicit BotTransport(RandomFunction randomFunction);
+
+    // ---------------------------------------------------------------
+    // CONFIGURATION
+    // ---------------------------------------------------------------
+
+    // Server to talk to (closes the open connection)
+    // client: Connection to use (TLS or plain TCP), must stay valid
+    // useTls: Only decides the default port left out of "Host:"
+    // RETURNS: false if host is longer than TELEGRAM_API_HOST_MAX_BYTES - 1
+    bool setServer(Client& client, const char* host, uint16_t port, bool useTls);
+
+    // Bot token for the request path (/bot<token>/...)
+    // A held long poll for another token is dropped
+    // RETURNS: false if longer than TELEGRAM_TOKEN_MAX_BYTES - 1
+    bool setToken(const char* token);
+
+    // Use other's circuit breaker instead of an own one
+    // Two connections to the same server should back off together
+    void shareBreaker(BotTransport& other);
+
+    // Check that cuts a waiting long poll short
+    // Called every TELEGRAM_LONG_POLL_CHECK_MS while the answer is
+    // held back; return true when something else needs the network
+    void onLongPollInterrupt(std::function<bool()> callback);
+
+    // ---------------------------------------------------------------
+    // REQUESTS
+    // ---------------------------------------------------------------
+
+    // Send one request and parse the answer while it arrives
+    //
+    // method:    "GET" or "POST"
+    // endpoint:  API method ("getUpdates")
+    // params:    Query string without '?', "" for none
+    // body:      JSON body for POST, "" for none
+    // parseBody: Reads the answer body
+    // waitMs:    Long poll - how long the server may hold the answer
+    //            back (0 = answers right away)
+    //
+    // RETURNS: true if a complete answer arrived and parseBody
+    //          accepted it (any HTTP status - Telegram's errors come
+    //          as JSON). false if refused by the breaker, failed or
+    //          interrupted (see wasInterrupted(), isHolding())
+    //
+    // A held long poll is dropped first (its answer would be read as
+    // this request's)
+    bool request(const char* method, const char* endpoint, const char* params,
+                 const char* body, BodyParser parseBody, unsigned long waitMs);
+
+    // Go on waiting for the answer of the held long poll
+    // Same wait limit as the original request, measured from when it
+    // was sent; may be interrupted (and held) again
+    // RETURNS: Like request(), false if nothing is held
+    bool resume(BodyParser parseBody);
+
+    // Close the connection (the next request opens a new one)
+    // Drops a held long poll
+    void close();
+
+    // ---------------------------------------------------------------
+    // STATUS & INFORMATION
+    // ---------------------------------------------------------------
+
+    // Last request was cut short by the interrupt callback (not an error)
+    bool wasInterrupted() const;
+
+    // A long poll was cut short and its answer is still to come on
+    // the open connection (see resume())
+    bool isHolding() const;
+
+    // HTTP status of the last answer, 0 if none arrived
+    int getLastStatusCode() const;
+
+    // Body size of the last answer (bytes)
+    size_t getLastResponseBytes() const;
+
+    // Requests sent on an already open connection
+    uint32_t getReusedCount() const;
+
+    // Long polls cut short so far
+    uint32_t getLongPollInterrupts() const;
+
+    // The breaker (state, back-off, counters), shared or own
+    CircuitBreaker& getBreaker();
+    const CircuitBreaker& getBreaker() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    Client* connection;           // nullptr until setServer()
+    char host[TELEGRAM_API_HOST_MAX_BYTES];
+    uint16_t port;
+    bool tls;
+    char token[TELEGRAM_TOKEN_MAX_BYTES];
+
+    CircuitBreaker ownBreaker;
+    CircuitBreaker* breaker;      // &ownBreaker unless shareBreaker()
+    RandomFunction randomFunction;
+
+    std::function<bool()> callbackLongPollInterrupt;
+
+    unsigned long lastRequestTime;  // When the connection was last used
+    uint32_t reusedCount;
+    bool interrupted;             // Last request cut short on purpose
+    bool holding;                 // Long poll answer still to come
+    bool holdingReused;           // ... sent on a reused connection
+    unsigned long waitStart;      // When the long poll was sent
+    unsigned long waitLimitMs;    // How long its answer may take
+    uint32_t longPollInterrupts;
+    int lastStatusCode;
+    size_t lastResponseBytes;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // The network part of request() (without the breaker)
+    bool performRequest(const char* method, const char* endpoint, const char* params,
+                        const char* body, BodyParser& parseBody, unsigned long waitMs);
+
+    // Success or failure into the breaker (interrupts don't count)
+    // RETURNS: success
+    bool recordResult(bool success);
+
+    // Read the answer on the open connection into parseBody
+    // reused:  The request went out on a reused connection
+    // anyData: Set to true if any byte of the answer arrived
+    // RETURNS: true if complete and accepted (connection closed if not)
+    bool readAnswer(BodyParser& parseBody, bool reused, bool& anyData);
+
+    // Build request line and headers into head
+    // RETURNS: Length, or 0 if it does not fit
+    int buildHead(char* head, size_t size, const char* method, const char* endpoint,
+                  const char* params, size_t bodyLength) const;
+
+    // Make sure the connection is open
+    // reused: Set to true if an already open connection is used
+    // RETURNS: true if connected
+    bool openConnection(bool& reused);
+
+    // Wait for the first byte of a long-poll answer, until
+    // waitLimitMs after waitStart
+    // RETURNS: true if the answer is arriving (or the server closed),
+    //          false if interrupted (held) or timed out (closed)
+    bool waitForLongPoll();
+};
+
+#endif // BOT_TRANSPORT_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * BotTransport transport(esp_random);
+ * transport.setServer(tlsClient, "api.telegram.org", 443, true);
+ * transport.setToken(botToken.c_str());
+ *
+ * JsonDocument doc;
+ * bool ok = transport.request("GET", "getMe", "", "", [&doc](Stream& body) {
+ *     return !deserializeJson(doc, body);
+ * }, 0);
+ *
+ * ===============================================================
+ */
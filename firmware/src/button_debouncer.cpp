@@ -0,0 +1,212 @@
+/*
+ * ===============================================================
+ * WakeAssist - Button Debouncer (Implementation)
+ * ===============================================================
+ *
+ * This file implements the edge-based debouncer declared in
+ * button_debouncer.h
+ *
+ * NOTE: No Arduino includes on purpose - the PC unit tests replay
+ * bounce patterns through it (test/test_button_debouncer).
+ *
+ * ===============================================================
+ */
+
+#include "button_debouncer.h"
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+ButtonDebouncer::ButtonDebouncer() {
+    debounceTime = 0;
+    longPressTime = 0;
+    confirmTime = 0;
+
+    stablePressed = false;
+    settling = false;
+    settleUntil = 0;
+    pressTime = 0;
+    longPressSent = false;
+
+    confirming = false;
+    confirmUntil = 0;
+    candidateTime = 0;
+    rejectedCount = 0;
+}
+
+void ButtonDebouncer::configure(unsigned long debounceMs, unsigned long longPressMs,
+                                unsigned long confirmMs) {
+    debounceTime = debounceMs;
+    longPressTime = longPressMs;
+    confirmTime = confirmMs;
+}
+
+// ===============================================================
+// INPUT
+// ===============================================================
+
+bool ButtonDebouncer::handleEdge(bool pressed, unsigned long edgeTime, ButtonEvent& event) {
+    // Inside bounce window - ignore, handleDeadline() checks the
+    // real level when the window ends
+    if (settling) {
+        return false;
+    }
+
+    // Press not confirmed yet: any edge (bounce or the end of a
+    // spike) restarts the stable time, handleDeadline() decides
+    if (confirming) {
+        confirmUntil = edgeTime + confirmTime;
+        return false;
+    }
+
+    // Edge back to the state we already have (e.g. a missed edge
+    // in between) - nothing changed
+    if (pressed == stablePressed) {
+        return false;
+    }
+
+    if (pressed && confirmTime > 0) {
+        confirming = true;
+        candidateTime = edgeTime;
+        confirmUntil = edgeTime + confirmTime;
+        return false;
+    }
+
+    acceptChange(pressed, edgeTime, event);
+    return true;
+}
+
+bool ButtonDebouncer::handleDeadline(bool pressedNow, unsigned long now, ButtonEvent& event) {
+    // ---------------------------------------------------------------
+    // End of confirmation: no edge for confirmTime
+    // ---------------------------------------------------------------
+    if (confirming && !isBefore(now, confirmUntil)) {
+        confirming = false;
+
+        if (!pressedNow) {
+            // Spike or glitch - never was a press
+            rejectedCount++;
+            return false;
+        }
+
+        // Pin held still: the bounce is over, no window needed
+        stablePressed = true;
+        pressTime = candidateTime;
+        longPressSent = false;
+
+        event.type = BUTTON_EVENT_PRESS;
+        event.edgeTime = candidateTime;
+        return true;
+    }
+    // ---------------------------------------------------------------
+    // End of bounce window
+    // ---------------------------------------------------------------
+    if (settling && !isBefore(now, settleUntil)) {
+        settling = false;
+
+        // Level changed again during the window (short tap or
+        // release bounce) - report it now
+        if (pressedNow != stablePressed) {
+            acceptChange(pressedNow, now, event);
+            return true;
+        }
+    }
+
+    // ---------------------------------------------------------------
+    // Long press
+    // ---------------------------------------------------------------
+    if (stablePressed && longPressTime > 0 && !longPressSent &&
+        !isBefore(now, pressTime + longPressTime)) {
+        longPressSent = true;
+        event.type = BUTTON_EVENT_LONG_PRESS;
+        event.edgeTime = pressTime + longPressTime;
+        return true;
+    }
+
+    return false;
+}
+
+// ===============================================================
+// STATE
+// ===============================================================
+
+bool ButtonDebouncer::hasDeadline() const {
+    if (settling || confirming) {
+        return true;
+    }
+
+    return (stablePressed && longPressTime > 0 && !longPressSent);
+}
+
+unsigned long ButtonDebouncer::getDeadline() const {
+    if (settling) {
+        return settleUntil;
+    }
+
+    if (confirming) {
+        return confirmUntil;
+    }
+
+    return pressTime + longPressTime;
+}
+
+bool ButtonDebouncer::isPressed() const {
+    return stablePressed;
+}
+
+bool ButtonDebouncer::isConfirming() const {
+    return confirming;
+}
+
+uint32_t ButtonDebouncer::getRejectedCount() const {
+    return rejectedCount;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+void ButtonDebouncer::acceptChange(bool pressed, unsigned long time, ButtonEvent& event) {
+    stablePressed = pressed;
+    settling = true;
+    settleUntil = time + debounceTime;
+
+    if (pressed) {
+        pressTime = time;
+        longPressSent = false;
+    }
+
+    event.type = pressed ? BUTTON_EVENT_PRESS : BUTTON_EVENT_RELEASE;
+    event.edgeTime = time;
+}
+
+bool ButtonDebouncer::isBefore(unsigned long a, unsigned long b) {
+    // Signed difference keeps working when millis() wraps around
+    return (long)(a - b) < 0;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * WHY LEADING-EDGE DEBOUNCING?
+ * The old code waited until the pin had been stable for 50ms before
+ * reporting a press. Ignoring the bounce AFTER the first edge filters
+ * contact bounce just as well with almost zero latency.
+ *
+ * It does NOT filter noise: a single spike looks exactly like the
+ * first edge of a press. That is fine for TEST (a stray buzzer
+ * test), not for SILENCE and RESET - those use confirmMs. Their
+ * press is reported confirmMs after the bounce ends (still well
+ * below the old 50ms), and the SILENCE interrupt cuts the sound at
+ * the first edge anyway (see Hardware::buttonISR()).
+ *
+ * WHAT IF AN EDGE IS MISSED?
+ * The bounce window always ends with a check of the real pin level
+ * (handleDeadline). If the ring buffer ever overflows, Hardware
+ * re-reads all pins, which goes through handleEdge() as well.
+ *
+ * ===============================================================
+ */
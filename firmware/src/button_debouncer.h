@@ -0,0 +1,192 @@
+/*
+ * ===============================================================
+ * WakeAssist - Button Debouncer (Header File)
+ * ===============================================================
+ *
+ * Turns the raw, bouncy edges of ONE push button into clean events:
+ * - PRESS:      Button went down
+ * - RELEASE:    Button came back up
+ * - LONG_PRESS: Button has been held for the long-press time
+ *
+ * WHERE DO THE EDGES COME FROM?
+ * Hardware attaches a GPIO interrupt to each button. The interrupt
+ * handler only records "pin X changed to level Y at time T" in a
+ * ring buffer. The alarm task later feeds those edges into this
+ * class (see Hardware::processButtonEdges()).
+ *
+ * HOW DEBOUNCING WORKS (leading edge):
+ * 1. The FIRST edge that changes the stable state is accepted
+ *    immediately, so a press reacts without waiting 50ms
+ * 2. For BUTTON_DEBOUNCE_MS after that, further edges are bounce
+ *    and are ignored
+ * 3. When that window ends the caller passes in the real pin level.
+ *    If it no longer matches (e.g. a very short tap), the missed
+ *    change is reported then
+ *
+ * CONFIRMED PRESS (optional, confirmMs > 0):
+ * A leading edge can't tell a press from a single spike (EMI, a
+ * loose contact). For buttons where that matters (SILENCE stops the
+ * alarm, RESET wipes the settings), a press is only reported once
+ * the pin stayed pressed for confirmMs after its LAST edge. A spike
+ * ends released and is dropped (counted in getRejectedCount()).
+ * PRESS still carries the time of the first edge.
+ *
+ * HOST TESTING:
+ * This class does no I/O and never reads the clock itself - every
+ * time is passed in by the caller. A host simulation can replay a
+ * recorded bounce pattern and measure edge-to-event latency.
+ *
+ * ===============================================================
+ */
+
+#ifndef BUTTON_DEBOUNCER_H
+#define BUTTON_DEBOUNCER_H
+
+#include <stdint.h>
+
+// ===============================================================
+// BUTTON EVENT TYPES
+// ===============================================================
+
+enum ButtonEventType {
+    BUTTON_EVENT_PRESS,          // Button pressed (debounced)
+    BUTTON_EVENT_RELEASE,        // Button released (debounced)
+    BUTTON_EVENT_LONG_PRESS      // Button held for the long-press time
+};
+
+// ===============================================================
+// BUTTON EVENT STRUCTURE
+// ===============================================================
+// Delivered to the button callback (see Hardware::setButtonCallback())
+
+struct ButtonEvent {
+    uint8_t button;              // Which button (ButtonId from hardware.h)
+    ButtonEventType type;        // What happened
+    unsigned long edgeTime;      // When it happened (ms, interrupt time
+                                 // for PRESS/RELEASE)
+};
+
+// ===============================================================
+// BUTTON DEBOUNCER CLASS
+// ===============================================================
+
+class ButtonDebouncer {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    ButtonDebouncer();
+
+    // Set timing for this button
+    // debounceMs:  Ignore edges for this long after an accepted edge
+    // longPressMs: Hold time for LONG_PRESS (0 = no long-press event)
+    // confirmMs:   Pin must stay pressed this long before PRESS
+    //              (0 = report PRESS on the first edge)
+    void configure(unsigned long debounceMs, unsigned long longPressMs,
+                   unsigned long confirmMs = 0);
+
+    // ---------------------------------------------------------------
+    // INPUT
+    // ---------------------------------------------------------------
+
+    // Feed one raw edge recorded by the interrupt handler
+    //
+    // pressed:  Pin level after the edge (true = pressed)
+    // edgeTime: Time of the edge (ms)
+    // event:    Filled in if an event is produced
+    //
+    // RETURNS: true if 'event' contains a new event
+    bool handleEdge(bool pressed, unsigned long edgeTime, ButtonEvent& event);
+
+    // Call when the deadline from getDeadline() has been reached
+    //
+    // pressedNow: Current pin level (true = pressed)
+    // now:        Current time (ms)
+    // event:      Filled in if an event is produced
+    //
+    // RETURNS: true if 'event' contains a new event
+    //          (call again until it returns false)
+    bool handleDeadline(bool pressedNow, unsigned long now, ButtonEvent& event);
+
+    // ---------------------------------------------------------------
+    // STATE
+    // ---------------------------------------------------------------
+
+    // Check if handleDeadline() needs to be called at some point
+    bool hasDeadline() const;
+
+    // Time at which handleDeadline() should be called next (ms)
+    // Only valid if hasDeadline() returns true
+    unsigned long getDeadline() const;
+
+    // Debounced state (true = pressed)
+    bool isPressed() const;
+
+    // Check if a press is waiting for confirmation (confirmMs)
+    bool isConfirming() const;
+
+    // Presses that did not hold for confirmMs (spikes, glitches)
+    uint32_t getRejectedCount() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    unsigned long debounceTime;      // Bounce window length (ms)
+    unsigned long longPressTime;     // Long-press hold time (ms, 0 = off)
+    unsigned long confirmTime;       // Stable time before PRESS (ms, 0 = off)
+
+    bool stablePressed;              // Debounced state
+    bool settling;                   // Inside bounce window?
+    unsigned long settleUntil;       // End of bounce window
+    unsigned long pressTime;         // When current press started
+    bool longPressSent;              // LONG_PRESS already reported?
+
+    bool confirming;                 // Press seen, not confirmed yet?
+    unsigned long confirmUntil;      // Pin must still be pressed then
+    unsigned long candidateTime;     // First edge of that press
+    uint32_t rejectedCount;          // Presses that were not confirmed
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Accept a state change and open a new bounce window
+    void acceptChange(bool pressed, unsigned long time, ButtonEvent& event);
+
+    // Compare two times, safe across millis() overflow
+    static bool isBefore(unsigned long a, unsigned long b);
+};
+
+#endif // BUTTON_DEBOUNCER_H
+
+/*
+ * ===============================================================
+ * HOST SIMULATION EXAMPLE:
+ * ===============================================================
+ *
+ * ButtonDebouncer button;
+ * button.configure(50, 2000);
+ * ButtonEvent event;
+ *
+ * // Bouncy press at t=1000: only the first edge produces an event
+ * button.handleEdge(true, 1000, event);    // -> PRESS, edgeTime 1000
+ * button.handleEdge(false, 1002, event);   // -> ignored (bounce)
+ * button.handleEdge(true, 1004, event);    // -> ignored (bounce)
+ *
+ * // End of bounce window: pin is still pressed, nothing new
+ * button.handleDeadline(true, 1050, event);   // -> false
+ *
+ * // Still held 2 seconds after the press
+ * button.handleDeadline(true, 3000, event);   // -> LONG_PRESS
+ *
+ * // With confirmation: a 1ms spike is not a press
+ * ButtonDebouncer silence;
+ * silence.configure(50, 2000, 20);
+ * silence.handleEdge(true, 5000, event);      // -> false (confirming)
+ * silence.handleEdge(false, 5001, event);     // -> false
+ * silence.handleDeadline(false, 5021, event); // -> false, rejected
+ *
+ * ===============================================================
+ */
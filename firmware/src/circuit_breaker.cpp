@@ -0,0 +1,167 @@
+/*
+ * ===============================================================
+ * WakeAssist - Circuit Breaker (Implementation)
+ * ===============================================================
+ *
+ * This file implements the circuit breaker declared in
+ * circuit_breaker.h
+ *
+ * NOTE: The time always comes from the caller, never from millis(),
+ * so a whole outage plays out in microseconds in the host tests
+ * (test/test_circuit_breaker).
+ *
+ * ===============================================================
+ */
+
+#include "circuit_breaker.h"
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+CircuitBreaker::CircuitBreaker() {
+    threshold = 1;
+    baseBackoff = 0;
+    maxBackoff = 0;
+    jitter = 0;
+
+    state = CIRCUIT_CLOSED;
+    consecutiveFailures = 0;
+    currentBackoff = 0;
+    openUntil = 0;
+
+    tripCount = 0;
+    fastFailCount = 0;
+}
+
+void CircuitBreaker::configure(uint8_t failureThreshold, unsigned long baseBackoffMs,
+                               unsigned long maxBackoffMs, uint8_t jitterPercent) {
+    threshold = (failureThreshold > 0) ? failureThreshold : 1;
+    baseBackoff = baseBackoffMs;
+    maxBackoff = (maxBackoffMs > baseBackoffMs) ? maxBackoffMs : baseBackoffMs;
+    jitter = (jitterPercent <= 100) ? jitterPercent : 100;
+    currentBackoff = baseBackoff;
+}
+
+// ===============================================================
+// REQUESTS
+// ===============================================================
+
+bool CircuitBreaker::allowRequest(unsigned long now) {
+    if (state != CIRCUIT_OPEN) {
+        return true;
+    }
+
+    if (isBefore(now, openUntil)) {
+        fastFailCount++;
+        return false;
+    }
+
+    // Back-off over: let one trial request through
+    state = CIRCUIT_HALF_OPEN;
+    return true;
+}
+
+void CircuitBreaker::recordSuccess() {
+    state = CIRCUIT_CLOSED;
+    consecutiveFailures = 0;
+    currentBackoff = baseBackoff;
+}
+
+void CircuitBreaker::recordFailure(unsigned long now, uint32_t randomValue) {
+    if (consecutiveFailures < UINT8_MAX) {
+        consecutiveFailures++;
+    }
+
+    if (state == CIRCUIT_HALF_OPEN) {
+        // Trial failed: wait twice as long this time
+        currentBackoff = (currentBackoff > maxBackoff / 2) ? maxBackoff : currentBackoff * 2;
+        open(now, randomValue);
+    } else if (state == CIRCUIT_CLOSED && consecutiveFailures >= threshold) {
+        currentBackoff = baseBackoff;
+        open(now, randomValue);
+    }
+}
+
+// ===============================================================
+// STATE
+// ===============================================================
+
+CircuitState CircuitBreaker::getState() const {
+    return state;
+}
+
+const char* CircuitBreaker::getStateName() const {
+    switch (state) {
+        case CIRCUIT_CLOSED:    return "closed";
+        case CIRCUIT_OPEN:      return "open";
+        case CIRCUIT_HALF_OPEN: return "half-open";
+        default:                return "unknown";
+    }
+}
+
+unsigned long CircuitBreaker::getRemainingMs(unsigned long now) const {
+    if (state != CIRCUIT_OPEN || !isBefore(now, openUntil)) {
+        return 0;
+    }
+    return openUntil - now;
+}
+
+uint8_t CircuitBreaker::getConsecutiveFailures() const {
+    return consecutiveFailures;
+}
+
+uint32_t CircuitBreaker::getTripCount() const {
+    return tripCount;
+}
+
+uint32_t CircuitBreaker::getFastFailCount() const {
+    return fastFailCount;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+void CircuitBreaker::open(unsigned long now, uint32_t randomValue) {
+    // currentBackoff +- jitter%
+    unsigned long backoff = currentBackoff;
+    unsigned long range = backoff / 100 * jitter;
+    if (range > 0) {
+        backoff = backoff - range + randomValue % (2 * range + 1);
+    }
+
+    state = CIRCUIT_OPEN;
+    openUntil = now + backoff;
+    tripCount++;
+}
+
+bool CircuitBreaker::isBefore(unsigned long a, unsigned long b) {
+    // Signed difference keeps working when millis() wraps around
+    return (long)(a - b) < 0;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. WHY NOT JUST RETRY EVERY FEW SECONDS?
+ *    When DNS or the server is gone, every attempt blocks the
+ *    network task for a full connect or response timeout. Retrying
+ *    every 5 seconds then means the task is blocked most of the
+ *    time, and notifications, WiFi checks and MQTT wait behind it.
+ *    While OPEN a request costs nothing.
+ *
+ * 2. WHY A THRESHOLD?
+ *    A single failed request is usually a dropped connection, and
+ *    the next one works. Tripping only after several failures in a
+ *    row keeps one hiccup from silencing the bot.
+ *
+ * 3. WHY ONLY ONE TRIAL REQUEST?
+ *    If the server is still down, one trial costs one timeout. The
+ *    back-off then doubles, so a long outage costs fewer and fewer
+ *    timeouts per hour.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,147 @@
+/*
+ * ===============================================================
+ * WakeAssist - Circuit Breaker (Header File)
+ * ===============================================================
+ *
+ * Stops a client from waiting on a server that is down, again and
+ * again. Works like the breaker in a fuse box:
+ *
+ *   CLOSED     Normal. Requests go through. After
+ *              failureThreshold failures in a row it trips -> OPEN
+ *   OPEN       Requests fail at once without touching the network
+ *              (fast-fail) until the back-off time is over -> HALF_OPEN
+ *   HALF_OPEN  One trial request goes through:
+ *              success -> CLOSED, failure -> OPEN again with twice
+ *              the back-off (up to maxBackoffMs)
+ *
+ * Every back-off gets a random +-jitter, so many devices that lost
+ * the server at the same moment don't all come back at once.
+ *
+ * HOST TESTING:
+ * This class does no I/O and never reads the clock or a random
+ * generator itself - both are passed in by the caller. A host test
+ * can drive it through every state with made-up times.
+ *
+ * ===============================================================
+ */
+
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <stdint.h>
+
+// ===============================================================
+// BREAKER STATES
+// ===============================================================
+
+enum CircuitState {
+    CIRCUIT_CLOSED,          // Requests allowed
+    CIRCUIT_OPEN,            // Requests fail fast
+    CIRCUIT_HALF_OPEN        // One trial request allowed
+};
+
+// ===============================================================
+// CIRCUIT BREAKER CLASS
+// ===============================================================
+
+class CircuitBreaker {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    CircuitBreaker();
+
+    // Set the limits
+    // failureThreshold: Failures in a row that trip the breaker
+    // baseBackoffMs:    First back-off after tripping
+    // maxBackoffMs:     Longest back-off
+    // jitterPercent:    Random +-% on each back-off
+    void configure(uint8_t failureThreshold, unsigned long baseBackoffMs,
+                   unsigned long maxBackoffMs, uint8_t jitterPercent);
+
+    // ---------------------------------------------------------------
+    // REQUESTS
+    // ---------------------------------------------------------------
+
+    // Ask before every request
+    // now: Current time (ms)
+    // RETURNS: true if the request may go out, false = fail fast
+    bool allowRequest(unsigned long now);
+
+    // Report the result of a request that went out
+    void recordSuccess();
+
+    // now:         Current time (ms)
+    // randomValue: Any random number (for the jitter)
+    void recordFailure(unsigned long now, uint32_t randomValue);
+
+    // ---------------------------------------------------------------
+    // STATE
+    // ---------------------------------------------------------------
+
+    CircuitState getState() const;
+
+    // "closed", "open" or "half-open"
+    const char* getStateName() const;
+
+    // Time until a trial request is allowed (0 unless OPEN)
+    unsigned long getRemainingMs(unsigned long now) const;
+
+    // Statistics
+    uint8_t getConsecutiveFailures() const;
+    uint32_t getTripCount() const;          // Times it went OPEN
+    uint32_t getFastFailCount() const;      // Requests refused while OPEN
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    // Limits (see configure())
+    uint8_t threshold;
+    unsigned long baseBackoff;
+    unsigned long maxBackoff;
+    uint8_t jitter;
+
+    CircuitState state;
+    uint8_t consecutiveFailures;
+    unsigned long currentBackoff;     // Back-off without jitter
+    unsigned long openUntil;          // End of the OPEN time
+
+    uint32_t tripCount;
+    uint32_t fastFailCount;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Go OPEN for currentBackoff (+-jitter)
+    void open(unsigned long now, uint32_t randomValue);
+
+    // Compare two times, safe across millis() overflow
+    static bool isBefore(unsigned long a, unsigned long b);
+};
+
+#endif // CIRCUIT_BREAKER_H
+
+/*
+ * ===============================================================
+ * HOST SIMULATION EXAMPLE:
+ * ===============================================================
+ *
+ * CircuitBreaker breaker;
+ * breaker.configure(3, 5000, 120000, 0);   // No jitter: exact times
+ *
+ * // Three failures in a row trip it
+ * breaker.recordFailure(1000, 0);
+ * breaker.recordFailure(2000, 0);
+ * breaker.recordFailure(3000, 0);          // -> OPEN until 8000
+ *
+ * breaker.allowRequest(4000);              // -> false (fast-fail)
+ * breaker.allowRequest(8000);              // -> true, HALF_OPEN
+ * breaker.recordFailure(9000, 0);          // -> OPEN until 19000 (10s)
+ * breaker.allowRequest(19000);             // -> true, HALF_OPEN
+ * breaker.recordSuccess();                 // -> CLOSED, back-off reset
+ *
+ * ===============================================================
+ */
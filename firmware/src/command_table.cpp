@@ -0,0 +1,280 @@
+/*
+ * ===============================================================
+ * WakeAssist - Command Table Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the runtime half of command_table.h: the
+ * hash of a received command word and the word splitter.
+ *
+ * KEY CONCEPTS:
+ * - Nothing here allocates memory or copies text
+ * - commandHash(text, length) must give exactly the same value as
+ *   the constexpr commandHash(name) used for the table
+ *
+ * ===============================================================
+ */
+
+#include "command_table.h"
+
+// ===============================================================
+// COMMAND NAME HASH
+// ===============================================================
+
+uint32_t commandHash(const char* text, size_t length) {
+    uint32_t hash = COMMAND_HASH_OFFSET;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ commandFoldCase(text[i])) * COMMAND_HASH_PRIME;
+    }
+    return hash;
+}
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+CommandArgs::CommandArgs() {
+    command = "";
+    commandLength = 0;
+    commandHashValue = commandHash("");
+    botName = "";
+    botNameLength = 0;
+    argCount = 0;
+}
+
+// ===============================================================
+// PARSING
+// ===============================================================
+
+bool CommandArgs::parse(const char* text) {
+    *this = CommandArgs();
+
+    if (text[0] != '/') {
+        return false;
+    }
+
+    // Command word: up to the first separator or '@'
+    const char* p = text;
+    command = p;
+    while (*p != '\0' && *p != '@' && !isSeparator(*p)) {
+        p++;
+    }
+    commandLength = p - command;
+    commandHashValue = commandHash(command, commandLength);
+
+    // Optional "@botname" glued to the command
+    if (*p == '@') {
+        p++;
+        botName = p;
+        while (*p != '\0' && !isSeparator(*p)) {
+            p++;
+        }
+        botNameLength = p - botName;
+    }
+
+    // Arguments
+    while (*p != '\0' && argCount < TELEGRAM_COMMAND_MAX_ARGS) {
+        while (isSeparator(*p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+
+        args[argCount] = p;
+        while (*p != '\0' && !isSeparator(*p)) {
+            p++;
+        }
+        argLengths[argCount] = p - args[argCount];
+        argCount++;
+    }
+
+    return true;
+}
+
+// ===============================================================
+// COMMAND WORD
+// ===============================================================
+
+bool CommandArgs::isCommand(const char* name) const {
+    return wordEquals(command, commandLength, name);
+}
+
+bool CommandArgs::isForBot(const char* ourName) const {
+    if (botNameLength == 0 || ourName[0] == '\0') {
+        return true;
+    }
+    return wordEquals(botName, botNameLength, ourName);
+}
+
+// ===============================================================
+// ARGUMENTS
+// ===============================================================
+
+bool CommandArgs::is(int index, const char* word) const {
+    if (index < 0 || index >= argCount) {
+        return false;
+    }
+    return wordEquals(args[index], argLengths[index], word);
+}
+
+bool CommandArgs::getUInt(int index, uint32_t& value,
+                          uint32_t min, uint32_t max) const {
+    if (index < 0 || index >= argCount) {
+        return false;
+    }
+
+    uint32_t result = 0;
+    for (size_t i = 0; i < argLengths[index]; i++) {
+        char c = args[index][i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        uint32_t digit = c - '0';
+        if (result > (UINT32_MAX - digit) / 10) {
+            return false;  // Too big for 32 bits
+        }
+        result = result * 10 + digit;
+    }
+
+    if (result < min || result > max) {
+        return false;
+    }
+
+    value = result;
+    return true;
+}
+
+bool CommandArgs::getDuration(int index, unsigned long& valueMs,
+                              unsigned long defaultUnitMs, unsigned long maxMs) const {
+    if (index < 0 || index >= argCount) {
+        return false;
+    }
+
+    const char* word = args[index];
+    size_t length = argLengths[index];
+
+    // Unit suffix
+    unsigned long unitMs = defaultUnitMs;
+    switch (word[length - 1]) {
+        case 's': case 'S': unitMs = 1000UL;    length--; break;
+        case 'm': case 'M': unitMs = 60000UL;   length--; break;
+        case 'h': case 'H': unitMs = 3600000UL; length--; break;
+        default: break;
+    }
+
+    if (length == 0) {
+        return false;  // Only a unit, no number
+    }
+
+    unsigned long number = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (word[i] < '0' || word[i] > '9') {
+            return false;
+        }
+        number = number * 10 + (word[i] - '0');
+        if (number > maxMs / unitMs) {
+            return false;  // Too long (also keeps the multiply from overflowing)
+        }
+    }
+
+    valueMs = number * unitMs;
+    return true;
+}
+
+// ===============================================================
+// TABLE LOOKUP
+// ===============================================================
+
+const TelegramCommand* findCommand(const TelegramCommand* table, size_t count,
+                                   const CommandArgs& args) {
+    uint32_t hash = args.getCommandHash();
+
+    for (size_t i = 0; i < count; i++) {
+        // Hash first (cheap), text only for the one that matches
+        if (table[i].hash == hash && args.isCommand(table[i].name)) {
+            return &table[i];
+        }
+    }
+    return nullptr;
+}
+
+DispatchResult dispatchCommand(const TelegramCommand* table, size_t count,
+                               const TelegramMessage& message, const char* botName) {
+    // Only commands (starting with '/') are handled
+    CommandArgs args;
+    if (!args.parse(message.text)) {
+        return DISPATCH_NOT_COMMAND;
+    }
+
+    // "/wake@OtherBot" in a group is for another bot
+    if (!args.isForBot(botName)) {
+        DEBUG_PRINTF("[Command] For @%.*s, ignored\n",
+                    (int)args.getBotNameLength(), args.getBotName());
+        return DISPATCH_OTHER_BOT;
+    }
+
+    const TelegramCommand* entry = findCommand(table, count, args);
+    if (entry == nullptr) {
+        DEBUG_PRINTF("[Command] Unknown: %.*s\n",
+                    (int)args.getCommandLength(), args.getCommand());
+        return DISPATCH_UNKNOWN;
+    }
+
+    DEBUG_PRINTF("[Command] Running handler for: %s\n", entry->name);
+    entry->handler(message, args);
+    return DISPATCH_RAN;
+}
+
+// ===============================================================
+// MESSAGES
+// ===============================================================
+
+TelegramMessage messageFromUpdate(const TelegramUpdate& update, MessageSource source) {
+    TelegramMessage message;
+    message.chatId = update.chatId;
+    message.messageId = update.messageId;
+    message.text = update.text;
+    message.username = (update.username[0] != '\0') ? update.username : "unknown";
+    message.timestamp = update.date;
+    message.textTruncated = update.truncated;
+    message.source = source;
+    return message;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+bool CommandArgs::wordEquals(const char* word, size_t length, const char* other) {
+    return strlen(other) == length && strncasecmp(word, other, length) == 0;
+}
+
+bool CommandArgs::isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. WHY A HASH AND NOT A switch OVER STRINGS?
+ *    C++ can't switch over strings. The old code compared the
+ *    message against every registered command with a string
+ *    compare. Now the message is hashed once and each table row
+ *    costs one 32-bit compare; the text is compared only for the
+ *    row that matched. The table rows are calculated by the
+ *    compiler, so nothing is built at startup.
+ *
+ * 2. WHY NOT A HASH MAP?
+ *    With a dozen commands, walking a flash array of 32-bit hashes
+ *    is a few dozen instructions - less than a hash map lookup would
+ *    cost, and it needs no RAM and no size limit.
+ *
+ * 3. WHY POINTERS INTO THE TEXT?
+ *    Before, every message made a String copy of its command word
+ *    (heap). The words of a CommandArgs point into the message slot
+ *    of TelegramBot, which stays valid while the handler runs.
+ *
+ * ===============================================================
+ */
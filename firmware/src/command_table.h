@@ -0,0 +1,292 @@
+/*
+ * ===============================================================
+ * WakeAssist - Command Table Module (Header File)
+ * ===============================================================
+ *
+ * This module describes the Telegram commands the bot understands:
+ * - TelegramCommand: one row of the command table (name, handler,
+ *   help text). The table itself is a constant array, so it lives
+ *   in flash and has no size limit
+ * - commandHash(): case-insensitive hash of a command name. For the
+ *   names in the table it is calculated by the compiler
+ * - CommandArgs: splits "/cmd@botname arg1 arg2" into words without
+ *   copying anything (the words point into the message text)
+ * - TelegramMessage: what a handler gets - a view of the update slot
+ *   (or the MQTT buffer) the command arrived in, not a copy
+ *
+ * HOW A COMMAND IS FOUND:
+ * 1. The message is split into words (CommandArgs::parse)
+ * 2. The command word is hashed once
+ * 3. The table is searched by comparing 32-bit hashes
+ * 4. Only the entry with the same hash is compared as text
+ *    (a different command that happens to have the same hash must
+ *    not run)
+ *
+ * ===============================================================
+ */
+
+#ifndef COMMAND_TABLE_H
+#define COMMAND_TABLE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "update_parser.h"
+
+// ===============================================================
+// MESSAGE SOURCE
+// ===============================================================
+// Commands also arrive over MQTT (see mqtt_control.h). Handlers use
+// the source to send their answer back the same way
+
+enum MessageSource {
+    MESSAGE_FROM_TELEGRAM,   // getUpdates
+    MESSAGE_FROM_BUTTON,     // getUpdates, inline button (callback_query)
+    MESSAGE_FROM_MQTT        // MQTT command topic
+};
+
+// ===============================================================
+// TELEGRAM MESSAGE
+// ===============================================================
+// A received command as the handlers see it. The texts are not
+// copied: they point into the getUpdates slot (or the MQTT buffer)
+// the command arrived in, so a message is only valid while its
+// handler runs. Keep a copy of anything needed later
+
+struct TelegramMessage {
+    int64_t chatId;          // Unique chat ID (user identifier)
+    int32_t messageId;       // Message ID
+    const char* text;        // Message text content
+    const char* username;    // Sender's username
+    unsigned long timestamp; // When message was received (Unix timestamp)
+    bool textTruncated;      // text was cut off
+    MessageSource source;    // Where the message came from
+};
+
+// View of a getUpdates slot as a message (no copy)
+// An update without a username gets "unknown"
+TelegramMessage messageFromUpdate(const TelegramUpdate& update, MessageSource source);
+
+// ===============================================================
+// COMMAND NAME HASH
+// ===============================================================
+// 32-bit FNV-1a over the lower-cased name ("/WAKE" == "/wake").
+// Written as a single-expression recursion so the compiler can
+// calculate it for string constants (C++11 constexpr rules).
+
+#define COMMAND_HASH_OFFSET   2166136261UL
+#define COMMAND_HASH_PRIME    16777619UL
+
+// 'A'..'Z' -> 'a'..'z', everything else unchanged
+constexpr uint8_t commandFoldCase(char c) {
+    return (c >= 'A' && c <= 'Z') ? (uint8_t)(c - 'A' + 'a') : (uint8_t)c;
+}
+
+// Hash the rest of a zero-terminated name (helper for commandHash)
+constexpr uint32_t commandHashFrom(const char* name, uint32_t hash) {
+    return (*name == '\0')
+        ? hash
+        : commandHashFrom(name + 1,
+                          (uint32_t)((hash ^ commandFoldCase(*name)) * COMMAND_HASH_PRIME));
+}
+
+// Hash a zero-terminated name (compile time for string constants)
+constexpr uint32_t commandHash(const char* name) {
+    return commandHashFrom(name, COMMAND_HASH_OFFSET);
+}
+
+// Hash the first length characters of text (same result as above)
+// Used at runtime for the command word of a message
+uint32_t commandHash(const char* text, size_t length);
+
+// ===============================================================
+// COMMAND ARGUMENTS
+// ===============================================================
+// A message split into words. Nothing is copied: every word is a
+// pointer into the message text plus a length, so a CommandArgs is
+// only valid as long as the message it was parsed from.
+//
+// "/wake@WakeAssistBot 10m now"
+//   command = "/wake", botName = "WakeAssistBot", args = "10m", "now"
+
+class CommandArgs {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    CommandArgs();
+
+    // ---------------------------------------------------------------
+    // PARSING
+    // ---------------------------------------------------------------
+
+    // Split a message text into command, bot name and arguments
+    // Words are separated by spaces, tabs or line breaks. Words after
+    // the first TELEGRAM_COMMAND_MAX_ARGS are ignored
+    //
+    // RETURNS: false if text is not a command (doesn't start with '/')
+    bool parse(const char* text);
+
+    // ---------------------------------------------------------------
+    // COMMAND WORD
+    // ---------------------------------------------------------------
+
+    // Command name including the '/', not zero-terminated
+    const char* getCommand() const { return command; }
+    size_t getCommandLength() const { return commandLength; }
+
+    // Hash of the command name (see commandHash())
+    uint32_t getCommandHash() const { return commandHashValue; }
+
+    // Check the command name (case-insensitive)
+    bool isCommand(const char* name) const;
+
+    // Bot name after '@' ("/wake@MyBot"), length 0 if none
+    // Telegram adds it when a command is picked from the menu in a
+    // group, so the right bot answers
+    const char* getBotName() const { return botName; }
+    size_t getBotNameLength() const { return botNameLength; }
+
+    // Check if the command was meant for this bot
+    // (true if it has no "@botname" or ours is not known yet)
+    bool isForBot(const char* ourName) const;
+
+    // ---------------------------------------------------------------
+    // ARGUMENTS
+    // ---------------------------------------------------------------
+
+    // Number of arguments after the command
+    int count() const { return argCount; }
+
+    // Check argument index against a word (case-insensitive)
+    // RETURNS: false if the argument is missing or different
+    bool is(int index, const char* word) const;
+
+    // Read argument index as a whole number
+    // RETURNS: false if missing, not a number or outside min..max
+    //          (value is unchanged then)
+    bool getUInt(int index, uint32_t& value,
+                 uint32_t min = 0, uint32_t max = UINT32_MAX) const;
+
+    // Read argument index as a duration: "90s", "10m", "2h", or a
+    // plain number in defaultUnitMs ("10" with 60000 = 10 minutes)
+    // RETURNS: false if missing, malformed or longer than maxMs
+    //          (value is unchanged then)
+    bool getDuration(int index, unsigned long& valueMs,
+                     unsigned long defaultUnitMs, unsigned long maxMs) const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    const char* command;
+    uint8_t commandLength;
+    uint32_t commandHashValue;
+
+    const char* botName;
+    uint8_t botNameLength;
+
+    // One word = start pointer + length
+    const char* args[TELEGRAM_COMMAND_MAX_ARGS];
+    uint8_t argLengths[TELEGRAM_COMMAND_MAX_ARGS];
+    int argCount;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Case-insensitive compare of a word with a zero-terminated string
+    static bool wordEquals(const char* word, size_t length, const char* other);
+
+    static bool isSeparator(char c);
+};
+
+// ===============================================================
+// COMMAND TABLE ENTRY
+// ===============================================================
+
+// Runs when the command is received (on the network task)
+// message: The whole message, args: its words
+typedef void (*CommandHandler)(const TelegramMessage& message, const CommandArgs& args);
+
+struct TelegramCommand {
+    const char* name;             // "/wake" (with the '/')
+    uint32_t hash;                // commandHash(name)
+    CommandHandler handler;       // Function to run
+    const char* usage;            // Arguments for the help text, "" if none
+    const char* description;      // One line for the help text
+};
+
+// One table row, with the hash calculated by the compiler:
+//   TELEGRAM_COMMAND("/wake", "[delay]", "Start alarm", handleWakeCommand)
+#define TELEGRAM_COMMAND(name, usage, description, handler) \
+    { name, commandHash(name), handler, usage, description }
+
+// Find the table entry for a parsed command
+// RETURNS: Entry, or nullptr if the command is unknown
+const TelegramCommand* findCommand(const TelegramCommand* table, size_t count,
+                                   const CommandArgs& args);
+
+// What dispatchCommand() did with a message
+enum DispatchResult {
+    DISPATCH_RAN,            // The command's handler ran
+    DISPATCH_NOT_COMMAND,    // Plain text (no '/'), ignored
+    DISPATCH_OTHER_BOT,      // "/wake@OtherBot", ignored
+    DISPATCH_UNKNOWN         // No such command (caller tells the user)
+};
+
+// Split a message, find its command and run the handler
+// Used by every command channel (Telegram, MQTT)
+// botName: Our bot's username ("" = accept any "@botname")
+DispatchResult dispatchCommand(const TelegramCommand* table, size_t count,
+                               const TelegramMessage& message, const char* botName);
+
+// ---------------------------------------------------------------
+// COMPILE-TIME CHECK
+// ---------------------------------------------------------------
+// Two rows with the same hash would make one of them unreachable
+// (same name twice, or a rare hash collision). Check with:
+//   static_assert(commandTableIsUnique(TABLE, count), "...");
+
+// Compare entry i with entries j.. and every later pair (helper)
+constexpr bool commandTableIsUniqueFrom(const TelegramCommand* table, size_t count,
+                                        size_t i, size_t j) {
+    return (i + 1 >= count)
+        ? true
+        : (j >= count)
+            ? commandTableIsUniqueFrom(table, count, i + 1, i + 2)
+            : (table[i].hash != table[j].hash) &&
+              commandTableIsUniqueFrom(table, count, i, j + 1);
+}
+
+constexpr bool commandTableIsUnique(const TelegramCommand* table, size_t count) {
+    return commandTableIsUniqueFrom(table, count, 0, 1);
+}
+
+#endif // COMMAND_TABLE_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * void handleWakeCommand(const TelegramMessage& msg, const CommandArgs& args) {
+ *     unsigned long delayMs = 0;
+ *     if (args.count() > 0 &&
+ *         !args.getDuration(0, delayMs, 60000, WAKE_DELAY_MAX_MS)) {
+ *         telegramBot.sendMessage("Usage: /wake [delay]");
+ *         return;
+ *     }
+ *     ...
+ * }
+ *
+ * static constexpr TelegramCommand COMMANDS[] = {
+ *     TELEGRAM_COMMAND("/wake", "[delay]", "Start alarm", handleWakeCommand),
+ *     TELEGRAM_COMMAND("/stop", "", "Stop alarm", handleStopCommand),
+ * };
+ * static_assert(commandTableIsUnique(COMMANDS, 2), "Duplicate command");
+ *
+ * telegramBot.setCommandTable(COMMANDS, 2);
+ *
+ * ===============================================================
+ */
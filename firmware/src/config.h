@@ -86,9 +86,29 @@
 // Prevents multiple triggers from a single press
 #define BUTTON_DEBOUNCE_MS  50
 
+// SILENCE and RESET must stay pressed this long (after the last
+// bounce) to count, so a noise spike can't stop an alarm or start
+// a factory reset (milliseconds)
+#define BUTTON_CONFIRM_MS   20
+
 // How long to hold RESET button for factory reset (milliseconds)
 #define RESET_HOLD_TIME_MS  10000   // 10 seconds
 
+// LEDs blink this long after a factory reset, then the device restarts
+#define FACTORY_RESET_REBOOT_MS  3000   // 3 seconds
+
+// The network task tells the alarm task the settings are cleared;
+// if the command queue stays full this long it restarts by itself
+#define FACTORY_RESET_DONE_TRIES     100    // Attempts...
+#define FACTORY_RESET_DONE_RETRY_MS  10     // ...this far apart (1 second)
+
+// How long to hold TEST/SILENCE for a long-press event (milliseconds)
+#define BUTTON_LONG_PRESS_MS  2000  // 2 seconds
+
+// Button edges the interrupt can queue before the alarm task runs
+// Each press/release with contact bounce can produce several edges
+#define BUTTON_EDGE_QUEUE_SIZE  32
+
 // Button state (with internal pullup, pressed = LOW)
 #define BUTTON_PRESSED      LOW
 #define BUTTON_RELEASED     HIGH
@@ -118,6 +138,18 @@
 #define ALARM_TRIGGERED_DELAY_MS    3000    // Delay before alarm starts: 3 seconds
                                             // Gives user time to prepare after /wake
 
+// ===============================================================
+// BUZZER TEST TIMING (/test)
+// ===============================================================
+// Each step of the buzzer test sequence (total ~11.5 seconds)
+
+#define TEST_START_DELAY_MS         1000    // After "Testing buzzers..."
+#define TEST_COUNTDOWN_MS           3000    // After each "in 3... 2... 1..."
+#define TEST_SMALL_BUZZER_MS        1000    // Small buzzer on
+#define TEST_SMALL_PAUSE_MS         2000    // Pause after small buzzer
+#define TEST_LARGE_BUZZER_MS        500     // Large buzzer on (shorter, it's loud)
+#define TEST_LARGE_PAUSE_MS         1000    // Pause before "Test complete"
+
 // ===============================================================
 // BUZZER PWM CONFIGURATION
 // ===============================================================
@@ -148,6 +180,20 @@
 // How long to wait for connection before considering it failed
 #define WIFI_CONNECT_TIMEOUT_MS     10000   // 10 seconds
 
+// Fast connect timeout (milliseconds)
+// Connecting straight to the last access point (known BSSID and
+// channel, no scan, cached IP lease) normally takes a few hundred
+// milliseconds. If it takes longer than this, fall back to a normal
+// connect with a full scan
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 3000   // 3 seconds
+
+// DHCP lease time used if the router's answer can't be read (seconds)
+// The fast connect reuses a lease only for half of it (see wifi_manager.cpp)
+#define WIFI_LEASE_DEFAULT_S        3600    // 1 hour
+
+// How often to check WiFi.status() while connecting (milliseconds)
+#define WIFI_CONNECT_POLL_MS        20
+
 // WiFi reconnection attempts before falling back to AP mode
 #define WIFI_MAX_RECONNECT_ATTEMPTS 3
 
@@ -166,8 +212,61 @@
 // ===============================================================
 
 // How often to poll Telegram API for new messages (milliseconds)
+// Used without long polling (while active), and to retry after an error
 #define TELEGRAM_POLL_INTERVAL_MS   5000    // 5 seconds (don't make this too fast!)
 
+// Long polling: getUpdates waits on Telegram's side until a message
+// arrives (or this many seconds pass), so commands are delivered
+// within one round-trip instead of up to TELEGRAM_POLL_INTERVAL_MS.
+// 0 = classic polling every TELEGRAM_POLL_INTERVAL_MS
+#define TELEGRAM_LONG_POLL_TIMEOUT_S 50
+
+// While a long poll waits, check this often whether alarm
+// notifications are queued (the poll is cut short to send them)
+#define TELEGRAM_LONG_POLL_CHECK_MS 20
+
+// Adaptive poll cadence (see poll_policy.h)
+// The gap between polls follows the alarm: none while it rings,
+// growing while nothing happens for hours
+#define TELEGRAM_POLL_MIN_INTERVAL_MS    1000      // Never poll faster than this
+#define TELEGRAM_POLL_ALARM_INTERVAL_MS  1000      // Alarm running (no long polling)
+#define TELEGRAM_POLL_IDLE_AFTER_MS      900000    // 15 min without command/alarm = idle
+#define TELEGRAM_POLL_BACKOFF_STEP_MS    3600000   // Idle gap doubles every hour
+#define TELEGRAM_POLL_IDLE_MIN_MS        5000      // First idle gap
+#define TELEGRAM_POLL_IDLE_MAX_MS        60000     // Longest idle gap
+#define TELEGRAM_POLL_JITTER_PERCENT     20        // Random +-% on idle gaps
+
+// Telegram Bot API server. Only change this to talk to a local
+// stand-in server instead of Telegram (e.g. "192.168.1.10", 8081,
+// false for tools/mock_telegram_api.py). Plain HTTP sends the bot
+// token unencrypted. Can also be changed at runtime with setApiServer()
+#define TELEGRAM_API_HOST           "api.telegram.org"
+#define TELEGRAM_API_PORT           443
+#define TELEGRAM_API_TLS            true    // false = plain HTTP
+
+// Longest API host name and bot token the transport keeps (bytes,
+// including the terminating zero; tokens are ~46 characters)
+#define TELEGRAM_API_HOST_MAX_BYTES 64
+#define TELEGRAM_TOKEN_MAX_BYTES    64
+
+// Time server for the real time (command latency, see poll_policy.h,
+// and old commands, see below)
+#define NTP_SERVER                  "pool.ntp.org"
+
+// Before this time (Unix seconds, 2020-09) the clock is not set yet
+#define NTP_VALID_AFTER             1600000000UL
+
+// Commands sent while the device was off or restarting are still
+// run after boot (the getUpdates position is kept), unless they are
+// older than this (seconds). Only checked until the backlog from
+// before boot is read (see stale_filter.h); /stop always runs.
+// Without a set clock the age is relative to the newest message
+#define TELEGRAM_STALE_COMMAND_S    120     // 2 minutes
+
+// The getUpdates position is kept in RTC memory (restarts) and
+// written to flash at most this often (power loss)
+#define TELEGRAM_OFFSET_SAVE_MS     60000   // 1 minute
+
 // Telegram API timeout (milliseconds)
 // How long to wait for Telegram API to respond
 #define TELEGRAM_API_TIMEOUT_MS     10000   // 10 seconds
@@ -175,9 +274,112 @@
 // HTTP request timeout for Telegram
 #define TELEGRAM_HTTP_TIMEOUT_MS    10000   // 10 seconds
 
+// Keep-alive: reuse the HTTPS connection if it was used within this
+// time (milliseconds). Saves a TLS handshake on almost every request.
+// Servers drop idle connections after a while, so older connections
+// are closed and opened fresh instead of risking a failed request
+#define TELEGRAM_KEEPALIVE_IDLE_MS  30000   // 30 seconds
+
+// Circuit breaker (see circuit_breaker.h): after this many failed
+// requests in a row, requests fail at once for a back-off time that
+// doubles with every failed retry
+#define TELEGRAM_BREAKER_FAILURES        3
+#define TELEGRAM_BREAKER_BASE_MS         5000      // First back-off
+#define TELEGRAM_BREAKER_MAX_MS          120000    // Longest back-off (2 minutes)
+#define TELEGRAM_BREAKER_JITTER_PERCENT  25        // Random +-% on each back-off
+
+// Telegram's send limit (see token_bucket.h): about one message per
+// second in a private chat. A burst of TELEGRAM_SEND_BURST messages goes
+// out at once, then one per TELEGRAM_SEND_REFILL_MS; the rest waits
+#define TELEGRAM_SEND_BURST         3
+#define TELEGRAM_SEND_REFILL_MS     1000    // 1 second
+
+// Longest "retry_after" of a 429 answer we follow (seconds)
+#define TELEGRAM_RETRY_AFTER_MAX_S  300     // 5 minutes
+
+// Largest HTTP response body we accept (bytes)
+#define TELEGRAM_MAX_RESPONSE_BYTES 16384
+
+// Fixed buffers of the streaming HTTP reader (see http_response.h)
+// Network data is read in blocks of this size (bytes)
+#define HTTP_READ_BUFFER_BYTES      256
+
+// Status line and header lines longer than this are cut off (bytes)
+// Only the start of a header matters to us
+#define HTTP_LINE_BUFFER_BYTES      128
+
+// Request line + headers are built in a stack buffer this big (bytes)
+#define TELEGRAM_REQUEST_HEAD_BYTES 384
+
+// getUpdates answers are parsed straight into fixed slots (see
+// update_parser.h). Longer texts are cut off (on a UTF-8 boundary)
+#define TELEGRAM_UPDATE_SLOTS       10      // Updates per getUpdates
+#define TELEGRAM_TEXT_MAX_BYTES     256     // Message text / button data
+#define TELEGRAM_USERNAME_MAX_BYTES 33      // Usernames are max 32 chars
+#define TELEGRAM_CALLBACK_ID_BYTES  32      // callback_query id
+#define TELEGRAM_ERROR_TEXT_BYTES   96      // API error description
+
+// Command that is never skipped as stale (see stale_filter.h)
+#define TELEGRAM_PRIORITY_COMMAND   "/stop"
+
+// Words after a command that are kept as arguments (see command_table.h)
+#define TELEGRAM_COMMAND_MAX_ARGS   4
+
+// ===============================================================
+// TLS CONFIGURATION
+// ===============================================================
+// HTTPS client with session resumption (see tls_client.h)
+
+// Give up on a TLS handshake (or a stuck write) after this long
+#define TLS_HANDSHAKE_TIMEOUT_MS    10000   // 10 seconds
+
+// RTC memory reserved for the TLS session, so a resumed handshake
+// also works after a software or watchdog restart (bytes)
+// 0 = keep the session in RAM only
+#define TLS_SESSION_RTC_BYTES       2048
+
 // Rate limiting: minimum time between /wake commands (milliseconds)
 #define TELEGRAM_WAKE_COOLDOWN_MS   300000  // 5 minutes (prevents spam)
 
+// "/wake 20" starts the alarm later. A plain number is minutes,
+// "90s", "20m", "2h" are also understood
+#define WAKE_DELAY_DEFAULT_UNIT_MS  60000       // Plain number = minutes
+#define WAKE_DELAY_MAX_MS           43200000    // 12 hours
+
+// ===============================================================
+// MQTT CONFIGURATION (optional)
+// ===============================================================
+// Second command channel for a broker on your own network (see
+// mqtt_control.h). Commands arrive within milliseconds instead of
+// waiting for the next Telegram poll. Telegram keeps working as well.
+
+// Broker address, e.g. "192.168.1.10" or "mqtt.local"
+// "" = MQTT off
+#define MQTT_BROKER_HOST            ""
+#define MQTT_BROKER_PORT            1883
+#define MQTT_USERNAME               ""      // "" = no login
+#define MQTT_PASSWORD               ""
+
+// Topics are MQTT_TOPIC_PREFIX/<device id>/cmd, /state, /online, /reply
+#define MQTT_TOPIC_PREFIX           "wakeassist"
+#define MQTT_TOPIC_MAX_BYTES        64
+
+// Keep-alive (seconds). Must be longer than a Telegram long poll:
+// MQTT is not serviced while the network task waits in one
+#define MQTT_KEEPALIVE_S            90
+
+// Give up on a broker that doesn't answer (seconds)
+#define MQTT_SOCKET_TIMEOUT_S       2
+
+// How often the network task checks for MQTT commands (milliseconds)
+#define MQTT_LOOP_INTERVAL_MS       20
+
+// Wait between connection attempts to the broker (milliseconds)
+#define MQTT_RECONNECT_MS           5000
+
+// Largest MQTT packet (bytes). The /poll reply needs ~1.5k
+#define MQTT_BUFFER_BYTES           2048
+
 // ===============================================================
 // HARDWARE VERIFICATION
 // ===============================================================
@@ -200,8 +402,11 @@
 // Individual storage keys (max 15 characters each)
 #define KEY_WIFI_SSID              "wifi_ssid"
 #define KEY_WIFI_PASSWORD          "wifi_pass"
+#define KEY_WIFI_FAST_CONNECT      "wifi_fast"     // BSSID, channel, IP lease
 #define KEY_TELEGRAM_TOKEN         "tg_token"
 #define KEY_TELEGRAM_USER_ID       "tg_user_id"
+#define KEY_TELEGRAM_BOT_NAME      "tg_bot_name"   // Cached getMe username
+#define KEY_TELEGRAM_OFFSET        "tg_offset"     // Last processed update
 #define KEY_LAST_TEST_TIME         "last_test"
 #define KEY_SETUP_COMPLETE         "setup_done"
 
@@ -249,10 +454,88 @@
 // Automatically restart ESP32 if it freezes for this long
 #define WATCHDOG_TIMEOUT_MS         60000   // 60 seconds
 
+// How often the stall watchdog checks for stuck code (milliseconds)
+#define WATCHDOG_CHECK_INTERVAL_MS  1000    // 1 second
+
+// How long each subsystem may be busy before it counts as a stall
+// (milliseconds, see stall_watchdog.h)
+#define WATCHDOG_TELEGRAM_BUDGET_MS (TELEGRAM_API_TIMEOUT_MS + 5000)
+#define WATCHDOG_WIFI_BUDGET_MS     (WIFI_FAST_CONNECT_TIMEOUT_MS + WIFI_CONNECT_TIMEOUT_MS + 5000)
+#define WATCHDOG_ALARM_BUDGET_MS    1000    // One alarm loop pass
+
+// Maximum length of a call site name in a stall record
+#define WATCHDOG_SITE_LENGTH        24
+
 // Status report interval (milliseconds)
 // How often to print system status to serial monitor
 #define STATUS_REPORT_INTERVAL_MS   60000   // 1 minute
 
+// ===============================================================
+// TASK CONFIGURATION (DUAL-CORE)
+// ===============================================================
+// The ESP32 has two CPU cores. We split the firmware into two tasks:
+// - Network task (core 0): WiFi, Telegram polling and sending
+// - Alarm task (core 1): buttons, LEDs, buzzers, alarm state machine
+// A slow Telegram request can then never freeze the SILENCE button.
+
+// Which core each task runs on
+#define NETWORK_TASK_CORE           0       // Same core as the WiFi stack
+#define ALARM_TASK_CORE             1       // Real-time alarm and IO
+
+// Task stack sizes (bytes) - TLS needs a big stack
+#define NETWORK_TASK_STACK_SIZE     8192
+#define ALARM_TASK_STACK_SIZE       4096
+
+// Task priorities (higher number = more important)
+#define NETWORK_TASK_PRIORITY       1
+#define ALARM_TASK_PRIORITY         2
+
+// Queue sizes between the two tasks
+#define COMMAND_QUEUE_SIZE          8       // Network -> alarm commands
+#define NOTIFICATION_QUEUE_SIZE     8       // Alarm -> network messages
+#define NOTIFICATION_MAX_LENGTH     128     // Max bytes per queued message
+
+// Outgoing notifications waiting on the network task (see
+// notification_outbox.h). When full, the oldest normal message goes
+#define NOTIFICATION_OUTBOX_SIZE    16
+
+// Waiting notifications are joined into one Telegram message of at
+// most this many bytes (Telegram allows 4096)
+#define NOTIFICATION_BATCH_MAX_BYTES 1024
+
+// Alarm live status (see live_status.h): one message per alarm,
+// edited at most every LIVE_STATUS_MIN_EDIT_MS
+#define LIVE_STATUS_MIN_EDIT_MS     2000    // 2 seconds
+#define LIVE_STATUS_MAX_BYTES       512     // Oldest lines go when full
+
+// Retry sending after Telegram was offline or a send failed
+#define NOTIFICATION_RETRY_MS       5000    // 5 seconds
+
+// ===============================================================
+// SCHEDULER CONFIGURATION
+// ===============================================================
+// Each task sleeps until its next deadline instead of waking up
+// every few milliseconds (see scheduler.h)
+
+// Maximum number of timers per scheduler
+#define SCHEDULER_MAX_TIMERS        16
+
+// Longest time a task sleeps even if nothing is due (milliseconds)
+// Keeps tasks alive if a deadline is ever missed
+#define SCHEDULER_MAX_SLEEP_MS      1000
+
+// How often hardware health is checked during an alarm (milliseconds)
+#define ALARM_HEALTH_CHECK_INTERVAL_MS  10000   // 10 seconds
+
+// ===============================================================
+// PERFORMANCE STATISTICS
+// ===============================================================
+// Latency histograms reported by /perf (see perf_stats.h)
+
+// Number of log2 buckets per histogram
+// Bucket 31 holds everything from ~1 second up
+#define PERF_HISTOGRAM_BUCKETS      32
+
 // ===============================================================
 // TELEGRAM MESSAGES (Templates)
 // ===============================================================
@@ -265,6 +548,8 @@
 #define MSG_EMERGENCY_STARTED      "🚨 EMERGENCY - LARGE BUZZER ACTIVATED!"
 #define MSG_ALARM_STOPPED          "✅ Alarm stopped. Duration: %lus. Source: %s"
 #define MSG_ALARM_TIMEOUT          "⏰ Alarm auto-stopped after 5 minutes (safety)"
+#define MSG_ALARM_HARDWARE_STOP    "❌ Alarm stopped after %lus: hardware check failed"
+#define MSG_STOP_BUTTON            "🛑 STOP"   // Button under the live status
 
 // Error messages
 #define MSG_ERROR_BUZZER_SMALL     "⚠️ Small buzzer circuit issue - using large buzzer only"
@@ -278,8 +563,10 @@
 #define MSG_TEST_SMALL             "Small buzzer test in 3... 2... 1..."
 #define MSG_TEST_LARGE             "Large buzzer test (LOUD!) in 3... 2... 1..."
 #define MSG_TEST_COMPLETE          "✅ Test complete! Both buzzers working."
+#define MSG_TEST_ABORTED           "⏹ Test aborted"
 
 // Status messages
+#define MSG_STALE_COMMANDS         "⌛ Ignored %d old command(s) sent while the device was offline"
 #define MSG_DEVICE_ONLINE          "🟢 WakeAssist connected! Send /wake to test."
 #define MSG_RATE_LIMITED           "⏰ Please wait %d more seconds before next /wake"
 #define MSG_TEST_REMINDER          "⏰ Weekly reminder: Run /test to verify your device works. Last test: %d days ago"
@@ -12,10 +12,18 @@
  */
 
 #include "hardware.h"
+#include "task_manager.h"   // To wake the alarm task from the button ISR
+#include "perf_stats.h"
+#include <soc/ledc_struct.h>  // Buzzer duty from the button ISR
 
 // Create global hardware instance
 Hardware hardware;
 
+// Guards "silence latched?" + buzzer PWM write as one step. The
+// button ISR runs on the same core as the alarm task and could
+// otherwise cut in between the check and the write
+static portMUX_TYPE buzzerMux = portMUX_INITIALIZER_UNLOCKED;
+
 // ===============================================================
 // CONSTRUCTOR
 // ===============================================================
@@ -32,25 +40,51 @@ Hardware::Hardware() {
     state.buttonTest = false;
     state.buttonSilence = false;
     state.buttonReset = false;
-    state.resetButtonPressTime = 0;
 
     // Enable LEDs by default
     state.ledsEnabled = true;
 
-    // Initialize LED states (all off, not blinking)
-    wifiLED = {false, false, 0, 0};
-    alarmLED = {false, false, 0, 0};
-    statusLED = {false, false, 0, 0};
+    // Initialize LED states (all off, not blinking, timers created in begin())
+    wifiLED = {false, false, 0, Scheduler::INVALID_TIMER, PIN_LED_WIFI};
+    alarmLED = {false, false, 0, Scheduler::INVALID_TIMER, PIN_LED_ALARM};
+    statusLED = {false, false, 0, Scheduler::INVALID_TIMER, PIN_LED_STATUS};
+
+    // Initialize buttons (not pressed, timers created in begin())
+    buttons[BUTTON_TEST].pin = PIN_BUTTON_TEST;
+    buttons[BUTTON_TEST].name = "TEST";
+    buttons[BUTTON_SILENCE].pin = PIN_BUTTON_SILENCE;
+    buttons[BUTTON_SILENCE].name = "SILENCE";
+    buttons[BUTTON_RESET].pin = PIN_BUTTON_RESET;
+    buttons[BUTTON_RESET].name = "RESET";
+
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        buttons[i].timerId = Scheduler::INVALID_TIMER;
+    }
 
-    // Initialize button states (not pressed, stable)
-    testButton = {false, false, 0};
-    silenceButton = {false, false, 0};
-    resetButton = {false, false, 0};
+    // Only RESET needs the long 10 second hold. SILENCE and RESET
+    // ignore noise spikes (BUTTON_CONFIRM_MS), TEST reacts at once
+    buttons[BUTTON_TEST].debouncer.configure(BUTTON_DEBOUNCE_MS, BUTTON_LONG_PRESS_MS);
+    buttons[BUTTON_SILENCE].debouncer.configure(BUTTON_DEBOUNCE_MS, BUTTON_LONG_PRESS_MS,
+                                                BUTTON_CONFIRM_MS);
+    buttons[BUTTON_RESET].debouncer.configure(BUTTON_DEBOUNCE_MS, RESET_HOLD_TIME_MS,
+                                              BUTTON_CONFIRM_MS);
+
+    silenceArmed = false;
+    silenceLatched = false;
+    smallBuzzerDuty = 0;
+    largeBuzzerDuty = 0;
+    silenceGlitchCount = 0;
+    hardSilenceCount = 0;
+    lastSilenceMicros = 0;
+    worstSilenceMicros = 0;
+
+    droppedButtonEdges = 0;
+    buttonResyncNeeded = false;
+    buttonCallback = nullptr;
 
     // Initialize pulse state (not pulsing)
-    lastPulseToggle = 0;
     pulseState = false;
-    pulseStartTime = 0;
+    pulseTimerId = Scheduler::INVALID_TIMER;
 }
 
 // ===============================================================
@@ -116,6 +150,40 @@ bool Hardware::begin() {
 
     DEBUG_PRINTLN("✓ PWM channels configured");
 
+    // ---------------------------------------------------------------
+    // Register Timers for LED Blinking and Buzzer Pulsing
+    // ---------------------------------------------------------------
+    // alarmScheduler wakes the alarm task exactly at each toggle,
+    // instead of checking the time on every loop iteration
+
+    wifiLED.timerId = alarmScheduler.createTimer("led_wifi",
+                                                 [this]() { toggleBlinkingLED(wifiLED); });
+    alarmLED.timerId = alarmScheduler.createTimer("led_alarm",
+                                                  [this]() { toggleBlinkingLED(alarmLED); });
+    statusLED.timerId = alarmScheduler.createTimer("led_status",
+                                                   [this]() { toggleBlinkingLED(statusLED); });
+    pulseTimerId = alarmScheduler.createTimer("buzzer_pulse",
+                                              [this]() { togglePulse(); });
+
+    DEBUG_PRINTLN("✓ LED and buzzer timers registered");
+
+    // ---------------------------------------------------------------
+    // Register Button Timers and Attach Button Interrupts
+    // ---------------------------------------------------------------
+    // Each button gets one timer for the end of its bounce window
+    // and its long-press time. The interrupts do the rest.
+
+    buttons[BUTTON_TEST].timerId = alarmScheduler.createTimer("btn_test",
+                                                              [this]() { serviceButton(BUTTON_TEST); });
+    buttons[BUTTON_SILENCE].timerId = alarmScheduler.createTimer("btn_silence",
+                                                                 [this]() { serviceButton(BUTTON_SILENCE); });
+    buttons[BUTTON_RESET].timerId = alarmScheduler.createTimer("btn_reset",
+                                                               [this]() { serviceButton(BUTTON_RESET); });
+
+    attachButtonInterrupts();
+
+    DEBUG_PRINTLN("✓ Button interrupts attached");
+
     // ---------------------------------------------------------------
     // Perform Initial Hardware Check
     // ---------------------------------------------------------------
@@ -193,8 +261,16 @@ void Hardware::setupPWM() {
 // Use 0 (off) or 255 (on) for best results.
 
 void Hardware::setSmallBuzzer(uint8_t dutyCycle) {
+    // SILENCE interrupt already cut the sound - keep it off
+    portENTER_CRITICAL(&buzzerMux);
+    smallBuzzerDuty = dutyCycle;
+    if (silenceLatched) {
+        dutyCycle = 0;
+    }
+
     // Write PWM duty cycle to channel
     ledcWrite(BUZZER_PWM_CHANNEL_SMALL, dutyCycle);
+    portEXIT_CRITICAL(&buzzerMux);
 
     // Debug output (only on state changes to avoid spam)
     static uint8_t lastDutyCycle = 255;  // Track last value
@@ -210,7 +286,14 @@ void Hardware::setSmallBuzzer(uint8_t dutyCycle) {
 // ---------------------------------------------------------------
 
 void Hardware::setLargeBuzzer(uint8_t dutyCycle) {
+    portENTER_CRITICAL(&buzzerMux);
+    largeBuzzerDuty = dutyCycle;
+    if (silenceLatched) {
+        dutyCycle = 0;
+    }
+
     ledcWrite(BUZZER_PWM_CHANNEL_LARGE, dutyCycle);
+    portEXIT_CRITICAL(&buzzerMux);
 
     static uint8_t lastDutyCycle = 255;
     if (dutyCycle != lastDutyCycle) {
@@ -226,57 +309,90 @@ void Hardware::setLargeBuzzer(uint8_t dutyCycle) {
 // Emergency stop function - turns off all sound
 
 void Hardware::stopAllBuzzers() {
+    stopSmallBuzzerPulse();
     setSmallBuzzer(0);
     setLargeBuzzer(0);
     DEBUG_PRINTLN("All buzzers stopped");
 }
 
 // ---------------------------------------------------------------
-// Pulse Small Buzzer (WARNING Stage Pattern)
+// Hard Silence Latch
 // ---------------------------------------------------------------
-// Creates a pulsing pattern: 0.5s ON, 0.5s OFF
-// This function should be called repeatedly in loop()
-//
-// RETURNS: false while pulsing, true when complete
-
-bool Hardware::pulseSmallBuzzer() {
-    unsigned long currentTime = millis();
-
-    // First call - initialize pulsing
-    if (pulseStartTime == 0) {
-        pulseStartTime = currentTime;
-        lastPulseToggle = currentTime;
-        pulseState = true;
-        setSmallBuzzer(BUZZER_ON);
-        DEBUG_PRINTLN("Started pulsing pattern");
+// The actual silencing happens in buttonISR()
+
+void Hardware::armHardSilence() {
+    silenceLatched = false;
+    silenceArmed = true;
+}
+
+void Hardware::disarmHardSilence() {
+    silenceArmed = false;
+    silenceLatched = false;
+}
+
+void Hardware::releaseHardSilence() {
+    bool released = false;
+
+    // A new press may have latched again meanwhile - keep that one
+    portENTER_CRITICAL(&buzzerMux);
+    if (silenceLatched && !readButton(BUTTON_SILENCE)) {
+        silenceLatched = false;
+        ledcWrite(BUZZER_PWM_CHANNEL_SMALL, smallBuzzerDuty);
+        ledcWrite(BUZZER_PWM_CHANNEL_LARGE, largeBuzzerDuty);
+        released = true;
     }
+    portEXIT_CRITICAL(&buzzerMux);
 
-    // Check if pulse pattern is complete (30 seconds)
-    if (currentTime - pulseStartTime >= ALARM_WARNING_DURATION_MS) {
-        stopAllBuzzers();
-        pulseStartTime = 0;  // Reset for next time
-        DEBUG_PRINTLN("Pulse pattern complete");
-        return true;  // Pattern finished
+    if (released) {
+        silenceGlitchCount++;
+        DEBUG_PRINTLN("[Button] SILENCE spike (not a press) - buzzers back on");
     }
+}
 
-    // Toggle buzzer on/off at correct intervals
-    if (pulseState) {
-        // Currently ON - check if it's time to turn OFF
-        if (currentTime - lastPulseToggle >= BUZZER_PULSE_ON_MS) {
-            setSmallBuzzer(BUZZER_OFF);
-            pulseState = false;
-            lastPulseToggle = currentTime;
-        }
-    } else {
-        // Currently OFF - check if it's time to turn ON
-        if (currentTime - lastPulseToggle >= BUZZER_PULSE_OFF_MS) {
-            setSmallBuzzer(BUZZER_ON);
-            pulseState = true;
-            lastPulseToggle = currentTime;
-        }
+bool Hardware::isHardSilenced() const {
+    return silenceLatched;
+}
+
+unsigned long Hardware::getWorstSilenceMicros() const {
+    return worstSilenceMicros;
+}
+
+// ---------------------------------------------------------------
+// Pulse Small Buzzer (WARNING Stage Pattern)
+// ---------------------------------------------------------------
+// Creates a pulsing pattern: 0.5s ON, 0.5s OFF
+// Each edge is a one-shot alarmScheduler timer, so the pattern
+// keeps exact timing without being polled from the loop
+
+void Hardware::startSmallBuzzerPulse() {
+    pulseState = true;
+    setSmallBuzzer(BUZZER_ON);
+    alarmScheduler.schedule(pulseTimerId, BUZZER_PULSE_ON_MS);
+    DEBUG_PRINTLN("Started pulsing pattern");
+}
+
+void Hardware::stopSmallBuzzerPulse() {
+    if (!alarmScheduler.isScheduled(pulseTimerId)) {
+        return;  // Not pulsing
     }
 
-    return false;  // Still pulsing
+    alarmScheduler.cancel(pulseTimerId);
+    pulseState = false;
+    setSmallBuzzer(BUZZER_OFF);
+    DEBUG_PRINTLN("Pulse pattern stopped");
+}
+
+// ---------------------------------------------------------------
+// Toggle Pulse (Timer Callback)
+// ---------------------------------------------------------------
+
+void Hardware::togglePulse() {
+    pulseState = !pulseState;
+    setSmallBuzzer(pulseState ? BUZZER_ON : BUZZER_OFF);
+
+    // Schedule the next edge (ON and OFF can have different lengths)
+    alarmScheduler.schedule(pulseTimerId,
+                            pulseState ? BUZZER_PULSE_ON_MS : BUZZER_PULSE_OFF_MS);
 }
 
 // ===============================================================
@@ -289,20 +405,20 @@ bool Hardware::pulseSmallBuzzer() {
 
 void Hardware::setWiFiLED(bool state) {
     if (!this->state.ledsEnabled) return;  // LEDs disabled
+    stopBlink(wifiLED);  // Disable blinking if it was on
     digitalWrite(PIN_LED_WIFI, state ? HIGH : LOW);
-    wifiLED.enabled = false;  // Disable blinking if it was on
 }
 
 void Hardware::setAlarmLED(bool state) {
     if (!this->state.ledsEnabled) return;
+    stopBlink(alarmLED);
     digitalWrite(PIN_LED_ALARM, state ? HIGH : LOW);
-    alarmLED.enabled = false;
 }
 
 void Hardware::setStatusLED(bool state) {
     if (!this->state.ledsEnabled) return;
+    stopBlink(statusLED);
     digitalWrite(PIN_LED_STATUS, state ? HIGH : LOW);
-    statusLED.enabled = false;
 }
 
 // ---------------------------------------------------------------
@@ -311,51 +427,46 @@ void Hardware::setStatusLED(bool state) {
 // interval: Blink period in milliseconds (e.g., 1000 = 1s on, 1s off)
 
 void Hardware::blinkWiFiLED(uint16_t interval) {
-    wifiLED.enabled = true;
-    wifiLED.interval = interval;
-    wifiLED.lastToggle = millis();
+    startBlink(wifiLED, interval);
 }
 
 void Hardware::blinkAlarmLED(uint16_t interval) {
-    alarmLED.enabled = true;
-    alarmLED.interval = interval;
-    alarmLED.lastToggle = millis();
+    startBlink(alarmLED, interval);
 }
 
 void Hardware::blinkStatusLED(uint16_t interval) {
-    statusLED.enabled = true;
-    statusLED.interval = interval;
-    statusLED.lastToggle = millis();
+    startBlink(statusLED, interval);
 }
 
 // ---------------------------------------------------------------
-// Update LED States (Call in Loop)
+// Start/Stop Blinking (Private Helpers)
 // ---------------------------------------------------------------
-// Handles timing for all blinking LEDs
 
-void Hardware::updateLEDs() {
-    if (!state.ledsEnabled) return;
+void Hardware::startBlink(LEDState& led, uint16_t interval) {
+    led.enabled = true;
+    led.interval = interval;
+    alarmScheduler.schedule(led.timerId, interval);
+}
 
-    updateSingleLED(wifiLED, PIN_LED_WIFI);
-    updateSingleLED(alarmLED, PIN_LED_ALARM);
-    updateSingleLED(statusLED, PIN_LED_STATUS);
+void Hardware::stopBlink(LEDState& led) {
+    led.enabled = false;
+    alarmScheduler.cancel(led.timerId);
 }
 
 // ---------------------------------------------------------------
-// Update Single LED State (Private Helper)
+// Toggle Blinking LED (Timer Callback)
 // ---------------------------------------------------------------
 
-void Hardware::updateSingleLED(LEDState& led, uint8_t pin) {
-    if (!led.enabled) return;  // Not blinking
+void Hardware::toggleBlinkingLED(LEDState& led) {
+    PerfScope scope(PERF_LED_TOGGLE);
 
-    unsigned long currentTime = millis();
+    if (!led.enabled || !state.ledsEnabled) return;  // Not blinking
 
-    // Check if it's time to toggle
-    if (currentTime - led.lastToggle >= led.interval) {
-        led.currentState = !led.currentState;
-        digitalWrite(pin, led.currentState ? HIGH : LOW);
-        led.lastToggle = currentTime;
-    }
+    led.currentState = !led.currentState;
+    digitalWrite(led.pin, led.currentState ? HIGH : LOW);
+
+    // Re-arm for the next toggle
+    alarmScheduler.schedule(led.timerId, led.interval);
 }
 
 // ---------------------------------------------------------------
@@ -363,9 +474,9 @@ void Hardware::updateSingleLED(LEDState& led, uint8_t pin) {
 // ---------------------------------------------------------------
 
 void Hardware::turnOffAllLEDs() {
-    wifiLED.enabled = false;
-    alarmLED.enabled = false;
-    statusLED.enabled = false;
+    stopBlink(wifiLED);
+    stopBlink(alarmLED);
+    stopBlink(statusLED);
 
     digitalWrite(PIN_LED_WIFI, LOW);
     digitalWrite(PIN_LED_ALARM, LOW);
@@ -379,104 +490,212 @@ void Hardware::turnOffAllLEDs() {
 // ===============================================================
 
 // ---------------------------------------------------------------
-// Update Button States (Call in Loop)
+// Attach Button Interrupts (Private Helper)
 // ---------------------------------------------------------------
-// Reads buttons and handles debouncing
+// CHANGE = interrupt on both press (falling) and release (rising)
+//
+// NOTE: All GPIO interrupts are serviced on the core that attached
+// them (core 1, where setup() runs), one at a time. That makes the
+// ISR the single producer of the buttonEdges queue.
+
+void Hardware::attachButtonInterrupts() {
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        attachInterruptArg(buttons[i].pin, buttonISR, (void*)(uintptr_t)i, CHANGE);
+    }
 
-void Hardware::updateButtons() {
-    // Read raw button states (LOW = pressed with pullup)
-    bool testRaw = (digitalRead(PIN_BUTTON_TEST) == BUTTON_PRESSED);
-    bool silenceRaw = (digitalRead(PIN_BUTTON_SILENCE) == BUTTON_PRESSED);
-    bool resetRaw = (digitalRead(PIN_BUTTON_RESET) == BUTTON_PRESSED);
+    // Pick up a button that is already held during boot
+    buttonResyncNeeded = true;
+}
 
-    // Debounce and update states
-    state.buttonTest = debounceButton(testRaw, testButton);
-    state.buttonSilence = debounceButton(silenceRaw, silenceButton);
-    state.buttonReset = debounceButton(resetRaw, resetButton);
+// ledcWrite() for the ISR: ledcWrite() itself is in flash, and the
+// ISR can run while an NVS write (offset, WiFi cache) has the flash
+// cache turned off. Same registers ledc_set_duty()/ledc_update_duty()
+// write; fade settings and the output enable are left as the last
+// ledcWrite() set them.
+static inline void IRAM_ATTR ledcWriteFromISR(uint8_t channel, uint32_t duty) {
+    uint8_t group = channel / 8;        // 0 = high speed, 1 = low speed
+    uint8_t index = channel % 8;
+
+    LEDC.channel_group[group].channel[index].duty.duty = duty << 4;  // 4 fraction bits
+    LEDC.channel_group[group].channel[index].conf1.duty_start = 1;
+    if (group == 1) {
+        // Low speed channels only take new settings on this bit
+        LEDC.channel_group[group].channel[index].conf0.low_speed_update = 1;
+    }
+}
+
+// ---------------------------------------------------------------
+// Button Interrupt Handler
+// ---------------------------------------------------------------
+// Runs in interrupt context: keep it short!
+// - No debouncing, no Serial output, no heap allocation
+// - Only IRAM code: the flash cache may be off (see ledcWriteFromISR)
+// - Record the edge and wake the alarm task
+// - EXCEPTION: a SILENCE press during an alarm turns the buzzers
+//   off right here, before anything else runs
 
-    // Track RESET button hold time for factory reset
-    if (state.buttonReset) {
-        if (state.resetButtonPressTime == 0) {
-            // Button just pressed - record time
-            state.resetButtonPressTime = millis();
+void IRAM_ATTR Hardware::buttonISR(void* arg) {
+    unsigned long entryMicros = micros();
+    uint8_t button = (uint8_t)(uintptr_t)arg;
+
+    ButtonEdge edge;
+    edge.button = button;
+    edge.pressed = (digitalRead(hardware.buttons[button].pin) == BUTTON_PRESSED);
+    edge.time = millis();
+
+    // ---------------------------------------------------------------
+    // Hard silence: cut both buzzer channels immediately
+    // ---------------------------------------------------------------
+    // Acts on the first edge, before the debouncer has confirmed
+    // the press (BUTTON_CONFIRM_MS): silence can't wait. A spike is
+    // undone by serviceButton() -> releaseHardSilence()
+    //
+    // Same lock as setSmallBuzzer()/setLargeBuzzer(): the alarm task
+    // can't write a stage duty between our check and our 0
+    portENTER_CRITICAL_ISR(&buzzerMux);
+    bool silenceNow = (button == BUTTON_SILENCE && edge.pressed &&
+                       hardware.silenceArmed && !hardware.silenceLatched);
+    if (silenceNow) {
+        ledcWriteFromISR(BUZZER_PWM_CHANNEL_SMALL, 0);
+        ledcWriteFromISR(BUZZER_PWM_CHANNEL_LARGE, 0);
+        hardware.silenceLatched = true;
+    }
+    portEXIT_CRITICAL_ISR(&buzzerMux);
+
+    if (silenceNow) {
+        unsigned long elapsed = micros() - entryMicros;
+        hardware.lastSilenceMicros = elapsed;
+        if (elapsed > hardware.worstSilenceMicros) {
+            hardware.worstSilenceMicros = elapsed;
         }
-        // Button still held - check for long press in isFactoryResetRequested()
-    } else {
-        // Button released - reset timer
-        state.resetButtonPressTime = 0;
+        hardware.hardSilenceCount++;
     }
+
+    if (!hardware.buttonEdges.push(edge)) {
+        // Queue full - the alarm task will re-read all pins instead
+        hardware.droppedButtonEdges++;
+        hardware.buttonResyncNeeded = true;
+    }
+
+    taskManager.wakeAlarmTaskFromISR();
 }
 
 // ---------------------------------------------------------------
-// Debounce Button (Private Helper)
+// Process Queued Button Edges (Call from Alarm Task)
 // ---------------------------------------------------------------
-// Prevents false triggers from electrical noise
-//
-// How debouncing works:
-// 1. Button state must be stable for BUTTON_DEBOUNCE_MS (50ms)
-// 2. Rapid changes are ignored (noise filtering)
-// 3. Only stable state changes are registered
-
-bool Hardware::debounceButton(bool rawState, ButtonState& buttonState) {
-    unsigned long currentTime = millis();
-
-    // Check if state has changed
-    if (rawState != buttonState.lastReading) {
-        // State changed - reset debounce timer
-        buttonState.lastChange = currentTime;
-        buttonState.lastReading = rawState;
+// Feeds every queued edge into its button's debouncer
+
+void Hardware::processButtonEdges() {
+    ButtonEdge edge;
+    ButtonEvent event;
+
+    while (buttonEdges.pop(edge)) {
+        event.button = edge.button;
+
+        if (buttons[edge.button].debouncer.handleEdge(edge.pressed, edge.time, event)) {
+            dispatchButtonEvent(event);
+        }
+
+        updateButtonTimer(edge.button);
     }
 
-    // Check if state has been stable long enough
-    if ((currentTime - buttonState.lastChange) > BUTTON_DEBOUNCE_MS) {
-        // State is stable - update if different
-        if (rawState != buttonState.stableState) {
-            buttonState.stableState = rawState;
+    // ---------------------------------------------------------------
+    // Recover from a full queue (or initial state at boot)
+    // ---------------------------------------------------------------
+    // Edges were lost, so treat the current pin levels as new edges
+    if (buttonResyncNeeded) {
+        buttonResyncNeeded = false;
+
+        for (int i = 0; i < BUTTON_COUNT; i++) {
+            event.button = i;
 
-            // Log button events for debugging
-            if (rawState) {
-                DEBUG_PRINTF("Button pressed (pin change detected)\n");
+            if (buttons[i].debouncer.handleEdge(readButton(i), millis(), event)) {
+                dispatchButtonEvent(event);
             }
+
+            updateButtonTimer(i);
         }
     }
+}
 
-    return buttonState.stableState;
+void Hardware::setButtonCallback(ButtonCallback callback) {
+    buttonCallback = callback;
 }
 
 // ---------------------------------------------------------------
-// Check Button States (Public Interface)
+// Button Timer Callback (Private Helper)
 // ---------------------------------------------------------------
+// Runs when a bounce window ends or the long-press time is reached
 
-bool Hardware::isTestButtonPressed() {
-    return state.buttonTest;
+void Hardware::serviceButton(uint8_t button) {
+    ButtonDebouncer& debouncer = buttons[button].debouncer;
+    uint32_t rejectedBefore = debouncer.getRejectedCount();
+    ButtonEvent event;
+    event.button = button;
+
+    while (debouncer.handleDeadline(readButton(button), millis(), event)) {
+        dispatchButtonEvent(event);
+    }
+
+    // The edge that tripped the hard silence was not a press
+    if (button == BUTTON_SILENCE && debouncer.getRejectedCount() != rejectedBefore) {
+        releaseHardSilence();
+    }
+
+    updateButtonTimer(button);
 }
 
-bool Hardware::isSilenceButtonPressed() {
-    return state.buttonSilence;
+void Hardware::updateButtonTimer(uint8_t button) {
+    ButtonInput& input = buttons[button];
+
+    if (input.debouncer.hasDeadline()) {
+        alarmScheduler.scheduleAt(input.timerId, input.debouncer.getDeadline());
+    } else {
+        alarmScheduler.cancel(input.timerId);
+    }
 }
 
-bool Hardware::isResetButtonPressed() {
-    return state.buttonReset;
+bool Hardware::readButton(uint8_t button) const {
+    // LOW = pressed with pullup
+    return (digitalRead(buttons[button].pin) == BUTTON_PRESSED);
 }
 
 // ---------------------------------------------------------------
-// Check for Factory Reset Request
+// Dispatch Button Event (Private Helper)
 // ---------------------------------------------------------------
-// RETURNS: true if RESET button held for 10+ seconds
 
-bool Hardware::isFactoryResetRequested() {
-    if (state.resetButtonPressTime == 0) {
-        return false;  // Not pressed
+void Hardware::dispatchButtonEvent(const ButtonEvent& event) {
+    bool pressed = buttons[event.button].debouncer.isPressed();
+
+    switch (event.button) {
+        case BUTTON_TEST:    state.buttonTest = pressed;    break;
+        case BUTTON_SILENCE: state.buttonSilence = pressed; break;
+        case BUTTON_RESET:   state.buttonReset = pressed;   break;
     }
 
-    unsigned long holdTime = millis() - state.resetButtonPressTime;
+    DEBUG_PRINTF("[Button] %s %s\n", buttons[event.button].name,
+                 (event.type == BUTTON_EVENT_PRESS) ? "pressed" :
+                 (event.type == BUTTON_EVENT_RELEASE) ? "released" : "long press");
 
-    if (holdTime >= RESET_HOLD_TIME_MS) {
-        DEBUG_PRINTLN("⚠ Factory reset requested (10s hold)");
-        return true;
+    if (buttonCallback) {
+        buttonCallback(event);
     }
+}
 
-    return false;
+// ---------------------------------------------------------------
+// Check Button States (Public Interface)
+// ---------------------------------------------------------------
+
+bool Hardware::isTestButtonPressed() {
+    return state.buttonTest;
+}
+
+bool Hardware::isSilenceButtonPressed() {
+    return state.buttonSilence;
+}
+
+bool Hardware::isResetButtonPressed() {
+    return state.buttonReset;
 }
 
 // ===============================================================
@@ -608,6 +827,23 @@ String Hardware::getStatusString() const {
     status += ", RESET=";
     status += state.buttonReset ? "PRESSED" : "RELEASED";
 
+    if (droppedButtonEdges > 0) {
+        status += " (dropped edges: " + String(droppedButtonEdges) + ")";
+    }
+
+    if (hardSilenceCount > 0) {
+        status += "\n  Hard silence: " + String(hardSilenceCount) + "x, last " +
+                  String(lastSilenceMicros) + "us, worst " +
+                  String(worstSilenceMicros) + "us, undone (spike) " +
+                  String(silenceGlitchCount) + "x";
+    }
+
+    uint32_t rejected = buttons[BUTTON_SILENCE].debouncer.getRejectedCount() +
+                        buttons[BUTTON_RESET].debouncer.getRejectedCount();
+    if (rejected > 0) {
+        status += "\n  Button spikes ignored: " + String(rejected);
+    }
+
     return status;
 }
 
@@ -622,6 +858,7 @@ String Hardware::getStatusString() const {
  * ☐ Test pulsing pattern (should be 0.5s on, 0.5s off)
  * ☐ Test LED blinking at different intervals
  * ☐ Test button debouncing (rapid presses should register as one)
+ * ☐ Hold TEST/SILENCE: device keeps polling and blinking meanwhile
  * ☐ Test factory reset (hold RESET for 10s)
  * ☐ Test hardware checks (disconnect buzzer wire, check if detected)
  *
@@ -21,6 +21,10 @@
 
 #include <Arduino.h>      // Arduino core functions (digitalWrite, pinMode, etc.)
 #include "config.h"       // Our pin definitions and constants
+#include <functional>     // For std::function (button callback)
+#include "scheduler.h"    // Timers for LED blinking and buzzer pulsing
+#include "spsc_queue.h"   // Ring buffer for button edges (ISR -> task)
+#include "button_debouncer.h"  // Edge-based debouncing
 
 // ===============================================================
 // HARDWARE STATUS ENUMERATION
@@ -51,12 +55,24 @@ struct HardwareState {
     bool buttonSilence;             // Current state of SILENCE button
     bool buttonReset;               // Current state of RESET button
 
-    unsigned long resetButtonPressTime;  // When RESET button was first pressed
-                                         // (Used to detect long hold for factory reset)
-
     bool ledsEnabled;               // Master LED enable (can disable all for testing)
 };
 
+// ===============================================================
+// BUTTON IDENTIFIERS
+// ===============================================================
+// Used in ButtonEvent.button
+
+enum ButtonId {
+    BUTTON_TEST,              // TEST button (PIN_BUTTON_TEST)
+    BUTTON_SILENCE,           // SILENCE button (PIN_BUTTON_SILENCE)
+    BUTTON_RESET,             // RESET button (PIN_BUTTON_RESET)
+    BUTTON_COUNT              // Number of buttons (not a button)
+};
+
+// Function called for every debounced button event
+typedef std::function<void(const ButtonEvent&)> ButtonCallback;
+
 // ===============================================================
 // HARDWARE CLASS
 // ===============================================================
@@ -102,10 +118,41 @@ public:
     // Used for emergency stop or alarm completion
     void stopAllBuzzers();
 
-    // Create pulsing pattern for WARNING stage
-    // This function handles timing internally
-    // RETURNS: true if pattern is complete (30 seconds elapsed)
-    bool pulseSmallBuzzer();
+    // Start pulsing pattern for WARNING stage (0.5s on, 0.5s off)
+    // Pulse edges are driven by alarmScheduler - no polling needed
+    // The pattern runs until stopSmallBuzzerPulse() or stopAllBuzzers()
+    void startSmallBuzzerPulse();
+
+    // Stop pulsing pattern and leave small buzzer off
+    void stopSmallBuzzerPulse();
+
+    // ---------------------------------------------------------------
+    // HARD SILENCE (SILENCE BUTTON INTERRUPT)
+    // ---------------------------------------------------------------
+    // While armed, a SILENCE press turns both buzzer PWM channels off
+    // directly inside the button interrupt and latches "silenced".
+    // While latched, setSmallBuzzer()/setLargeBuzzer() keep the
+    // buzzers off, so a pulse edge cannot restart the sound before
+    // the alarm task has processed the stop.
+    //
+    // The ISR acts on the first edge, before the press is confirmed
+    // (BUTTON_CONFIRM_MS). If it turns out to be a spike, the latch
+    // is undone and the buzzers come back on after ~20ms of quiet.
+
+    // Allow the ISR to silence the buzzers (clears an old latch)
+    // Call when an alarm starts
+    void armHardSilence();
+
+    // Stop the ISR from silencing and clear the latch
+    // Call when an alarm has been stopped
+    void disarmHardSilence();
+
+    // Check if the ISR has silenced the buzzers
+    bool isHardSilenced() const;
+
+    // Worst-case time from entering the SILENCE interrupt until both
+    // buzzers were off (microseconds, 0 = never triggered)
+    unsigned long getWorstSilenceMicros() const;
 
     // ---------------------------------------------------------------
     // LED CONTROL
@@ -123,10 +170,6 @@ public:
     void setStatusLED(bool state);
     void blinkStatusLED(uint16_t interval);
 
-    // Update all blinking LEDs (call this in loop())
-    // This handles the timing for LED blink patterns
-    void updateLEDs();
-
     // Turn off all LEDs (for power saving or testing)
     void turnOffAllLEDs();
 
@@ -134,21 +177,30 @@ public:
     // BUTTON INPUT
     // ---------------------------------------------------------------
 
-    // Read button states with debouncing
-    // Debouncing prevents false triggers from electrical noise
-    // Call these functions to check if buttons are pressed
+    // Buttons are interrupt driven: each pin change is timestamped
+    // by an ISR and queued. The alarm task turns the queued edges
+    // into debounced PRESS / RELEASE / LONG_PRESS events.
+
+    // Register function to call for every button event
+    // Runs in the alarm task (never in the interrupt)
+    //
+    // USAGE:
+    // hardware.setButtonCallback([](const ButtonEvent& event) {
+    //     if (event.button == BUTTON_SILENCE &&
+    //         event.type == BUTTON_EVENT_PRESS) { ... }
+    // });
+    void setButtonCallback(ButtonCallback callback);
+
+    // Handle edges queued by the button interrupts
+    // Call from the alarm task every time it wakes up - the ISR
+    // wakes the alarm task whenever it queues an edge
+    void processButtonEdges();
+
+    // Read debounced button states (true = pressed)
     bool isTestButtonPressed();
     bool isSilenceButtonPressed();
     bool isResetButtonPressed();
 
-    // Check if RESET button has been held for factory reset time (10 seconds)
-    // RETURNS: true if held long enough, false otherwise
-    bool isFactoryResetRequested();
-
-    // Update button state tracking (call this in loop())
-    // Handles debouncing and long-press detection
-    void updateButtons();
-
     // ---------------------------------------------------------------
     // HARDWARE HEALTH CHECKS
     // ---------------------------------------------------------------
@@ -198,28 +250,52 @@ private:
         bool enabled;             // Is this LED currently blinking?
         bool currentState;        // Current on/off state
         uint16_t interval;        // Blink interval in milliseconds
-        unsigned long lastToggle; // Last time LED state changed (millis())
+        int timerId;              // alarmScheduler timer for next toggle
+        uint8_t pin;              // GPIO pin of this LED
     };
 
     LEDState wifiLED;
     LEDState alarmLED;
     LEDState statusLED;
 
-    // Button debouncing state
-    struct ButtonState {
-        bool lastReading;         // Last raw button reading
-        bool stableState;         // Debounced button state
-        unsigned long lastChange; // Last time button changed state
+    // Per-button input state
+    struct ButtonInput {
+        uint8_t pin;              // GPIO pin of this button
+        const char* name;         // For debug output
+        ButtonDebouncer debouncer; // Turns edges into events
+        int timerId;              // alarmScheduler timer (bounce window / long press)
+    };
+
+    ButtonInput buttons[BUTTON_COUNT];
+
+    // Raw edge recorded by the button ISR
+    struct ButtonEdge {
+        uint8_t button;           // ButtonId
+        bool pressed;             // Pin level after the edge
+        unsigned long time;       // millis() when the edge happened
     };
 
-    ButtonState testButton;
-    ButtonState silenceButton;
-    ButtonState resetButton;
+    // ISR (single producer) -> alarm task (single consumer)
+    SpscQueue<ButtonEdge, BUTTON_EDGE_QUEUE_SIZE> buttonEdges;
+
+    // Hard silence latch (written by the button ISR)
+    volatile bool silenceArmed;             // ISR may silence buzzers
+    volatile bool silenceLatched;           // ISR has silenced buzzers
+    uint8_t smallBuzzerDuty;                // Duty asked for, restored if
+    uint8_t largeBuzzerDuty;                // the latch was a glitch
+    uint32_t silenceGlitchCount;            // Latches undone (not a press)
+    volatile uint32_t hardSilenceCount;     // Times the ISR silenced
+    volatile unsigned long lastSilenceMicros;   // Last press-to-silence time
+    volatile unsigned long worstSilenceMicros;  // Worst press-to-silence time
+
+    volatile uint32_t droppedButtonEdges;   // Edges lost to a full queue
+    volatile bool buttonResyncNeeded;       // Re-read pins after a drop
+
+    ButtonCallback buttonCallback;
 
     // Buzzer pulsing state (for WARNING stage)
-    unsigned long lastPulseToggle;  // Last time pulse pattern changed
     bool pulseState;                // Current pulse on/off state
-    unsigned long pulseStartTime;   // When pulsing started
+    int pulseTimerId;               // alarmScheduler timer for next pulse edge
 
     // ---------------------------------------------------------------
     // PRIVATE HELPER FUNCTIONS
@@ -229,14 +305,40 @@ private:
     // Initialize PWM channels for buzzer control
     void setupPWM();
 
-    // Read button with debouncing logic
-    // rawState: Current raw reading from digitalRead()
-    // buttonState: Reference to button state structure to update
-    // RETURNS: Debounced button state (true = pressed)
-    bool debounceButton(bool rawState, ButtonState& buttonState);
+    // Attach a CHANGE interrupt to every button pin
+    void attachButtonInterrupts();
+
+    // Button interrupt handler (arg = ButtonId)
+    // Only timestamps and queues the edge - no debouncing here
+    static void buttonISR(void* arg);
+
+    // Read raw pin level of a button (true = pressed)
+    bool readButton(uint8_t button) const;
 
-    // Update a single LED's blink state
-    void updateSingleLED(LEDState& led, uint8_t pin);
+    // Timer callback: end of bounce window or long-press time
+    void serviceButton(uint8_t button);
+
+    // Undo a hard silence whose SILENCE "press" was not confirmed
+    // (noise spike): buzzers go back to their duty
+    void releaseHardSilence();
+
+    // Arm or cancel a button's timer from its debouncer deadline
+    void updateButtonTimer(uint8_t button);
+
+    // Update state and pass an event to the button callback
+    void dispatchButtonEvent(const ButtonEvent& event);
+
+    // Start blinking a single LED (arms its timer)
+    void startBlink(LEDState& led, uint16_t interval);
+
+    // Stop blinking a single LED (disarms its timer)
+    void stopBlink(LEDState& led);
+
+    // Timer callback: toggle a blinking LED and re-arm its timer
+    void toggleBlinkingLED(LEDState& led);
+
+    // Timer callback: flip the pulse pattern and re-arm the timer
+    void togglePulse();
 };
 
 // ===============================================================
@@ -274,14 +376,9 @@ extern Hardware hardware;
  * }
  *
  * void loop() {
- *     // Update button and LED states
- *     hardware.updateButtons();
- *     hardware.updateLEDs();
- *
- *     // Check for button press
- *     if (hardware.isSilenceButtonPressed()) {
- *         hardware.stopAllBuzzers();
- *     }
+ *     // Handle button edges (LEDs blink via alarmScheduler)
+ *     hardware.processButtonEdges();
+ *     alarmScheduler.runDueTimers();
  *
  *     // Control buzzers
  *     hardware.setSmallBuzzer(255);  // Turn on full power
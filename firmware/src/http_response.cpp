@@ -0,0 +1,387 @@
+/*
+ * ===============================================================
+ * WakeAssist - HTTP Response Reader Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the streaming HTTP/1.1 response reader
+ * declared in http_response.h
+ *
+ * KEY CONCEPTS:
+ * - Raw bytes: Everything the server sent, including the chunk
+ *   size lines ("1a3\r\n") of a chunked body
+ * - Body bytes: What the JSON parser sees - raw bytes without any
+ *   framing, ending exactly at the end of the body
+ * - All buffers are members (no heap); lines that don't fit are
+ *   cut off, which is fine because we only look at their start
+ *
+ * ===============================================================
+ */
+
+#include "http_response.h"
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+HttpResponse::HttpResponse(Client& client, unsigned long timeoutMs, size_t maxBodyBytes)
+    : client(client) {
+    this->timeoutMs = timeoutMs;
+    this->maxBodyBytes = maxBodyBytes;
+    startTime = millis();
+
+    bufferPos = 0;
+    bufferLen = 0;
+
+    statusCode = 0;
+    keepAlive = false;
+    gotData = false;
+    error = false;
+    closed = false;
+
+    bodyMode = BODY_LENGTH;
+    remaining = 0;
+    firstChunk = true;
+    bodyDone = true;      // Nothing to read before begin()
+    bodyBytesRead = 0;
+    peekedByte = -1;
+
+    // read() already waits for the network - Stream::readBytes()
+    // must not wait again after the end of the body
+    setTimeout(0);
+}
+
+// ===============================================================
+// READING
+// ===============================================================
+
+bool HttpResponse::begin() {
+    char line[HTTP_LINE_BUFFER_BYTES];
+    startTime = millis();
+
+    // ---------------------------------------------------------------
+    // 1. Status line: "HTTP/1.1 200 OK"
+    // ---------------------------------------------------------------
+    if (!readLine(line, sizeof(line))) {
+        fail("Request timeout");
+        return false;
+    }
+
+    if (strncmp(line, "HTTP/1.", 7) != 0) {
+        fail("Not an HTTP response");
+        return false;
+    }
+
+    // HTTP/1.0 closes by default
+    keepAlive = (line[7] == '1');
+
+    if (strlen(line) > 9) {
+        statusCode = atoi(line + 9);
+    }
+
+    // ---------------------------------------------------------------
+    // 2. Headers (until empty line)
+    // ---------------------------------------------------------------
+    long contentLength = -1;
+    bool chunked = false;
+
+    while (true) {
+        if (!readLine(line, sizeof(line))) {
+            fail("Timeout in headers");
+            return false;
+        }
+
+        if (line[0] == '\0') {
+            break;  // End of headers
+        }
+
+        // Header names (and the values we check) are case-insensitive
+        for (char* p = line; *p != '\0'; p++) {
+            *p = tolower(*p);
+        }
+
+        if (strncmp(line, "content-length:", 15) == 0) {
+            contentLength = strtol(line + 15, nullptr, 10);
+        } else if (strncmp(line, "transfer-encoding:", 18) == 0 && strstr(line, "chunked") != nullptr) {
+            chunked = true;
+        } else if (strncmp(line, "connection:", 11) == 0) {
+            keepAlive = (strstr(line, "close") == nullptr);
+        }
+    }
+
+    // ---------------------------------------------------------------
+    // 3. How the body ends
+    // ---------------------------------------------------------------
+    bodyDone = false;
+
+    if (chunked) {
+        bodyMode = BODY_CHUNKED;
+        remaining = 0;          // First read() fetches the first size
+    } else if (contentLength >= 0) {
+        if ((size_t)contentLength > maxBodyBytes) {
+            fail("Response too large");
+            return false;
+        }
+        bodyMode = BODY_LENGTH;
+        remaining = contentLength;
+        bodyDone = (remaining == 0);
+    } else {
+        // No length at all: body ends when the server closes
+        bodyMode = BODY_UNTIL_CLOSE;
+        keepAlive = false;
+    }
+
+    return true;
+}
+
+bool HttpResponse::finish() {
+    // Whatever the parser did not need (e.g. a trailing newline)
+    peekedByte = -1;
+    while (readBodyByte() >= 0) {
+    }
+
+    // Bytes after the end of the body belong to no request we sent -
+    // the connection is out of step
+    if (bufferPos < bufferLen) {
+        keepAlive = false;
+    }
+
+    return !error;
+}
+
+// ===============================================================
+// RESPONSE INFORMATION
+// ===============================================================
+
+int HttpResponse::getStatusCode() const {
+    return statusCode;
+}
+
+bool HttpResponse::isKeepAlive() const {
+    return keepAlive && !error;
+}
+
+bool HttpResponse::hasData() const {
+    return gotData;
+}
+
+bool HttpResponse::hasError() const {
+    return error;
+}
+
+size_t HttpResponse::getBodyBytesRead() const {
+    return bodyBytesRead;
+}
+
+// ===============================================================
+// STREAM INTERFACE
+// ===============================================================
+
+int HttpResponse::available() {
+    int extra = (peekedByte >= 0) ? 1 : 0;
+
+    if (error || bodyDone) {
+        return extra;
+    }
+
+    size_t buffered = bufferLen - bufferPos;
+
+    // Framing bytes (next chunk size line) are not body bytes
+    if (bodyMode != BODY_UNTIL_CLOSE && buffered > remaining) {
+        buffered = remaining;
+    }
+
+    return (int)buffered + extra;
+}
+
+int HttpResponse::read() {
+    if (peekedByte >= 0) {
+        int c = peekedByte;
+        peekedByte = -1;
+        return c;
+    }
+
+    return readBodyByte();
+}
+
+int HttpResponse::peek() {
+    if (peekedByte < 0) {
+        peekedByte = readBodyByte();
+    }
+
+    return peekedByte;
+}
+
+size_t HttpResponse::write(uint8_t b) {
+    (void)b;
+    return 0;
+}
+
+void HttpResponse::flush() {
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+int HttpResponse::nextRawByte() {
+    if (bufferPos >= bufferLen && !fillBuffer()) {
+        return -1;
+    }
+
+    return buffer[bufferPos++];
+}
+
+bool HttpResponse::fillBuffer() {
+    while (millis() - startTime < timeoutMs) {
+        int waiting = client.available();
+
+        if (waiting > 0) {
+            int got = client.read(buffer, min((size_t)waiting, sizeof(buffer)));
+
+            if (got > 0) {
+                bufferPos = 0;
+                bufferLen = got;
+                gotData = true;
+                return true;
+            }
+        } else if (!client.connected()) {
+            closed = true;
+            return false;
+        }
+
+        delay(1);
+    }
+
+    return false;
+}
+
+bool HttpResponse::readLine(char* line, size_t size) {
+    size_t length = 0;
+
+    while (true) {
+        int c = nextRawByte();
+
+        if (c < 0) {
+            return false;
+        }
+
+        if (c == '\n') {
+            break;
+        }
+
+        if (c != '\r' && length < size - 1) {
+            line[length++] = (char)c;
+        }
+    }
+
+    line[length] = '\0';
+    return true;
+}
+
+bool HttpResponse::startNextChunk() {
+    char line[HTTP_LINE_BUFFER_BYTES];
+
+    // Each chunk: "<size in hex>\r\n<data>\r\n", last chunk has size 0
+    // The "\r\n" after the previous chunk's data comes first
+    if (!firstChunk && !readLine(line, sizeof(line))) {
+        fail("Chunk cut short");
+        return false;
+    }
+    firstChunk = false;
+
+    if (!readLine(line, sizeof(line))) {
+        fail("Chunk cut short");
+        return false;
+    }
+
+    long chunkSize = strtol(line, nullptr, 16);
+
+    if (chunkSize < 0) {
+        fail("Bad chunk size");
+        return false;
+    }
+
+    if (chunkSize == 0) {
+        // Skip trailers (until empty line)
+        do {
+            if (!readLine(line, sizeof(line))) {
+                fail("Chunk cut short");
+                return false;
+            }
+        } while (line[0] != '\0');
+
+        bodyDone = true;
+        return true;
+    }
+
+    remaining = chunkSize;
+    return true;
+}
+
+int HttpResponse::readBodyByte() {
+    if (error || bodyDone) {
+        return -1;
+    }
+
+    if (bodyMode == BODY_CHUNKED && remaining == 0) {
+        if (!startNextChunk() || bodyDone) {
+            return -1;
+        }
+    }
+
+    int c = nextRawByte();
+
+    if (c < 0) {
+        if (bodyMode == BODY_UNTIL_CLOSE && closed) {
+            bodyDone = true;   // Normal end of this kind of body
+            return -1;
+        }
+        return fail("Body cut short");
+    }
+
+    bodyBytesRead++;
+
+    if (bodyBytesRead > maxBodyBytes) {
+        return fail("Response too large");
+    }
+
+    if (bodyMode != BODY_UNTIL_CLOSE) {
+        remaining--;
+        if (bodyMode == BODY_LENGTH && remaining == 0) {
+            bodyDone = true;
+        }
+    }
+
+    return c;
+}
+
+int HttpResponse::fail(const char* reason) {
+    DEBUG_PRINTF("[HTTP] ERROR: %s\n", reason);
+    error = true;
+    keepAlive = false;
+    return -1;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. WHY A STREAM?
+ *    ArduinoJson can read from any Stream. It asks for one byte at a
+ *    time, and every byte comes out of our 256 byte buffer, so the
+ *    body never has to exist as a whole in memory.
+ *
+ * 2. WHY setTimeout(0)?
+ *    Stream::readBytes() calls read() until its own timeout passes.
+ *    Our read() already waits for the network (up to timeoutMs), so
+ *    a second wait would only add a pause after the end of the body.
+ *
+ * 3. WHY finish()?
+ *    The JSON parser stops at the closing '}'. Telegram may send a
+ *    newline after it, and a chunked body still has its last chunk
+ *    and trailers. If those stayed unread, the next request on the
+ *    same connection would see them as the start of its response.
+ *
+ * ===============================================================
+ */
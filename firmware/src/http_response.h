@@ -0,0 +1,187 @@
+/*
+ * ===============================================================
+ * WakeAssist - HTTP Response Reader Module (Header File)
+ * ===============================================================
+ *
+ * This module reads an HTTP/1.1 response from a Client piece by
+ * piece, using only fixed buffers:
+ * - Status line and headers (Content-Length, chunked, Connection)
+ * - Body as a Stream: the reader removes the chunked framing and
+ *   stops exactly at the end of the body
+ *
+ * WHY?
+ * Reading the whole body into a String first means the String grows
+ * (and is copied) again and again, and the full response sits in
+ * heap next to the parsed JSON. Here the JSON parser pulls the body
+ * straight from a 256 byte buffer:
+ *
+ *   deserializeJson(doc, response);
+ *
+ * HOW IT ENDS:
+ * - Content-Length: after exactly that many bytes
+ * - Chunked: after the last (size 0) chunk and its trailers
+ * - Neither: when the server closes the connection
+ * Call finish() after parsing to read what the parser left over, so
+ * the connection can carry the next request.
+ *
+ * ===============================================================
+ */
+
+#ifndef HTTP_RESPONSE_H
+#define HTTP_RESPONSE_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "config.h"
+
+// ===============================================================
+// HTTP RESPONSE CLASS
+// ===============================================================
+// One object per response (cheap: lives on the stack)
+
+class HttpResponse : public Stream {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    // client: Connection the request was sent on
+    // timeoutMs: Time allowed for the whole response (from begin())
+    // maxBodyBytes: Larger bodies are treated as an error
+    HttpResponse(Client& client, unsigned long timeoutMs, size_t maxBodyBytes);
+
+    // ---------------------------------------------------------------
+    // READING
+    // ---------------------------------------------------------------
+
+    // Read status line and headers
+    // RETURNS: true if the body can be read now
+    bool begin();
+
+    // Read and drop the rest of the body (and chunk trailers)
+    // RETURNS: true if the whole response arrived without error
+    bool finish();
+
+    // ---------------------------------------------------------------
+    // RESPONSE INFORMATION
+    // ---------------------------------------------------------------
+
+    // Status code from the status line (200, 429, ...), 0 if none
+    int getStatusCode() const;
+
+    // RETURNS: false if the server closes the connection after this
+    //          response (Connection: close, HTTP/1.0, no length)
+    bool isKeepAlive() const;
+
+    // RETURNS: true once any byte of the response has arrived
+    bool hasData() const;
+
+    // RETURNS: true after a timeout, closed connection or bad framing
+    bool hasError() const;
+
+    // Body bytes handed out so far (without chunk framing)
+    size_t getBodyBytesRead() const;
+
+    // ---------------------------------------------------------------
+    // STREAM INTERFACE (body only)
+    // ---------------------------------------------------------------
+
+    // Body bytes that can be read without waiting
+    int available() override;
+
+    // Next body byte, waits for the network if needed
+    // RETURNS: Byte, or -1 at the end of the body or on error
+    int read() override;
+    int peek() override;
+
+    // Read-only stream
+    size_t write(uint8_t b) override;
+    void flush() override;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE TYPES
+    // ---------------------------------------------------------------
+
+    enum BodyMode {
+        BODY_LENGTH,        // Content-Length bytes
+        BODY_CHUNKED,       // Transfer-Encoding: chunked
+        BODY_UNTIL_CLOSE    // Until the server closes the connection
+    };
+
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    Client& client;
+    unsigned long startTime;
+    unsigned long timeoutMs;
+    size_t maxBodyBytes;
+
+    // Raw network data not handed out yet
+    uint8_t buffer[HTTP_READ_BUFFER_BYTES];
+    size_t bufferPos;
+    size_t bufferLen;
+
+    int statusCode;
+    bool keepAlive;
+    bool gotData;
+    bool error;
+    bool closed;              // Server closed, buffer is all there is
+
+    BodyMode bodyMode;
+    size_t remaining;         // Left in body (LENGTH) or chunk (CHUNKED)
+    bool firstChunk;          // No chunk read yet (no CRLF to skip)
+    bool bodyDone;            // End of body reached
+    size_t bodyBytesRead;
+    int peekedByte;           // Byte returned by peek(), -1 = none
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Next raw byte (framing included), refills the buffer if empty
+    // RETURNS: Byte, or -1 if closed or timed out
+    int nextRawByte();
+
+    // Wait for data and read one block into the buffer
+    // RETURNS: false if closed or timed out
+    bool fillBuffer();
+
+    // Read one line without "\r\n" (cut off at size - 1 characters)
+    // RETURNS: false if closed or timed out
+    bool readLine(char* line, size_t size);
+
+    // Read the size line of the next chunk (and the CRLF before it)
+    // Reads the trailers and marks the body done after the last one
+    // RETURNS: false on error
+    bool startNextChunk();
+
+    // Next decoded body byte (no peek handling)
+    int readBodyByte();
+
+    // Mark response broken (the connection must not be reused)
+    int fail(const char* reason);
+};
+
+#endif // HTTP_RESPONSE_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * client.print("GET /... HTTP/1.1\r\n...\r\n");
+ *
+ * HttpResponse response(client, 10000, 16384);
+ *
+ * if (response.begin()) {
+ *     JsonDocument doc;
+ *     DeserializationError err = deserializeJson(doc, response);
+ *
+ *     if (!response.finish() || err) {
+ *         client.stop();     // Don't reuse a half-read connection
+ *     }
+ * }
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,203 @@
+/*
+ * ===============================================================
+ * WakeAssist - Live Status Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the live alarm status message declared in
+ * live_status.h
+ *
+ * KEY CONCEPTS:
+ * - The whole text lives in one fixed buffer (no heap); if it is
+ *   full, the oldest line goes
+ * - "pending" marks text that Telegram has not seen yet. Adding a
+ *   line while pending costs no request at all (coalescing)
+ *
+ * ===============================================================
+ */
+
+#include "live_status.h"
+#include "telegram_bot.h"
+
+// One tap runs /stop through the command table
+static const TelegramButton STOP_BUTTON = { MSG_STOP_BUTTON, "/stop" };
+
+// ===============================================================
+// GLOBAL LIVE STATUS INSTANCE
+// ===============================================================
+
+LiveStatus liveStatus;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+LiveStatus::LiveStatus() {
+    text[0] = '\0';
+    length = 0;
+    messageId = 0;
+    pending = false;
+    alarmRunning = false;
+    lastSendTime = 0;
+    messagesSent = 0;
+    editsSent = 0;
+    linesCoalesced = 0;
+}
+
+// ===============================================================
+// UPDATING
+// ===============================================================
+
+void LiveStatus::addLine(const char* line, NotificationPriority kind) {
+    if (kind == NOTIFY_LIVE_START) {
+        // Unsent lines of the last alarm are dropped: the new alarm
+        // says more than how the old one went
+        text[0] = '\0';
+        length = 0;
+        messageId = 0;
+        pending = false;
+        alarmRunning = true;
+    } else if (kind == NOTIFY_LIVE_END) {
+        alarmRunning = false;
+    }
+
+    if (pending) {
+        linesCoalesced++;
+    }
+
+    // Longest line that fits at all ('\n' + text + '\0')
+    size_t lineLength = strlen(line);
+    if (lineLength > sizeof(text) - 2) {
+        lineLength = sizeof(text) - 2;
+    }
+
+    // Make room: the newest lines matter most
+    while (length > 0 && length + 1 + lineLength + 1 > sizeof(text)) {
+        dropFirstLine();
+    }
+
+    if (length > 0) {
+        text[length++] = '\n';
+    }
+    memcpy(text + length, line, lineLength);
+    length += lineLength;
+    text[length] = '\0';
+
+    pending = true;
+}
+
+bool LiveStatus::flush() {
+    if (!pending) {
+        return true;
+    }
+
+    if (!telegramBot.isOnline() || getDelayMs() > 0) {
+        return false;
+    }
+
+    bool sent;
+    const TelegramButton* button = alarmRunning ? &STOP_BUTTON : nullptr;
+
+    if (messageId != 0) {
+        sent = telegramBot.editMessage(messageId, text, button);
+
+        if (sent) {
+            editsSent++;
+        } else if (telegramBot.getLastErrorCode() == 400) {
+            // Telegram refused the edit (message deleted, too old):
+            // send the text as a new message next time
+            DEBUG_PRINTLN("[Live] Message can't be edited - starting a new one");
+            messageId = 0;
+        }
+    } else {
+        int32_t newId = 0;
+        sent = telegramBot.sendMessage(text, newId, button);
+
+        if (sent) {
+            messageId = newId;
+            messagesSent++;
+        }
+    }
+
+    if (!sent) {
+        return false;
+    }
+
+    pending = false;
+    lastSendTime = millis();
+    return true;
+}
+
+bool LiveStatus::hasPending() const {
+    return pending;
+}
+
+unsigned long LiveStatus::getDelayMs() const {
+    unsigned long delayMs = 0;
+
+    // Throttle edits only - the first line of an alarm goes out at once
+    if (messageId != 0) {
+        unsigned long sinceLast = millis() - lastSendTime;
+        if (sinceLast < LIVE_STATUS_MIN_EDIT_MS) {
+            delayMs = LIVE_STATUS_MIN_EDIT_MS - sinceLast;
+        }
+    }
+
+    unsigned long sendWaitMs = telegramBot.getSendWaitMs();
+    return (sendWaitMs > delayMs) ? sendWaitMs : delayMs;
+}
+
+// ===============================================================
+// STATUS & INFORMATION
+// ===============================================================
+
+String LiveStatus::getStatusString() const {
+    String result = "[Live] Messages: " + String(messagesSent);
+    result += ", Edits: " + String(editsSent);
+    result += ", Lines coalesced: " + String(linesCoalesced);
+    if (pending) {
+        result += " (update waiting)";
+    }
+    return result;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+void LiveStatus::dropFirstLine() {
+    char* newline = strchr(text, '\n');
+    if (newline == nullptr) {
+        text[0] = '\0';
+        length = 0;
+        return;
+    }
+
+    size_t dropped = (newline - text) + 1;
+    memmove(text, newline + 1, length - dropped + 1);
+    length -= dropped;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. HOW MANY REQUESTS DOES THIS SAVE?
+ *    A full escalation used to be five sendMessage calls (received,
+ *    WARNING, ALERT, EMERGENCY, stopped), each also a push
+ *    notification. Now it is one sendMessage and up to four edits -
+ *    fewer when stages come close together, as the throttle joins
+ *    them into one edit. The chat keeps one message per alarm.
+ *
+ * 2. WHY THROTTLE EDITS?
+ *    Edits count against the same Telegram limits as messages. Two
+ *    seconds is fast enough to follow the stages and stops a burst
+ *    (WiFi flapping during an alarm) from using up the send budget
+ *    that urgent messages need.
+ *
+ * 3. WHAT STILL GOES OUT AS ITS OWN MESSAGE?
+ *    Hardware errors and replies: they need a push notification,
+ *    and an edit does not make the phone ring.
+ *
+ * ===============================================================
+ */
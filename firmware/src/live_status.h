@@ -0,0 +1,132 @@
+/*
+ * ===============================================================
+ * WakeAssist - Live Status Module (Header File)
+ * ===============================================================
+ *
+ * This module keeps the user up to date about a running alarm with
+ * ONE Telegram message instead of one message per stage:
+ *
+ *   ✅ Command received. Starting alarm in 3s...
+ *   ⏰ WARNING stage started - small buzzer pulsing
+ *   🔔 ALERT stage - small buzzer continuous
+ *   ✅ Alarm stopped. Duration: 42s. Source: Button
+ *
+ * The first line is sent with sendMessage. Telegram answers with the
+ * message_id, and every later line edits that message in place
+ * (editMessageText).
+ *
+ * While the alarm runs, the message carries a STOP button: one tap
+ * sends /stop (as a callback_query, see TelegramBot). The last line
+ * (alarm stopped) removes the button again.
+ *
+ * THROTTLED AND COALESCED:
+ * An edit goes out at most every LIVE_STATUS_MIN_EDIT_MS (and only
+ * when Telegram's rate limit allows it). Lines that arrive in the
+ * meantime are only added to the text - the next edit carries all of
+ * them. Only the newest text is ever sent.
+ *
+ * HOW LINES GET HERE:
+ * alarm task -> taskManager.postNotification(text, NOTIFY_LIVE...)
+ *            -> network task (sendQueuedNotifications) -> addLine()
+ *
+ * ===============================================================
+ */
+
+#ifndef LIVE_STATUS_H
+#define LIVE_STATUS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "task_manager.h"      // NotificationPriority
+
+// ===============================================================
+// LIVE STATUS CLASS
+// ===============================================================
+// Network task only (no locking)
+
+class LiveStatus {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    LiveStatus();
+
+    // ---------------------------------------------------------------
+    // UPDATING
+    // ---------------------------------------------------------------
+
+    // Add a line to the live message
+    // line: Text of the line
+    // kind: NOTIFY_LIVE_START = start a new message (a new alarm),
+    //       NOTIFY_LIVE = add to the current one,
+    //       NOTIFY_LIVE_END = add the last line (alarm over, the STOP
+    //       button goes away)
+    void addLine(const char* line, NotificationPriority kind);
+
+    // Send or edit the message if it changed and the throttle allows
+    // RETURNS: true if nothing is left to send
+    bool flush();
+
+    // Check if the message changed since it was last sent
+    bool hasPending() const;
+
+    // Time until flush() may send (0 = now)
+    unsigned long getDelayMs() const;
+
+    // ---------------------------------------------------------------
+    // STATUS & INFORMATION
+    // ---------------------------------------------------------------
+
+    // Get human-readable status string
+    // RETURNS: String like "[Live] Messages: 3, Edits: 9, Lines coalesced: 2"
+    String getStatusString() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    char text[LIVE_STATUS_MAX_BYTES];   // Lines, separated by '\n'
+    size_t length;
+
+    int32_t messageId;            // Telegram message to edit, 0 = none yet
+    bool pending;                 // Text changed since last sent
+    bool alarmRunning;            // Show the STOP button
+    unsigned long lastSendTime;   // millis() of the last send or edit
+
+    // Statistics
+    uint32_t messagesSent;        // New messages
+    uint32_t editsSent;           // Edits of a message
+    uint32_t linesCoalesced;      // Lines that went out with a later one
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Drop the oldest line (to make room)
+    void dropFirstLine();
+};
+
+// ===============================================================
+// GLOBAL LIVE STATUS INSTANCE
+// ===============================================================
+
+extern LiveStatus liveStatus;
+
+#endif // LIVE_STATUS_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE (network task):
+ * ===============================================================
+ *
+ * liveStatus.addLine(MSG_WAKE_RECEIVED, NOTIFY_LIVE_START);
+ * liveStatus.flush();                               // sendMessage
+ *
+ * liveStatus.addLine(MSG_WARNING_STARTED, NOTIFY_LIVE);
+ * if (!liveStatus.flush()) {
+ *     // Throttled: try again after liveStatus.getDelayMs()
+ * }
+ *
+ * ===============================================================
+ */
@@ -11,19 +11,28 @@
  * - Alarm controller (state machine)
  *
  * STARTUP SEQUENCE:
+ * Phase 1 - setup(), no network (alarm ready in milliseconds):
  * 1. Initialize serial communication
- * 2. Initialize hardware (GPIO, PWM)
- * 3. Connect to WiFi (or start config portal)
- * 4. Initialize Telegram bot
- * 5. Register command handlers
- * 6. Enter main loop
+ * 2. Initialize hardware (GPIO, PWM, buttons, self-test)
+ * 3. Initialize alarm controller
+ * 4. Load Telegram bot configuration, register command handlers
+ * 5. Start network task (core 0) and alarm task (core 1)
  *
- * MAIN LOOP:
- * - Update hardware (buttons, LEDs)
- * - Poll Telegram for messages
- * - Update alarm state machine
- * - Check for button presses
- * - Monitor WiFi connection
+ * Phase 2 - network task, in the background:
+ * 6. Connect to WiFi (or start config portal)
+ * 7. Bring Telegram bot online (polling resumes where it left off)
+ * 8. Start polling
+ *
+ * ALARM TASK (core 1):
+ * - Handle button edges queued by the button interrupts
+ * - Run commands received from the network task
+ * - Run due timers: button debounce, LEDs, buzzer pulse, alarm stages
+ *
+ * NETWORK TASK (core 0):
+ * - Send notifications queued by the alarm task
+ * - Run due timers: Telegram polling, WiFi monitoring, status
+ *
+ * Both tasks sleep until their next deadline (see scheduler.h)
  *
  * ===============================================================
  */
@@ -34,6 +43,15 @@
 #include "wifi_manager.h"
 #include "telegram_bot.h"
 #include "alarm_controller.h"
+#include "task_manager.h"
+#include "scheduler.h"
+#include "perf_stats.h"
+#include "stall_watchdog.h"
+#include "boot_timing.h"
+#include "notification_outbox.h"
+#include "live_status.h"
+#include "mqtt_control.h"
+#include "poll_policy.h"
 
 // ===============================================================
 // FUNCTION DECLARATIONS
@@ -44,18 +62,39 @@ void setupHardware();
 void setupWiFi();
 void setupTelegram();
 void setupCommandHandlers();
-void handleButtons();
+void setupTimers();
+void bringUpNetwork();
+unsigned long networkLoop();
+unsigned long alarmLoop();
+void processAlarmCommands();
+void sendQueuedNotifications();
+void scheduleNotificationRetry();
+void flushLiveStatus();
+void handleButtonEvent(const ButtonEvent& event);
 void checkWiFiStatus();
 void printStatus();
+void printSchedulerStatus(const char* name, const Scheduler& scheduler);
+void clearStoredSettings();
+void sendReply(const TelegramMessage& msg, const String& text);
 
 // ===============================================================
 // GLOBAL VARIABLES
 // ===============================================================
 
-// Timing variables for non-blocking operations
-unsigned long lastTelegramPoll = 0;
-unsigned long lastStatusPrint = 0;
-unsigned long lastWiFiCheck = 0;
+// Scheduler timers owned by main.cpp (see setupTimers())
+int networkBootTimer = Scheduler::INVALID_TIMER;   // network task
+int telegramPollTimer = Scheduler::INVALID_TIMER;  // network task
+int wifiCheckTimer = Scheduler::INVALID_TIMER;     // network task
+int statusPrintTimer = Scheduler::INVALID_TIMER;   // network task
+int notifyRetryTimer = Scheduler::INVALID_TIMER;   // network task
+int liveStatusTimer = Scheduler::INVALID_TIMER;    // network task
+int mqttTimer = Scheduler::INVALID_TIMER;          // network task
+int delayedWakeTimer = Scheduler::INVALID_TIMER;   // alarm task
+int factoryResetTimer = Scheduler::INVALID_TIMER;  // alarm task
+
+// Factory reset in progress (alarm task only)
+bool factoryResetPosted = false;    // Network task was asked to clear
+bool factoryResetCleared = false;   // ...and has done so
 
 // Status tracking
 bool systemReady = false;
@@ -70,13 +109,21 @@ unsigned long bootTime = 0;
 // the device for operation
 
 void setup() {
+    // ---------------------------------------------------------------
+    // PHASE 1: LOCAL BOOT (this function)
+    // ---------------------------------------------------------------
+    // Only things that need no network run here, so buttons and
+    // buzzers work a few milliseconds after power-on. WiFi and
+    // Telegram come up afterwards in the network task (see
+    // bringUpNetwork()) while the alarm is already usable.
+
     // ---------------------------------------------------------------
     // 1. INITIALIZE SERIAL COMMUNICATION
     // ---------------------------------------------------------------
     // Start serial port for debugging (115200 baud)
     // This must be first so we can see debug messages
+    // (No delay() to "stabilize" - the UART is ready immediately)
     Serial.begin(SERIAL_BAUD_RATE);
-    delay(1000);  // Wait for serial to stabilize
 
     DEBUG_PRINTLN("\n\n");
     DEBUG_PRINTLN("===============================================");
@@ -88,78 +135,63 @@ void setup() {
 
     bootTime = millis();
 
+    // Read stall record from before the reset, start stall monitor
+    stallWatchdog.begin();
+
+    // Cycle counter -> microseconds for the /perf histograms
+    perfStats.begin();
+    alarmScheduler.setLatenessRecorder([](unsigned long lateMs) {
+        perfStats.recordMicros(PERF_ALARM_LATENESS, lateMs * 1000);
+    });
+    networkScheduler.setLatenessRecorder([](unsigned long lateMs) {
+        perfStats.recordMicros(PERF_NETWORK_LATENESS, lateMs * 1000);
+    });
+
     // ---------------------------------------------------------------
     // 2. INITIALIZE HARDWARE
     // ---------------------------------------------------------------
+    // Includes the buzzer circuit self-test
     DEBUG_PRINTLN("[Setup] Initializing hardware...");
 
     if (!hardware.begin()) {
         DEBUG_PRINTLN("[Setup] FATAL ERROR: Hardware initialization failed!");
         // Blink status LED rapidly to indicate error
+        hardware.blinkStatusLED(LED_BLINK_FAST);
         while (true) {
-            hardware.blinkStatusLED(LED_BLINK_FAST);
-            hardware.updateLEDs();
-            delay(100);
+            alarmScheduler.runDueTimers();
+            delay(10);
         }
     }
 
     // Turn on status LED to show device is working
     hardware.setStatusLED(true);
 
-    // Perform hardware health checks
-    DEBUG_PRINTLN("[Setup] Running hardware diagnostics...");
-    if (!hardware.checkBuzzerCircuits()) {
-        DEBUG_PRINTLN("[Setup] WARNING: Buzzer circuit issues detected!");
-        DEBUG_PRINTLN(hardware.getStatusString());
-        // Continue anyway - user should run /test to verify
-    } else {
-        DEBUG_PRINTLN("[Setup] Hardware diagnostics passed");
-    }
+    // Physical buttons (events arrive in the alarm task)
+    hardware.setButtonCallback(handleButtonEvent);
+
+    bootTiming.mark(BOOT_PHASE_HARDWARE);
 
     // ---------------------------------------------------------------
-    // 3. INITIALIZE WIFI
+    // 3. INITIALIZE ALARM CONTROLLER
     // ---------------------------------------------------------------
-    DEBUG_PRINTLN("[Setup] Initializing WiFi...");
+    DEBUG_PRINTLN("[Setup] Initializing alarm controller...");
 
-    if (!wifiMgr.begin()) {
-        DEBUG_PRINTLN("[Setup] ERROR: WiFi initialization failed!");
+    if (!alarmController.begin()) {
+        DEBUG_PRINTLN("[Setup] ERROR: Alarm controller initialization failed!");
     }
 
-    // Set up WiFi callbacks
-    wifiMgr.onConnect([]() {
-        DEBUG_PRINTLN("[Setup] WiFi connected!");
-        hardware.setWiFiLED(true);  // Solid WiFi LED = connected
-    });
-
-    wifiMgr.onDisconnect([]() {
-        DEBUG_PRINTLN("[Setup] WiFi disconnected!");
-        hardware.blinkWiFiLED(LED_BLINK_FAST);  // Blinking WiFi LED = error
-    });
-
-    wifiMgr.onConfigPortalStart([]() {
-        DEBUG_PRINTLN("[Setup] Config portal started");
-        hardware.blinkWiFiLED(LED_BLINK_SLOW);  // Slow blink = setup mode
-    });
+    // Enable Telegram notifications for alarm events
+    alarmController.setTelegramNotificationsEnabled(true);
 
-    // Connect to WiFi (or start config portal if first time)
-    DEBUG_PRINTLN("[Setup] Connecting to WiFi...");
-    if (wifiMgr.connect(true)) {  // autoConnect = true
-        DEBUG_PRINTLN("[Setup] WiFi connection successful!");
-        DEBUG_PRINT("[Setup] IP Address: ");
-        DEBUG_PRINTLN(wifiMgr.getIPAddress());
-        DEBUG_PRINT("[Setup] SSID: ");
-        DEBUG_PRINTLN(wifiMgr.getSSID());
-    } else {
-        DEBUG_PRINTLN("[Setup] ERROR: WiFi connection failed!");
-        DEBUG_PRINTLN("[Setup] Device may not be fully functional");
-    }
+    // Enable hardware health checks during alarms
+    alarmController.setHardwareChecksEnabled(true);
 
     // ---------------------------------------------------------------
-    // 4. INITIALIZE TELEGRAM BOT
+    // 4. LOAD TELEGRAM BOT CONFIGURATION
     // ---------------------------------------------------------------
+    // Flash only - the bot goes online in bringUpNetwork()
     DEBUG_PRINTLN("[Setup] Initializing Telegram bot...");
 
-    // Try to load bot configuration from flash
     if (telegramBot.beginFromStorage()) {
         DEBUG_PRINTLN("[Setup] Telegram bot loaded from storage");
     } else {
@@ -171,266 +203,794 @@ void setup() {
     // Set up Telegram callbacks
     telegramBot.onOnline([]() {
         DEBUG_PRINTLN("[Setup] Telegram bot is online");
-        telegramBot.sendMessage(MSG_DEVICE_ONLINE);
+
+        // Mention what went wrong before the last restart (once)
+        String message = MSG_DEVICE_ONLINE;
+        String bootReport = stallWatchdog.getBootReport();
+        if (bootReport.length() > 0) {
+            message += "\n\n" + bootReport;
+        }
+
+        if (telegramBot.sendMessage(message)) {
+            stallWatchdog.clearBootReport();
+        }
     });
 
     telegramBot.onOffline([]() {
         DEBUG_PRINTLN("[Setup] Telegram bot went offline");
     });
 
-    telegramBot.onUnauthorizedAccess([](int64_t userId, String message) {
+    telegramBot.onUnauthorizedAccess([](int64_t userId, const char* message) {
         DEBUG_PRINTF("[Setup] Unauthorized access from user %lld: %s\n",
-                    userId, message.c_str());
+                    userId, message);
     });
 
-    // ---------------------------------------------------------------
-    // 5. INITIALIZE ALARM CONTROLLER
-    // ---------------------------------------------------------------
-    DEBUG_PRINTLN("[Setup] Initializing alarm controller...");
-
-    if (!alarmController.begin()) {
-        DEBUG_PRINTLN("[Setup] ERROR: Alarm controller initialization failed!");
-    }
-
-    // Enable Telegram notifications for alarm events
-    alarmController.setTelegramNotificationsEnabled(true);
+    // A waiting long poll must not hold back alarm notifications,
+    // MQTT commands, MQTT state updates or any network timer that is
+    // due (notification retries, live status, WiFi check). The poll
+    // timer itself is disarmed while it runs. The request stays open
+    // and the next poll goes on waiting for it
+    telegramBot.onLongPollInterrupt([]() {
+        return taskManager.hasPendingNotifications() ||
+               mqttControl.hasIncoming() ||
+               !mqttControl.isStateCurrent(alarmController.getState()) ||
+               networkScheduler.getTimeUntilNext() == 0;
+    });
 
-    // Enable hardware health checks during alarms
-    alarmController.setHardwareChecksEnabled(true);
+    // Optional MQTT command channel (off unless MQTT_BROKER_HOST is set)
+    mqttControl.begin();
 
-    // ---------------------------------------------------------------
-    // 6. REGISTER COMMAND HANDLERS
-    // ---------------------------------------------------------------
     DEBUG_PRINTLN("[Setup] Registering Telegram command handlers...");
     setupCommandHandlers();
 
     // ---------------------------------------------------------------
-    // 7. FINAL SETUP
+    // 5. SET UP WIFI CALLBACKS
     // ---------------------------------------------------------------
+    // These run on the network task, so LED changes are queued for
+    // the alarm task (which owns the hardware) instead of done here
+    wifiMgr.onConnect([]() {
+        DEBUG_PRINTLN("[Setup] WiFi connected!");
+        taskManager.postCommand(CMD_SET_WIFI_LED, 1);  // Solid WiFi LED = connected
+    });
+
+    wifiMgr.onDisconnect([]() {
+        DEBUG_PRINTLN("[Setup] WiFi disconnected!");
+        taskManager.postCommand(CMD_BLINK_WIFI_LED, LED_BLINK_FAST);  // Blinking = error
+    });
+
+    wifiMgr.onConfigPortalStart([]() {
+        DEBUG_PRINTLN("[Setup] Config portal started");
+        taskManager.postCommand(CMD_BLINK_WIFI_LED, LED_BLINK_SLOW);  // Slow blink = setup mode
+    });
+
+    // Register periodic work with the schedulers
+    // (the first network timer runs bringUpNetwork())
+    setupTimers();
 
-    // If Telegram is configured, mark all old messages as read
-    // (We don't want old /wake commands to trigger on boot!)
-    if (telegramBot.isConfigured()) {
-        DEBUG_PRINTLN("[Setup] Marking old Telegram messages as read...");
-        telegramBot.markAllRead();
+    // ---------------------------------------------------------------
+    // 6. START TASKS
+    // ---------------------------------------------------------------
+    // From here on, networkLoop() runs on core 0 and alarmLoop()
+    // runs on core 1. The Arduino loop() below is no longer used.
+    if (!taskManager.begin(networkLoop, alarmLoop)) {
+        DEBUG_PRINTLN("[Setup] FATAL ERROR: Could not start tasks!");
+        hardware.blinkStatusLED(LED_BLINK_FAST);
+        while (true) {
+            alarmScheduler.runDueTimers();
+            delay(10);
+        }
     }
 
-    // System is ready!
+    // Alarm is ready! Network continues in the background
     systemReady = true;
+    bootTiming.mark(BOOT_PHASE_ALARM_READY);
 
     DEBUG_PRINTLN("\n===============================================");
-    DEBUG_PRINTLN("           SYSTEM READY FOR USE               ");
+    DEBUG_PRINTLN("           ALARM READY FOR USE                ");
     DEBUG_PRINTLN("===============================================");
-    DEBUG_PRINTLN("[Setup] Send /wake via Telegram to test alarm");
     DEBUG_PRINTLN("[Setup] Press TEST button to test hardware");
+    DEBUG_PRINTLN("[Setup] WiFi and Telegram connecting in background...");
     DEBUG_PRINTLN("===============================================\n");
-
-    // Print initial status
-    printStatus();
 }
 
 // ===============================================================
-// MAIN LOOP
+// NETWORK BRING-UP (PHASE 2)
 // ===============================================================
-// Runs continuously after setup() completes
-//
-// This is the heart of the program - it keeps everything
-// running by calling update functions for each subsystem
-
-void loop() {
-    unsigned long currentTime = millis();
+// Runs once in the network task right after it starts. May block
+// for seconds (WiFi connect, TLS) or minutes (config portal) -
+// the alarm task is already running on the other core.
 
+void bringUpNetwork() {
     // ---------------------------------------------------------------
-    // 1. UPDATE HARDWARE
+    // 1. CONNECT WIFI
     // ---------------------------------------------------------------
-    // Update button states (debouncing) and LED blinking
-    hardware.updateButtons();
-    hardware.updateLEDs();
+    DEBUG_PRINTLN("[Boot] Initializing WiFi...");
 
-    // ---------------------------------------------------------------
-    // 2. HANDLE BUTTON PRESSES
-    // ---------------------------------------------------------------
-    handleButtons();
+    if (!wifiMgr.begin()) {
+        DEBUG_PRINTLN("[Boot] ERROR: WiFi initialization failed!");
+    }
+
+    // Connect to WiFi (or start config portal if first time)
+    DEBUG_PRINTLN("[Boot] Connecting to WiFi...");
+    if (wifiMgr.connect(true)) {  // autoConnect = true
+        bootTiming.mark(BOOT_PHASE_WIFI);
+        DEBUG_PRINT("[Boot] IP Address: ");
+        DEBUG_PRINTLN(wifiMgr.getIPAddress());
+        DEBUG_PRINT("[Boot] SSID: ");
+        DEBUG_PRINTLN(wifiMgr.getSSID());
+    } else {
+        DEBUG_PRINTLN("[Boot] ERROR: WiFi connection failed!");
+        DEBUG_PRINTLN("[Boot] Alarm works from buttons only until WiFi returns");
+    }
+
+    // Real time (UTC) for command latency statistics. Runs in the
+    // background and keeps retrying, also if WiFi comes up later
+    configTime(0, 0, NTP_SERVER);
 
     // ---------------------------------------------------------------
-    // 3. UPDATE ALARM STATE MACHINE
+    // 2. BRING TELEGRAM BOT ONLINE
     // ---------------------------------------------------------------
-    // CRITICAL: This must be called frequently for alarm timing
-    alarmController.update();
+    // Normally no request (cached username). If it fails, the poll
+    // timer retries.
+    if (wifiMgr.isConnected() && telegramBot.isConfigured()) {
+        if (telegramBot.connect()) {
+            bootTiming.mark(BOOT_PHASE_TELEGRAM);
+        }
+    }
 
     // ---------------------------------------------------------------
-    // 4. POLL TELEGRAM FOR MESSAGES
+    // 3. REPORT
     // ---------------------------------------------------------------
-    // Only poll if:
-    // - Bot is configured
-    // - WiFi is connected
-    // - Enough time has elapsed since last poll
-    if (telegramBot.isConfigured() &&
-        wifiMgr.isConnected() &&
-        currentTime - lastTelegramPoll >= TELEGRAM_POLL_INTERVAL_MS) {
+    DEBUG_PRINTLN("[Boot] Boot timing:");
+    DEBUG_PRINT(bootTiming.getReportString());
 
-        lastTelegramPoll = currentTime;
-        telegramBot.poll();
-    }
+    printStatus();
+}
+
+// ===============================================================
+// MAIN LOOP
+// ===============================================================
+// The Arduino loop() task is not needed any more - all work runs
+// in the two pinned tasks started at the end of setup().
+// Deleting it frees its stack (CONFIG_ARDUINO_LOOP_STACK_SIZE).
+
+void loop() {
+    vTaskDelete(NULL);
+}
+
+// ===============================================================
+// ALARM TASK LOOP (CORE 1)
+// ===============================================================
+// Called by the alarm task whenever it wakes up: either a deadline
+// in alarmScheduler is due, or the network task queued a command.
+//
+// Everything here is time-critical and must NEVER touch the network.
+// Anything that needs Telegram is put in the notification queue.
+//
+// RETURNS: How long the alarm task may sleep (milliseconds)
+
+unsigned long alarmLoop() {
+    // Heartbeat: one pass must finish within WATCHDOG_ALARM_BUDGET_MS
+    WatchdogSection section(WD_ALARM_TICK, "alarmLoop");
 
     // ---------------------------------------------------------------
-    // 5. MAINTAIN WIFI CONNECTION
+    // 1. HANDLE BUTTON EDGES
     // ---------------------------------------------------------------
-    // Periodically check WiFi status and reconnect if needed
-    if (currentTime - lastWiFiCheck >= WIFI_CHECK_INTERVAL_MS) {
-        lastWiFiCheck = currentTime;
-        checkWiFiStatus();
+    // Queued by the button interrupts, which also wake this task.
+    // Debounced events end up in handleButtonEvent()
+    {
+        PerfScope scope(PERF_BUTTON_EDGES);
+        hardware.processButtonEdges();
     }
 
     // ---------------------------------------------------------------
-    // 6. PERIODIC STATUS REPORTING
+    // 2. RUN COMMANDS FROM NETWORK TASK
     // ---------------------------------------------------------------
-    // Print system status to serial monitor for debugging
-    if (DEBUG_ENABLED && currentTime - lastStatusPrint >= STATUS_REPORT_INTERVAL_MS) {
-        lastStatusPrint = currentTime;
-        printStatus();
+    // /wake, /stop, /test and WiFi LED changes arrive here
+    {
+        PerfScope scope(PERF_ALARM_COMMANDS);
+        processAlarmCommands();
     }
 
     // ---------------------------------------------------------------
-    // 7. YIELD TO SYSTEM
+    // 3. RUN DUE TIMERS
     // ---------------------------------------------------------------
-    // Allow ESP32 to handle background tasks (WiFi, etc.)
-    // This prevents watchdog timer resets
-    yield();
-    delay(10);  // Small delay to prevent loop from running too fast
+    // Button debounce/long-press, LED blinking, buzzer pulse edges and
+    // alarm stage transitions (alarmController.update()) run from here
+    PerfScope scope(PERF_ALARM_TIMERS);
+    return alarmScheduler.runDueTimers();
 }
 
 // ===============================================================
-// COMMAND HANDLER REGISTRATION
+// NETWORK TASK LOOP (CORE 0)
 // ===============================================================
-// Register all Telegram command handlers
+// Called by the network task whenever it wakes up: either a deadline
+// in networkScheduler is due, or the alarm task queued a notification.
+//
+// Everything here may block for seconds (TLS, WiFi reconnect).
+// That is fine - the alarm task keeps running on the other core.
 //
-// Each command has a callback function that runs when
-// the user sends that command via Telegram
+// RETURNS: How long the network task may sleep (milliseconds)
 
-void setupCommandHandlers() {
+unsigned long networkLoop() {
     // ---------------------------------------------------------------
-    // /start - Welcome message
+    // 1. SEND QUEUED NOTIFICATIONS
     // ---------------------------------------------------------------
-    telegramBot.onCommand("/start", [](TelegramMessage msg) {
-        String welcome = "🔔 *WakeAssist Remote Alarm*\n\n";
-        welcome += "Available commands:\n";
-        welcome += "/wake - Start alarm sequence\n";
-        welcome += "/stop - Stop active alarm\n";
-        welcome += "/test - Test buzzer hardware\n";
-        welcome += "/status - Show device status\n";
-        welcome += "/help - Show this message\n";
+    // Stage changes, stop confirmations and test messages from the
+    // alarm task
+    {
+        PerfScope scope(PERF_NOTIFICATIONS);
+        sendQueuedNotifications();
+    }
 
-        telegramBot.sendMessage(welcome);
-    });
+    // ---------------------------------------------------------------
+    // 2. RUN DUE TIMERS
+    // ---------------------------------------------------------------
+    // Telegram polling, WiFi checks and status reports
+    return networkScheduler.runDueTimers();
+}
 
+// ===============================================================
+// TIMER REGISTRATION
+// ===============================================================
+// Register the periodic work that main.cpp owns. Each callback
+// re-arms its own timer, so the period starts after the work is
+// done (a slow Telegram request never causes back-to-back polls).
+
+void setupTimers() {
     // ---------------------------------------------------------------
-    // /wake - Start alarm
+    // NETWORK TASK: Boot phase 2 (runs once, right away)
     // ---------------------------------------------------------------
-    telegramBot.onCommand("/wake", [](TelegramMessage msg) {
-        // Check rate limit
-        if (telegramBot.isWakeRateLimited()) {
-            unsigned long remaining = telegramBot.getWakeCooldownRemaining();
-            char rateMsg[128];
-            snprintf(rateMsg, sizeof(rateMsg), MSG_RATE_LIMITED, remaining);
-            telegramBot.sendMessage(rateMsg);
-            return;
+    // Regular network work starts only after WiFi and Telegram had
+    // their first chance to come up
+    networkBootTimer = networkScheduler.createTimer("network_boot", []() {
+        bringUpNetwork();
+        networkScheduler.schedule(telegramPollTimer, TELEGRAM_POLL_INTERVAL_MS);
+        networkScheduler.schedule(wifiCheckTimer, WIFI_CHECK_INTERVAL_MS);
+        if (mqttControl.isEnabled()) {
+            networkScheduler.schedule(mqttTimer, 0);
         }
+    });
+    networkScheduler.schedule(networkBootTimer, 0);
 
-        // Check if alarm already active
-        if (alarmController.isActive()) {
-            telegramBot.sendMessage("⚠️ Alarm already active!");
-            return;
+    // ---------------------------------------------------------------
+    // NETWORK TASK: Poll Telegram for messages
+    // ---------------------------------------------------------------
+    // Only poll if bot is configured and WiFi is connected.
+    // Until the bot was online once, retry connect() instead. Old
+    // commands are skipped by the first polls (TELEGRAM_STALE_COMMAND_S).
+    //
+    // The gap to the next poll comes from pollPolicy: none while the
+    // alarm rings or right after a command, growing while idle (see
+    // poll_policy.h). After an error TELEGRAM_POLL_INTERVAL_MS is
+    // used, or longer while the circuit breaker is open or Telegram
+    // answered 429 (don't hammer a server that is down or busy).
+    // Queued notifications and due timers cut a waiting poll short;
+    // they run before the poll goes on (see isPollHeld()).
+    telegramPollTimer = networkScheduler.createTimer("telegram_poll", []() {
+        unsigned long nextPollMs = TELEGRAM_POLL_INTERVAL_MS;
+
+        if (telegramBot.isConfigured() && wifiMgr.isConnected()) {
+            PerfScope scope(PERF_TELEGRAM_POLL);
+
+            if (bootTiming.isDone(BOOT_PHASE_TELEGRAM)) {
+                pollPolicy.recordRequest();
+                if (telegramBot.poll() && telegramBot.getLastMessageDate() != 0) {
+                    pollPolicy.recordCommand(telegramBot.getLastMessageDate());
+                }
+                if (telegramBot.isOnline()) {
+                    nextPollMs = pollPolicy.getNextDelay(alarmController.isActive());
+                }
+                // Telegram unreachable (circuit breaker) or asked us to
+                // wait (429): sleep until the next try is allowed
+                if (telegramBot.getBackoffRemaining() > nextPollMs) {
+                    nextPollMs = telegramBot.getBackoffRemaining();
+                }
+                // Cut short for other work: go on waiting for the open
+                // request once the due timers ran (its answer may
+                // already be waiting)
+                if (telegramBot.isPollHeld()) {
+                    nextPollMs = 0;
+                }
+            } else if (telegramBot.connect()) {
+                bootTiming.mark(BOOT_PHASE_TELEGRAM);
+            }
         }
+        networkScheduler.schedule(telegramPollTimer, nextPollMs);
+    });
 
-        // Start alarm
-        if (alarmController.start()) {
-            telegramBot.resetWakeRateLimit();  // Start cooldown
-            DEBUG_PRINTLN("[Command] /wake - Alarm started");
-        } else {
-            telegramBot.sendMessage("❌ Failed to start alarm");
+    // ---------------------------------------------------------------
+    // NETWORK TASK: Maintain WiFi connection
+    // ---------------------------------------------------------------
+    wifiCheckTimer = networkScheduler.createTimer("wifi_check", []() {
+        {
+            PerfScope scope(PERF_WIFI_CHECK);
+            checkWiFiStatus();
         }
+        networkScheduler.schedule(wifiCheckTimer, WIFI_CHECK_INTERVAL_MS);
     });
 
     // ---------------------------------------------------------------
-    // /stop - Stop alarm
+    // NETWORK TASK: MQTT commands and alarm state
     // ---------------------------------------------------------------
-    telegramBot.onCommand("/stop", [](TelegramMessage msg) {
-        if (!alarmController.isActive()) {
-            telegramBot.sendMessage("ℹ️ No active alarm to stop");
-            return;
+    // Short interval: incoming commands don't wake the task, so this
+    // timer decides how fast they are seen (see mqtt_control.cpp)
+    mqttTimer = networkScheduler.createTimer("mqtt", []() {
+        if (wifiMgr.isConnected()) {
+            PerfScope scope(PERF_MQTT);
+            mqttControl.loop();
+
+            // Retained state follows every alarm state change
+            AlarmState state = alarmController.getState();
+            if (!mqttControl.isStateCurrent(state)) {
+                mqttControl.publishState(state, alarmController.getStateString().c_str());
+            }
         }
+        networkScheduler.schedule(mqttTimer, MQTT_LOOP_INTERVAL_MS);
+    });
 
-        if (alarmController.stop(STOP_TELEGRAM_COMMAND)) {
-            DEBUG_PRINTLN("[Command] /stop - Alarm stopped");
-            // Notification sent by alarm controller
-        } else {
-            telegramBot.sendMessage("❌ Failed to stop alarm");
-        }
+    // ---------------------------------------------------------------
+    // NETWORK TASK: Retry notifications that could not be sent
+    // ---------------------------------------------------------------
+    // Armed by sendQueuedNotifications() only while some are waiting
+    notifyRetryTimer = networkScheduler.createTimer("notify_retry", []() {
+        PerfScope scope(PERF_NOTIFICATIONS);
+        sendQueuedNotifications();
+    });
+
+    // ---------------------------------------------------------------
+    // NETWORK TASK: Send the throttled edit of the live status
+    // ---------------------------------------------------------------
+    // Armed by flushLiveStatus() while an update waits
+    liveStatusTimer = networkScheduler.createTimer("live_status", []() {
+        PerfScope scope(PERF_NOTIFICATIONS);
+        flushLiveStatus();
     });
 
     // ---------------------------------------------------------------
-    // /test - Test hardware
+    // ALARM TASK: Restart after a factory reset
     // ---------------------------------------------------------------
-    telegramBot.onCommand("/test", [](TelegramMessage msg) {
-        if (alarmController.isActive()) {
-            telegramBot.sendMessage("⚠️ Cannot test while alarm is active");
+    // Armed by handleButtonEvent() while the LEDs blink. Restarts
+    // only once the network task has cleared the settings (it may be
+    // busy with a request for a few seconds)
+    factoryResetTimer = alarmScheduler.createTimer("factory_reset", []() {
+        if (!factoryResetPosted) {
+            // Notification queue was full - ask again
+            factoryResetPosted = taskManager.postNotification("", NOTIFY_FACTORY_RESET);
+        }
+
+        if (!factoryResetCleared) {
+            alarmScheduler.schedule(factoryResetTimer, LED_BLINK_MEDIUM);
             return;
         }
 
-        DEBUG_PRINTLN("[Command] /test - Running hardware test");
-        alarmController.testAlarm();
+        DEBUG_PRINTLN("[Reset] Factory reset complete! Rebooting...");
+        ESP.restart();
+    });
+
+    // ---------------------------------------------------------------
+    // ALARM TASK: Start the alarm of a delayed /wake
+    // ---------------------------------------------------------------
+    // Armed by processAlarmCommands(), cancelled by /stop
+    delayedWakeTimer = alarmScheduler.createTimer("delayed_wake", []() {
+        DEBUG_PRINTLN("[Alarm] Delayed /wake is due");
+        if (!alarmController.start()) {
+            taskManager.postNotification("❌ Failed to start alarm");
+        }
     });
 
     // ---------------------------------------------------------------
-    // /status - Show system status
+    // NETWORK TASK: Periodic status reporting
     // ---------------------------------------------------------------
-    telegramBot.onCommand("/status", [](TelegramMessage msg) {
-        String status = "📊 *Device Status*\n\n";
+    if (DEBUG_ENABLED) {
+        statusPrintTimer = networkScheduler.createTimer("status_print", []() {
+            printStatus();
+            networkScheduler.schedule(statusPrintTimer, STATUS_REPORT_INTERVAL_MS);
+        });
+        networkScheduler.schedule(statusPrintTimer, STATUS_REPORT_INTERVAL_MS);
+    }
+}
 
-        // Uptime
-        unsigned long uptimeSeconds = (millis() - bootTime) / 1000;
-        unsigned long uptimeMinutes = uptimeSeconds / 60;
-        unsigned long uptimeHours = uptimeMinutes / 60;
-        status += "⏱ Uptime: " + String(uptimeHours) + "h " +
-                 String(uptimeMinutes % 60) + "m\n";
+// ===============================================================
+// TASK HAND-OFF HELPERS
+// ===============================================================
 
-        // WiFi status
-        status += "📡 WiFi: ";
-        if (wifiMgr.isConnected()) {
-            status += "Connected (" + wifiMgr.getSSID() + ")\n";
-            status += "   IP: " + wifiMgr.getIPAddress() + "\n";
-            status += "   Signal: " + String(wifiMgr.getRSSI()) + " dBm\n";
+// Run all commands queued by the network task (alarm task only)
+
+void processAlarmCommands() {
+    AlarmCommand command;
+
+    while (taskManager.getNextCommand(command)) {
+        switch (command.type) {
+            case CMD_START_ALARM:
+                if (command.arg > 0) {
+                    // "/wake 20": start later (replaces an earlier delay)
+                    alarmScheduler.schedule(delayedWakeTimer, command.arg);
+
+                    char text[NOTIFICATION_MAX_LENGTH];
+                    unsigned long seconds = command.arg / 1000;
+                    if (seconds < 120) {
+                        snprintf(text, sizeof(text),
+                                "⏳ Alarm starts in %lus. Send /stop to cancel.", seconds);
+                    } else {
+                        snprintf(text, sizeof(text),
+                                "⏳ Alarm starts in %lu min. Send /stop to cancel.",
+                                (seconds + 59) / 60);
+                    }
+                    taskManager.postNotification(text);
+                } else if (!alarmController.start()) {
+                    taskManager.postNotification("❌ Failed to start alarm");
+                }
+                break;
+
+            case CMD_STOP_ALARM:
+                // Also cancels a delayed /wake that has not started yet
+                if (alarmScheduler.isScheduled(delayedWakeTimer)) {
+                    alarmScheduler.cancel(delayedWakeTimer);
+                    taskManager.postNotification("🚫 Delayed alarm cancelled", NOTIFY_URGENT);
+
+                    if (!alarmController.isActive() && !alarmController.isTesting()) {
+                        break;
+                    }
+                }
+
+                if (!alarmController.stop((AlarmStopSource)command.arg)) {
+                    taskManager.postNotification("ℹ️ No active alarm to stop", NOTIFY_URGENT);
+                }
+                break;
+
+            case CMD_TEST_ALARM:
+                if (alarmController.isActive()) {
+                    taskManager.postNotification("⚠️ Cannot test while alarm is active");
+                } else if (!alarmController.testAlarm()) {
+                    taskManager.postNotification("⚠️ Test already running");
+                }
+                break;
+
+            case CMD_SET_WIFI_LED:
+                hardware.setWiFiLED(command.arg != 0);
+                break;
+
+            case CMD_BLINK_WIFI_LED:
+                hardware.blinkWiFiLED(command.arg);
+                break;
+
+            case CMD_FACTORY_RESET_DONE:
+                // factoryResetTimer restarts when the blinking is over
+                factoryResetCleared = true;
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+// Send all notifications queued by the alarm task (network task only)
+// They go through the outbox: urgent ones first, joined into as few
+// Telegram messages as possible, kept and retried if sending fails.
+// Alarm stage lines update the live status message instead
+
+void sendQueuedNotifications() {
+    TelegramNotification notification;
+    bool liveChanged = false;
+
+    while (taskManager.getNextNotification(notification)) {
+        if (notification.priority == NOTIFY_FACTORY_RESET) {
+            clearStoredSettings();
+        } else if (notification.priority == NOTIFY_LIVE_START ||
+            notification.priority == NOTIFY_LIVE ||
+            notification.priority == NOTIFY_LIVE_END) {
+            liveStatus.addLine(notification.text,
+                               (NotificationPriority)notification.priority);
+            liveChanged = true;
         } else {
-            status += "Disconnected\n";
+            notificationOutbox.add(notification);
         }
+    }
 
-        // Telegram status
-        status += "💬 Telegram: ";
-        status += telegramBot.isOnline() ? "Online\n" : "Offline\n";
+    if (liveChanged) {
+        flushLiveStatus();
+    }
 
-        // Alarm status
-        status += "🔔 Alarm: " + alarmController.getStateString() + "\n";
+    if (notificationOutbox.isEmpty()) {
+        return;
+    }
 
-        // Hardware status
-        HardwareState hwState = hardware.getState();
-        status += "🔧 Hardware:\n";
-        status += "   Small Buzzer: " +
-                 String(hwState.smallBuzzer == HW_STATUS_OK ? "OK" : "Issue") + "\n";
-        status += "   Large Buzzer: " +
-                 String(hwState.largeBuzzer == HW_STATUS_OK ? "OK" : "Issue") + "\n";
+    if (telegramBot.isOnline()) {
+        String text;
 
-        telegramBot.sendMessage(status);
-        DEBUG_PRINTLN("[Command] /status - Status sent");
-    });
+        while (notificationOutbox.buildBatch(text) > 0) {
+            if (!telegramBot.sendMessage(text)) {
+                break;  // Stays in the outbox
+            }
+            notificationOutbox.removeBatch();
+        }
 
-    // ---------------------------------------------------------------
-    // /help - Show help
-    // ---------------------------------------------------------------
-    telegramBot.onCommand("/help", [](TelegramMessage msg) {
-        // Same as /start
-        telegramBot.onCommand("/start", [](TelegramMessage msg) {});
-    });
+        if (notificationOutbox.isEmpty()) {
+            return;
+        }
+    } else {
+        DEBUG_PRINTLN("[Notify] Telegram bot offline - notifications kept for later");
+    }
+
+    scheduleNotificationRetry();
+}
+
+// Send the live status message if it changed, or arm liveStatusTimer
+// for when the throttle (or Telegram's rate limit) allows the edit
+
+void flushLiveStatus() {
+    if (liveStatus.flush()) {
+        return;
+    }
+
+    // Offline: try again like the outbox does
+    unsigned long delayMs = liveStatus.getDelayMs();
+    if (delayMs == 0) {
+        delayMs = NOTIFICATION_RETRY_MS;
+    }
+    networkScheduler.schedule(liveStatusTimer, delayMs);
+}
+
+// Arm the retry of the outbox: as soon as Telegram's rate limit lets
+// the next message out, or after NOTIFICATION_RETRY_MS if sending
+// failed for another reason (don't push an already armed retry
+// further out)
+
+void scheduleNotificationRetry() {
+    if (networkScheduler.isScheduled(notifyRetryTimer)) {
+        return;
+    }
+
+    unsigned long retryMs = telegramBot.getSendWaitMs();
+    if (retryMs == 0) {
+        retryMs = NOTIFICATION_RETRY_MS;
+    }
+    networkScheduler.schedule(notifyRetryTimer, retryMs);
+}
+
+// ===============================================================
+// TELEGRAM COMMAND HANDLERS
+// ===============================================================
+// One function per command, listed in COMMAND_TABLE below.
+// They run on the network task: anything that touches the alarm or
+// the buzzers is handed to the alarm task with postCommand().
+//
+// msg: The whole message, args: the words after the command
+// Answers go through sendReply(), back to where the command came from
+
+void sendReply(const TelegramMessage& msg, const String& text) {
+    if (msg.source == MESSAGE_FROM_MQTT) {
+        mqttControl.publishReply(text.c_str());
+        return;
+    }
+
+    if (telegramBot.sendMessage(text)) {
+        return;
+    }
+
+    // Rate limited (or the send failed): short answers wait in the
+    // outbox and go out with the next batch. Long reports (/status,
+    // /perf) don't fit - those can simply be asked for again
+    if (text.length() < NOTIFICATION_MAX_LENGTH) {
+        TelegramNotification notification;
+        strcpy(notification.text, text.c_str());
+        notification.priority = NOTIFY_URGENT;
+        notificationOutbox.add(notification);
+        scheduleNotificationRetry();
+    } else {
+        DEBUG_PRINTLN("[Telegram] Reply not sent (too long to keep)");
+    }
+}
+
+// ---------------------------------------------------------------
+// /start and /help - Welcome message with the command list
+// ---------------------------------------------------------------
+void handleHelpCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    String welcome = "🔔 *WakeAssist Remote Alarm*\n\n";
+    welcome += "Available commands:\n";
+    welcome += telegramBot.getCommandHelp();
+
+    sendReply(msg, welcome);
+}
+
+// ---------------------------------------------------------------
+// /wake [delay] - Start alarm, now or after a delay
+// ---------------------------------------------------------------
+// "/wake 20" = in 20 minutes, "/wake 90s", "/wake 2h" (see
+// WAKE_DELAY_MAX_MS). The alarm task keeps the delay, so a later
+// /stop can still cancel it.
+void handleWakeCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    unsigned long delayMs = 0;
+    if (args.count() > 0 &&
+        !args.getDuration(0, delayMs, WAKE_DELAY_DEFAULT_UNIT_MS, WAKE_DELAY_MAX_MS)) {
+        sendReply(msg, "⚠️ Usage: /wake [delay]\n"
+                               "Examples: /wake 20 (minutes), /wake 90s, /wake 2h (max 12h)");
+        return;
+    }
+
+    // Check rate limit
+    if (telegramBot.isWakeRateLimited()) {
+        unsigned long remaining = telegramBot.getWakeCooldownRemaining();
+        char rateMsg[128];
+        snprintf(rateMsg, sizeof(rateMsg), MSG_RATE_LIMITED, remaining);
+        sendReply(msg, rateMsg);
+        return;
+    }
+
+    // Check if alarm already active
+    if (alarmController.isActive()) {
+        sendReply(msg, "⚠️ Alarm already active!");
+        return;
+    }
+
+    // Hand the start over to the alarm task (arg = delay)
+    if (taskManager.postCommand(CMD_START_ALARM, delayMs)) {
+        telegramBot.resetWakeRateLimit();  // Start cooldown
+        DEBUG_PRINTF("[Command] /wake - Alarm start queued (delay %lu ms)\n", delayMs);
+    } else {
+        sendReply(msg, "❌ Failed to start alarm");
+    }
+}
+
+// ---------------------------------------------------------------
+// /stop - Stop alarm (or buzzer test, or a delayed /wake)
+// ---------------------------------------------------------------
+void handleStopCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    // Always handed over: only the alarm task knows about a delayed
+    // /wake. It answers "No active alarm" itself if nothing runs
+    // The STOP button under the live status counts separately (it
+    // shows how much the one-tap button is used)
+    AlarmStopSource source = (msg.source == MESSAGE_FROM_BUTTON) ?
+                             STOP_TELEGRAM_BUTTON : STOP_TELEGRAM_COMMAND;
+
+    if (taskManager.postCommand(CMD_STOP_ALARM, source)) {
+        DEBUG_PRINTLN("[Command] /stop - Alarm stop queued");
+        // Notification sent by alarm controller
+    } else {
+        sendReply(msg, "❌ Failed to stop alarm");
+    }
+}
+
+// ---------------------------------------------------------------
+// /test - Test hardware
+// ---------------------------------------------------------------
+void handleTestCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    if (alarmController.isActive()) {
+        sendReply(msg, "⚠️ Cannot test while alarm is active");
+        return;
+    }
+
+    DEBUG_PRINTLN("[Command] /test - Hardware test queued");
+    taskManager.postCommand(CMD_TEST_ALARM);
+}
+
+// ---------------------------------------------------------------
+// /status - Show system status
+// ---------------------------------------------------------------
+void handleStatusCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    String status = "📊 *Device Status*\n\n";
+
+    // Uptime
+    unsigned long uptimeSeconds = (millis() - bootTime) / 1000;
+    unsigned long uptimeMinutes = uptimeSeconds / 60;
+    unsigned long uptimeHours = uptimeMinutes / 60;
+    status += "⏱ Uptime: " + String(uptimeHours) + "h " +
+             String(uptimeMinutes % 60) + "m\n";
+
+    // WiFi status
+    status += "📡 WiFi: ";
+    if (wifiMgr.isConnected()) {
+        status += "Connected (" + wifiMgr.getSSID() + ")\n";
+        status += "   IP: " + wifiMgr.getIPAddress() + "\n";
+        status += "   Signal: " + String(wifiMgr.getRSSI()) + " dBm\n";
+    } else {
+        status += "Disconnected\n";
+    }
+
+    // Telegram status
+    status += "💬 Telegram: ";
+    status += telegramBot.isOnline() ? "Online\n" : "Offline\n";
+
+    // Alarm status
+    status += "🔔 Alarm: " + alarmController.getStateString() + "\n";
+
+    // Hardware status
+    HardwareState hwState = hardware.getState();
+    status += "🔧 Hardware:\n";
+    status += "   Small Buzzer: " +
+             String(hwState.smallBuzzer == HW_STATUS_OK ? "OK" : "Issue") + "\n";
+    status += "   Large Buzzer: " +
+             String(hwState.largeBuzzer == HW_STATUS_OK ? "OK" : "Issue") + "\n";
+
+    // Worst SILENCE press-to-silence time seen by the interrupt
+    if (hardware.getWorstSilenceMicros() > 0) {
+        status += "   Silence: worst " +
+                 String(hardware.getWorstSilenceMicros()) + " µs\n";
+    }
+
+    sendReply(msg, status);
+    DEBUG_PRINTLN("[Command] /status - Status sent");
+}
+
+// ---------------------------------------------------------------
+// /perf - Show timing histograms ("/perf reset" clears them)
+// ---------------------------------------------------------------
+void handlePerfCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    if (args.is(0, "reset")) {
+        perfStats.reset();
+        sendReply(msg, "🧹 Timing statistics cleared");
+        DEBUG_PRINTLN("[Command] /perf reset - Statistics cleared");
+        return;
+    }
+
+    // Code block keeps the columns aligned
+    String report = "⏱ *Timing (µs)*\n```\n";
+    report += perfStats.getReportString();
+    report += "```";
+
+    sendReply(msg, report);
+    DEBUG_PRINTLN("[Command] /perf - Report sent");
+}
+
+// ---------------------------------------------------------------
+// /boot - Show how long each boot phase took
+// ---------------------------------------------------------------
+void handleBootCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    // Code block keeps the columns aligned
+    String report = "🚀 *Boot timing*\n```\n";
+    report += bootTiming.getReportString();
+    report += "```";
+
+    sendReply(msg, report);
+    DEBUG_PRINTLN("[Command] /boot - Report sent");
+}
+
+// ---------------------------------------------------------------
+// /poll - Show poll cadence and requests/latency per hour
+// ---------------------------------------------------------------
+void handlePollCommand(const TelegramMessage& msg, const CommandArgs& args) {
+    // Code block keeps the columns aligned
+    String report = "📶 *Polling*\n```\n";
+    report += pollPolicy.getStatusString();
+    report += "\n\n";
+    report += pollPolicy.getReportString();
+    report += "```";
+
+    sendReply(msg, report);
+    DEBUG_PRINTLN("[Command] /poll - Report sent");
+}
+
+// ===============================================================
+// COMMAND TABLE
+// ===============================================================
+// Every Telegram command the bot understands, in the order /help
+// lists them. The table is constant (flash, built by the compiler),
+// so adding a command is just adding a line here.
+
+static constexpr TelegramCommand COMMAND_TABLE[] = {
+    TELEGRAM_COMMAND("/wake",   "[delay]", "Start alarm sequence (now or later)", handleWakeCommand),
+    TELEGRAM_COMMAND("/stop",   "",        "Stop active alarm",                  handleStopCommand),
+    TELEGRAM_COMMAND("/test",   "",        "Test buzzer hardware",               handleTestCommand),
+    TELEGRAM_COMMAND("/status", "",        "Show device status",                 handleStatusCommand),
+    TELEGRAM_COMMAND("/perf",   "[reset]", "Show timing statistics",             handlePerfCommand),
+    TELEGRAM_COMMAND("/boot",   "",        "Show boot timing",                   handleBootCommand),
+    TELEGRAM_COMMAND("/poll",   "",        "Show polling statistics",            handlePollCommand),
+    TELEGRAM_COMMAND("/start",  "",        "Show this message",                  handleHelpCommand),
+    TELEGRAM_COMMAND("/help",   "",        "Show this message",                  handleHelpCommand),
+};
+
+static const size_t COMMAND_COUNT = sizeof(COMMAND_TABLE) / sizeof(COMMAND_TABLE[0]);
+
+// A duplicate name would never be reached - fail the build instead
+static_assert(commandTableIsUnique(COMMAND_TABLE, COMMAND_COUNT),
+              "Two commands in COMMAND_TABLE have the same name (or hash)");
+
+void setupCommandHandlers() {
+    // Same handlers for both command channels
+    telegramBot.setCommandTable(COMMAND_TABLE, COMMAND_COUNT);
+    mqttControl.setCommandTable(COMMAND_TABLE, COMMAND_COUNT);
 
     DEBUG_PRINTLN("[Setup] Command handlers registered");
 }
@@ -438,80 +998,99 @@ void setupCommandHandlers() {
 // ===============================================================
 // BUTTON HANDLING
 // ===============================================================
-// Check for physical button presses and handle them
+// Called by hardware for every debounced button event
+// Runs in the alarm task and must return quickly (never wait for
+// the button to be released - a RELEASE event will follow)
+
+void handleButtonEvent(const ButtonEvent& event) {
+    PerfScope scope(PERF_BUTTON_EVENT);
+
+    // Time from the interrupt edge to handling it here
+    unsigned long latency = millis() - event.edgeTime;
 
-void handleButtons() {
     // ---------------------------------------------------------------
     // TEST BUTTON
     // ---------------------------------------------------------------
     // Pressing TEST button runs hardware test
-    if (hardware.isTestButtonPressed()) {
-        DEBUG_PRINTLN("[Button] TEST button pressed");
+    if (event.button == BUTTON_TEST && event.type == BUTTON_EVENT_PRESS) {
+        DEBUG_PRINTF("[Button] TEST button pressed (%lums after edge)\n", latency);
 
         if (!alarmController.isActive()) {
             alarmController.testAlarm();
         } else {
             DEBUG_PRINTLN("[Button] Cannot test - alarm active");
         }
-
-        // Wait for button release
-        while (hardware.isTestButtonPressed()) {
-            hardware.updateButtons();
-            delay(50);
-        }
     }
 
     // ---------------------------------------------------------------
     // SILENCE BUTTON
     // ---------------------------------------------------------------
     // Pressing SILENCE button stops active alarm
-    if (hardware.isSilenceButtonPressed()) {
-        DEBUG_PRINTLN("[Button] SILENCE button pressed");
+    if (event.button == BUTTON_SILENCE && event.type == BUTTON_EVENT_PRESS) {
+        DEBUG_PRINTF("[Button] SILENCE button pressed (%lums after edge)\n", latency);
 
-        if (alarmController.isActive()) {
+        // Also aborts a running buzzer test
+        if (alarmController.isActive() || alarmController.isTesting()) {
             alarmController.stop(STOP_SILENCE_BUTTON);
         }
-
-        // Wait for button release
-        while (hardware.isSilenceButtonPressed()) {
-            hardware.updateButtons();
-            delay(50);
-        }
     }
 
     // ---------------------------------------------------------------
     // RESET BUTTON (FACTORY RESET)
     // ---------------------------------------------------------------
     // Holding RESET button for 10 seconds triggers factory reset
-    if (hardware.isFactoryResetRequested()) {
+    //
+    // WiFi and flash belong to the network task, so it does the
+    // clearing (NOTIFY_FACTORY_RESET). This task only blinks the LEDs
+    // and restarts from factoryResetTimer - no delay() here
+    if (event.button == BUTTON_RESET && event.type == BUTTON_EVENT_LONG_PRESS &&
+        !alarmScheduler.isScheduled(factoryResetTimer)) {
         DEBUG_PRINTLN("[Button] FACTORY RESET triggered!");
 
-        // Stop alarm if active
-        if (alarmController.isActive()) {
+        // Stop alarm (or buzzer test) if running
+        if (alarmController.isActive() || alarmController.isTesting()) {
             alarmController.stop(STOP_SILENCE_BUTTON);
         }
 
-        // Clear all stored data
-        DEBUG_PRINTLN("[Reset] Clearing WiFi credentials...");
-        wifiMgr.clearCredentials();
+        factoryResetPosted = taskManager.postNotification("", NOTIFY_FACTORY_RESET);
+        factoryResetCleared = false;
 
-        DEBUG_PRINTLN("[Reset] Clearing Telegram configuration...");
-        // Note: Need to add clearConfiguration() method to TelegramBot class
+        // Blink all LEDs to indicate reset
+        hardware.blinkStatusLED(LED_BLINK_MEDIUM);
+        hardware.blinkWiFiLED(LED_BLINK_MEDIUM);
+        hardware.blinkAlarmLED(LED_BLINK_MEDIUM);
 
-        DEBUG_PRINTLN("[Reset] Factory reset complete!");
-        DEBUG_PRINTLN("[Reset] Rebooting in 3 seconds...");
+        DEBUG_PRINTF("[Reset] Rebooting in %d seconds...\n", FACTORY_RESET_REBOOT_MS / 1000);
+        alarmScheduler.schedule(factoryResetTimer, FACTORY_RESET_REBOOT_MS);
+    }
+}
 
-        // Blink all LEDs to indicate reset
-        for (int i = 0; i < 6; i++) {
-            hardware.setStatusLED(i % 2 == 0);
-            hardware.setWiFiLED(i % 2 == 0);
-            hardware.setAlarmLED(i % 2 == 0);
-            delay(500);
-        }
+// ===============================================================
+// FACTORY RESET
+// ===============================================================
+// Network task part of a factory reset (RESET button held, see
+// handleButtonEvent). The alarm task restarts once this is done
 
-        // Reboot device
-        ESP.restart();
+void clearStoredSettings() {
+    DEBUG_PRINTLN("[Reset] Clearing WiFi credentials...");
+    wifiMgr.clearCredentials();
+
+    DEBUG_PRINTLN("[Reset] Clearing Telegram configuration...");
+    telegramBot.clearConfiguration();
+
+    // The alarm task waits for this before it restarts, so it must
+    // not get lost in a full queue
+    for (int attempt = 0; attempt < FACTORY_RESET_DONE_TRIES; attempt++) {
+        if (taskManager.postCommand(CMD_FACTORY_RESET_DONE)) {
+            return;
+        }
+        delay(FACTORY_RESET_DONE_RETRY_MS);
     }
+
+    // Alarm task not taking commands: settings are gone anyway, so
+    // finish the reset from here rather than blink forever
+    DEBUG_PRINTLN("[Reset] ERROR: Alarm task did not answer - rebooting now");
+    ESP.restart();
 }
 
 // ===============================================================
@@ -530,20 +1109,24 @@ void checkWiFiStatus() {
         // Connection lost
         DEBUG_PRINTLN("[WiFi] Connection lost!");
 
-        // If alarm is active, send notification via Telegram (if still possible)
+        // If alarm is active, add it to the live status (sent once
+        // the connection is back)
         if (alarmController.isActive() && telegramBot.isConfigured()) {
-            telegramBot.sendMessage(MSG_ERROR_WIFI_LOST);
+            liveStatus.addLine(MSG_ERROR_WIFI_LOST, NOTIFY_LIVE);
+            flushLiveStatus();
         }
     } else if (!wasConnected && isConnected) {
-        // Connection restored
+        // Connection restored (or first connection if boot failed)
         DEBUG_PRINTLN("[WiFi] Connection restored!");
+        bootTiming.mark(BOOT_PHASE_WIFI);
 
         // Send notification
         if (alarmController.isActive() && telegramBot.isConfigured()) {
             char msg[128];
             snprintf(msg, sizeof(msg), MSG_ERROR_WIFI_RESTORED,
                     alarmController.getStateString().c_str());
-            telegramBot.sendMessage(msg);
+            liveStatus.addLine(msg, NOTIFY_LIVE);
+            flushLiveStatus();
         }
     }
 }
@@ -567,6 +1150,8 @@ void printStatus() {
 
     // Telegram status
     DEBUG_PRINTLN(telegramBot.getStatusString());
+    DEBUG_PRINTLN(mqttControl.getStatusString());
+    DEBUG_PRINTLN(pollPolicy.getStatusString());
 
     // Alarm status
     DEBUG_PRINTF("Alarm State: %s\n", alarmController.getStateString().c_str());
@@ -574,31 +1159,69 @@ void printStatus() {
     // Hardware status
     DEBUG_PRINTLN(hardware.getStatusString());
 
+    // Task and queue status
+    DEBUG_PRINTLN(taskManager.getStatusString());
+    DEBUG_PRINTLN(notificationOutbox.getStatusString());
+    DEBUG_PRINTLN(liveStatus.getStatusString());
+    printSchedulerStatus("alarm", alarmScheduler);
+    printSchedulerStatus("network", networkScheduler);
+    DEBUG_PRINTLN(stallWatchdog.getStatusString());
+
+    // Timing histograms (same as /perf)
+    DEBUG_PRINT(perfStats.getReportString());
+
     // Memory info
     DEBUG_PRINTF("Free Heap: %u bytes\n", ESP.getFreeHeap());
 
     DEBUG_PRINTLN("===============================================\n");
 }
 
+// One line per scheduler: armed timers, wakeups, callbacks, next timer
+void printSchedulerStatus(const char* name, const Scheduler& scheduler) {
+    DEBUG_PRINTF("[Scheduler] %s: Armed: %d/%d, Wakeups: %u, Callbacks: %u",
+                 name, scheduler.getArmedCount(), scheduler.getTimerCount(),
+                 scheduler.getWakeupCount(), scheduler.getCallbackCount());
+
+    const char* next = scheduler.getNextTimerName();
+    if (next != nullptr) {
+        DEBUG_PRINTF(", Next: '%s' in %lums", next, scheduler.getTimeUntilNext());
+    }
+    DEBUG_PRINTLN("");
+}
+
 /*
  * ===============================================================
  * PROGRAM FLOW SUMMARY:
  * ===============================================================
  *
- * STARTUP (setup() function):
+ * STARTUP (setup() function, no network):
  * 1. Serial communication starts (115200 baud)
- * 2. Hardware initialized (GPIO pins, PWM channels)
- * 3. WiFi connects (or starts config portal if first time)
- * 4. Telegram bot loads configuration from flash
+ * 2. Hardware initialized (GPIO pins, PWM channels, buttons)
+ * 3. Alarm controller initialized
+ * 4. Telegram bot loads configuration (and cached username) from flash
  * 5. Command handlers registered (/wake, /test, /status, etc.)
- * 6. Old messages marked as read (prevent accidental triggers)
- * 7. System enters main loop
+ * 6. Network and alarm tasks start, Arduino loop() deletes itself
+ *    -> buttons and buzzers work from here ("alarm ready")
+ *
+ * NETWORK BRING-UP (bringUpNetwork(), network task):
+ * 1. WiFi connects (or starts config portal if first time)
+ * 2. Telegram bot goes online, resumes from the saved update position
+ * 3. Boot timing report printed (also available via /boot)
+ *
+ * ALARM TASK (alarmLoop(), core 1):
+ * - Sleeps until the next alarmScheduler deadline, a queued command
+ *   or a button interrupt
+ * - Turns button edges into debounced press/release/long-press events
+ * - Toggles LEDs and buzzer pulse exactly at their edges
+ * - Runs /wake, /stop, /test commands queued by the network task
+ * - Updates alarm state machine when a stage deadline is due
  *
- * MAIN LOOP (loop() function):
- * - Runs continuously, ~100 times per second
- * - Updates hardware (buttons, LEDs) every cycle
- * - Polls Telegram every 5 seconds
- * - Updates alarm state machine every cycle
+ * NETWORK TASK (networkLoop(), core 0):
+ * - Sleeps until the next networkScheduler deadline or a notification
+ * - Sends notifications queued by the alarm task (urgent first,
+ *   joined into one message, kept and retried while offline)
+ * - Long-polls Telegram (a command arrives within a fraction of a
+ *   second; queued notifications cut the wait short)
  * - Checks WiFi connection every 30 seconds
  * - Prints status every 60 seconds (if DEBUG_ENABLED)
  *
@@ -0,0 +1,297 @@
+/*
+ * ===============================================================
+ * WakeAssist - MQTT Control Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the MQTT command channel declared in
+ * mqtt_control.h
+ *
+ * KEY CONCEPTS:
+ * - PubSubClient does the MQTT protocol (CONNECT, SUBSCRIBE,
+ *   PUBLISH, PUBACK for QoS 1, PINGREQ)
+ * - A received command is turned into a TelegramMessage with
+ *   source MESSAGE_FROM_MQTT and dispatched through the same
+ *   command table, so there is only one set of handlers
+ * - Reconnects are spaced MQTT_RECONNECT_MS apart, so a broker that
+ *   is down costs one short connect attempt now and then
+ *
+ * ===============================================================
+ */
+
+#include "mqtt_control.h"
+#include "telegram_bot.h"
+
+// The broker drops us after 1.5 keep-alives without a packet, and
+// nothing is sent while a Telegram long poll waits
+static_assert(MQTT_KEEPALIVE_S > TELEGRAM_LONG_POLL_TIMEOUT_S,
+              "MQTT_KEEPALIVE_S must be longer than TELEGRAM_LONG_POLL_TIMEOUT_S");
+
+// ===============================================================
+// GLOBAL MQTT INSTANCE
+// ===============================================================
+
+MqttControl mqttControl;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+MqttControl::MqttControl() : mqtt(netClient) {
+    enabled = false;
+    clientId[0] = '\0';
+    topicCommand[0] = '\0';
+    topicReply[0] = '\0';
+    topicState[0] = '\0';
+    topicOnline[0] = '\0';
+    commandTable = nullptr;
+    commandCount = 0;
+    wasConnected = false;
+    everConnected = false;
+    lastConnectAttempt = 0;
+    publishedState = -1;
+    commandsReceived = 0;
+    reconnects = 0;
+}
+
+// ===============================================================
+// INITIALIZATION
+// ===============================================================
+
+bool MqttControl::begin() {
+    if (strlen(MQTT_BROKER_HOST) == 0) {
+        DEBUG_PRINTLN("[MQTT] No broker configured - MQTT off");
+        enabled = false;
+        return false;
+    }
+
+    // Device ID from the chip ID (same digits as the setup WiFi name)
+    uint32_t chipId = 0;
+    for (int i = 0; i < 17; i = i + 8) {
+        chipId |= ((ESP.getEfuseMac() >> (40 - i)) & 0xff) << i;
+    }
+    char deviceId[8];
+    snprintf(deviceId, sizeof(deviceId), "%06X", (unsigned)(chipId & 0xFFFFFF));
+
+    snprintf(clientId, sizeof(clientId), "WakeAssist-%s", deviceId);
+    snprintf(topicCommand, sizeof(topicCommand), "%s/%s/cmd", MQTT_TOPIC_PREFIX, deviceId);
+    snprintf(topicReply, sizeof(topicReply), "%s/%s/reply", MQTT_TOPIC_PREFIX, deviceId);
+    snprintf(topicState, sizeof(topicState), "%s/%s/state", MQTT_TOPIC_PREFIX, deviceId);
+    snprintf(topicOnline, sizeof(topicOnline), "%s/%s/online", MQTT_TOPIC_PREFIX, deviceId);
+
+    mqtt.setServer(MQTT_BROKER_HOST, MQTT_BROKER_PORT);
+    mqtt.setKeepAlive(MQTT_KEEPALIVE_S);
+    mqtt.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S);
+    mqtt.setBufferSize(MQTT_BUFFER_BYTES);
+    mqtt.setCallback([this](char* topic, uint8_t* payload, unsigned int length) {
+        handleMessage(topic, payload, length);
+    });
+
+    enabled = true;
+
+    DEBUG_PRINTF("[MQTT] Broker %s:%d, commands on %s\n",
+                MQTT_BROKER_HOST, MQTT_BROKER_PORT, topicCommand);
+    return true;
+}
+
+bool MqttControl::isEnabled() const {
+    return enabled;
+}
+
+void MqttControl::setCommandTable(const TelegramCommand* table, size_t count) {
+    commandTable = table;
+    commandCount = count;
+}
+
+// ===============================================================
+// RUNNING
+// ===============================================================
+
+void MqttControl::loop() {
+    if (!enabled) {
+        return;
+    }
+
+    if (mqtt.connected()) {
+        mqtt.loop();
+        return;
+    }
+
+    if (wasConnected) {
+        DEBUG_PRINTF("[MQTT] Connection lost (state %d)\n", mqtt.state());
+        wasConnected = false;
+    }
+
+    // Space out the attempts (a broker that is down must not cost
+    // a connect timeout on every loop)
+    if (lastConnectAttempt != 0 && millis() - lastConnectAttempt < MQTT_RECONNECT_MS) {
+        return;
+    }
+    lastConnectAttempt = millis();
+
+    connect();
+}
+
+bool MqttControl::hasIncoming() {
+    return enabled && netClient.connected() && netClient.available() > 0;
+}
+
+// ===============================================================
+// PUBLISHING
+// ===============================================================
+
+bool MqttControl::isStateCurrent(int state) const {
+    // Nothing to publish while there is no connection
+    return !enabled || !wasConnected || state == publishedState;
+}
+
+bool MqttControl::publishState(int state, const char* text) {
+    if (!enabled || !mqtt.connected()) {
+        return false;
+    }
+
+    if (!mqtt.publish(topicState, text, true)) {
+        return false;
+    }
+
+    publishedState = state;
+    DEBUG_PRINTF("[MQTT] State: %s\n", text);
+    return true;
+}
+
+bool MqttControl::publishReply(const char* text) {
+    if (!enabled || !mqtt.connected()) {
+        return false;
+    }
+    return mqtt.publish(topicReply, text, false);
+}
+
+// ===============================================================
+// STATUS & INFORMATION
+// ===============================================================
+
+bool MqttControl::isConnected() {
+    return enabled && mqtt.connected();
+}
+
+String MqttControl::getStatusString() {
+    if (!enabled) {
+        return "[MQTT] Off";
+    }
+
+    String result = "[MQTT] ";
+    result += mqtt.connected() ? "Connected to " : "Disconnected from ";
+    result += String(MQTT_BROKER_HOST) + ":" + String(MQTT_BROKER_PORT);
+    result += ", Commands: " + String(commandsReceived);
+    result += ", Reconnects: " + String(reconnects);
+    return result;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+bool MqttControl::connect() {
+    DEBUG_PRINTF("[MQTT] Connecting to %s:%d...\n", MQTT_BROKER_HOST, MQTT_BROKER_PORT);
+
+    const char* username = (strlen(MQTT_USERNAME) > 0) ? MQTT_USERNAME : nullptr;
+    const char* password = (strlen(MQTT_USERNAME) > 0) ? MQTT_PASSWORD : nullptr;
+
+    // Last will: the broker publishes "offline" (retained) if we
+    // vanish without disconnecting. Clean session: commands sent
+    // while we were offline are NOT delivered later (a /wake from
+    // hours ago should not ring now)
+    if (!mqtt.connect(clientId, username, password,
+                      topicOnline, 1, true, "offline", true)) {
+        DEBUG_PRINTF("[MQTT] Connect failed (state %d)\n", mqtt.state());
+        return false;
+    }
+
+    // Commands are single small packets - send answers right away
+    netClient.setNoDelay(true);
+
+    mqtt.publish(topicOnline, "online", true);
+
+    if (!mqtt.subscribe(topicCommand, 1)) {
+        DEBUG_PRINTLN("[MQTT] ERROR: Subscribe failed");
+        mqtt.disconnect();
+        return false;
+    }
+
+    // New connection: publish the state again
+    publishedState = -1;
+
+    if (everConnected) {
+        reconnects++;
+    }
+    everConnected = true;
+    wasConnected = true;
+
+    DEBUG_PRINTLN("[MQTT] Connected");
+    return true;
+}
+
+void MqttControl::handleMessage(const char* topic, const uint8_t* payload,
+                                unsigned int length) {
+    if (strcmp(topic, topicCommand) != 0) {
+        return;
+    }
+
+    // Copy first: topic and payload live in PubSubClient's buffer,
+    // which the reply (a publish) overwrites
+    char text[TELEGRAM_TEXT_MAX_BYTES];
+    TelegramMessage message;
+    memset(&message, 0, sizeof(message));
+    message.text = text;
+    message.username = "mqtt";
+    message.source = MESSAGE_FROM_MQTT;
+
+    // "status" works as well as "/status"
+    size_t offset = 0;
+    if (length == 0 || payload[0] != '/') {
+        text[0] = '/';
+        offset = 1;
+    }
+
+    size_t copyLength = length;
+    if (offset + copyLength > sizeof(text) - 1) {
+        copyLength = sizeof(text) - 1 - offset;
+        message.textTruncated = true;
+    }
+    memcpy(text + offset, payload, copyLength);
+    text[offset + copyLength] = '\0';
+
+    commandsReceived++;
+    DEBUG_PRINTF("[MQTT] Command: %s\n", text);
+
+    // No bot name here: "/status@AnyBot" runs too
+    if (dispatchCommand(commandTable, commandCount, message, "") == DISPATCH_UNKNOWN) {
+        publishReply("❓ Unknown command. Send /help for the list of commands.");
+    }
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. HOW FAST DOES A COMMAND ARRIVE?
+ *    The network task checks the connection every
+ *    MQTT_LOOP_INTERVAL_MS (20 ms). While it waits in a Telegram
+ *    long poll, the poll is cut short (checked every
+ *    TELEGRAM_LONG_POLL_CHECK_MS) as soon as an MQTT packet is
+ *    waiting. Either way the handler runs well within 100 ms of the
+ *    broker forwarding the command. The /perf "mqtt" row shows how
+ *    long handling took.
+ *
+ * 2. WHY NO TLS?
+ *    This channel is meant for a broker on the same network. Plain
+ *    TCP keeps the connection cheap; the broker's login and ACLs
+ *    decide who may send commands.
+ *
+ * 3. WHY QoS 1 ONLY FOR COMMANDS?
+ *    A lost /stop matters, so commands are acknowledged. State and
+ *    replies are sent with QoS 0: the state is retained and sent
+ *    again after every reconnect anyway.
+ *
+ * ===============================================================
+ */
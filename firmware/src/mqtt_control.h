@@ -0,0 +1,184 @@
+/*
+ * ===============================================================
+ * WakeAssist - MQTT Control Module (Header File)
+ * ===============================================================
+ *
+ * This module is an optional second command channel next to the
+ * Telegram bot, for a MQTT broker (e.g. Mosquitto) on your own
+ * network:
+ * - One connection that stays open (no polling)
+ * - Commands arrive on a QoS 1 topic and run the same handlers as
+ *   Telegram commands (the command table from setupCommandHandlers)
+ * - The alarm state is published as a retained message, so a new
+ *   subscriber sees it at once
+ * - The broker publishes "offline" for us if the device disappears
+ *   (last will)
+ *
+ * TOPICS (<id> = last 6 hex digits of the chip ID):
+ *   wakeassist/<id>/cmd     <- "/wake 20", "/stop", "status" (QoS 1)
+ *   wakeassist/<id>/reply   -> answers of the command handlers
+ *   wakeassist/<id>/state   -> "Idle", "Warning", ... (retained)
+ *   wakeassist/<id>/online  -> "online" / "offline" (retained, last will)
+ *
+ * SECURITY:
+ * Anyone who can publish to the cmd topic can start the alarm, and
+ * there is no Telegram user ID to check. Use broker logins (MQTT_USERNAME)
+ * and an ACL that limits who may write the topic.
+ *
+ * Off unless MQTT_BROKER_HOST is set in config.h.
+ *
+ * ===============================================================
+ */
+
+#ifndef MQTT_CONTROL_H
+#define MQTT_CONTROL_H
+
+#include <Arduino.h>
+#include <WiFi.h>               // WiFiClient (plain TCP, local network)
+#include <PubSubClient.h>       // MQTT 3.1.1 client
+#include "config.h"
+#include "command_table.h"
+
+// ===============================================================
+// MQTT CONTROL CLASS
+// ===============================================================
+// Network task only (no locking)
+
+class MqttControl {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    MqttControl();
+
+    // ---------------------------------------------------------------
+    // INITIALIZATION
+    // ---------------------------------------------------------------
+
+    // Prepare client and topic names (no network yet)
+    // RETURNS: true if MQTT is configured, false if it stays off
+    bool begin();
+
+    // Check if MQTT is configured (MQTT_BROKER_HOST not empty)
+    bool isEnabled() const;
+
+    // Set the command table (the same one the Telegram bot uses)
+    void setCommandTable(const TelegramCommand* table, size_t count);
+
+    // ---------------------------------------------------------------
+    // RUNNING
+    // ---------------------------------------------------------------
+
+    // Receive commands, send keep-alives, reconnect if needed
+    // Call every MQTT_LOOP_INTERVAL_MS while WiFi is connected.
+    // Received commands run their handler from inside this call
+    void loop();
+
+    // Check if a packet is waiting on the connection
+    // Used to cut a Telegram long poll short, so commands are not
+    // held back until it ends
+    bool hasIncoming();
+
+    // ---------------------------------------------------------------
+    // PUBLISHING
+    // ---------------------------------------------------------------
+
+    // Check if state was the last state published (and still valid
+    // on this connection). Lets the caller skip building the text.
+    // Also true while disconnected (the state is sent on connect)
+    bool isStateCurrent(int state) const;
+
+    // Publish the alarm state (retained)
+    // state: AlarmState value, text: its name
+    // RETURNS: true if published
+    bool publishState(int state, const char* text);
+
+    // Publish the answer to an MQTT command
+    // RETURNS: true if published
+    bool publishReply(const char* text);
+
+    // ---------------------------------------------------------------
+    // STATUS & INFORMATION
+    // ---------------------------------------------------------------
+
+    // Check if connected to the broker
+    bool isConnected();
+
+    // Get human-readable status string
+    // RETURNS: String like "[MQTT] Connected to 192.168.1.10:1883, Commands: 3, Reconnects: 0"
+    String getStatusString();
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    WiFiClient netClient;
+    PubSubClient mqtt;
+    bool enabled;
+
+    // Topic names and client ID, built once in begin()
+    char clientId[24];
+    char topicCommand[MQTT_TOPIC_MAX_BYTES];
+    char topicReply[MQTT_TOPIC_MAX_BYTES];
+    char topicState[MQTT_TOPIC_MAX_BYTES];
+    char topicOnline[MQTT_TOPIC_MAX_BYTES];
+
+    // Command table (see setCommandTable)
+    const TelegramCommand* commandTable;
+    size_t commandCount;
+
+    // Connection tracking
+    bool wasConnected;            // Connected at the last loop()
+    bool everConnected;           // Connected at least once (for reconnects)
+    unsigned long lastConnectAttempt;
+
+    // Last published state, -1 = none on this connection
+    int publishedState;
+
+    // Statistics
+    uint32_t commandsReceived;
+    uint32_t reconnects;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Connect, announce "online" and subscribe to the command topic
+    // RETURNS: true if connected
+    bool connect();
+
+    // Called by PubSubClient for every received message
+    void handleMessage(const char* topic, const uint8_t* payload, unsigned int length);
+};
+
+// ===============================================================
+// GLOBAL MQTT INSTANCE
+// ===============================================================
+
+extern MqttControl mqttControl;
+
+#endif // MQTT_CONTROL_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * // setup():
+ * mqttControl.begin();
+ * mqttControl.setCommandTable(COMMAND_TABLE, COMMAND_COUNT);
+ *
+ * // Network task, every MQTT_LOOP_INTERVAL_MS:
+ * mqttControl.loop();
+ * if (!mqttControl.isStateCurrent(alarmController.getState())) {
+ *     mqttControl.publishState(alarmController.getState(),
+ *                              alarmController.getStateString().c_str());
+ * }
+ *
+ * // Try it from a Linux PC with Mosquitto:
+ * //   mosquitto_sub -h 192.168.1.10 -t 'wakeassist/#' -v
+ * //   mosquitto_pub -h 192.168.1.10 -q 1 -t wakeassist/A3B5C7/cmd -m '/wake'
+ *
+ * ===============================================================
+ */
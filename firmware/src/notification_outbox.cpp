@@ -0,0 +1,202 @@
+/*
+ * ===============================================================
+ * WakeAssist - Notification Outbox Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the prioritized, coalescing outbox declared
+ * in notification_outbox.h
+ *
+ * KEY CONCEPTS:
+ * - entries[] is kept in arrival order. Priority only decides the
+ *   order inside a batch and what is dropped when full, so messages
+ *   of the same priority never swap places
+ * - A batch is built first and removed only after the send worked,
+ *   so a failed send loses nothing
+ * - The array is small (16), so removing by moving the rest up is
+ *   cheaper and simpler than a linked structure
+ *
+ * ===============================================================
+ */
+
+#include "notification_outbox.h"
+
+// Separator between joined notifications (blank line)
+#define OUTBOX_SEPARATOR "\n\n"
+
+// batchMask has one bit per entry
+static_assert(NOTIFICATION_OUTBOX_SIZE <= 32, "NOTIFICATION_OUTBOX_SIZE must be <= 32");
+
+// ===============================================================
+// GLOBAL OUTBOX INSTANCE
+// ===============================================================
+
+NotificationOutbox notificationOutbox;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+NotificationOutbox::NotificationOutbox() {
+    count = 0;
+    batchMask = 0;
+    batchCount = 0;
+    sentNotifications = 0;
+    sentMessages = 0;
+    droppedNotifications = 0;
+}
+
+// ===============================================================
+// ADDING
+// ===============================================================
+
+bool NotificationOutbox::add(const TelegramNotification& notification) {
+    if (count >= NOTIFICATION_OUTBOX_SIZE) {
+        // Make room: stage chatter goes before any urgent message
+        int victim = findOldest(NOTIFY_NORMAL);
+
+        if (victim < 0) {
+            if (notification.priority != NOTIFY_URGENT) {
+                droppedNotifications++;
+                DEBUG_PRINTF("[Outbox] WARNING: Full of urgent messages, dropping: %s\n",
+                            notification.text);
+                return false;
+            }
+            victim = 0;  // Oldest urgent message
+        }
+
+        DEBUG_PRINTF("[Outbox] WARNING: Full, dropping: %s\n", entries[victim].text);
+        removeAt(victim);
+        droppedNotifications++;
+    }
+
+    entries[count] = notification;
+    count++;
+
+    return true;
+}
+
+// ===============================================================
+// SENDING
+// ===============================================================
+
+int NotificationOutbox::buildBatch(String& text) {
+    text = "";
+    batchMask = 0;
+    batchCount = 0;
+
+    // Urgent messages first, then normal ones (each oldest first)
+    const NotificationPriority order[] = { NOTIFY_URGENT, NOTIFY_NORMAL };
+
+    for (NotificationPriority priority : order) {
+        for (int i = 0; i < count; i++) {
+            if (entries[i].priority != priority) {
+                continue;
+            }
+
+            size_t length = strlen(entries[i].text);
+            size_t needed = (batchCount > 0) ? length + strlen(OUTBOX_SEPARATOR) : length;
+
+            // Full: the rest goes in the next batch (the first message
+            // always fits, NOTIFICATION_MAX_LENGTH is much smaller)
+            if (batchCount > 0 && text.length() + needed > NOTIFICATION_BATCH_MAX_BYTES) {
+                return batchCount;
+            }
+
+            if (batchCount > 0) {
+                text += OUTBOX_SEPARATOR;
+            }
+            text += entries[i].text;
+
+            batchMask |= (1UL << i);
+            batchCount++;
+        }
+    }
+
+    return batchCount;
+}
+
+void NotificationOutbox::removeBatch() {
+    // removeAt() forgets the batch, so take it first
+    uint32_t mask = batchMask;
+    int sent = batchCount;
+
+    if (sent == 0) {
+        return;
+    }
+
+    // Back to front, so the indexes in the mask stay valid
+    for (int i = count - 1; i >= 0; i--) {
+        if (mask & (1UL << i)) {
+            removeAt(i);
+        }
+    }
+
+    sentNotifications += sent;
+    sentMessages++;
+}
+
+// ===============================================================
+// STATUS & INFORMATION
+// ===============================================================
+
+bool NotificationOutbox::isEmpty() const {
+    return count == 0;
+}
+
+int NotificationOutbox::size() const {
+    return count;
+}
+
+String NotificationOutbox::getStatusString() const {
+    String result = "[Outbox] Waiting: " + String(count) + "/" +
+                    String(NOTIFICATION_OUTBOX_SIZE);
+    result += ", Sent: " + String(sentNotifications) + " in " +
+              String(sentMessages) + " messages";
+    result += ", Dropped: " + String(droppedNotifications);
+    return result;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+void NotificationOutbox::removeAt(int index) {
+    for (int i = index; i < count - 1; i++) {
+        entries[i] = entries[i + 1];
+    }
+    count--;
+
+    // Indexes moved - a batch built before is no longer valid
+    batchMask = 0;
+    batchCount = 0;
+}
+
+int NotificationOutbox::findOldest(NotificationPriority priority) const {
+    for (int i = 0; i < count; i++) {
+        if (entries[i].priority == priority) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. WHY JOIN MESSAGES?
+ *    When the alarm escalates quickly (or after Telegram was
+ *    offline for a while) several notifications wait at once. Each
+ *    sendMessage is a full HTTPS request, and Telegram limits how
+ *    many messages a bot may send per second. One message with
+ *    several lines arrives sooner and reads better.
+ *
+ * 2. WHY KEEP MESSAGES WHILE OFFLINE?
+ *    Before the outbox, notifications were thrown away when the bot
+ *    was offline. Now "Alarm stopped" still reaches the user once
+ *    the connection is back. The size limit keeps a long outage
+ *    from piling up stage messages: they are the first to go.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,138 @@
+/*
+ * ===============================================================
+ * WakeAssist - Notification Outbox Module (Header File)
+ * ===============================================================
+ *
+ * This module holds the notifications the network task still has to
+ * send to the user:
+ * - Bounded: at most NOTIFICATION_OUTBOX_SIZE messages
+ * - Prioritized: urgent messages (hardware errors, /stop
+ *   answers) go out ahead of stage and test messages
+ * - Coalescing: everything waiting is joined into as few Telegram
+ *   messages as possible (one sendMessage instead of one per line)
+ * - Kept until sent: if Telegram is offline or a send fails, the
+ *   messages stay and are retried later
+ *
+ * HOW MESSAGES GET HERE:
+ * alarm task -> taskManager.postNotification() (lock-free queue)
+ *            -> network task moves them into the outbox
+ *            -> sent in batches
+ * The alarm task never waits for any of this.
+ *
+ * ===============================================================
+ */
+
+#ifndef NOTIFICATION_OUTBOX_H
+#define NOTIFICATION_OUTBOX_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "task_manager.h"
+
+// ===============================================================
+// NOTIFICATION OUTBOX CLASS
+// ===============================================================
+// Network task only (no locking)
+
+class NotificationOutbox {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    NotificationOutbox();
+
+    // ---------------------------------------------------------------
+    // ADDING
+    // ---------------------------------------------------------------
+
+    // Add a notification
+    // When full, the oldest normal message is dropped to make room.
+    // If all waiting messages are urgent, a new normal message is
+    // dropped instead (an urgent one replaces the oldest urgent)
+    //
+    // RETURNS: true if added, false if the new message was dropped
+    bool add(const TelegramNotification& notification);
+
+    // ---------------------------------------------------------------
+    // SENDING
+    // ---------------------------------------------------------------
+
+    // Join the next batch into one text: urgent messages first, then
+    // normal ones, each group oldest first, separated by a blank line.
+    // Stops before NOTIFICATION_BATCH_MAX_BYTES would be exceeded
+    //
+    // text: Receives the joined text
+    // RETURNS: Number of messages in the batch, 0 if outbox is empty
+    int buildBatch(String& text);
+
+    // Remove the messages of the last buildBatch() (after it was sent)
+    void removeBatch();
+
+    // ---------------------------------------------------------------
+    // STATUS & INFORMATION
+    // ---------------------------------------------------------------
+
+    bool isEmpty() const;
+    int size() const;
+
+    // Get human-readable status string
+    // RETURNS: String like "[Outbox] Waiting: 2/16, Sent: 14 in 9 messages, Dropped: 0"
+    String getStatusString() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    // Waiting messages, oldest first
+    TelegramNotification entries[NOTIFICATION_OUTBOX_SIZE];
+    int count;
+
+    // Which entries the last buildBatch() used (bit i = entries[i])
+    uint32_t batchMask;
+    int batchCount;
+
+    // Statistics
+    uint32_t sentNotifications;   // Notifications delivered
+    uint32_t sentMessages;        // Telegram messages used for them
+    uint32_t droppedNotifications;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Remove entries[index], later entries move up one place
+    void removeAt(int index);
+
+    // Index of the oldest entry with this priority, -1 if none
+    int findOldest(NotificationPriority priority) const;
+};
+
+// ===============================================================
+// GLOBAL OUTBOX INSTANCE
+// ===============================================================
+
+extern NotificationOutbox notificationOutbox;
+
+#endif // NOTIFICATION_OUTBOX_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE (network task):
+ * ===============================================================
+ *
+ * TelegramNotification notification;
+ * while (taskManager.getNextNotification(notification)) {
+ *     notificationOutbox.add(notification);
+ * }
+ *
+ * String text;
+ * while (notificationOutbox.buildBatch(text) > 0) {
+ *     if (!telegramBot.sendMessage(text)) {
+ *         break;                          // Stays in the outbox
+ *     }
+ *     notificationOutbox.removeBatch();
+ * }
+ *
+ * ===============================================================
+ */
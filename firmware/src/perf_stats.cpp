@@ -0,0 +1,222 @@
+/*
+ * ===============================================================
+ * WakeAssist - Performance Statistics Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the latency histograms declared in
+ * perf_stats.h
+ *
+ * KEY CONCEPTS:
+ * - Cycle counter: The CPU counts clock cycles in a register
+ *   (CCOUNT). Reading it is a single instruction, much cheaper
+ *   than micros()
+ * - log2 buckets: __builtin_clz() counts leading zero bits, which
+ *   gives the bucket number without a loop
+ *
+ * ===============================================================
+ */
+
+#include "perf_stats.h"
+
+// ===============================================================
+// GLOBAL INSTANCE
+// ===============================================================
+
+PerfStats perfStats;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+PerfStats::PerfStats() {
+    memset(histograms, 0, sizeof(histograms));
+    resetGeneration = 0;
+    cyclesPerMicro = 240;  // Default ESP32 clock until begin()
+}
+
+// ===============================================================
+// INITIALIZATION
+// ===============================================================
+
+void PerfStats::begin() {
+    uint32_t cpuMHz = ESP.getCpuFreqMHz();
+
+    if (cpuMHz > 0) {
+        cyclesPerMicro = cpuMHz;
+    }
+
+    DEBUG_PRINTF("[Perf] Cycle counter at %u MHz\n", cyclesPerMicro);
+}
+
+// ===============================================================
+// MEASURING
+// ===============================================================
+
+uint32_t PerfStats::startCycles() {
+    return ESP.getCycleCount();
+}
+
+void PerfStats::stop(PerfProbe probe, uint32_t startCycleCount) {
+    // Unsigned subtraction handles counter wrap (every ~18s at 240MHz)
+    uint32_t cycles = ESP.getCycleCount() - startCycleCount;
+    recordMicros(probe, cycles / cyclesPerMicro);
+}
+
+void PerfStats::recordMicros(PerfProbe probe, uint32_t micros) {
+    Histogram& histogram = histograms[probe];
+
+    // Apply a pending reset() from the owning task
+    uint32_t generation = resetGeneration;
+    if (histogram.generation != generation) {
+        memset(histogram.buckets, 0, sizeof(histogram.buckets));
+        histogram.count = 0;
+        histogram.maxMicros = 0;
+        histogram.generation = generation;
+    }
+
+    histogram.buckets[bucketFor(micros)]++;
+    histogram.count++;
+
+    if (micros > histogram.maxMicros) {
+        histogram.maxMicros = micros;
+    }
+}
+
+// ===============================================================
+// REPORTING
+// ===============================================================
+
+void PerfStats::reset() {
+    resetGeneration = resetGeneration + 1;
+    DEBUG_PRINTLN("[Perf] Histograms reset");
+}
+
+String PerfStats::getReportString() const {
+    String result = "probe         count   p50us   p99us   maxus\n";
+    char line[64];
+    bool anyRecorded = false;
+
+    for (int i = 0; i < PERF_PROBE_COUNT; i++) {
+        const Histogram& histogram = histograms[i];
+
+        // Skip probes with no data (or not yet cleared after reset)
+        if (histogram.count == 0 || histogram.generation != resetGeneration) {
+            continue;
+        }
+
+        snprintf(line, sizeof(line), "%-12s %6u %7u %7u %7u\n",
+                 probeName((PerfProbe)i),
+                 (unsigned)histogram.count,
+                 (unsigned)percentile(histogram, 50),
+                 (unsigned)percentile(histogram, 99),
+                 (unsigned)histogram.maxMicros);
+        result += line;
+        anyRecorded = true;
+    }
+
+    if (!anyRecorded) {
+        result += "(no data yet)\n";
+    }
+
+    return result;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+int PerfStats::bucketFor(uint32_t micros) {
+    if (micros == 0) {
+        return 0;
+    }
+
+    // Number of significant bits = bucket (1 -> 1, 2..3 -> 2, ...)
+    int bucket = 32 - __builtin_clz(micros);
+
+    if (bucket >= PERF_HISTOGRAM_BUCKETS) {
+        bucket = PERF_HISTOGRAM_BUCKETS - 1;  // Everything huge goes last
+    }
+
+    return bucket;
+}
+
+uint32_t PerfStats::bucketUpperBound(int bucket) {
+    if (bucket >= 32) {
+        return 0xFFFFFFFF;
+    }
+
+    return (1UL << bucket) - 1;
+}
+
+uint32_t PerfStats::percentile(const Histogram& histogram, uint8_t percent) {
+    // Number of measurements that must be at or below the result
+    uint32_t target = (histogram.count * percent + 99) / 100;
+    uint32_t seen = 0;
+
+    for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram.buckets[i];
+
+        if (seen >= target) {
+            uint32_t bound = bucketUpperBound(i);
+            return (bound < histogram.maxMicros) ? bound : histogram.maxMicros;
+        }
+    }
+
+    return histogram.maxMicros;
+}
+
+const char* PerfStats::probeName(PerfProbe probe) {
+    switch (probe) {
+        case PERF_BUTTON_EDGES:     return "btn_edges";
+        case PERF_BUTTON_EVENT:     return "btn_event";
+        case PERF_ALARM_COMMANDS:   return "alarm_cmds";
+        case PERF_ALARM_TIMERS:     return "alarm_timers";
+        case PERF_ALARM_UPDATE:     return "alarm_update";
+        case PERF_LED_TOGGLE:       return "led_toggle";
+        case PERF_ALARM_LATENESS:   return "alarm_late";
+        case PERF_NOTIFICATIONS:    return "notify";
+        case PERF_TELEGRAM_POLL:    return "tg_poll";
+        case PERF_TELEGRAM_PARSE:   return "tg_parse";
+        case PERF_WIFI_CHECK:       return "wifi_check";
+        case PERF_MQTT:             return "mqtt";
+        case PERF_NETWORK_LATENESS: return "net_late";
+        default:                    return "unknown";
+    }
+}
+
+// ===============================================================
+// SCOPED MEASUREMENT HELPER
+// ===============================================================
+
+PerfScope::PerfScope(PerfProbe probe) {
+    scopeProbe = probe;
+    startCycleCount = PerfStats::startCycles();
+}
+
+PerfScope::~PerfScope() {
+    perfStats.stop(scopeProbe, startCycleCount);
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * WHY NO MUTEX?
+ * Every probe is written by exactly one task. The /perf command
+ * reads alarm-task histograms from the network task without a lock,
+ * so a report can be off by the one measurement that is being
+ * written at that moment. That is fine for statistics and keeps
+ * the alarm path free of locks.
+ *
+ * WHY A GENERATION COUNTER FOR RESET?
+ * If the network task cleared an alarm-task histogram directly, it
+ * could race with an increment. Instead reset() only bumps a
+ * counter, and each histogram clears itself on its next record.
+ *
+ * LONG MEASUREMENTS:
+ * The cycle counter wraps every ~18 seconds at 240MHz. Anything
+ * that takes longer (a stuck TLS handshake) is under-reported.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,190 @@
+/*
+ * ===============================================================
+ * WakeAssist - Performance Statistics Module (Header File)
+ * ===============================================================
+ *
+ * This module measures how long each part of the firmware takes:
+ * - Alarm task: button edges, button events, commands, timers,
+ *   alarm state machine, LED toggles, timer lateness
+ * - Network task: Telegram polling, WiFi checks, notifications,
+ *   timer lateness
+ *
+ * Every measurement goes into a small histogram with power-of-two
+ * buckets (1us, 2-3us, 4-7us, ...). From that we report:
+ * - p50: Half of all runs were at most this long
+ * - p99: 99 of 100 runs were at most this long
+ * - max: Longest run ever seen (exact)
+ *
+ * WHY?
+ * The "lateness" probes show how late timers ran compared to their
+ * deadline. If the alarm task lateness stays near zero while a
+ * Telegram poll takes seconds, the alarm never waited for the
+ * network.
+ *
+ * COST:
+ * Two cycle counter reads and one array increment per measurement.
+ * All memory is static (no heap).
+ *
+ * ===============================================================
+ */
+
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===============================================================
+// MEASUREMENT POINTS
+// ===============================================================
+// Each probe must only be recorded from ONE task (see comments)
+
+enum PerfProbe {
+    // Alarm task (core 1)
+    PERF_BUTTON_EDGES,       // hardware.processButtonEdges()
+    PERF_BUTTON_EVENT,       // handleButtonEvent()
+    PERF_ALARM_COMMANDS,     // processAlarmCommands()
+    PERF_ALARM_TIMERS,       // alarmScheduler.runDueTimers() (all timers)
+    PERF_ALARM_UPDATE,       // alarmController.update()
+    PERF_LED_TOGGLE,         // One LED blink edge
+    PERF_ALARM_LATENESS,     // How late alarm timers ran after their deadline
+
+    // Network task (core 0)
+    PERF_NOTIFICATIONS,      // sendQueuedNotifications()
+    PERF_TELEGRAM_POLL,      // telegramBot.poll()
+    PERF_TELEGRAM_PARSE,     // Read + parse one Telegram API response
+    PERF_WIFI_CHECK,         // checkWiFiStatus()
+    PERF_MQTT,               // mqttControl.loop() (incl. command handlers)
+    PERF_NETWORK_LATENESS,   // How late network timers ran after their deadline
+
+    PERF_PROBE_COUNT         // Number of probes (not a probe)
+};
+
+// ===============================================================
+// PERFORMANCE STATISTICS CLASS
+// ===============================================================
+
+class PerfStats {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    PerfStats();
+
+    // ---------------------------------------------------------------
+    // INITIALIZATION
+    // ---------------------------------------------------------------
+    // Read the CPU clock so cycle counts can be turned into
+    // microseconds. Call once in setup()
+    void begin();
+
+    // ---------------------------------------------------------------
+    // MEASURING
+    // ---------------------------------------------------------------
+
+    // Read the CPU cycle counter (start of a measurement)
+    // Start and stop must run on the same core (same task is fine,
+    // our tasks are pinned)
+    static uint32_t startCycles();
+
+    // Record time since startCycles() for a probe
+    void stop(PerfProbe probe, uint32_t startCycleCount);
+
+    // Record a value that is already in microseconds
+    void recordMicros(PerfProbe probe, uint32_t micros);
+
+    // ---------------------------------------------------------------
+    // REPORTING
+    // ---------------------------------------------------------------
+
+    // Clear all histograms
+    // Safe to call from any task: each histogram is cleared by its
+    // own task the next time it records something
+    void reset();
+
+    // Get report with one line per probe (count, p50, p99, max)
+    // Probes that were never recorded are skipped
+    String getReportString() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    // Bucket 0 = 0us, bucket i = 2^(i-1) .. 2^i - 1 microseconds
+    struct Histogram {
+        uint32_t buckets[PERF_HISTOGRAM_BUCKETS];
+        uint32_t count;              // Number of measurements
+        uint32_t maxMicros;          // Longest measurement
+        uint32_t generation;         // Last reset seen by this histogram
+    };
+
+    Histogram histograms[PERF_PROBE_COUNT];
+
+    volatile uint32_t resetGeneration;   // Incremented by reset()
+    uint32_t cyclesPerMicro;             // CPU MHz (240 by default)
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Find bucket for a value (log2)
+    static int bucketFor(uint32_t micros);
+
+    // Highest value that falls into a bucket
+    static uint32_t bucketUpperBound(int bucket);
+
+    // Value below which 'percent' of measurements fall
+    // (bucket upper bound, never more than the max)
+    static uint32_t percentile(const Histogram& histogram, uint8_t percent);
+
+    // Short name of a probe for the report
+    static const char* probeName(PerfProbe probe);
+};
+
+// ===============================================================
+// SCOPED MEASUREMENT HELPER
+// ===============================================================
+// Measures from creation to end of the enclosing { } block
+//
+// USAGE:
+// {
+//     PerfScope scope(PERF_TELEGRAM_POLL);
+//     telegramBot.poll();
+// }   // <- time recorded here
+
+class PerfScope {
+public:
+    explicit PerfScope(PerfProbe probe);
+    ~PerfScope();
+
+private:
+    PerfProbe scopeProbe;
+    uint32_t startCycleCount;
+};
+
+// ===============================================================
+// GLOBAL PERF STATS INSTANCE
+// ===============================================================
+
+extern PerfStats perfStats;
+
+#endif // PERF_STATS_H
+
+/*
+ * ===============================================================
+ * EXAMPLE REPORT (/perf or serial status):
+ * ===============================================================
+ *
+ * probe         count   p50us   p99us   maxus
+ * btn_edges        12       7      15      11
+ * alarm_timers   4210      15      63      58
+ * alarm_late     4210       0    1023    1000
+ * tg_poll         720  262143 1048575  812345
+ *
+ * Values are bucket upper bounds, so p50 = 15 means "between 8 and
+ * 15 microseconds". Timer lateness is measured in whole
+ * milliseconds, so it shows up as 0 or ~1000us steps.
+ *
+ * ===============================================================
+ */
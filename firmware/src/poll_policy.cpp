@@ -0,0 +1,253 @@
+/*
+ * ===============================================================
+ * WakeAssist - Poll Policy Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the adaptive poll cadence declared in
+ * poll_policy.h
+ *
+ * KEY CONCEPTS:
+ * - The policy only answers "how long until the next poll?"; the
+ *   poll timer in main.cpp does the waiting
+ * - Idle back-off is calculated from the idle time every time, so
+ *   there is no state to reset: a command simply sets lastActivity
+ * - Statistics live in a ring of 24 hour slots
+ *
+ * ===============================================================
+ */
+
+#include "poll_policy.h"
+
+// One statistics slot
+#define POLL_STATS_HOUR_MS      3600000UL
+
+// ===============================================================
+// GLOBAL POLL POLICY INSTANCE
+// ===============================================================
+
+PollPolicy pollPolicy;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+PollPolicy::PollPolicy() {
+    mode = POLL_MODE_ACTIVE;
+    lastActivity = 0;        // Boot counts as activity
+    lastDelay = 0;
+
+    memset(hours, 0, sizeof(hours));
+    currentHour = 0;
+    hourStart = 0;
+    hoursFilled = 1;
+
+    totalRequests = 0;
+    totalCommands = 0;
+    totalLatencySamples = 0;
+    totalLatencySum = 0;
+    totalLatencyMax = 0;
+}
+
+// ===============================================================
+// CADENCE
+// ===============================================================
+
+unsigned long PollPolicy::getNextDelay(bool alarmActive) {
+    unsigned long now = millis();
+    bool longPoll = (TELEGRAM_LONG_POLL_TIMEOUT_S > 0);
+
+    // Alarm running: answer /stop as fast as possible
+    if (alarmActive) {
+        lastActivity = now;
+        mode = POLL_MODE_ALARM;
+        lastDelay = longPoll ? 0 : TELEGRAM_POLL_ALARM_INTERVAL_MS;
+        return lastDelay;
+    }
+
+    unsigned long idleMs = now - lastActivity;
+
+    // Recent command or alarm: the user is probably still around
+    if (idleMs < TELEGRAM_POLL_IDLE_AFTER_MS) {
+        mode = POLL_MODE_ACTIVE;
+        lastDelay = longPoll ? 0 : TELEGRAM_POLL_INTERVAL_MS;
+        return lastDelay;
+    }
+
+    // Idle: double the gap for every back-off step of idle time
+    mode = POLL_MODE_IDLE;
+
+    unsigned long steps = (idleMs - TELEGRAM_POLL_IDLE_AFTER_MS) / TELEGRAM_POLL_BACKOFF_STEP_MS;
+    unsigned long gap = TELEGRAM_POLL_IDLE_MIN_MS;
+    while (steps > 0 && gap < TELEGRAM_POLL_IDLE_MAX_MS) {
+        gap *= 2;
+        steps--;
+    }
+    if (gap > TELEGRAM_POLL_IDLE_MAX_MS) {
+        gap = TELEGRAM_POLL_IDLE_MAX_MS;
+    }
+
+    lastDelay = addJitter(gap);
+    return lastDelay;
+}
+
+PollMode PollPolicy::getMode() const {
+    return mode;
+}
+
+// ===============================================================
+// RECORDING
+// ===============================================================
+
+void PollPolicy::recordRequest() {
+    advanceHour();
+
+    if (hours[currentHour].requests < UINT16_MAX) {
+        hours[currentHour].requests++;
+    }
+    totalRequests++;
+}
+
+void PollPolicy::recordCommand(unsigned long messageDate) {
+    // Tighten right away: the next getNextDelay() is ACTIVE again
+    lastActivity = millis();
+
+    advanceHour();
+    HourStats& hour = hours[currentHour];
+
+    if (hour.commands < UINT16_MAX) {
+        hour.commands++;
+    }
+    totalCommands++;
+
+    // Latency = now - when Telegram received the message. Needs the
+    // real time, which only exists after NTP answered
+    time_t now = time(nullptr);
+    if (messageDate == 0 || (unsigned long)now < NTP_VALID_AFTER ||
+        (unsigned long)now < messageDate) {
+        return;
+    }
+
+    unsigned long latency = (unsigned long)now - messageDate;
+    if (latency > UINT16_MAX) {
+        latency = UINT16_MAX;
+    }
+
+    if (hour.latencySamples < UINT16_MAX) {
+        hour.latencySamples++;
+        hour.latencySum += latency;
+    }
+    if (latency > hour.latencyMax) {
+        hour.latencyMax = latency;
+    }
+
+    totalLatencySamples++;
+    totalLatencySum += latency;
+    if (latency > totalLatencyMax) {
+        totalLatencyMax = latency;
+    }
+}
+
+// ===============================================================
+// STATUS & INFORMATION
+// ===============================================================
+
+String PollPolicy::getStatusString() const {
+    String result = "[Poll] Mode: ";
+    switch (mode) {
+        case POLL_MODE_ALARM:  result += "alarm";  break;
+        case POLL_MODE_ACTIVE: result += "active"; break;
+        case POLL_MODE_IDLE:   result += "idle";   break;
+    }
+    result += " (gap " + String(lastDelay / 1000) + "s)";
+
+    unsigned long uptimeMs = millis();
+    unsigned long requestsPerHour = uptimeMs > 0 ?
+        (unsigned long)((uint64_t)totalRequests * POLL_STATS_HOUR_MS / uptimeMs) : 0;
+    result += ", Requests: " + String(totalRequests) + " (" + String(requestsPerHour) + "/h)";
+    result += ", Commands: " + String(totalCommands);
+
+    if (totalLatencySamples > 0) {
+        result += ", Latency: avg " + String(totalLatencySum / totalLatencySamples) +
+                  "s, max " + String(totalLatencyMax) + "s";
+    }
+    return result;
+}
+
+String PollPolicy::getReportString() {
+    advanceHour();
+
+    String report;
+    char line[64];
+
+    for (int i = 0; i < hoursFilled; i++) {
+        const HourStats& hour = hours[(currentHour - i + HOURS_KEPT) % HOURS_KEPT];
+
+        int length = snprintf(line, sizeof(line), "%2dh ago: %4u req, %3u cmd",
+                              i, hour.requests, hour.commands);
+        if (hour.latencySamples > 0) {
+            snprintf(line + length, sizeof(line) - length, ", avg %lus, max %us",
+                     (unsigned long)(hour.latencySum / hour.latencySamples),
+                     hour.latencyMax);
+        }
+        report += line;
+        report += "\n";
+    }
+    return report;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+void PollPolicy::advanceHour() {
+    unsigned long elapsedHours = (millis() - hourStart) / POLL_STATS_HOUR_MS;
+    if (elapsedHours == 0) {
+        return;
+    }
+
+    // After a whole day without calls every slot is stale anyway
+    unsigned long clear = elapsedHours < (unsigned long)HOURS_KEPT ? elapsedHours : HOURS_KEPT;
+    for (unsigned long i = 0; i < clear; i++) {
+        currentHour = (currentHour + 1) % HOURS_KEPT;
+        memset(&hours[currentHour], 0, sizeof(HourStats));
+    }
+
+    hourStart += elapsedHours * POLL_STATS_HOUR_MS;
+    hoursFilled += clear;
+    if (hoursFilled > HOURS_KEPT) {
+        hoursFilled = HOURS_KEPT;
+    }
+}
+
+unsigned long PollPolicy::addJitter(unsigned long delayMs) {
+    unsigned long range = delayMs * TELEGRAM_POLL_JITTER_PERCENT / 100;
+    if (range == 0) {
+        return delayMs;
+    }
+
+    // delayMs - range ... delayMs + range
+    return delayMs - range + (unsigned long)random(0, (long)(2 * range + 1));
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. WHAT DOES BACKING OFF COST?
+ *    With the defaults, the gap is 5s after 15 idle minutes, 10s
+ *    after 1h15, 20s, 40s and then 60s from about 4 hours on. With
+ *    long polling, a message sent during a long poll still arrives
+ *    at once; only messages sent during the gap wait (at most the
+ *    gap). The first command tightens everything again.
+ *
+ * 2. WHY JITTER?
+ *    Without it, devices that booted together (power cut) poll at
+ *    the same moments forever. +-20% spreads them out.
+ *
+ * 3. WHY IS LATENCY IN SECONDS?
+ *    Telegram's message "date" has one-second resolution. That is
+ *    still fine to see whether a back-off gap made a command wait.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,159 @@
+/*
+ * ===============================================================
+ * WakeAssist - Poll Policy Module (Header File)
+ * ===============================================================
+ *
+ * This module decides how long the network task waits between two
+ * Telegram polls. Instead of one fixed interval it follows what the
+ * device is doing:
+ *
+ *   ALARM   Alarm running, the user may send /stop any second:
+ *           poll again right away (long poll) or every
+ *           TELEGRAM_POLL_ALARM_INTERVAL_MS
+ *   ACTIVE  A command or alarm within TELEGRAM_POLL_IDLE_AFTER_MS:
+ *           poll again right away (long poll) or every
+ *           TELEGRAM_POLL_INTERVAL_MS
+ *   IDLE    Nothing happened for a while: the gap starts at
+ *           TELEGRAM_POLL_IDLE_MIN_MS and doubles every
+ *           TELEGRAM_POLL_BACKOFF_STEP_MS of idle time, up to
+ *           TELEGRAM_POLL_IDLE_MAX_MS. A random +-jitter keeps many
+ *           devices from polling in step
+ *
+ * Any received command goes straight back to ACTIVE.
+ *
+ * It also keeps statistics for the last 24 hours: requests, commands
+ * and command latency per hour, to see what the cadence costs
+ * (requests) and what it buys (latency). Shown by /poll.
+ *
+ * ===============================================================
+ */
+
+#ifndef POLL_POLICY_H
+#define POLL_POLICY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===============================================================
+// POLL MODES
+// ===============================================================
+
+enum PollMode {
+    POLL_MODE_ALARM,         // Alarm running
+    POLL_MODE_ACTIVE,        // Recent command or alarm
+    POLL_MODE_IDLE           // Backing off
+};
+
+// ===============================================================
+// POLL POLICY CLASS
+// ===============================================================
+// Network task only (no locking)
+
+class PollPolicy {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    PollPolicy();
+
+    // ---------------------------------------------------------------
+    // CADENCE
+    // ---------------------------------------------------------------
+
+    // Time to wait before the next poll
+    // alarmActive: alarmController.isActive()
+    // RETURNS: Milliseconds (0 = poll again right away)
+    unsigned long getNextDelay(bool alarmActive);
+
+    // Current mode (as of the last getNextDelay())
+    PollMode getMode() const;
+
+    // ---------------------------------------------------------------
+    // RECORDING
+    // ---------------------------------------------------------------
+
+    // Count one getUpdates request
+    void recordRequest();
+
+    // A command was received: back to ACTIVE, and record its latency
+    // messageDate: Telegram's "date" of the message (Unix seconds).
+    //              Latency is only recorded once the clock is set (NTP)
+    void recordCommand(unsigned long messageDate);
+
+    // ---------------------------------------------------------------
+    // STATUS & INFORMATION
+    // ---------------------------------------------------------------
+
+    // Get human-readable status string
+    // RETURNS: String like "[Poll] Mode: idle (gap 20s), Requests: 812 (68/h), Latency: avg 1s, max 21s"
+    String getStatusString() const;
+
+    // One line per hour of the last 24 hours, newest first
+    // RETURNS: Multi-line report like " 0h ago:   71 req,   2 cmd, avg 1s, max 3s"
+    String getReportString();
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    PollMode mode;
+    unsigned long lastActivity;       // millis() of last command or alarm
+    unsigned long lastDelay;          // Result of the last getNextDelay()
+
+    // Statistics for one hour
+    struct HourStats {
+        uint16_t requests;
+        uint16_t commands;
+        uint16_t latencySamples;      // Commands with a known latency
+        uint32_t latencySum;          // Seconds
+        uint16_t latencyMax;          // Seconds
+    };
+
+    // Ring of the last 24 hours, hours[currentHour] is the running one
+    static const int HOURS_KEPT = 24;
+    HourStats hours[HOURS_KEPT];
+    int currentHour;
+    unsigned long hourStart;          // millis() when currentHour began
+    int hoursFilled;                  // Slots with data (up to HOURS_KEPT)
+
+    // Totals since boot
+    uint32_t totalRequests;
+    uint32_t totalCommands;
+    uint32_t totalLatencySamples;
+    uint32_t totalLatencySum;
+    uint16_t totalLatencyMax;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Move to a new hour slot if an hour has passed
+    void advanceHour();
+
+    // Add +-TELEGRAM_POLL_JITTER_PERCENT to a delay
+    static unsigned long addJitter(unsigned long delayMs);
+};
+
+// ===============================================================
+// GLOBAL POLL POLICY INSTANCE
+// ===============================================================
+
+extern PollPolicy pollPolicy;
+
+#endif // POLL_POLICY_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE (poll timer on the network task):
+ * ===============================================================
+ *
+ * pollPolicy.recordRequest();
+ * if (telegramBot.poll() && telegramBot.getLastMessageDate() != 0) {
+ *     pollPolicy.recordCommand(telegramBot.getLastMessageDate());
+ * }
+ * networkScheduler.schedule(telegramPollTimer,
+ *                           pollPolicy.getNextDelay(alarmController.isActive()));
+ *
+ * ===============================================================
+ */
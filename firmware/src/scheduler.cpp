@@ -0,0 +1,305 @@
+/*
+ * ===============================================================
+ * WakeAssist - Deadline Scheduler Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the min-heap timer scheduler declared in
+ * scheduler.h
+ *
+ * KEY CONCEPTS:
+ * - Min-heap: A binary tree stored in an array where every parent
+ *   is due no later than its children, so heap[0] is always next
+ * - heapIndex: Each timer remembers its heap position so it can be
+ *   cancelled or re-armed without searching
+ *
+ * ===============================================================
+ */
+
+#include "scheduler.h"
+
+// ===============================================================
+// GLOBAL INSTANCES
+// ===============================================================
+
+Scheduler alarmScheduler;
+Scheduler networkScheduler;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+Scheduler::Scheduler(ClockFunction clockFunction) {
+    clock = clockFunction;
+    timerCount = 0;
+    heapSize = 0;
+    wakeupCount = 0;
+    callbackCount = 0;
+    latenessRecorder = nullptr;
+
+    for (int i = 0; i < SCHEDULER_MAX_TIMERS; i++) {
+        timers[i].name = "";
+        timers[i].callback = nullptr;
+        timers[i].deadline = 0;
+        timers[i].heapIndex = -1;
+        heap[i] = -1;
+    }
+}
+
+// ===============================================================
+// TIMER REGISTRATION
+// ===============================================================
+
+int Scheduler::createTimer(const char* name, std::function<void()> callback) {
+    if (timerCount >= SCHEDULER_MAX_TIMERS) {
+        DEBUG_PRINTF("[Scheduler] ERROR: Max timers reached, cannot create '%s'\n", name);
+        return INVALID_TIMER;
+    }
+
+    int timerId = timerCount++;
+    timers[timerId].name = name;
+    timers[timerId].callback = callback;
+    timers[timerId].heapIndex = -1;
+
+    return timerId;
+}
+
+void Scheduler::schedule(int timerId, unsigned long delayMs) {
+    scheduleAt(timerId, now() + delayMs);
+}
+
+void Scheduler::scheduleAt(int timerId, unsigned long deadline) {
+    if (!isValidTimer(timerId)) {
+        return;
+    }
+
+    Timer& timer = timers[timerId];
+    unsigned long oldDeadline = timer.deadline;
+    timer.deadline = deadline;
+
+    if (timer.heapIndex < 0) {
+        // Not armed yet - append and move up into place
+        timer.heapIndex = heapSize;
+        heap[heapSize] = timerId;
+        heapSize++;
+        siftUp(timer.heapIndex);
+    } else if (isBefore(deadline, oldDeadline)) {
+        // Earlier than before - may need to move up
+        siftUp(timer.heapIndex);
+    } else {
+        // Later than before - may need to move down
+        siftDown(timer.heapIndex);
+    }
+}
+
+void Scheduler::cancel(int timerId) {
+    if (!isValidTimer(timerId) || timers[timerId].heapIndex < 0) {
+        return;
+    }
+
+    heapRemove(timers[timerId].heapIndex);
+}
+
+bool Scheduler::isScheduled(int timerId) const {
+    return isValidTimer(timerId) && timers[timerId].heapIndex >= 0;
+}
+
+unsigned long Scheduler::getTimeUntil(int timerId) const {
+    if (!isScheduled(timerId)) {
+        return 0;
+    }
+
+    unsigned long currentTime = now();
+    unsigned long deadline = timers[timerId].deadline;
+
+    if (!isBefore(currentTime, deadline)) {
+        return 0;  // Already due
+    }
+
+    return deadline - currentTime;
+}
+
+// ===============================================================
+// RUNNING TIMERS
+// ===============================================================
+
+unsigned long Scheduler::runDueTimers() {
+    wakeupCount++;
+
+    // Limit callbacks per call so a timer that keeps re-arming itself
+    // with zero delay cannot lock up the task
+    int budget = SCHEDULER_MAX_TIMERS;
+
+    while (heapSize > 0 && budget > 0) {
+        int timerId = heap[0];
+        unsigned long currentTime = now();
+
+        if (isBefore(currentTime, timers[timerId].deadline)) {
+            break;  // Earliest timer not due yet - nothing else is either
+        }
+
+        // How long past its deadline this timer runs
+        if (latenessRecorder != nullptr) {
+            latenessRecorder(currentTime - timers[timerId].deadline);
+        }
+
+        // Disarm before running so the callback can re-arm it
+        heapRemove(0);
+        budget--;
+        callbackCount++;
+
+        if (timers[timerId].callback != nullptr) {
+            timers[timerId].callback();
+        }
+    }
+
+    return getTimeUntilNext();
+}
+
+unsigned long Scheduler::getTimeUntilNext() const {
+    if (heapSize == 0) {
+        return SCHEDULER_MAX_SLEEP_MS;  // Nothing armed
+    }
+
+    unsigned long waitMs = getTimeUntil(heap[0]);
+
+    if (waitMs > SCHEDULER_MAX_SLEEP_MS) {
+        waitMs = SCHEDULER_MAX_SLEEP_MS;
+    }
+
+    return waitMs;
+}
+
+unsigned long Scheduler::now() const {
+    return clock();
+}
+
+void Scheduler::setLatenessRecorder(LatenessFunction recorder) {
+    latenessRecorder = recorder;
+}
+
+// ===============================================================
+// STATUS & INFORMATION
+// ===============================================================
+
+int Scheduler::getArmedCount() const {
+    return heapSize;
+}
+
+int Scheduler::getTimerCount() const {
+    return timerCount;
+}
+
+uint32_t Scheduler::getWakeupCount() const {
+    return wakeupCount;
+}
+
+uint32_t Scheduler::getCallbackCount() const {
+    return callbackCount;
+}
+
+const char* Scheduler::getNextTimerName() const {
+    return (heapSize > 0) ? timers[heap[0]].name : nullptr;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+bool Scheduler::isBefore(unsigned long a, unsigned long b) {
+    // Signed difference keeps working when millis() wraps around
+    return (long)(a - b) < 0;
+}
+
+bool Scheduler::isValidTimer(int timerId) const {
+    return (timerId >= 0 && timerId < timerCount);
+}
+
+void Scheduler::heapSwap(int i, int j) {
+    int temp = heap[i];
+    heap[i] = heap[j];
+    heap[j] = temp;
+
+    timers[heap[i]].heapIndex = i;
+    timers[heap[j]].heapIndex = j;
+}
+
+void Scheduler::siftUp(int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (!isBefore(timers[heap[index]].deadline, timers[heap[parent]].deadline)) {
+            break;  // Parent is due first - heap order restored
+        }
+
+        heapSwap(index, parent);
+        index = parent;
+    }
+}
+
+void Scheduler::siftDown(int index) {
+    while (true) {
+        int left = 2 * index + 1;
+        int right = left + 1;
+        int earliest = index;
+
+        if (left < heapSize &&
+            isBefore(timers[heap[left]].deadline, timers[heap[earliest]].deadline)) {
+            earliest = left;
+        }
+
+        if (right < heapSize &&
+            isBefore(timers[heap[right]].deadline, timers[heap[earliest]].deadline)) {
+            earliest = right;
+        }
+
+        if (earliest == index) {
+            break;  // Both children due later - heap order restored
+        }
+
+        heapSwap(index, earliest);
+        index = earliest;
+    }
+}
+
+void Scheduler::heapRemove(int index) {
+    int timerId = heap[index];
+    int last = heapSize - 1;
+
+    // Move last element into the hole, then fix heap order
+    if (index != last) {
+        heapSwap(index, last);
+    }
+
+    heapSize--;
+    heap[heapSize] = -1;
+    timers[timerId].heapIndex = -1;
+
+    if (index < heapSize) {
+        siftUp(index);
+        siftDown(index);
+    }
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * WHY A HEAP AND NOT A TIMER WHEEL?
+ * We only have a handful of timers (LEDs, pulse, alarm stages,
+ * polling). A heap of at most SCHEDULER_MAX_TIMERS entries is tiny,
+ * needs no tick granularity decisions, and handles deadlines from
+ * 200ms (fast LED blink) to 5 minutes (safety timeout) equally well.
+ *
+ * WHY ONE-SHOT TIMERS?
+ * Periodic timers would drift or need extra bookkeeping. Re-arming
+ * from the callback keeps every module in charge of its own cadence
+ * (for example the pulse pattern alternates ON and OFF durations).
+ *
+ * MILLIS() OVERFLOW:
+ * All comparisons use the signed difference of two unsigned times,
+ * which stays correct across the 49-day wrap as long as deadlines
+ * are less than ~24 days apart.
+ *
+ * ===============================================================
+ */
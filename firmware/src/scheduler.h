@@ -0,0 +1,199 @@
+/*
+ * ===============================================================
+ * WakeAssist - Deadline Scheduler Module (Header File)
+ * ===============================================================
+ *
+ * This module keeps track of WHEN each part of the firmware needs
+ * to run next:
+ * - LED blink edges
+ * - Buzzer pulse edges (WARNING stage)
+ * - Alarm stage transitions and safety timeout
+ * - Telegram polling, WiFi checks, status reports
+ *
+ * Modules create a named timer once and then (re)arm it with a
+ * deadline. The task loop runs every timer that is due and then
+ * sleeps until the earliest remaining deadline, instead of waking
+ * up every 10 ms to check everything.
+ *
+ * HOW IT WORKS:
+ * Timers are kept in a min-heap ordered by deadline, so finding the
+ * next due timer is O(1) and (re)arming or cancelling is O(log n).
+ *
+ * TESTING:
+ * The clock is passed in through the constructor (millis() by
+ * default). test/test_scheduler passes a virtual clock and steps
+ * time forward without waiting, across the millis() wrap too.
+ *
+ * ===============================================================
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <functional>
+#include "config.h"
+
+// ===============================================================
+// SCHEDULER CLASS
+// ===============================================================
+// NOT thread-safe: each task owns its own Scheduler instance and
+// only that task may create, arm or run its timers.
+
+class Scheduler {
+public:
+    // Function that returns the current time in milliseconds
+    typedef unsigned long (*ClockFunction)();
+
+    // Function told how late a timer ran after its deadline
+    typedef void (*LatenessFunction)(unsigned long lateMs);
+
+    // Returned by createTimer() when no slot is free
+    static const int INVALID_TIMER = -1;
+
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    // clockFunction: Time source (millis() on the device,
+    //                a virtual clock in host tests)
+    Scheduler(ClockFunction clockFunction = millis);
+
+    // ---------------------------------------------------------------
+    // TIMER REGISTRATION
+    // ---------------------------------------------------------------
+
+    // Create a timer (not armed yet)
+    // Call once during initialization, keep the returned ID
+    //
+    // name: Short label for debugging (must stay valid - use a literal)
+    // callback: Function to run when the timer is due
+    //
+    // RETURNS: Timer ID, or INVALID_TIMER if SCHEDULER_MAX_TIMERS reached
+    int createTimer(const char* name, std::function<void()> callback);
+
+    // Arm (or re-arm) a timer to fire delayMs from now
+    // A timer is one-shot: re-arm it from its callback to repeat
+    void schedule(int timerId, unsigned long delayMs);
+
+    // Arm (or re-arm) a timer to fire at an absolute time
+    // deadline: Time in the same units as the clock (millis)
+    void scheduleAt(int timerId, unsigned long deadline);
+
+    // Disarm a timer (does nothing if not armed)
+    void cancel(int timerId);
+
+    // Check if a timer is currently armed
+    bool isScheduled(int timerId) const;
+
+    // Get time until a timer fires
+    // RETURNS: Milliseconds until due, 0 if due or not armed
+    unsigned long getTimeUntil(int timerId) const;
+
+    // ---------------------------------------------------------------
+    // RUNNING TIMERS
+    // ---------------------------------------------------------------
+
+    // Run every timer whose deadline has passed
+    // Call this from the owning task loop
+    //
+    // RETURNS: Milliseconds until the next deadline, capped at
+    //          SCHEDULER_MAX_SLEEP_MS (the task may sleep this long)
+    unsigned long runDueTimers();
+
+    // Get time until the earliest armed timer
+    // RETURNS: Milliseconds, capped at SCHEDULER_MAX_SLEEP_MS
+    unsigned long getTimeUntilNext() const;
+
+    // Current time according to this scheduler's clock
+    unsigned long now() const;
+
+    // Report how late each timer runs after its deadline
+    // recorder: Called before each due callback (nullptr = off)
+    void setLatenessRecorder(LatenessFunction recorder);
+
+    // ---------------------------------------------------------------
+    // STATUS & INFORMATION
+    // ---------------------------------------------------------------
+
+    int getArmedCount() const;           // Timers waiting to fire
+    int getTimerCount() const;           // Timers created
+    uint32_t getWakeupCount() const;     // Calls to runDueTimers()
+    uint32_t getCallbackCount() const;   // Timer callbacks run
+
+    // Name of the earliest armed timer
+    // RETURNS: nullptr if none is armed
+    const char* getNextTimerName() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    struct Timer {
+        const char* name;                // Debug label
+        std::function<void()> callback;  // What to run
+        unsigned long deadline;          // When to run it
+        int heapIndex;                   // Position in heap, -1 = not armed
+    };
+
+    ClockFunction clock;
+
+    Timer timers[SCHEDULER_MAX_TIMERS];
+    int timerCount;                      // Timers created so far
+
+    int heap[SCHEDULER_MAX_TIMERS];      // Timer IDs, earliest deadline first
+    int heapSize;                        // Number of armed timers
+
+    uint32_t wakeupCount;                // Calls to runDueTimers()
+    uint32_t callbackCount;              // Timer callbacks run
+
+    LatenessFunction latenessRecorder;   // nullptr = not recorded
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Compare two times, safe across millis() overflow (~49 days)
+    // RETURNS: true if time a is before time b
+    static bool isBefore(unsigned long a, unsigned long b);
+
+    // Check if a timer ID refers to a created timer
+    bool isValidTimer(int timerId) const;
+
+    // Heap maintenance
+    void heapSwap(int i, int j);
+    void siftUp(int index);
+    void siftDown(int index);
+    void heapRemove(int index);
+};
+
+// ===============================================================
+// GLOBAL SCHEDULER INSTANCES
+// ===============================================================
+// One scheduler per task:
+// - alarmScheduler:   hardware and alarm controller (alarm task)
+// - networkScheduler: Telegram, WiFi, status reports (network task)
+
+extern Scheduler alarmScheduler;
+extern Scheduler networkScheduler;
+
+#endif // SCHEDULER_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * // Once, during initialization:
+ * int blinkTimer = alarmScheduler.createTimer("blink", []() {
+ *     toggleLED();
+ *     alarmScheduler.schedule(blinkTimer, 500);  // Repeat in 500ms
+ * });
+ * alarmScheduler.schedule(blinkTimer, 500);
+ *
+ * // In the task loop:
+ * unsigned long sleepMs = alarmScheduler.runDueTimers();
+ * vTaskDelay(pdMS_TO_TICKS(sleepMs));
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,141 @@
+/*
+ * ===============================================================
+ * WakeAssist - Lock-Free Single-Producer/Single-Consumer Queue
+ * ===============================================================
+ *
+ * A fixed-size ring buffer that lets exactly ONE task push items
+ * and exactly ONE other task pop them, without any mutex.
+ *
+ * WHY LOCK-FREE?
+ * The alarm task (core 1) must never wait for the network task
+ * (core 0). A mutex could be held by the network task while it is
+ * stuck inside a TLS call, which would stall the buzzers. With a
+ * single producer and a single consumer, two atomic indexes are
+ * enough to make push/pop safe without ever blocking.
+ *
+ * HOST TESTING:
+ * This header only uses standard C++ (<atomic>), so it compiles on
+ * a Linux host as well. test/test_spsc_queue runs the hand-off with
+ * two std::thread instances standing in for the FreeRTOS tasks.
+ *
+ * ===============================================================
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+// push()/pop() are always inlined: a push from an IRAM_ATTR interrupt
+// handler is then IRAM code as well. An out-of-line template function
+// would live in flash, which can't be read while an NVS write has the
+// flash cache turned off.
+#define SPSC_INLINE  inline __attribute__((always_inline))
+
+// ===============================================================
+// SPSC QUEUE TEMPLATE
+// ===============================================================
+// T:        Item type (copied in and out, keep it small and trivial)
+// Capacity: Maximum number of items that can be waiting
+//
+// RULES:
+// - Only ONE task (or ONE interrupt handler) may call push()
+// - Only ONE (other) task may call pop()
+// - push() and pop() never block, so push() is safe inside an ISR
+//   as long as all pushes come from that same interrupt context
+//   (and T's copy does not call flash code: keep T a plain struct)
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Add item to the queue (producer side only)
+    // RETURNS: true if queued, false if queue is full
+    SPSC_INLINE bool push(const T& item) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        size_t nextHead = increment(currentHead);
+
+        // Full when advancing head would catch up with tail
+        if (nextHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        buffer[currentHead] = item;
+
+        // Release: item contents become visible before the new head
+        head.store(nextHead, std::memory_order_release);
+        return true;
+    }
+
+    // Remove oldest item from the queue (consumer side only)
+    // RETURNS: true if an item was copied into 'item', false if empty
+    SPSC_INLINE bool pop(T& item) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+
+        // Empty when tail has caught up with head
+        if (currentTail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = buffer[currentTail];
+
+        // Release: slot can be reused by the producer after this
+        tail.store(increment(currentTail), std::memory_order_release);
+        return true;
+    }
+
+    // Check if queue is empty (approximate when called from producer)
+    bool isEmpty() const {
+        return head.load(std::memory_order_acquire) ==
+               tail.load(std::memory_order_acquire);
+    }
+
+    // Number of items currently waiting (approximate snapshot)
+    size_t size() const {
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_acquire);
+        return (h >= t) ? (h - t) : (SLOTS - t + h);
+    }
+
+    // Maximum number of items the queue can hold
+    static size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    // One slot is always left empty to tell "full" from "empty"
+    static const size_t SLOTS = Capacity + 1;
+
+    T buffer[SLOTS];
+    std::atomic<size_t> head;   // Next slot to write (owned by producer)
+    std::atomic<size_t> tail;   // Next slot to read (owned by consumer)
+
+    static SPSC_INLINE size_t increment(size_t index) {
+        return (index + 1 == SLOTS) ? 0 : index + 1;
+    }
+};
+
+#endif // SPSC_QUEUE_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * SpscQueue<int, 8> queue;
+ *
+ * // Producer task:
+ * if (!queue.push(42)) {
+ *     // Queue full - drop or retry later
+ * }
+ *
+ * // Consumer task:
+ * int value;
+ * while (queue.pop(value)) {
+ *     // Handle value
+ * }
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,108 @@
+/*
+ * ===============================================================
+ * WakeAssist - Stale Command Filter (Implementation)
+ * ===============================================================
+ *
+ * This file implements the filter declared in stale_filter.h
+ *
+ * NOTE: The time always comes from the caller, never from time(),
+ * so a backlog from any night can be replayed in the host tests.
+ *
+ * ===============================================================
+ */
+
+#include "stale_filter.h"
+#include <string.h>
+#include <strings.h>
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+StaleFilter::StaleFilter() {
+    active = true;
+    staleBefore = 0;
+    newestDate = 0;
+}
+
+// ===============================================================
+// FILTERING
+// ===============================================================
+
+void StaleFilter::beginBatch(const TelegramUpdateBatch& batch, unsigned long now) {
+    if (!active || !batch.ok) {
+        staleBefore = 0;
+        return;
+    }
+
+    // No clock yet (NTP still running after power-on): the newest
+    // message of the backlog so far is the best guess for "now".
+    // Commands well before it were left over; a lone old one can't
+    // be told apart and is run
+    for (int i = 0; i < batch.count; i++) {
+        const TelegramUpdate& update = batch.updates[i];
+        if (update.kind == UPDATE_MESSAGE && update.date > newestDate) {
+            newestDate = update.date;
+        }
+    }
+
+    if (now < NTP_VALID_AFTER) {
+        now = newestDate;
+    }
+
+    // Never moves back: the backlog is sorted by time
+    unsigned long cutoff = (now > TELEGRAM_STALE_COMMAND_S) ? now - TELEGRAM_STALE_COMMAND_S : 0;
+    if (cutoff > staleBefore) {
+        staleBefore = cutoff;
+    }
+
+    // Telegram fills every slot while more is waiting: an answer with
+    // a free slot was the end of the backlog. Later answers were sent
+    // while the device was running (even if late, e.g. after a 429)
+    if (batch.count < TELEGRAM_UPDATE_SLOTS) {
+        active = false;
+    }
+}
+
+bool StaleFilter::isStale(const TelegramUpdate& update) const {
+    // Stopping a ringing alarm is never too late
+    if (commandMatches(update.text, TELEGRAM_PRIORITY_COMMAND)) {
+        return false;
+    }
+
+    return update.date < staleBefore;
+}
+
+bool StaleFilter::commandMatches(const char* text, const char* command) {
+    size_t length = strcspn(text, " ");
+    return length == strlen(command) && strncasecmp(text, command, length) == 0;
+}
+
+// ===============================================================
+// STATE
+// ===============================================================
+
+bool StaleFilter::isActive() const {
+    return active;
+}
+
+unsigned long StaleFilter::getStaleBefore() const {
+    return staleBefore;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * WHY NOT ONLY THE FIRST ANSWER?
+ * One getUpdates answer holds at most TELEGRAM_UPDATE_SLOTS updates.
+ * After a night with more commands than that, the first answer only
+ * has the oldest ones; checking just that answer ran the rest of the
+ * night's commands at boot. The filter stays on until an answer with
+ * a free slot shows the backlog is read.
+ *
+ * An empty answer (count 0) also ends the backlog.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,99 @@
+/*
+ * ===============================================================
+ * WakeAssist - Stale Command Filter (Header File)
+ * ===============================================================
+ *
+ * Skips commands that were sent long before the device came back
+ * (power-off overnight, WiFi down), so a /wake from last night does
+ * not ring at boot:
+ *
+ *   - Active from boot until the backlog is read: every getUpdates
+ *     answer that fills all TELEGRAM_UPDATE_SLOTS may have more
+ *     waiting behind it, the first one that doesn't was the last
+ *   - A command older than TELEGRAM_STALE_COMMAND_S is stale
+ *   - TELEGRAM_PRIORITY_COMMAND (/stop) never is
+ *
+ * "Now" is the real time if the clock is set, else the newest
+ * message seen in the backlog so far.
+ *
+ * HOST TESTING:
+ * Like circuit_breaker.h, this class does no I/O and never reads the
+ * clock - the caller passes the time in (test/test_stale_filter).
+ *
+ * ===============================================================
+ */
+
+#ifndef STALE_FILTER_H
+#define STALE_FILTER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "update_parser.h"
+
+// ===============================================================
+// STALE FILTER CLASS
+// ===============================================================
+
+class StaleFilter {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    // Starts active (right after boot)
+    StaleFilter();
+
+    // ---------------------------------------------------------------
+    // FILTERING
+    // ---------------------------------------------------------------
+
+    // Call with every getUpdates answer, before isStale()
+    // batch: The answer (only ok answers count)
+    // now:   Unix time from the clock, anything below NTP_VALID_AFTER
+    //        if it is not set yet
+    void beginBatch(const TelegramUpdateBatch& batch, unsigned long now);
+
+    // Check if a message update of the current batch is too old to run
+    bool isStale(const TelegramUpdate& update) const;
+
+    // Check if text starts with command as a whole word
+    // ("/stop", "/stop now" match "/stop"; "/stopwatch" does not)
+    static bool commandMatches(const char* text, const char* command);
+
+    // ---------------------------------------------------------------
+    // STATE
+    // ---------------------------------------------------------------
+
+    // Still reading the backlog from before boot
+    bool isActive() const;
+
+    // Unix time before which commands of the current batch are stale
+    // (0 = none are)
+    unsigned long getStaleBefore() const;
+
+private:
+    bool active;                  // Backlog not read to the end yet
+    unsigned long staleBefore;    // For the current batch
+    unsigned long newestDate;     // Newest message in the backlog so far
+};
+
+#endif // STALE_FILTER_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * StaleFilter staleFilter;
+ *
+ * // After every getUpdates answer:
+ * staleFilter.beginBatch(batch, (unsigned long)time(nullptr));
+ * for (int i = 0; i < batch.count; i++) {
+ *     if (batch.updates[i].kind == UPDATE_MESSAGE &&
+ *         staleFilter.isStale(batch.updates[i])) {
+ *         continue;  // Sent long before the device came back
+ *     }
+ *     ...
+ * }
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,301 @@
+/*
+ * ===============================================================
+ * WakeAssist - Stall Watchdog Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the stall detector declared in
+ * stall_watchdog.h
+ *
+ * KEY CONCEPTS:
+ * - RTC_NOINIT_ATTR: Places a variable in RTC slow memory that is
+ *   NOT cleared on boot. It keeps its value across software resets
+ *   and watchdog resets, but contains garbage after power loss -
+ *   so the record carries a magic number and a checksum
+ * - esp_reset_reason(): Tells us why the chip restarted (power on,
+ *   panic, watchdog, brownout, ...)
+ *
+ * ===============================================================
+ */
+
+#include "stall_watchdog.h"
+#include <esp_system.h>
+
+// ===============================================================
+// RTC-RETAINED STALL RECORD
+// ===============================================================
+
+#define STALL_RECORD_MAGIC  0x5741534CUL   // "WASL"
+
+struct StallRecord {
+    uint32_t magic;                      // STALL_RECORD_MAGIC if valid
+    uint8_t subsystem;                   // WatchdogSubsystem
+    char site[WATCHDOG_SITE_LENGTH];     // Call site that blocked
+    uint32_t blockedMs;                  // How long it blocked
+    uint32_t uptimeMs;                   // Uptime when detected
+    bool causedReset;                    // Watchdog restarted the device
+    uint32_t checksum;                   // Over all fields above
+};
+
+RTC_NOINIT_ATTR static StallRecord rtcStallRecord;
+
+// Simple checksum so garbage after power-on is never reported
+static uint32_t stallRecordChecksum(const StallRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    uint32_t sum = 0x12345678;
+
+    for (size_t i = 0; i < offsetof(StallRecord, checksum); i++) {
+        sum = (sum << 5) + sum + bytes[i];  // djb2-style hash
+    }
+
+    return sum;
+}
+
+// ===============================================================
+// GLOBAL INSTANCE
+// ===============================================================
+
+StallWatchdog stallWatchdog;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+StallWatchdog::StallWatchdog() {
+    for (int i = 0; i < WD_SUBSYSTEM_COUNT; i++) {
+        sections[i].active = false;
+        sections[i].startTime = 0;
+        sections[i].site[0] = '\0';
+        sections[i].reported = false;
+    }
+
+    // How long each subsystem may be busy before it counts as a stall
+    sections[WD_TELEGRAM_IO].budgetMs = WATCHDOG_TELEGRAM_BUDGET_MS;
+    sections[WD_WIFI_CONNECT].budgetMs = WATCHDOG_WIFI_BUDGET_MS;
+    sections[WD_ALARM_TICK].budgetMs = WATCHDOG_ALARM_BUDGET_MS;
+
+    stallCount = 0;
+    bootReport = "";
+}
+
+// ===============================================================
+// INITIALIZATION
+// ===============================================================
+
+bool StallWatchdog::begin() {
+    // ---------------------------------------------------------------
+    // 1. Read what the previous boot left behind
+    // ---------------------------------------------------------------
+    bool recordValid = (rtcStallRecord.magic == STALL_RECORD_MAGIC &&
+                        rtcStallRecord.checksum == stallRecordChecksum(rtcStallRecord));
+
+    if (recordValid) {
+        char line[160];
+        rtcStallRecord.site[WATCHDOG_SITE_LENGTH - 1] = '\0';
+
+        snprintf(line, sizeof(line),
+                 "⚠️ Before restart: %s stuck in %s for %lu.%lus%s",
+                 subsystemName(rtcStallRecord.subsystem),
+                 rtcStallRecord.site,
+                 (unsigned long)(rtcStallRecord.blockedMs / 1000),
+                 (unsigned long)((rtcStallRecord.blockedMs % 1000) / 100),
+                 rtcStallRecord.causedReset ? " (watchdog restart)" : "");
+        bootReport = line;
+    } else {
+        // No stall recorded - still mention crashes and watchdog resets
+        esp_reset_reason_t reason = esp_reset_reason();
+
+        if (reason == ESP_RST_PANIC) {
+            bootReport = "⚠️ Before restart: crash (panic)";
+        } else if (reason == ESP_RST_TASK_WDT || reason == ESP_RST_INT_WDT ||
+                   reason == ESP_RST_WDT) {
+            bootReport = "⚠️ Before restart: hardware watchdog reset";
+        } else if (reason == ESP_RST_BROWNOUT) {
+            bootReport = "⚠️ Before restart: brownout (power supply dip)";
+        }
+    }
+
+    if (bootReport.length() > 0) {
+        DEBUG_PRINTF("[Watchdog] %s\n", bootReport.c_str());
+    }
+
+    // Start fresh for this boot
+    memset(&rtcStallRecord, 0, sizeof(rtcStallRecord));
+
+    // ---------------------------------------------------------------
+    // 2. Start the monitor
+    // ---------------------------------------------------------------
+    // Runs in the FreeRTOS timer service task, so it keeps running
+    // while the network or alarm task is stuck
+    TimerHandle_t timer = xTimerCreate("stall_wd",
+                                       pdMS_TO_TICKS(WATCHDOG_CHECK_INTERVAL_MS),
+                                       pdTRUE,     // Auto-reload
+                                       this,       // Timer ID = this instance
+                                       monitorCallback);
+
+    if (timer == nullptr || xTimerStart(timer, 0) != pdPASS) {
+        DEBUG_PRINTLN("[Watchdog] ERROR: Failed to start monitor timer!");
+        return false;
+    }
+
+    DEBUG_PRINTF("[Watchdog] Monitoring started (restart after %lus stuck)\n",
+                 (unsigned long)(WATCHDOG_TIMEOUT_MS / 1000));
+    return true;
+}
+
+// ===============================================================
+// HEARTBEATS
+// ===============================================================
+
+void StallWatchdog::beginSection(WatchdogSubsystem subsystem, const char* site) {
+    Section& section = sections[subsystem];
+
+    // Fill in site and time BEFORE marking active, so the monitor
+    // never sees an active section with old data
+    section.active = false;
+    strncpy(section.site, site, WATCHDOG_SITE_LENGTH - 1);
+    section.site[WATCHDOG_SITE_LENGTH - 1] = '\0';
+    section.startTime = millis();
+    section.reported = false;
+    section.active = true;
+}
+
+void StallWatchdog::endSection(WatchdogSubsystem subsystem) {
+    sections[subsystem].active = false;
+}
+
+// ===============================================================
+// REPORTING
+// ===============================================================
+
+String StallWatchdog::getBootReport() const {
+    return bootReport;
+}
+
+void StallWatchdog::clearBootReport() {
+    bootReport = "";
+}
+
+String StallWatchdog::getStatusString() const {
+    String result = "[Watchdog] Stalls this boot: " + String(stallCount);
+
+    if (rtcStallRecord.magic == STALL_RECORD_MAGIC) {
+        result += ", worst: " + String(subsystemName(rtcStallRecord.subsystem)) +
+                  " in " + String(rtcStallRecord.site) + " for " +
+                  String(rtcStallRecord.blockedMs) + "ms";
+    }
+
+    return result;
+}
+
+// ===============================================================
+// MONITOR
+// ===============================================================
+
+void StallWatchdog::monitorCallback(TimerHandle_t timer) {
+    StallWatchdog* self = static_cast<StallWatchdog*>(pvTimerGetTimerID(timer));
+    self->checkSections();
+}
+
+void StallWatchdog::checkSections() {
+    unsigned long currentTime = millis();
+
+    for (int i = 0; i < WD_SUBSYSTEM_COUNT; i++) {
+        Section& section = sections[i];
+
+        if (!section.active) {
+            continue;
+        }
+
+        unsigned long blockedMs = currentTime - section.startTime;
+
+        if (blockedMs <= section.budgetMs) {
+            continue;  // Busy, but within budget
+        }
+
+        // ---------------------------------------------------------------
+        // Over budget: count it once, keep the record up to date
+        // ---------------------------------------------------------------
+        if (!section.reported) {
+            section.reported = true;
+            stallCount++;
+            DEBUG_PRINTF("[Watchdog] STALL: %s stuck in %s (%lums)\n",
+                         subsystemName(i), section.site, blockedMs);
+        }
+
+        // ---------------------------------------------------------------
+        // Hung for good: save record and restart
+        // ---------------------------------------------------------------
+        if (blockedMs >= WATCHDOG_TIMEOUT_MS) {
+            recordStall((WatchdogSubsystem)i, section.site, blockedMs, true);
+            DEBUG_PRINTLN("[Watchdog] Device hung - restarting!");
+            delay(100);  // Let serial output finish
+            ESP.restart();
+        }
+
+        recordStall((WatchdogSubsystem)i, section.site, blockedMs, false);
+    }
+}
+
+void StallWatchdog::recordStall(WatchdogSubsystem subsystem, const char* site,
+                                unsigned long blockedMs, bool causedReset) {
+    // Only keep the worst stall (a reset always wins)
+    if (rtcStallRecord.magic == STALL_RECORD_MAGIC && !causedReset &&
+        blockedMs <= rtcStallRecord.blockedMs) {
+        return;
+    }
+
+    rtcStallRecord.magic = STALL_RECORD_MAGIC;
+    rtcStallRecord.subsystem = subsystem;
+    strncpy(rtcStallRecord.site, site, WATCHDOG_SITE_LENGTH - 1);
+    rtcStallRecord.site[WATCHDOG_SITE_LENGTH - 1] = '\0';
+    rtcStallRecord.blockedMs = blockedMs;
+    rtcStallRecord.uptimeMs = millis();
+    rtcStallRecord.causedReset = causedReset;
+    rtcStallRecord.checksum = stallRecordChecksum(rtcStallRecord);
+}
+
+const char* StallWatchdog::subsystemName(uint8_t subsystem) {
+    switch (subsystem) {
+        case WD_TELEGRAM_IO:  return "Telegram I/O";
+        case WD_WIFI_CONNECT: return "WiFi connect";
+        case WD_ALARM_TICK:   return "Alarm tick";
+        default:              return "Unknown";
+    }
+}
+
+// ===============================================================
+// SCOPED SECTION HELPER
+// ===============================================================
+
+WatchdogSection::WatchdogSection(WatchdogSubsystem subsystem, const char* site) {
+    sectionSubsystem = subsystem;
+    stallWatchdog.beginSection(subsystem, site);
+}
+
+WatchdogSection::~WatchdogSection() {
+    stallWatchdog.endSection(sectionSubsystem);
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * WHY NOT ONLY THE ESP-IDF TASK WATCHDOG?
+ * The built-in task watchdog resets the chip but cannot tell us
+ * which HTTPS request or which WiFi call was hanging. This layer
+ * knows the call site and keeps it across the reset.
+ *
+ * WHY A STALL THAT DID NOT RESET IS ALSO KEPT:
+ * A 15 second Telegram request does not hang the device, but it is
+ * worth knowing about. The worst one stays in RTC memory and is
+ * reported if the device restarts for any reason (e.g. a crash or
+ * a factory reset) before power is lost.
+ *
+ * THREAD SAFETY:
+ * Each section is written by its owning task and only read by the
+ * monitor. The RTC record is only written by the monitor (and by
+ * begin() before the monitor starts).
+ *
+ * ===============================================================
+ */
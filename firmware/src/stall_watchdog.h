@@ -0,0 +1,169 @@
+/*
+ * ===============================================================
+ * WakeAssist - Stall Watchdog Module (Header File)
+ * ===============================================================
+ *
+ * This module notices when a part of the firmware gets stuck and
+ * remembers WHO was stuck, WHERE and for HOW LONG:
+ * - Telegram I/O  (network task, one HTTPS request)
+ * - WiFi connect  (network task, connecting to the stored network)
+ * - Alarm tick    (alarm task, one pass of alarmLoop())
+ *
+ * HOW IT WORKS:
+ * 1. Code that can block opens a "section" with a call site name
+ *    (e.g. "getUpdates") and closes it when done. Opening a section
+ *    is the heartbeat: it says "I am busy here since now"
+ * 2. A FreeRTOS software timer checks all open sections every
+ *    WATCHDOG_CHECK_INTERVAL_MS
+ * 3. A section open longer than its budget is a STALL. The longest
+ *    stall is written to RTC memory, which survives a reset
+ * 4. A section open longer than WATCHDOG_TIMEOUT_MS means the
+ *    device is hung: the record is marked and the ESP32 restarts
+ * 5. On the next boot the record is reported together with
+ *    MSG_DEVICE_ONLINE
+ *
+ * ===============================================================
+ */
+
+#ifndef STALL_WATCHDOG_H
+#define STALL_WATCHDOG_H
+
+#include <Arduino.h>
+#include "freertos/timers.h"   // Software timer for the monitor
+#include "config.h"
+
+// ===============================================================
+// WATCHED SUBSYSTEMS
+// ===============================================================
+
+enum WatchdogSubsystem {
+    WD_TELEGRAM_IO,          // HTTPS request to Telegram (network task)
+    WD_WIFI_CONNECT,         // WiFi (re)connect (network task)
+    WD_ALARM_TICK,           // One alarmLoop() pass (alarm task)
+    WD_SUBSYSTEM_COUNT       // Number of subsystems (not a subsystem)
+};
+
+// ===============================================================
+// STALL WATCHDOG CLASS
+// ===============================================================
+
+class StallWatchdog {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    StallWatchdog();
+
+    // ---------------------------------------------------------------
+    // INITIALIZATION
+    // ---------------------------------------------------------------
+    // Read the stall record left by the previous boot and start the
+    // monitor timer. Call once, early in setup()
+    //
+    // RETURNS: true if the monitor timer is running
+    bool begin();
+
+    // ---------------------------------------------------------------
+    // HEARTBEATS
+    // ---------------------------------------------------------------
+    // Only the task that owns a subsystem may open/close its section
+
+    // Mark subsystem as busy at a call site
+    // site: Short name (copied, so a temporary String is fine)
+    void beginSection(WatchdogSubsystem subsystem, const char* site);
+
+    // Mark subsystem as done
+    void endSection(WatchdogSubsystem subsystem);
+
+    // ---------------------------------------------------------------
+    // REPORTING
+    // ---------------------------------------------------------------
+
+    // Text describing the stall (or crash) before the last reset
+    // RETURNS: Empty string if the last boot was clean
+    String getBootReport() const;
+
+    // Forget the boot report (call once it has been delivered)
+    void clearBootReport();
+
+    // Get human-readable status (stalls this boot, worst stall)
+    String getStatusString() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    // One open/closed section per subsystem
+    struct Section {
+        volatile bool active;            // Section open?
+        volatile unsigned long startTime;  // millis() when opened
+        char site[WATCHDOG_SITE_LENGTH]; // Call site name
+        unsigned long budgetMs;          // Longer than this = stall
+        bool reported;                   // Stall already counted
+    };
+
+    Section sections[WD_SUBSYSTEM_COUNT];
+
+    uint32_t stallCount;                 // Stalls seen this boot
+    String bootReport;                   // From previous boot
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // FreeRTOS timer callback (runs in the timer service task)
+    static void monitorCallback(TimerHandle_t timer);
+
+    // Check all sections for stalls (called by monitorCallback)
+    void checkSections();
+
+    // Store a stall in RTC memory if it is the worst one so far
+    void recordStall(WatchdogSubsystem subsystem, const char* site,
+                     unsigned long blockedMs, bool causedReset);
+
+    // Short name of a subsystem
+    static const char* subsystemName(uint8_t subsystem);
+};
+
+// ===============================================================
+// SCOPED SECTION HELPER
+// ===============================================================
+// Opens a section on creation and closes it at the end of the
+// enclosing { } block (also on early return)
+//
+// USAGE:
+// bool TelegramBot::sendRequest(const char* method, const String& endpoint, ...) {
+//     WatchdogSection section(WD_TELEGRAM_IO, endpoint.c_str());
+//     ...
+// }
+
+class WatchdogSection {
+public:
+    WatchdogSection(WatchdogSubsystem subsystem, const char* site);
+    ~WatchdogSection();
+
+private:
+    WatchdogSubsystem sectionSubsystem;
+};
+
+// ===============================================================
+// GLOBAL STALL WATCHDOG INSTANCE
+// ===============================================================
+
+extern StallWatchdog stallWatchdog;
+
+#endif // STALL_WATCHDOG_H
+
+/*
+ * ===============================================================
+ * EXAMPLE BOOT REPORT:
+ * ===============================================================
+ *
+ * 🟢 WakeAssist connected! Send /wake to test.
+ *
+ * ⚠️ Before restart: WiFi connect stuck in connectToStoredNetwork
+ * for 61.2s (watchdog restart)
+ *
+ * ===============================================================
+ */
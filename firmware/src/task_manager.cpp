@@ -0,0 +1,245 @@
+/*
+ * ===============================================================
+ * WakeAssist - Task Manager Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the dual-core task split declared in
+ * task_manager.h
+ *
+ * KEY CONCEPTS:
+ * - xTaskCreatePinnedToCore: Starts a FreeRTOS task on a fixed core
+ * - Task notifications: A lightweight "wake up" signal. Each task
+ *   sleeps in ulTaskNotifyTake() until its next scheduler deadline,
+ *   and xTaskNotifyGive() wakes it early when work is queued
+ *
+ * ===============================================================
+ */
+
+#include "task_manager.h"
+
+// ===============================================================
+// GLOBAL INSTANCE
+// ===============================================================
+
+TaskManager taskManager;
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+TaskManager::TaskManager() {
+    networkTaskHandle = nullptr;
+    alarmTaskHandle = nullptr;
+    networkLoopFunction = nullptr;
+    alarmLoopFunction = nullptr;
+    droppedCommands = 0;
+    droppedNotifications = 0;
+}
+
+// ===============================================================
+// INITIALIZATION
+// ===============================================================
+
+bool TaskManager::begin(unsigned long (*networkLoop)(), unsigned long (*alarmLoop)()) {
+    DEBUG_PRINTLN("[Tasks] Starting network and alarm tasks...");
+
+    networkLoopFunction = networkLoop;
+    alarmLoopFunction = alarmLoop;
+
+    // Alarm task first - it is the one that must always be running
+    BaseType_t result = xTaskCreatePinnedToCore(
+        alarmTaskEntry,           // Task function
+        "alarm",                  // Name (for debugging)
+        ALARM_TASK_STACK_SIZE,    // Stack size in bytes
+        this,                     // Parameter passed to task
+        ALARM_TASK_PRIORITY,      // Priority
+        &alarmTaskHandle,         // Handle output
+        ALARM_TASK_CORE);         // Core to pin to
+
+    if (result != pdPASS) {
+        DEBUG_PRINTLN("[Tasks] ERROR: Failed to create alarm task!");
+        return false;
+    }
+
+    result = xTaskCreatePinnedToCore(
+        networkTaskEntry,
+        "network",
+        NETWORK_TASK_STACK_SIZE,
+        this,
+        NETWORK_TASK_PRIORITY,
+        &networkTaskHandle,
+        NETWORK_TASK_CORE);
+
+    if (result != pdPASS) {
+        DEBUG_PRINTLN("[Tasks] ERROR: Failed to create network task!");
+        return false;
+    }
+
+    DEBUG_PRINTF("[Tasks] Alarm task on core %d, network task on core %d\n",
+                 ALARM_TASK_CORE, NETWORK_TASK_CORE);
+    return true;
+}
+
+bool TaskManager::isRunning() const {
+    return (networkTaskHandle != nullptr && alarmTaskHandle != nullptr);
+}
+
+// ===============================================================
+// COMMAND QUEUE
+// ===============================================================
+
+bool TaskManager::postCommand(AlarmCommandType type, uint32_t arg) {
+    AlarmCommand command;
+    command.type = type;
+    command.arg = arg;
+
+    if (!commandQueue.push(command)) {
+        droppedCommands++;
+        DEBUG_PRINTF("[Tasks] WARNING: Command queue full, dropped command %d\n", type);
+        return false;
+    }
+
+    // Wake the alarm task so the command runs immediately
+    if (alarmTaskHandle != nullptr) {
+        xTaskNotifyGive(alarmTaskHandle);
+    }
+
+    return true;
+}
+
+bool TaskManager::getNextCommand(AlarmCommand& command) {
+    return commandQueue.pop(command);
+}
+
+void IRAM_ATTR TaskManager::wakeAlarmTaskFromISR() {
+    if (alarmTaskHandle == nullptr) {
+        return;  // Tasks not started yet - edge is handled on first run
+    }
+
+    // Switch to the alarm task right after the ISR if it has a
+    // higher priority than the interrupted task
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(alarmTaskHandle, &higherPriorityTaskWoken);
+
+    if (higherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// ===============================================================
+// NOTIFICATION QUEUE
+// ===============================================================
+
+bool TaskManager::postNotification(const char* text, NotificationPriority priority) {
+    TelegramNotification notification;
+
+    // Copy text into the fixed buffer (always NUL-terminated)
+    strncpy(notification.text, text, sizeof(notification.text) - 1);
+    notification.text[sizeof(notification.text) - 1] = '\0';
+    notification.priority = priority;
+
+    if (!notificationQueue.push(notification)) {
+        droppedNotifications++;
+        DEBUG_PRINTLN("[Tasks] WARNING: Notification queue full, message dropped");
+        return false;
+    }
+
+    // Wake the network task so the message goes out immediately
+    if (networkTaskHandle != nullptr) {
+        xTaskNotifyGive(networkTaskHandle);
+    }
+
+    return true;
+}
+
+bool TaskManager::getNextNotification(TelegramNotification& notification) {
+    return notificationQueue.pop(notification);
+}
+
+bool TaskManager::hasPendingNotifications() const {
+    return !notificationQueue.isEmpty();
+}
+
+// ===============================================================
+// STATUS & INFORMATION
+// ===============================================================
+
+String TaskManager::getStatusString() const {
+    String result = "[Tasks] ";
+
+    if (!isRunning()) {
+        result += "Not started";
+        return result;
+    }
+
+    result += "Commands: " + String(commandQueue.size()) + "/" +
+              String(COMMAND_QUEUE_SIZE);
+    result += " (dropped " + String(droppedCommands) + ")";
+    result += ", Notifications: " + String(notificationQueue.size()) + "/" +
+              String(NOTIFICATION_QUEUE_SIZE);
+    result += " (dropped " + String(droppedNotifications) + ")";
+
+    // Stack high-water mark = smallest free stack ever seen (bytes)
+    result += ", Free stack: net=" +
+              String(uxTaskGetStackHighWaterMark(networkTaskHandle));
+    result += " alarm=" +
+              String(uxTaskGetStackHighWaterMark(alarmTaskHandle));
+
+    return result;
+}
+
+// ===============================================================
+// TASK ENTRY POINTS
+// ===============================================================
+
+void TaskManager::networkTaskEntry(void* param) {
+    TaskManager* self = static_cast<TaskManager*>(param);
+
+    // Tasks must never return - loop forever
+    while (true) {
+        waitForWork(self->networkLoopFunction());
+    }
+}
+
+void TaskManager::alarmTaskEntry(void* param) {
+    TaskManager* self = static_cast<TaskManager*>(param);
+
+    while (true) {
+        waitForWork(self->alarmLoopFunction());
+    }
+}
+
+void TaskManager::waitForWork(unsigned long timeoutMs) {
+    // Always block for at least one tick so lower-priority tasks
+    // (including the idle task that feeds the watchdog) get to run
+    TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
+    if (ticks == 0) {
+        ticks = 1;
+    }
+
+    // Returns early if postCommand()/postNotification() woke us
+    ulTaskNotifyTake(pdTRUE, ticks);
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * WHY CORE 0 FOR NETWORK?
+ * The ESP32 WiFi driver already runs on core 0. Keeping our network
+ * code on the same core avoids cross-core traffic inside the WiFi
+ * stack and leaves core 1 free for time-critical alarm work.
+ *
+ * WHY A HIGHER PRIORITY FOR THE ALARM TASK?
+ * Both tasks are pinned to different cores, so priority mostly
+ * matters against system tasks on the same core. A higher priority
+ * makes sure buzzer patterns are not delayed by background work.
+ *
+ * QUEUE FULL BEHAVIOR:
+ * Both queues drop the NEW item when full and count it. Commands
+ * are rare (one per Telegram message) so this should never happen
+ * in practice. The counters show up in getStatusString().
+ *
+ * ===============================================================
+ */
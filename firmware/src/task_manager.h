@@ -0,0 +1,224 @@
+/*
+ * ===============================================================
+ * WakeAssist - Task Manager Module (Header File)
+ * ===============================================================
+ *
+ * This module splits the firmware into two pinned FreeRTOS tasks:
+ * - Network task (core 0): WiFi maintenance, Telegram polling/sending
+ * - Alarm task (core 1): buttons, LEDs, buzzers, alarm state machine
+ *
+ * The tasks never call into each other's modules directly. Instead
+ * they talk through two lock-free queues:
+ * - Command queue:      network task -> alarm task
+ *                       (e.g. "/wake received, start the alarm")
+ * - Notification queue: alarm task -> network task
+ *                       (e.g. "send MSG_WARNING_STARTED to the user")
+ *
+ * WHY?
+ * A Telegram request can block for up to TELEGRAM_API_TIMEOUT_MS
+ * (10 seconds). On a single loop that froze the SILENCE button and
+ * the buzzer pulse timing. Now only the network task waits.
+ *
+ * ===============================================================
+ */
+
+#ifndef TASK_MANAGER_H
+#define TASK_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "spsc_queue.h"
+
+// ===============================================================
+// ALARM COMMAND TYPES
+// ===============================================================
+// Requests sent from the network task to the alarm task
+
+enum AlarmCommandType {
+    CMD_NONE,                // Empty command (never queued)
+    CMD_START_ALARM,         // Start alarm sequence (/wake)
+    CMD_STOP_ALARM,          // Stop alarm (arg = AlarmStopSource)
+    CMD_TEST_ALARM,          // Run buzzer test (/test)
+    CMD_SET_WIFI_LED,        // WiFi LED solid (arg = 1 on, 0 off)
+    CMD_BLINK_WIFI_LED,      // WiFi LED blinking (arg = interval in ms)
+    CMD_FACTORY_RESET_DONE   // Stored settings cleared, may restart now
+};
+
+// ===============================================================
+// ALARM COMMAND STRUCTURE
+// ===============================================================
+
+struct AlarmCommand {
+    AlarmCommandType type;   // What to do
+    uint32_t arg;            // Optional argument (meaning depends on type)
+};
+
+// ===============================================================
+// TELEGRAM NOTIFICATION TYPES
+// ===============================================================
+// Text the alarm task wants sent to the user
+// Fixed-size buffer so queuing never touches the heap
+
+enum NotificationPriority {
+    NOTIFY_NORMAL,           // Test steps, replies
+    NOTIFY_URGENT,           // Hardware errors, /stop answers
+
+    // Lines of the alarm's live status message: not sent on their
+    // own, they edit one message (see live_status.h)
+    NOTIFY_LIVE_START,       // First line of a new alarm
+    NOTIFY_LIVE,             // Stage changes
+    NOTIFY_LIVE_END,         // Stop confirmation (removes the STOP button)
+
+    // Not a message: RESET was held, the network task clears the
+    // stored settings (it owns WiFi and flash) - text is unused
+    NOTIFY_FACTORY_RESET
+};
+
+struct TelegramNotification {
+    char text[NOTIFICATION_MAX_LENGTH];
+    uint8_t priority;        // NotificationPriority
+};
+
+// ===============================================================
+// TASK MANAGER CLASS
+// ===============================================================
+
+class TaskManager {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    TaskManager();
+
+    // ---------------------------------------------------------------
+    // INITIALIZATION
+    // ---------------------------------------------------------------
+    // Create and start both tasks
+    // MUST be called once at the end of setup()
+    //
+    // networkLoop: Function run repeatedly on the network core
+    // alarmLoop:   Function run repeatedly on the alarm core
+    //
+    // Each loop function returns how long (ms) its task may sleep,
+    // normally the result of Scheduler::runDueTimers(). A queued
+    // command or notification wakes the receiving task early.
+    //
+    // RETURNS: true if both tasks were created
+    bool begin(unsigned long (*networkLoop)(), unsigned long (*alarmLoop)());
+
+    // Check if tasks have been started
+    bool isRunning() const;
+
+    // ---------------------------------------------------------------
+    // COMMAND QUEUE (network task -> alarm task)
+    // ---------------------------------------------------------------
+
+    // Queue a command for the alarm task
+    // ONLY call from the network task (single producer)
+    //
+    // RETURNS: true if queued, false if queue full
+    bool postCommand(AlarmCommandType type, uint32_t arg = 0);
+
+    // Get next waiting command
+    // ONLY call from the alarm task (single consumer)
+    //
+    // RETURNS: true if a command was returned
+    bool getNextCommand(AlarmCommand& command);
+
+    // Wake the alarm task from an interrupt handler
+    // Used by the button ISR after it queues an edge
+    void wakeAlarmTaskFromISR();
+
+    // ---------------------------------------------------------------
+    // NOTIFICATION QUEUE (alarm task -> network task)
+    // ---------------------------------------------------------------
+
+    // Queue a Telegram message for the network task to send
+    // ONLY call from the alarm task (single producer)
+    // Text longer than NOTIFICATION_MAX_LENGTH is truncated
+    //
+    // priority: Urgent messages are sent ahead of normal ones (see
+    //           notification_outbox.h)
+    // RETURNS: true if queued, false if queue full
+    bool postNotification(const char* text,
+                          NotificationPriority priority = NOTIFY_NORMAL);
+
+    // Get next waiting notification
+    // ONLY call from the network task (single consumer)
+    //
+    // RETURNS: true if a notification was returned
+    bool getNextNotification(TelegramNotification& notification);
+
+    // Check if notifications are waiting (network task only)
+    // Used to cut a Telegram long poll short
+    bool hasPendingNotifications() const;
+
+    // ---------------------------------------------------------------
+    // STATUS & INFORMATION
+    // ---------------------------------------------------------------
+
+    // Get human-readable status string (queue usage, stack headroom)
+    String getStatusString() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    SpscQueue<AlarmCommand, COMMAND_QUEUE_SIZE> commandQueue;
+    SpscQueue<TelegramNotification, NOTIFICATION_QUEUE_SIZE> notificationQueue;
+
+    TaskHandle_t networkTaskHandle;
+    TaskHandle_t alarmTaskHandle;
+
+    unsigned long (*networkLoopFunction)();
+    unsigned long (*alarmLoopFunction)();
+
+    // Drop counters (each written by one producer only)
+    uint32_t droppedCommands;
+    uint32_t droppedNotifications;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // FreeRTOS task entry points ('param' is the TaskManager instance)
+    static void networkTaskEntry(void* param);
+    static void alarmTaskEntry(void* param);
+
+    // Sleep until timeout or until another task wakes us
+    static void waitForWork(unsigned long timeoutMs);
+};
+
+// ===============================================================
+// GLOBAL TASK MANAGER INSTANCE
+// ===============================================================
+// USAGE IN OTHER FILES:
+//   extern TaskManager taskManager;
+//   taskManager.postNotification(MSG_WARNING_STARTED);
+
+extern TaskManager taskManager;
+
+#endif // TASK_MANAGER_H
+
+/*
+ * ===============================================================
+ * WHICH TASK OWNS WHAT:
+ * ===============================================================
+ *
+ * NETWORK TASK (core 0):
+ * - wifiMgr         (connect, reconnect, status)
+ * - telegramBot     (poll, sendMessage, command callbacks)
+ * - Pushes to the command queue, pops from the notification queue
+ *
+ * ALARM TASK (core 1):
+ * - hardware        (buttons, LEDs, buzzers)
+ * - alarmController (state machine, stage timing)
+ * - Pushes to the notification queue, pops from the command queue
+ *
+ * Reading a simple status value owned by the other task (for
+ * example alarmController.isActive() inside /status) is fine.
+ * Changing state owned by the other task must go through a queue.
+ *
+ * ===============================================================
+ */
@@ -8,17 +8,68 @@
  *
  * KEY CONCEPTS:
  * - Long Polling: We ask Telegram "any new messages?" repeatedly
- * - HTTPS: All communication is encrypted (WiFiClientSecure)
+ * - HTTPS: All communication is encrypted (TlsClient, which also
+ *   resumes TLS sessions after a reconnect)
+ * - Keep-alive: Two HTTPS connections (getUpdates, everything
+ *   else) stay open between requests, so the slow TLS handshake
+ *   happens once instead of every time (see bot_transport.h)
  * - JSON: Telegram API uses JSON format for requests/responses
  *
  * ===============================================================
  */
 
 #include "telegram_bot.h"
+#include "stall_watchdog.h"
+#include "perf_stats.h"
 
-// Telegram API configuration
-#define TELEGRAM_HOST "api.telegram.org"
-#define TELEGRAM_PORT 443  // HTTPS port
+// ===============================================================
+// RTC-RETAINED getUpdates POSITION
+// ===============================================================
+// The last processed update ID. Survives software and watchdog
+// restarts in RTC memory, garbage after power-on - hence the magic
+// number and checksum. A copy in flash covers power loss.
+// tokenHash ties the position to one bot (a new token starts over).
+
+#define OFFSET_RECORD_MAGIC  0x54474F46UL   // "TGOF"
+
+struct OffsetRecord {
+    uint32_t magic;                      // OFFSET_RECORD_MAGIC if valid
+    int32_t lastUpdateId;                // Last processed update
+    uint32_t tokenHash;                  // Bot it belongs to
+    uint32_t checksum;                   // Over all fields above
+};
+
+RTC_NOINIT_ATTR static OffsetRecord rtcOffset;
+
+static uint32_t hashBytes(const uint8_t* bytes, size_t length) {
+    uint32_t sum = 0x12345678;
+
+    for (size_t i = 0; i < length; i++) {
+        sum = (sum << 5) + sum + bytes[i];  // djb2-style hash
+    }
+
+    return sum;
+}
+
+// Handshake time one connection saved: each reused request saved a
+// full handshake, each resumed handshake saved the difference
+static unsigned long handshakeTimeSaved(const TlsClient& tls, uint32_t reusedCount) {
+    unsigned long fullMs = tls.getAverageFullHandshakeMs();
+    unsigned long resumedMs = tls.getAverageResumedHandshakeMs();
+
+    return reusedCount * fullMs +
+           (fullMs > resumedMs ? tls.getResumedHandshakeCount() * (fullMs - resumedMs) : 0);
+}
+
+static uint32_t offsetRecordChecksum(const OffsetRecord& record) {
+    return hashBytes((const uint8_t*)&record, offsetof(OffsetRecord, checksum));
+}
+
+static bool isValidOffsetRecord(const OffsetRecord& record, uint32_t tokenHash) {
+    return record.magic == OFFSET_RECORD_MAGIC &&
+           record.checksum == offsetRecordChecksum(record) &&
+           record.tokenHash == tokenHash;
+}
 
 // ===============================================================
 // GLOBAL INSTANCE
@@ -30,18 +81,49 @@ TelegramBot telegramBot;
 // CONSTRUCTOR
 // ===============================================================
 
-TelegramBot::TelegramBot() {
+TelegramBot::TelegramBot() : pollTransport(esp_random), sendTransport(esp_random) {
     status = BOT_NOT_INITIALIZED;
     botToken = "";
     authorizedUserId = 0;
     botUsername = "";
     lastUpdateId = 0;
+    offsetDirty = false;
+    lastOffsetSave = 0;
+    staleCommands = 0;
     lastPollTime = 0;
+    lastMessageDate = 0;
     lastWakeTime = 0;
-    messageQueueHead = 0;
-    messageQueueTail = 0;
-    messageQueueCount = 0;
-    commandCallbackCount = 0;
+    updateBatch.ok = false;
+    updateBatch.count = 0;
+    lastResponseBytes = 0;
+    lastResponseHeapBytes = 0;
+    maxResponseHeapBytes = 0;
+
+    // Keep the TLS session across software/watchdog restarts too
+    // (one RTC slot - the poll connection is the one always open)
+    client.setRtcSessionCache(true);
+
+    // Both connections go to the same server: back off together
+    sendTransport.shareBreaker(pollTransport);
+
+    setApiServer(TELEGRAM_API_HOST, TELEGRAM_API_PORT, TELEGRAM_API_TLS);
+
+    // Asked every TELEGRAM_LONG_POLL_CHECK_MS while getUpdates waits
+    pollTransport.onLongPollInterrupt([this]() {
+        // Waiting here is expected, not a stall - refresh the
+        // watchdog section so only a real hang is reported
+        stallWatchdog.beginSection(WD_TELEGRAM_IO, "getUpdates");
+        return callbackLongPollInterrupt != nullptr && callbackLongPollInterrupt();
+    });
+
+    sendBucket.configure(TELEGRAM_SEND_BURST, TELEGRAM_SEND_REFILL_MS);
+    sendRetryUntil = 0;
+    pollRetryUntil = 0;
+    rateLimitHits = 0;
+    lastErrorCode = 0;
+
+    commandTable = nullptr;
+    commandCount = 0;
 
     // Callbacks are null by default
     callbackOnline = nullptr;
@@ -57,8 +139,7 @@ bool TelegramBot::begin(const String& botToken, int64_t userId) {
     DEBUG_PRINTLN("[Telegram] Initializing bot...");
 
     // Initialize Preferences for flash storage
-    if (!preferences.begin(STORAGE_NAMESPACE, false)) {
-        DEBUG_PRINTLN("[Telegram] ERROR: Failed to initialize Preferences!");
+    if (!openStorage()) {
         return false;
     }
 
@@ -70,21 +151,22 @@ bool TelegramBot::begin(const String& botToken, int64_t userId) {
 
     setAuthorizedUserId(userId);
 
-    // Configure HTTPS client
-    // IMPORTANT: We're using insecure mode (no certificate validation)
+    // Same bot as before: go on where it left off
+    restoreOffset();
+
+    // NOTE: The HTTPS client does not validate certificates
     // This is acceptable for Telegram API as we're not sending sensitive data
     // and it saves flash memory space (no need to store CA certificates)
-    client.setInsecure();
 
-    // Get bot information from Telegram
+    // Save configuration to flash
+    saveConfiguration();
+
+    // Get bot information from Telegram (saved as cache)
     if (!getBotInfo()) {
         DEBUG_PRINTLN("[Telegram] WARNING: Failed to get bot info");
         // Continue anyway - might be temporary network issue
     }
 
-    // Save configuration to flash
-    saveConfiguration();
-
     updateStatus(BOT_ONLINE);
 
     DEBUG_PRINTLN("[Telegram] Initialization complete");
@@ -94,23 +176,49 @@ bool TelegramBot::begin(const String& botToken, int64_t userId) {
 bool TelegramBot::beginFromStorage() {
     DEBUG_PRINTLN("[Telegram] Loading configuration from storage...");
 
+    if (!openStorage()) {
+        return false;
+    }
+
     if (!loadConfiguration()) {
         DEBUG_PRINTLN("[Telegram] No stored configuration found");
         updateStatus(BOT_NO_TOKEN);
         return false;
     }
 
-    // Configure HTTPS client
-    client.setInsecure();
+    restoreOffset();
 
-    // Get bot information
-    if (!getBotInfo()) {
-        DEBUG_PRINTLN("[Telegram] WARNING: Failed to get bot info");
+    // No network yet - connect() brings the bot online later
+    updateStatus(BOT_CONNECTING);
+
+    DEBUG_PRINTLN("[Telegram] Loaded from storage successfully");
+    return true;
+}
+
+bool TelegramBot::connect() {
+    if (!isConfigured()) {
+        updateStatus(BOT_NO_TOKEN);
+        return false;
     }
 
-    updateStatus(BOT_ONLINE);
+    DEBUG_PRINTLN("[Telegram] Connecting...");
 
-    DEBUG_PRINTLN("[Telegram] Loaded from storage successfully");
+    // Username only changes with the token, so it is normally cached
+    // in flash and this getMe round-trip is skipped
+    if (botUsername.length() == 0) {
+        if (!getBotInfo()) {
+            DEBUG_PRINTLN("[Telegram] WARNING: Failed to get bot info");
+            updateStatus(BOT_OFFLINE);
+            return false;
+        }
+    } else {
+        DEBUG_PRINTF("[Telegram] Bot username (cached): @%s\n", botUsername.c_str());
+    }
+
+    // Nothing else to ask: polling goes on from lastUpdateId (see
+    // restoreOffset), and poll() skips commands that are too old
+    // (we don't want an old /wake to trigger on boot!)
+    updateStatus(BOT_ONLINE);
     return true;
 }
 
@@ -123,7 +231,15 @@ bool TelegramBot::setBotToken(const String& token) {
         return false;
     }
 
+    // Cached username and update position belong to the old bot
+    if (token != botToken) {
+        botUsername = "";
+        lastUpdateId = 0;
+    }
+
     botToken = token;
+    pollTransport.setToken(botToken.c_str());
+    sendTransport.setToken(botToken.c_str());
     DEBUG_PRINTLN("[Telegram] Bot token set");
     return true;
 }
@@ -138,6 +254,7 @@ bool TelegramBot::saveConfiguration() {
 
     preferences.putString(KEY_TELEGRAM_TOKEN, botToken);
     preferences.putLong64(KEY_TELEGRAM_USER_ID, authorizedUserId);
+    preferences.putString(KEY_TELEGRAM_BOT_NAME, botUsername);
 
     DEBUG_PRINTLN("[Telegram] Configuration saved");
     return true;
@@ -148,6 +265,13 @@ bool TelegramBot::loadConfiguration() {
 
     botToken = preferences.getString(KEY_TELEGRAM_TOKEN, "");
     authorizedUserId = preferences.getLong64(KEY_TELEGRAM_USER_ID, 0);
+    botUsername = preferences.getString(KEY_TELEGRAM_BOT_NAME, "");
+
+    // Too long for the request path: treat as not configured
+    if (!pollTransport.setToken(botToken.c_str()) ||
+        !sendTransport.setToken(botToken.c_str())) {
+        botToken = "";
+    }
 
     if (botToken.length() == 0 || authorizedUserId == 0) {
         DEBUG_PRINTLN("[Telegram] Incomplete configuration");
@@ -158,23 +282,75 @@ bool TelegramBot::loadConfiguration() {
     return true;
 }
 
+void TelegramBot::clearConfiguration() {
+    DEBUG_PRINTLN("[Telegram] Clearing configuration...");
+
+    preferences.remove(KEY_TELEGRAM_TOKEN);
+    preferences.remove(KEY_TELEGRAM_USER_ID);
+    preferences.remove(KEY_TELEGRAM_BOT_NAME);
+    preferences.remove(KEY_TELEGRAM_OFFSET);
+
+    // The RTC copy of the offset would survive the restart
+    rtcOffset.magic = 0;
+
+    botToken = "";
+    pollTransport.setToken("");
+    sendTransport.setToken("");
+    authorizedUserId = 0;
+    botUsername = "";
+    lastUpdateId = 0;
+    offsetDirty = false;
+
+    pollTransport.close();
+    sendTransport.close();
+    updateStatus(BOT_NO_TOKEN);
+
+    DEBUG_PRINTLN("[Telegram] Configuration cleared");
+}
+
+bool TelegramBot::isPollHeld() const {
+    return pollTransport.isHolding();
+}
+
 bool TelegramBot::isConfigured() const {
     return (botToken.length() > 0 && authorizedUserId != 0);
 }
 
+void TelegramBot::setApiServer(const char* host, uint16_t port, bool useTls) {
+    // Also closes the open connections (they go to the old server)
+    if (!pollTransport.setServer(useTls ? (Client&)client : (Client&)plainClient,
+                                 host, port, useTls) ||
+        !sendTransport.setServer(useTls ? (Client&)sendClient : (Client&)plainSendClient,
+                                 host, port, useTls)) {
+        DEBUG_PRINTLN("[Telegram] ERROR: API server name too long");
+        return;
+    }
+
+    apiHost = host;
+    apiPort = port;
+    apiTls = useTls;
+
+    DEBUG_PRINTF("[Telegram] API server: %s://%s:%u\n",
+                useTls ? "https" : "http", host, port);
+}
+
 // ===============================================================
 // MESSAGE POLLING
 // ===============================================================
 
 bool TelegramBot::poll() {
     unsigned long currentTime = millis();
+    bool longPoll = (TELEGRAM_LONG_POLL_TIMEOUT_S > 0);
 
-    // Don't poll too frequently (respect TELEGRAM_POLL_INTERVAL_MS)
-    if (currentTime - lastPollTime < TELEGRAM_POLL_INTERVAL_MS) {
+    // The caller decides the cadence (see poll_policy.h); this only
+    // guards against polling too fast by mistake. A long poll waits
+    // on the server instead, so no gap is needed
+    if (!longPoll && currentTime - lastPollTime < TELEGRAM_POLL_MIN_INTERVAL_MS) {
         return false;
     }
 
     lastPollTime = currentTime;
+    lastMessageDate = 0;
 
     if (!isConfigured()) {
         DEBUG_PRINTLN("[Telegram] Cannot poll - bot not configured");
@@ -182,63 +358,79 @@ bool TelegramBot::poll() {
         return false;
     }
 
-    DEBUG_PRINTLN("[Telegram] Polling for new messages...");
+    if (!pollTransport.isHolding()) {
+        DEBUG_PRINTLN("[Telegram] Polling for new messages...");
+    }
 
     // Build request parameters
     // offset = lastUpdateId + 1 (get only new messages)
-    // limit = 10 (max 10 messages per request)
-    // timeout = 5 (long polling - wait up to 5 seconds for new messages)
+    // limit = TELEGRAM_UPDATE_SLOTS (max updates per request)
+    // timeout = long polling - Telegram holds the request open until a
+    //           message arrives or the timeout (seconds) runs out
     String params = "offset=" + String(lastUpdateId + 1);
-    params += "&limit=10";
-    params += "&timeout=5";
-
-    // Make API request
-    String response = makeRequest("getUpdates", params);
-
-    if (response.length() == 0) {
-        DEBUG_PRINTLN("[Telegram] ERROR: Empty response");
+    params += "&limit=" + String(TELEGRAM_UPDATE_SLOTS);
+    params += "&timeout=" + String(TELEGRAM_LONG_POLL_TIMEOUT_S);
+
+    // Make API request (response is parsed while it arrives)
+    if (!requestUpdates(params, (unsigned long)TELEGRAM_LONG_POLL_TIMEOUT_S * 1000UL)) {
+        if (pollTransport.wasInterrupted()) {
+            // Cut short on purpose (other work waiting) - not an error,
+            // the request stays open for the next poll()
+            return false;
+        }
+        DEBUG_PRINTLN("[Telegram] ERROR: No response");
         updateStatus(BOT_OFFLINE);
         return false;
     }
 
-    // Parse JSON response
-    JsonDocument doc;
-    if (!parseResponse(response, doc)) {
-        DEBUG_PRINTLN("[Telegram] ERROR: Failed to parse response");
+    if (!updateBatch.ok) {
+        DEBUG_PRINTF("[Telegram] API error: %s\n", updateBatch.description);
+        if (updateBatch.errorCode == 429) {
+            applyRetryAfter(updateBatch.retryAfter, pollRetryUntil);
+        }
         return false;
     }
 
-    // Extract messages from response
-    JsonArray results = doc["result"].as<JsonArray>();
+    // Telegram answered - we are online even if there is nothing new
+    // (BOT_RATE_LIMITED counts as online too)
+    if (!isOnline()) {
+        updateStatus(BOT_ONLINE);
+    }
+    updateRateLimitStatus();
+
+    // Commands from before boot: checked until the backlog is read
+    // (see stale_filter.h)
+    staleFilter.beginBatch(updateBatch, (unsigned long)time(nullptr));
 
-    if (results.size() == 0) {
-        // No new messages
+    if (updateBatch.count == 0) {
+        // No new messages - a quiet moment to write a pending position
+        saveOffset();
         return false;
     }
 
-    DEBUG_PRINTF("[Telegram] Received %d new message(s)\n", results.size());
+    DEBUG_PRINTF("[Telegram] Received %d new update(s)\n", updateBatch.count);
 
-    // Process each message
-    for (JsonObject result : results) {
-        // Update lastUpdateId to mark this message as processed
-        lastUpdateId = result["update_id"].as<int32_t>();
+    int staleCount = 0;
 
-        // Extract message data
-        if (result.containsKey("message")) {
-            JsonObject msg = result["message"];
+    // Process each update
+    for (int i = 0; i < updateBatch.count; i++) {
+        const TelegramUpdate& update = updateBatch.updates[i];
 
-            TelegramMessage telegramMsg;
-            telegramMsg.chatId = msg["chat"]["id"].as<int64_t>();
-            telegramMsg.messageId = msg["message_id"].as<int32_t>();
-            telegramMsg.text = msg["text"].as<String>();
-            telegramMsg.timestamp = msg["date"].as<unsigned long>();
+        // Update lastUpdateId to mark this update as processed
+        lastUpdateId = update.updateId;
+        offsetDirty = true;
 
-            // Get username if available
-            if (msg["from"].containsKey("username")) {
-                telegramMsg.username = msg["from"]["username"].as<String>();
-            } else {
-                telegramMsg.username = "unknown";
-            }
+        // Sent long before the device came back: skip
+        if (update.kind == UPDATE_MESSAGE && staleFilter.isStale(update)) {
+            DEBUG_PRINTF("[Telegram] Skipping old message: %s\n", update.text);
+            staleCount++;
+            continue;
+        }
+
+        // Extract message data (other updates are only acknowledged)
+        if (update.kind == UPDATE_MESSAGE) {
+            // Points into the update's slot (no copy, no heap)
+            TelegramMessage telegramMsg = messageFromUpdate(update, MESSAGE_FROM_TELEGRAM);
 
             // Check authorization
             if (!isAuthorized(telegramMsg.chatId)) {
@@ -256,70 +448,95 @@ bool TelegramBot::poll() {
                 continue;  // Skip processing this message
             }
 
-            // Add to message queue
-            queueMessage(telegramMsg);
-
-            // Process message immediately
+            // Run it now, while the slot is still valid
+            lastMessageDate = telegramMsg.timestamp;
             processMessage(telegramMsg);
+        } else if (update.kind == UPDATE_CALLBACK_QUERY) {
+            // Inline button tapped (e.g. STOP under the live status)
+            processCallbackQuery(update);
         }
     }
 
-    updateStatus(BOT_ONLINE);
-    return true;
-}
+    saveOffset();
+
+    // Say so, instead of dropping them silently
+    if (staleCount > 0) {
+        staleCommands += staleCount;
 
-bool TelegramBot::getNextMessage(TelegramMessage& message) {
-    if (messageQueueCount == 0) {
-        return false;  // No messages in queue
+        char note[96];
+        snprintf(note, sizeof(note), MSG_STALE_COMMANDS, staleCount);
+        sendMessage(note);
     }
 
-    // Get message from queue tail (FIFO)
-    message = messageQueue[messageQueueTail];
+    return true;
+}
 
-    // Update queue pointers
-    messageQueueTail = (messageQueueTail + 1) % MESSAGE_QUEUE_SIZE;
-    messageQueueCount--;
+// ===============================================================
+// SENDING MESSAGES
+// ===============================================================
 
-    return true;
+bool TelegramBot::sendMessage(const String& text) {
+    return sendMessage(authorizedUserId, text);
+}
+
+bool TelegramBot::sendMessage(int64_t chatId, const String& text) {
+    return postMessage(chatId, text, nullptr, nullptr);
 }
 
-void TelegramBot::markAllRead() {
-    DEBUG_PRINTLN("[Telegram] Marking all messages as read...");
+bool TelegramBot::sendMessage(const String& text, int32_t& messageId,
+                              const TelegramButton* button) {
+    return postMessage(authorizedUserId, text, &messageId, button);
+}
 
-    // Request with offset=-1 gets the latest update ID
-    // Then we can start from there
-    String response = makeRequest("getUpdates", "offset=-1&limit=1");
+bool TelegramBot::editMessage(int32_t messageId, const String& text,
+                              const TelegramButton* button) {
+    lastErrorCode = 0;
 
-    if (response.length() == 0) {
-        return;
+    if (!isConfigured() || !takeSendToken()) {
+        return false;
     }
 
+    DEBUG_PRINTF("[Telegram] Editing message %d\n", messageId);
+
     JsonDocument doc;
-    if (!parseResponse(response, doc)) {
-        return;
-    }
+    doc["chat_id"] = authorizedUserId;
+    doc["message_id"] = messageId;
+    doc["text"] = text;
+    doc["parse_mode"] = "Markdown";
+    addButton(doc, button);
 
-    JsonArray results = doc["result"].as<JsonArray>();
-    if (results.size() > 0) {
-        lastUpdateId = results[0]["update_id"].as<int32_t>();
-        DEBUG_PRINTF("[Telegram] Last update ID: %d\n", lastUpdateId);
+    String jsonBody;
+    serializeJson(doc, jsonBody);
+
+    JsonDocument responseDoc;
+    if (!makePostRequest("editMessageText", jsonBody, responseDoc)) {
+        DEBUG_PRINTLN("[Telegram] ERROR: Failed to edit message");
+        return false;
     }
-}
 
-// ===============================================================
-// SENDING MESSAGES
-// ===============================================================
+    return checkResponse(responseDoc);
+}
 
-bool TelegramBot::sendMessage(const String& text) {
-    return sendMessage(authorizedUserId, text);
+int TelegramBot::getLastErrorCode() const {
+    return lastErrorCode;
 }
 
-bool TelegramBot::sendMessage(int64_t chatId, const String& text) {
+bool TelegramBot::postMessage(int64_t chatId, const String& text, int32_t* messageId,
+                              const TelegramButton* button) {
+    lastErrorCode = 0;
+
     if (!isConfigured()) {
         DEBUG_PRINTLN("[Telegram] Cannot send - bot not configured");
         return false;
     }
 
+    // Over Telegram's limit: send nothing, the caller keeps the message
+    if (!takeSendToken()) {
+        DEBUG_PRINTF("[Telegram] Send deferred (rate limit), retry in %lums\n",
+                    getSendWaitMs());
+        return false;
+    }
+
     DEBUG_PRINTF("[Telegram] Sending message to %lld: %s\n", chatId, text.c_str());
 
     // Build JSON request body
@@ -327,24 +544,29 @@ bool TelegramBot::sendMessage(int64_t chatId, const String& text) {
     doc["chat_id"] = chatId;
     doc["text"] = text;
     doc["parse_mode"] = "Markdown";  // Enable markdown formatting
+    if (button != nullptr) {
+        addButton(doc, button);
+    }
 
     String jsonBody;
     serializeJson(doc, jsonBody);
 
     // Make POST request
-    String response = makePostRequest("sendMessage", jsonBody);
-
-    if (response.length() == 0) {
+    JsonDocument responseDoc;
+    if (!makePostRequest("sendMessage", jsonBody, responseDoc)) {
         DEBUG_PRINTLN("[Telegram] ERROR: Failed to send message");
         return false;
     }
 
     // Check if successful
-    JsonDocument responseDoc;
-    if (!parseResponse(response, responseDoc)) {
+    if (!checkResponse(responseDoc)) {
         return false;
     }
 
+    if (messageId != nullptr) {
+        *messageId = responseDoc["result"]["message_id"].as<int32_t>();
+    }
+
     DEBUG_PRINTLN("[Telegram] Message sent successfully");
     return true;
 }
@@ -352,7 +574,7 @@ bool TelegramBot::sendMessage(int64_t chatId, const String& text) {
 bool TelegramBot::sendMessageWithButtons(const String& text,
                                         const String buttons[],
                                         int buttonCount) {
-    if (!isConfigured()) {
+    if (!isConfigured() || !takeSendToken()) {
         return false;
     }
 
@@ -376,54 +598,104 @@ bool TelegramBot::sendMessageWithButtons(const String& text,
     serializeJson(doc, jsonBody);
 
     // Make POST request
-    String response = makePostRequest("sendMessage", jsonBody);
+    JsonDocument responseDoc;
+    return makePostRequest("sendMessage", jsonBody, responseDoc) &&
+           checkResponse(responseDoc);
+}
+
+void TelegramBot::addButton(JsonDocument& doc, const TelegramButton* button) {
+    JsonArray keyboard = doc["reply_markup"]["inline_keyboard"].to<JsonArray>();
+
+    // No button: an empty keyboard removes the old one from an edit
+    if (button == nullptr) {
+        return;
+    }
+
+    JsonObject entry = keyboard.add<JsonArray>().add<JsonObject>();
+    entry["text"] = button->label;
+    entry["callback_data"] = button->data;
+}
+
+void TelegramBot::processCallbackQuery(const TelegramUpdate& update) {
+    // Check authorization (the user who tapped, not the chat)
+    if (!isAuthorized(update.chatId)) {
+        DEBUG_PRINTF("[Telegram] Unauthorized button from: %lld\n", update.chatId);
+
+        if (callbackUnauthorizedAccess != nullptr) {
+            callbackUnauthorizedAccess(update.chatId, update.text);
+        }
+
+        answerCallbackQuery(update.callbackId, "⛔ Unauthorized");
+        return;
+    }
+
+    DEBUG_PRINTF("[Telegram] Button: %s\n", update.text);
+
+    // Same path as a typed command, so /stop by button and by text
+    // run the same handler
+    TelegramMessage telegramMsg = messageFromUpdate(update, MESSAGE_FROM_BUTTON);
+    telegramMsg.timestamp = 0;    // Button presses have no date
+
+    // Run the command first: a /stop reaches the alarm task before
+    // the answer's round-trip
+    processMessage(telegramMsg);
+
+    // The phone shows a spinner on the button until this arrives
+    answerCallbackQuery(update.callbackId, "");
+}
+
+bool TelegramBot::answerCallbackQuery(const char* callbackId, const char* text) {
+    JsonDocument doc;
+    doc["callback_query_id"] = callbackId;
+    if (text[0] != '\0') {
+        doc["text"] = text;
+    }
 
-    return (response.length() > 0);
+    String jsonBody;
+    serializeJson(doc, jsonBody);
+
+    JsonDocument responseDoc;
+    return makePostRequest("answerCallbackQuery", jsonBody, responseDoc) &&
+           checkResponse(responseDoc);
 }
 
 // ===============================================================
 // COMMAND HANDLING
 // ===============================================================
 
-void TelegramBot::onCommand(const String& command,
-                           std::function<void(TelegramMessage)> callback) {
-    if (commandCallbackCount >= MAX_COMMANDS) {
-        DEBUG_PRINTLN("[Telegram] ERROR: Max commands reached!");
-        return;
-    }
+void TelegramBot::setCommandTable(const TelegramCommand* table, size_t count) {
+    commandTable = table;
+    commandCount = count;
 
-    // Store command and callback
-    commandCallbacks[commandCallbackCount].command = command;
-    commandCallbacks[commandCallbackCount].callback = callback;
-    commandCallbackCount++;
+    DEBUG_PRINTF("[Telegram] Command table set: %u commands\n", (unsigned)count);
+}
 
-    DEBUG_PRINTF("[Telegram] Registered command: %s\n", command.c_str());
+String TelegramBot::getCommandHelp() const {
+    String help;
+    for (size_t i = 0; i < commandCount; i++) {
+        help += commandTable[i].name;
+        if (commandTable[i].usage[0] != '\0') {
+            help += " ";
+            help += commandTable[i].usage;
+        }
+        help += " - ";
+        help += commandTable[i].description;
+        help += "\n";
+    }
+    return help;
 }
 
 void TelegramBot::processMessage(const TelegramMessage& message) {
-    DEBUG_PRINTF("[Telegram] Processing: %s\n", message.text.c_str());
-
-    // Check if message is a command (starts with '/')
-    if (message.text.startsWith("/")) {
-        // Extract command (everything before first space)
-        int spaceIndex = message.text.indexOf(' ');
-        String command = (spaceIndex > 0) ?
-                        message.text.substring(0, spaceIndex) :
-                        message.text;
-
-        // Find matching callback
-        for (int i = 0; i < commandCallbackCount; i++) {
-            if (commandCallbacks[i].command.equalsIgnoreCase(command)) {
-                DEBUG_PRINTF("[Telegram] Triggering callback for: %s\n", command.c_str());
-                commandCallbacks[i].callback(message);
-                return;
-            }
-        }
+    DEBUG_PRINTF("[Telegram] Processing: %s\n", message.text);
 
-        // No callback found for this command
-        DEBUG_PRINTF("[Telegram] Unknown command: %s\n", command.c_str());
-        sendMessage("❓ Unknown command. Try:\n/wake - Start alarm\n/status - Device status\n/test - Test buzzers");
+    DispatchResult result = dispatchCommand(commandTable, commandCount,
+                                            message, botUsername.c_str());
+    if (result != DISPATCH_UNKNOWN) {
+        return;
     }
+
+    // No handler for this command
+    sendMessage("❓ Unknown command. Send /help for the list of commands.");
 }
 
 // ===============================================================
@@ -439,6 +711,31 @@ bool TelegramBot::isWakeRateLimited() const {
     return (elapsed < TELEGRAM_WAKE_COOLDOWN_MS);
 }
 
+unsigned long TelegramBot::getBackoffRemaining() const {
+    unsigned long breakerMs = pollTransport.getBreaker().getRemainingMs(millis());
+    unsigned long retryAfterMs = remainingUntil(pollRetryUntil);
+    return (breakerMs > retryAfterMs) ? breakerMs : retryAfterMs;
+}
+
+unsigned long TelegramBot::getSendWaitMs() const {
+    unsigned long waitMs = sendBucket.getWaitMs(millis());
+
+    unsigned long retryAfterMs = remainingUntil(sendRetryUntil);
+    if (retryAfterMs > waitMs) {
+        waitMs = retryAfterMs;
+    }
+
+    unsigned long breakerMs = pollTransport.getBreaker().getRemainingMs(millis());
+    if (breakerMs > waitMs) {
+        waitMs = breakerMs;
+    }
+    return waitMs;
+}
+
+unsigned long TelegramBot::getLastMessageDate() const {
+    return lastMessageDate;
+}
+
 unsigned long TelegramBot::getWakeCooldownRemaining() const {
     if (!isWakeRateLimited()) {
         return 0;
@@ -461,7 +758,7 @@ TelegramBotStatus TelegramBot::getStatus() const {
 }
 
 bool TelegramBot::isOnline() const {
-    return (status == BOT_ONLINE);
+    return (status == BOT_ONLINE || status == BOT_RATE_LIMITED);
 }
 
 String TelegramBot::getBotUsername() const {
@@ -486,7 +783,11 @@ String TelegramBot::getStatusString() const {
             result += "Connecting...";
             break;
         case BOT_ONLINE:
-            result += "Online - Polling every " + String(TELEGRAM_POLL_INTERVAL_MS / 1000) + "s";
+            if (TELEGRAM_LONG_POLL_TIMEOUT_S > 0) {
+                result += "Online - Long polling (" + String(TELEGRAM_LONG_POLL_TIMEOUT_S) + "s)";
+            } else {
+                result += "Online - Polling (adaptive)";
+            }
             if (botUsername.length() > 0) {
                 result += " (@" + botUsername + ")";
             }
@@ -494,13 +795,61 @@ String TelegramBot::getStatusString() const {
         case BOT_OFFLINE:
             result += "Offline";
             break;
-        case BOT_RATE_LIMITED:
-            result += "Rate Limited";
+        case BOT_RATE_LIMITED: {
+            unsigned long pollMs = remainingUntil(pollRetryUntil);
+            unsigned long sendMs = remainingUntil(sendRetryUntil);
+            result += "Rate Limited - retry in " +
+                      String(((pollMs > sendMs) ? pollMs : sendMs) / 1000) + "s";
             break;
+        }
         default:
             result += "Unknown";
     }
 
+    // Keep-alive statistics over both connections
+    uint32_t handshakeCount = client.getFullHandshakeCount() +
+                              client.getResumedHandshakeCount() +
+                              sendClient.getFullHandshakeCount() +
+                              sendClient.getResumedHandshakeCount();
+    uint32_t reusedCount = pollTransport.getReusedCount() + sendTransport.getReusedCount();
+    unsigned long savedMs = handshakeTimeSaved(client, pollTransport.getReusedCount()) +
+                            handshakeTimeSaved(sendClient, sendTransport.getReusedCount());
+
+    unsigned long uptimeMs = millis();
+    unsigned long handshakesPerHour = uptimeMs > 0 ?
+        (unsigned long)((uint64_t)handshakeCount * 3600000ULL / uptimeMs) : 0;
+
+    result += "\n[Telegram] HTTPS: " + String(handshakeCount) + " handshakes (" +
+              String(handshakesPerHour) + "/h), " + String(reusedCount) +
+              " requests reused (~" + String(savedMs / 1000) + "s saved)";
+    if (TELEGRAM_LONG_POLL_TIMEOUT_S > 0) {
+        result += "\n[Telegram] Long polls cut short for other work: " +
+                  String(pollTransport.getLongPollInterrupts()) + " (kept open)";
+    }
+    result += "\n[Telegram] Last response: " + String((unsigned long)lastResponseBytes) +
+              " bytes, heap " + String(lastResponseHeapBytes) + " bytes (max " +
+              String(maxResponseHeapBytes) + ")";
+    result += "\n[Telegram] Sending: " + String(sendBucket.getTokens(millis())) + "/" +
+              String(TELEGRAM_SEND_BURST) + " tokens, " + String(sendBucket.getDeniedCount()) +
+              " deferred, 429 answers: " + String(rateLimitHits);
+    const CircuitBreaker& breaker = pollTransport.getBreaker();
+    result += "\n[Telegram] Circuit: " + String(breaker.getStateName());
+    if (breaker.getState() == CIRCUIT_OPEN) {
+        result += " (retry in " + String(breaker.getRemainingMs(millis()) / 1000) + "s)";
+    }
+    result += ", " + String(breaker.getConsecutiveFailures()) + " failures in a row, tripped " +
+              String(breaker.getTripCount()) + "x, " + String(breaker.getFastFailCount()) +
+              " requests fast-failed";
+    result += "\n[Telegram] Update position: " + String(lastUpdateId) +
+              (offsetDirty ? " (not in flash yet)" : "") + ", old commands skipped: " +
+              String(staleCommands);
+    result += "\n[Telegram] Poll " + client.getStatusString();
+    result += "\n[Telegram] Send " + sendClient.getStatusString();
+    if (apiHost != TELEGRAM_API_HOST) {
+        result += "\n[Telegram] API server: " + String(apiTls ? "https://" : "http://") +
+                  apiHost + ":" + String(apiPort);
+    }
+
     return result;
 }
 
@@ -516,179 +865,253 @@ void TelegramBot::onOffline(std::function<void()> callback) {
     callbackOffline = callback;
 }
 
-void TelegramBot::onUnauthorizedAccess(std::function<void(int64_t, String)> callback) {
+void TelegramBot::onUnauthorizedAccess(std::function<void(int64_t, const char*)> callback) {
     callbackUnauthorizedAccess = callback;
 }
 
+void TelegramBot::onLongPollInterrupt(std::function<bool()> callback) {
+    callbackLongPollInterrupt = callback;
+}
+
 // ===============================================================
 // PRIVATE HELPER FUNCTIONS
 // ===============================================================
 
-String TelegramBot::makeRequest(const String& endpoint, const String& params) {
-    // Build URL: https://api.telegram.org/bot<TOKEN>/<endpoint>?<params>
-    String url = "/bot" + botToken + "/" + endpoint;
-    if (params.length() > 0) {
-        url += "?" + params;
-    }
+bool TelegramBot::makeRequest(const String& endpoint, const String& params,
+                              JsonDocument& response) {
+    return sendRequest(sendTransport, "GET", endpoint, params, "", jsonParser(response), 0);
+}
 
-    DEBUG_PRINTF("[Telegram] GET %s\n", url.c_str());
+bool TelegramBot::makePostRequest(const String& endpoint, const String& jsonBody,
+                                  JsonDocument& response) {
+    return sendRequest(sendTransport, "POST", endpoint, "", jsonBody, jsonParser(response), 0);
+}
 
-    // Connect to Telegram API
-    if (!client.connect(TELEGRAM_HOST, TELEGRAM_PORT)) {
-        DEBUG_PRINTLN("[Telegram] ERROR: Connection failed");
-        return "";
-    }
+bool TelegramBot::requestUpdates(const String& params, unsigned long waitMs) {
+    // Straight into the update slots - no JSON tree in heap
+    return sendRequest(pollTransport, "GET", "getUpdates", params, "", [this](Stream& body) {
+        UpdateParser parser(body);
+        return parser.parse(updateBatch);
+    }, waitMs);
+}
 
-    // Send HTTP GET request
-    client.print(String("GET ") + url + " HTTP/1.1\r\n" +
-                "Host: " + TELEGRAM_HOST + "\r\n" +
-                "User-Agent: ESP32\r\n" +
-                "Connection: close\r\n\r\n");
+std::function<bool(Stream&)> TelegramBot::jsonParser(JsonDocument& response) {
+    return [&response](Stream& body) {
+        DeserializationError jsonError = deserializeJson(response, body);
 
-    // Wait for response with timeout
-    unsigned long timeout = millis() + TELEGRAM_API_TIMEOUT_MS;
-    while (client.available() == 0) {
-        if (millis() > timeout) {
-            DEBUG_PRINTLN("[Telegram] ERROR: Request timeout");
-            client.stop();
-            return "";
+        if (jsonError) {
+            DEBUG_PRINTF("[Telegram] JSON parse error: %s\n", jsonError.c_str());
+            return false;
         }
-        delay(10);
-    }
-
-    // Read response
-    String response = "";
-    bool headersEnded = false;
 
-    while (client.available()) {
-        String line = client.readStringUntil('\n');
-
-        // Skip HTTP headers (everything before blank line)
-        if (!headersEnded) {
-            if (line == "\r") {
-                headersEnded = true;
-            }
-            continue;
-        }
+        return true;
+    };
+}
 
-        // Read response body (JSON)
-        response += line;
+bool TelegramBot::sendRequest(BotTransport& via, const char* method, const String& endpoint,
+                              const String& params, const String& jsonBody,
+                              std::function<bool(Stream&)> parseBody,
+                              unsigned long waitMs) {
+    // Report to the stall watchdog if this request hangs
+    WatchdogSection section(WD_TELEGRAM_IO, endpoint.c_str());
+
+    // Parse time and the heap the parsed answer takes
+    bool measured = false;
+    uint32_t freeHeapBefore = 0;
+
+    BotTransport::BodyParser measuredParser = [&](Stream& body) {
+        measured = true;
+        freeHeapBefore = ESP.getFreeHeap();
+        uint32_t parseStart = PerfStats::startCycles();
+
+        bool parsed = parseBody(body);
+
+        perfStats.stop(PERF_TELEGRAM_PARSE, parseStart);
+        return parsed;
+    };
+
+    // A long poll cut short before is still open: its answer is the
+    // one for these parameters too (nothing was processed since)
+    bool success = via.isHolding() ?
+        via.resume(measuredParser) :
+        via.request(method, endpoint.c_str(), params.c_str(), jsonBody.c_str(),
+                    measuredParser, waitMs);
+
+    if (measured) {
+        recordResponseMemory(freeHeapBefore, via.getLastResponseBytes());
     }
 
-    client.stop();
-
-    return response;
+    return success;
 }
 
-String TelegramBot::makePostRequest(const String& endpoint, const String& jsonBody) {
-    // Build URL
-    String url = "/bot" + botToken + "/" + endpoint;
+void TelegramBot::recordResponseMemory(uint32_t freeHeapBefore, size_t bodyBytes) {
+    // Heap taken by the parsed response (the JsonDocument is still
+    // alive here), compared to before the response was read
+    uint32_t freeHeapAfter = ESP.getFreeHeap();
+    uint32_t heapUsed = (freeHeapBefore > freeHeapAfter) ? freeHeapBefore - freeHeapAfter : 0;
 
-    DEBUG_PRINTF("[Telegram] POST %s\n", url.c_str());
+    lastResponseBytes = bodyBytes;
+    lastResponseHeapBytes = heapUsed;
 
-    // Connect to Telegram API
-    if (!client.connect(TELEGRAM_HOST, TELEGRAM_PORT)) {
-        DEBUG_PRINTLN("[Telegram] ERROR: Connection failed");
-        return "";
+    if (heapUsed > maxResponseHeapBytes) {
+        maxResponseHeapBytes = heapUsed;
     }
+}
 
-    // Send HTTP POST request
-    client.print(String("POST ") + url + " HTTP/1.1\r\n" +
-                "Host: " + TELEGRAM_HOST + "\r\n" +
-                "User-Agent: ESP32\r\n" +
-                "Content-Type: application/json\r\n" +
-                "Content-Length: " + String(jsonBody.length()) + "\r\n" +
-                "Connection: close\r\n\r\n" +
-                jsonBody);
+bool TelegramBot::getBotInfo() {
+    DEBUG_PRINTLN("[Telegram] Getting bot info...");
 
-    // Wait for response
-    unsigned long timeout = millis() + TELEGRAM_API_TIMEOUT_MS;
-    while (client.available() == 0) {
-        if (millis() > timeout) {
-            DEBUG_PRINTLN("[Telegram] ERROR: Request timeout");
-            client.stop();
-            return "";
-        }
-        delay(10);
+    JsonDocument doc;
+    if (!makeRequest("getMe", "", doc) || !checkResponse(doc)) {
+        return false;
     }
 
-    // Read response (skip headers like in GET)
-    String response = "";
-    bool headersEnded = false;
-
-    while (client.available()) {
-        String line = client.readStringUntil('\n');
-
-        if (!headersEnded) {
-            if (line == "\r") {
-                headersEnded = true;
-            }
-            continue;
-        }
+    // Extract bot username
+    botUsername = doc["result"]["username"].as<String>();
 
-        response += line;
-    }
+    DEBUG_PRINTF("[Telegram] Bot username: @%s\n", botUsername.c_str());
 
-    client.stop();
+    // Cache it, so the next boot does not need this request
+    preferences.putString(KEY_TELEGRAM_BOT_NAME, botUsername);
 
-    return response;
+    return true;
 }
 
-bool TelegramBot::getBotInfo() {
-    DEBUG_PRINTLN("[Telegram] Getting bot info...");
+void TelegramBot::restoreOffset() {
+    uint32_t tokenHash = hashBytes((const uint8_t*)botToken.c_str(), botToken.length());
 
-    String response = makeRequest("getMe", "");
+    // Software restart: RTC memory is newest
+    if (isValidOffsetRecord(rtcOffset, tokenHash)) {
+        lastUpdateId = rtcOffset.lastUpdateId;
+        DEBUG_PRINTF("[Telegram] Update position from RTC memory: %d\n", lastUpdateId);
+        return;
+    }
 
-    if (response.length() == 0) {
-        return false;
+    // Power-on: the flash copy (up to TELEGRAM_OFFSET_SAVE_MS old)
+    OffsetRecord stored;
+    if (preferences.getBytes(KEY_TELEGRAM_OFFSET, &stored, sizeof(stored)) == sizeof(stored) &&
+        isValidOffsetRecord(stored, tokenHash)) {
+        lastUpdateId = stored.lastUpdateId;
+        rtcOffset = stored;
+        DEBUG_PRINTF("[Telegram] Update position from flash: %d\n", lastUpdateId);
+        return;
     }
 
-    JsonDocument doc;
-    if (!parseResponse(response, doc)) {
-        return false;
+    // New bot: Telegram starts with the oldest unconfirmed update
+    lastUpdateId = 0;
+    DEBUG_PRINTLN("[Telegram] No saved update position");
+}
+
+void TelegramBot::saveOffset() {
+    if (!offsetDirty) {
+        return;
     }
 
-    // Extract bot username
-    botUsername = doc["result"]["username"].as<String>();
+    // RTC memory is free to write - always up to date
+    rtcOffset.magic = OFFSET_RECORD_MAGIC;
+    rtcOffset.lastUpdateId = lastUpdateId;
+    rtcOffset.tokenHash = hashBytes((const uint8_t*)botToken.c_str(), botToken.length());
+    rtcOffset.checksum = offsetRecordChecksum(rtcOffset);
 
-    DEBUG_PRINTF("[Telegram] Bot username: @%s\n", botUsername.c_str());
+    // Flash wears out: write-behind, at most once per interval
+    unsigned long now = millis();
+    if (lastOffsetSave != 0 && now - lastOffsetSave < TELEGRAM_OFFSET_SAVE_MS) {
+        return;
+    }
 
-    return true;
+    preferences.putBytes(KEY_TELEGRAM_OFFSET, &rtcOffset, sizeof(rtcOffset));
+    lastOffsetSave = now;
+    offsetDirty = false;
 }
 
-bool TelegramBot::parseResponse(const String& response, JsonDocument& doc) {
-    // Parse JSON
-    DeserializationError error = deserializeJson(doc, response);
+bool TelegramBot::openStorage() {
+    // begin() fails if the namespace is already open (e.g. begin()
+    // after beginFromStorage()), so close it first
+    preferences.end();
 
-    if (error) {
-        DEBUG_PRINTF("[Telegram] JSON parse error: %s\n", error.c_str());
+    if (!preferences.begin(STORAGE_NAMESPACE, false)) {
+        DEBUG_PRINTLN("[Telegram] ERROR: Failed to initialize Preferences!");
         return false;
     }
 
+    return true;
+}
+
+bool TelegramBot::checkResponse(const JsonDocument& doc) {
     // Check if API call was successful
     bool ok = doc["ok"].as<bool>();
 
+    lastErrorCode = ok ? 0 : doc["error_code"].as<int>();
+
     if (!ok) {
         DEBUG_PRINTF("[Telegram] API error: %s\n",
                    doc["description"].as<String>().c_str());
+
+        // "Too Many Requests": Telegram says how long to stay quiet
+        if (lastErrorCode == 429) {
+            applyRetryAfter(doc["parameters"]["retry_after"].as<int>(), sendRetryUntil);
+        }
         return false;
     }
 
     return true;
 }
 
-void TelegramBot::queueMessage(const TelegramMessage& message) {
-    if (messageQueueCount >= MESSAGE_QUEUE_SIZE) {
-        DEBUG_PRINTLN("[Telegram] WARNING: Message queue full, dropping oldest");
-        // Drop oldest message (move tail forward)
-        messageQueueTail = (messageQueueTail + 1) % MESSAGE_QUEUE_SIZE;
-        messageQueueCount--;
+bool TelegramBot::takeSendToken() {
+    updateRateLimitStatus();
+
+    // Don't spend a token on a request that can't go out anyway
+    if (remainingUntil(sendRetryUntil) > 0 || pollTransport.getBreaker().getRemainingMs(millis()) > 0) {
+        return false;
+    }
+    return sendBucket.tryTake(millis());
+}
+
+void TelegramBot::applyRetryAfter(int retryAfterS, unsigned long& until) {
+    // No or nonsense value: wait a little anyway
+    if (retryAfterS <= 0) {
+        retryAfterS = 1;
+    } else if (retryAfterS > TELEGRAM_RETRY_AFTER_MAX_S) {
+        retryAfterS = TELEGRAM_RETRY_AFTER_MAX_S;
     }
 
-    // Add new message to queue head
-    messageQueue[messageQueueHead] = message;
-    messageQueueHead = (messageQueueHead + 1) % MESSAGE_QUEUE_SIZE;
-    messageQueueCount++;
+    // 0 means "no deadline"
+    until = millis() + (unsigned long)retryAfterS * 1000UL;
+    if (until == 0) {
+        until = 1;
+    }
+    rateLimitHits++;
+
+    DEBUG_PRINTF("[Telegram] Rate limited by Telegram - waiting %ds\n", retryAfterS);
+    updateRateLimitStatus();
+}
+
+void TelegramBot::updateRateLimitStatus() {
+    // Forget passed deadlines (a stale one would look pending again
+    // after millis() wraps around)
+    if (remainingUntil(sendRetryUntil) == 0) {
+        sendRetryUntil = 0;
+    }
+    if (remainingUntil(pollRetryUntil) == 0) {
+        pollRetryUntil = 0;
+    }
+
+    // Offline or not set up: that status says more
+    if (!isOnline()) {
+        return;
+    }
+
+    bool limited = (sendRetryUntil != 0 || pollRetryUntil != 0);
+    updateStatus(limited ? BOT_RATE_LIMITED : BOT_ONLINE);
+}
+
+unsigned long TelegramBot::remainingUntil(unsigned long until) {
+    if (until == 0) {
+        return 0;
+    }
+
+    long remaining = (long)(until - millis());
+    return (remaining > 0) ? (unsigned long)remaining : 0;
 }
 
 bool TelegramBot::isAuthorized(int64_t userId) const {
@@ -705,10 +1128,12 @@ void TelegramBot::updateStatus(TelegramBotStatus newStatus) {
 
     DEBUG_PRINTF("[Telegram] Status changed: %d -> %d\n", oldStatus, newStatus);
 
-    // Trigger callbacks
-    if (newStatus == BOT_ONLINE && callbackOnline != nullptr) {
+    // Trigger callbacks (being rate limited is still online)
+    bool wasOnline = (oldStatus == BOT_ONLINE || oldStatus == BOT_RATE_LIMITED);
+
+    if (isOnline() && !wasOnline && callbackOnline != nullptr) {
         callbackOnline();
-    } else if (oldStatus == BOT_ONLINE && newStatus != BOT_ONLINE) {
+    } else if (wasOnline && !isOnline()) {
         if (callbackOffline != nullptr) {
             callbackOffline();
         }
@@ -729,6 +1154,12 @@ bool TelegramBot::validateTokenFormat(const String& token) const {
         return false;
     }
 
+    // Must fit the transport's copy (see bot_transport.h)
+    if (token.length() >= TELEGRAM_TOKEN_MAX_BYTES) {
+        DEBUG_PRINTLN("[Telegram] Invalid token format (too long)");
+        return false;
+    }
+
     return true;
 }
 
@@ -738,8 +1169,25 @@ bool TelegramBot::validateTokenFormat(const String& token) const {
  * ===============================================================
  *
  * LONG POLLING vs WEBHOOKS:
- * This implementation uses "long polling" mode where we repeatedly
- * ask Telegram "any new messages?" every 5 seconds.
+ * poll() asks getUpdates with timeout=TELEGRAM_LONG_POLL_TIMEOUT_S
+ * (50 s). Telegram holds the request open until a message arrives,
+ * so a /wake or /stop is delivered within one round-trip. After 50 s
+ * without a message the answer is empty and the network task simply
+ * polls again (see poll_policy.h). TELEGRAM_LONG_POLL_TIMEOUT_S 0
+ * goes back to asking every TELEGRAM_POLL_INTERVAL_MS.
+ *
+ * While the request is held open the network task can't send, so
+ * BotTransport asks the onLongPollInterrupt() callback every
+ * TELEGRAM_LONG_POLL_CHECK_MS. main.cpp answers true when alarm
+ * notifications, MQTT work or a network timer are waiting. The
+ * getUpdates request stays open on its connection and the next
+ * poll() goes on waiting for its answer, while the sends use a
+ * second connection (sendClient) - no TLS handshake per interrupt.
+ * An interrupt is not a failure for the circuit breaker. The price
+ * is a second TLS context in heap while both connections are open.
+ *
+ * test/test_long_poll measures both modes against the local mock
+ * server (tools/mock_telegram_api.py).
  *
  * Alternative is "webhooks" where Telegram pushes messages to our server.
  * But webhooks require:
@@ -754,7 +1202,9 @@ bool TelegramBot::validateTokenFormat(const String& token) const {
  * SECURITY CONSIDERATIONS:
  * 1. User ID Authorization: Only authorized user can send commands
  * 2. Rate Limiting: Prevents spam if token is leaked
- * 3. HTTPS: All communication encrypted (even though we use setInsecure())
+ * 3. HTTPS: Communication with Telegram is encrypted (even without
+ *    certificate checks). Plain HTTP (TELEGRAM_API_TLS false) is
+ *    only for a local mock server
  * 4. No Certificate Validation: Trade-off for simplicity and memory savings
  *
  * ===============================================================
@@ -763,7 +1213,27 @@ bool TelegramBot::validateTokenFormat(const String& token) const {
  * - Network failures: Return false, caller can retry
  * - Invalid JSON: Log error, return false
  * - API errors: Log description from Telegram, return false
- * - Queue overflow: Drop oldest message (FIFO)
+ * - Many commands at once: nothing to overflow. Each update runs its
+ *   handler straight from the parser's slot (TelegramMessage only
+ *   points into it) before the next getUpdates, which is what keeps
+ *   the path free of copies and heap
+ *
+ * ===============================================================
+ *
+ * COMMANDS SENT WHILE THE DEVICE WAS OFF:
+ * The getUpdates position (lastUpdateId) is kept in RTC memory and,
+ * at most every TELEGRAM_OFFSET_SAVE_MS, in flash. After a restart the
+ * first poll goes on exactly where the last one stopped, instead of
+ * an extra "offset=-1" request that threw every waiting command away.
+ * Until the backlog from before boot is read (every answer that
+ * fills all TELEGRAM_UPDATE_SLOTS), commands older than
+ * TELEGRAM_STALE_COMMAND_S are skipped (and the user told so), so a
+ * /wake from last night does not ring at boot - however many
+ * commands waited. /stop is never skipped. Later answers are not
+ * checked: a command that waited out a breaker back-off or a 429 was
+ * sent while the device was running. See stale_filter.h. After a
+ * power loss up to one interval of updates comes again; they are in
+ * the backlog and get the same check.
  *
  * ===============================================================
  */
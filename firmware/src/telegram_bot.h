@@ -4,10 +4,12 @@
  * ===============================================================
  *
  * This module handles all Telegram Bot API interactions:
- * - Polling for new messages from user
+ * - Long polling for new messages from user (Telegram holds the
+ *   request open, so a command arrives within a fraction of a second)
  * - Parsing commands (/wake, /test, /status, etc.)
  * - Sending responses and notifications
- * - Rate limiting to prevent spam
+ * - Rate limiting to prevent spam, and staying under Telegram's own
+ *   limits (token bucket, HTTP 429 "retry_after")
  *
  * WHY TELEGRAM?
  * - Works anywhere with internet (no VPN needed)
@@ -22,22 +24,26 @@
 #define TELEGRAM_BOT_H
 
 #include <Arduino.h>
-#include <WiFiClientSecure.h>  // For HTTPS connections
+#include "tls_client.h"         // For HTTPS connections
+#include "update_parser.h"      // For getUpdates answers
+#include "command_table.h"      // For command dispatch
+#include "stale_filter.h"       // For skipping commands from before boot
+#include "bot_transport.h"      // For sending Bot API requests
+#include "token_bucket.h"       // For staying under Telegram's send limit
 #include <ArduinoJson.h>        // For parsing Telegram JSON responses
 #include <Preferences.h>        // For storing bot token
 #include "config.h"             // Configuration constants
 
 // ===============================================================
-// TELEGRAM MESSAGE STRUCTURE
+// INLINE BUTTON
 // ===============================================================
-// Stores information about a received Telegram message
-
-struct TelegramMessage {
-    int64_t chatId;          // Unique chat ID (user identifier)
-    int32_t messageId;       // Message ID
-    String text;             // Message text content
-    String username;         // Sender's username
-    unsigned long timestamp; // When message was received (Unix timestamp)
+// A button under a message. Tapping it arrives like a typed message
+// with text = data, so data is a command ("/stop") and runs through
+// the command table
+
+struct TelegramButton {
+    const char* label;       // Shown on the button
+    const char* data;        // callback_data, max 64 bytes
 };
 
 // ===============================================================
@@ -51,7 +57,7 @@ enum TelegramBotStatus {
     BOT_CONNECTING,          // Attempting to connect to Telegram API
     BOT_ONLINE,              // Successfully connected and polling
     BOT_OFFLINE,             // Connection lost or failed
-    BOT_RATE_LIMITED         // Temporary rate limit from Telegram API
+    BOT_RATE_LIMITED         // Online, but Telegram asked us to wait (429)
 };
 
 // ===============================================================
@@ -84,10 +90,21 @@ public:
 
     // Initialize using stored credentials from flash
     // Useful for auto-start after reboot
+    // Does NOT touch the network (safe before WiFi is up) - call
+    // connect() once WiFi is connected
     //
     // RETURNS: true if credentials found and loaded
     bool beginFromStorage();
 
+    // Bring the bot online (needs WiFi, blocks for TLS requests)
+    // - Gets bot username from Telegram, unless cached in flash
+    // - Polling goes on from the kept getUpdates position (RTC memory
+    //   or flash), so this normally needs no request at all. Old
+    //   commands are skipped by the first polls (TELEGRAM_STALE_COMMAND_S)
+    //
+    // RETURNS: true if online (status is BOT_ONLINE)
+    bool connect();
+
     // ---------------------------------------------------------------
     // BOT CONFIGURATION
     // ---------------------------------------------------------------
@@ -108,10 +125,29 @@ public:
     // RETURNS: true if configuration found
     bool loadConfiguration();
 
+    // Erase token, user ID, cached bot name and saved offset from
+    // flash and RAM (factory reset). The bot is BOT_NO_TOKEN afterwards
+    void clearConfiguration();
+
+    // A long poll was cut short by the interrupt callback and is still
+    // open; the next poll() goes on waiting for its answer, so call it
+    // again soon
+    bool isPollHeld() const;
+
     // Check if bot is configured with token and user ID
     // RETURNS: true if ready to use
     bool isConfigured() const;
 
+    // Talk to another Bot API server than api.telegram.org (default:
+    // TELEGRAM_API_HOST/PORT/TLS from config.h), e.g. the local mock
+    // in tools/mock_telegram_api.py for testing. Closes the open
+    // connection
+    //
+    // host: Name or IP address (shorter than TELEGRAM_API_HOST_MAX_BYTES,
+    //       else the server is not changed), port: TCP port
+    // useTls: true = HTTPS, false = plain HTTP
+    void setApiServer(const char* host, uint16_t port, bool useTls);
+
     // ---------------------------------------------------------------
     // MESSAGE POLLING
     // ---------------------------------------------------------------
@@ -126,17 +162,6 @@ public:
     // RETURNS: true if new messages were processed
     bool poll();
 
-    // Get next unprocessed message (if available)
-    // Use this in a loop after poll() returns true
-    //
-    // message: Reference to store the message
-    // RETURNS: true if message available, false if no more messages
-    bool getNextMessage(TelegramMessage& message);
-
-    // Mark all current messages as read
-    // Used to ignore old messages after startup
-    void markAllRead();
-
     // ---------------------------------------------------------------
     // SENDING MESSAGES
     // ---------------------------------------------------------------
@@ -152,6 +177,27 @@ public:
     // RETURNS: true if sent successfully
     bool sendMessage(int64_t chatId, const String& text);
 
+    // Send text message to authorized user and get its ID back
+    // (for editing it later)
+    // messageId: Receives Telegram's message_id
+    // button: Inline button under the message (nullptr = none)
+    // RETURNS: true if sent successfully
+    bool sendMessage(const String& text, int32_t& messageId,
+                     const TelegramButton* button = nullptr);
+
+    // Replace the text of a message we sent earlier (editMessageText)
+    // Counts against the send limit like a new message
+    // messageId: From sendMessage()
+    // button: Inline button under the message (nullptr removes it)
+    // RETURNS: true if edited. On false, getLastErrorCode() tells
+    //          whether Telegram refused the edit (400)
+    bool editMessage(int32_t messageId, const String& text,
+                     const TelegramButton* button = nullptr);
+
+    // "error_code" of the last failed API answer (400, 429, ...)
+    // RETURNS: 0 if the last request succeeded or got no answer
+    int getLastErrorCode() const;
+
     // Send message with inline keyboard buttons
     // Useful for yes/no confirmations
     //
@@ -167,21 +213,25 @@ public:
     // COMMAND HANDLING
     // ---------------------------------------------------------------
 
-    // Register callback for specific command
-    // Command callbacks are triggered when user sends matching command
+    // Set the table of commands the bot understands
+    // The table is not copied and must stay valid (use a constant
+    // array built with TELEGRAM_COMMAND, see command_table.h)
     //
     // USAGE:
-    //   telegramBot.onCommand("/wake", [](TelegramMessage msg) {
-    //       Serial.println("Wake command received!");
-    //   });
+    //   static constexpr TelegramCommand COMMANDS[] = {
+    //       TELEGRAM_COMMAND("/wake", "[delay]", "Start alarm", handleWakeCommand),
+    //   };
+    //   telegramBot.setCommandTable(COMMANDS, 1);
     //
-    // command: Command string (e.g., "/wake", "/test")
-    // callback: Function to call when command is received
-    void onCommand(const String& command,
-                  std::function<void(TelegramMessage)> callback);
+    // table: First entry, count: Number of entries
+    void setCommandTable(const TelegramCommand* table, size_t count);
+
+    // Help text listing every command of the table
+    // RETURNS: Lines like "/wake [delay] - Start alarm"
+    String getCommandHelp() const;
 
-    // Process a message and trigger appropriate command callback
-    // Called automatically by poll()
+    // Process a message and run the matching command handler
+    // Called by poll() for each update, straight from its slot
     void processMessage(const TelegramMessage& message);
 
     // ---------------------------------------------------------------
@@ -194,6 +244,23 @@ public:
     // RETURNS: true if rate limit active, false if allowed
     bool isWakeRateLimited() const;
 
+    // Time until the next getUpdates may go out: the circuit breaker
+    // back-off, or the "retry_after" of a 429 answer (0 if allowed).
+    // Callers can sleep this long instead of retrying into a fast-fail
+    unsigned long getBackoffRemaining() const;
+
+    // Time until sendMessage() may send again (0 = now)
+    // Messages are limited to TELEGRAM_SEND_BURST at once and then one
+    // per TELEGRAM_SEND_REFILL_MS, and stop completely for the
+    // "retry_after" of a 429 answer. While this is not 0, sendMessage()
+    // returns false at once (nothing is sent) - keep the message and
+    // try again after this time
+    unsigned long getSendWaitMs() const;
+
+    // Telegram "date" (Unix seconds) of the newest command the last
+    // poll() received, 0 if it received none
+    unsigned long getLastMessageDate() const;
+
     // Get remaining cooldown time for /wake command
     // RETURNS: Seconds remaining until next /wake allowed
     unsigned long getWakeCooldownRemaining() const;
@@ -210,7 +277,7 @@ public:
     TelegramBotStatus getStatus() const;
 
     // Check if bot is currently online and polling
-    // RETURNS: true if online
+    // RETURNS: true if online (also while BOT_RATE_LIMITED)
     bool isOnline() const;
 
     // Get bot username (from Telegram)
@@ -223,6 +290,7 @@ public:
 
     // Get human-readable status string
     // RETURNS: String like "Online - Polling every 5s"
+    //          plus a line with HTTPS connection statistics
     String getStatusString() const;
 
     // ---------------------------------------------------------------
@@ -237,79 +305,184 @@ public:
 
     // Set callback for unauthorized access attempts
     // Triggered when wrong user tries to send commands
-    void onUnauthorizedAccess(std::function<void(int64_t, String)> callback);
+    void onUnauthorizedAccess(std::function<void(int64_t, const char*)> callback);
+
+    // Set check that cuts a waiting long poll short
+    // Called every TELEGRAM_LONG_POLL_CHECK_MS while getUpdates waits;
+    // return true when something more urgent needs the connection
+    // (e.g. alarm notifications waiting to be sent)
+    void onLongPollInterrupt(std::function<bool()> callback);
 
 private:
     // ---------------------------------------------------------------
     // PRIVATE MEMBER VARIABLES
     // ---------------------------------------------------------------
 
-    WiFiClientSecure client;      // HTTPS client for Telegram API
+    // Two connections, both kept open between requests: getUpdates
+    // may stay open for a long poll (see isPollHeld) while messages
+    // go out on the other
+    TlsClient client;             // HTTPS for getUpdates
+    TlsClient sendClient;         // HTTPS for everything else
+    WiFiClient plainClient;       // Plain HTTP (local test server only)
+    WiFiClient plainSendClient;
+
+    // Send the requests on them: keep-alive, long poll wait, circuit
+    // breaker (shared by both, see bot_transport.h)
+    BotTransport pollTransport;
+    BotTransport sendTransport;
+
+    // API server (see setApiServer)
+    String apiHost;
+    uint16_t apiPort;
+    bool apiTls;
+
+    // Telegram's own rate limits
+    TokenBucket sendBucket;       // Messages we may send right now
+    unsigned long sendRetryUntil; // millis() until sends are refused (429), 0 = none
+    unsigned long pollRetryUntil; // Same for getUpdates
+    uint32_t rateLimitHits;       // 429 answers so far
+    int lastErrorCode;            // See getLastErrorCode()
     Preferences preferences;      // Flash storage for config
 
     TelegramBotStatus status;     // Current bot status
     String botToken;              // Bot token from @BotFather
     int64_t authorizedUserId;     // User ID who can control device
-    String botUsername;           // Bot's username (cached from API)
+    String botUsername;           // Bot's username (cached in flash)
 
     int32_t lastUpdateId;         // Last processed message ID
+    bool offsetDirty;             // lastUpdateId not in flash yet
+    unsigned long lastOffsetSave; // When it was last written to flash
+    StaleFilter staleFilter;      // Skips old commands after boot
+    uint32_t staleCommands;       // Old commands skipped after boot
+    TelegramUpdateBatch updateBatch;  // Last getUpdates answer (fixed slots)
     unsigned long lastPollTime;   // Last time we polled for messages
+    unsigned long lastMessageDate; // See getLastMessageDate()
 
     // Rate limiting
     unsigned long lastWakeTime;   // Last time /wake was sent
 
-    // Message queue (simple FIFO buffer)
-    static const int MESSAGE_QUEUE_SIZE = 10;
-    TelegramMessage messageQueue[MESSAGE_QUEUE_SIZE];
-    int messageQueueHead;         // Next position to write
-    int messageQueueTail;         // Next position to read
-    int messageQueueCount;        // Number of messages in queue
-
-    // Command callbacks (map of command -> function)
-    struct CommandCallback {
-        String command;
-        std::function<void(TelegramMessage)> callback;
-    };
-    static const int MAX_COMMANDS = 10;
-    CommandCallback commandCallbacks[MAX_COMMANDS];
-    int commandCallbackCount;
+    // Response memory (see recordResponseMemory)
+    size_t lastResponseBytes;     // Body size of the last response
+    uint32_t lastResponseHeapBytes;  // Heap used by its parsed JSON
+    uint32_t maxResponseHeapBytes;   // Largest of those so far
+
+    // Command table (see setCommandTable)
+    const TelegramCommand* commandTable;
+    size_t commandCount;
 
     // Status callbacks
     std::function<void()> callbackOnline;
     std::function<void()> callbackOffline;
-    std::function<void(int64_t, String)> callbackUnauthorizedAccess;
+    std::function<void(int64_t, const char*)> callbackUnauthorizedAccess;
+    std::function<bool()> callbackLongPollInterrupt;
 
     // ---------------------------------------------------------------
     // PRIVATE HELPER FUNCTIONS
     // ---------------------------------------------------------------
 
     // Make HTTPS GET request to Telegram API
-    // endpoint: API endpoint (e.g., "getUpdates")
+    // endpoint: API endpoint (e.g., "getMe")
     // params: URL parameters (e.g., "offset=123&limit=100")
-    // RETURNS: JSON response as String, empty if failed
-    String makeRequest(const String& endpoint, const String& params = "");
+    // response: Receives the parsed JSON answer
+    // RETURNS: true if a complete JSON answer arrived
+    bool makeRequest(const String& endpoint, const String& params,
+                     JsonDocument& response);
 
     // Make HTTPS POST request to Telegram API
     // endpoint: API endpoint (e.g., "sendMessage")
     // jsonBody: JSON request body
-    // RETURNS: JSON response as String, empty if failed
-    String makePostRequest(const String& endpoint, const String& jsonBody);
+    // response: Receives the parsed JSON answer
+    // RETURNS: true if a complete JSON answer arrived
+    bool makePostRequest(const String& endpoint, const String& jsonBody,
+                         JsonDocument& response);
+
+    // Call getUpdates, parse the answer into updateBatch
+    // params: URL parameters (offset, limit, timeout)
+    // waitMs: Long poll - how long the server may hold the answer
+    //         back (0 = answers right away)
+    // RETURNS: true if a complete answer arrived (check updateBatch.ok)
+    bool requestUpdates(const String& params, unsigned long waitMs);
+
+    // Body parser that fills a JsonDocument (for sendRequest)
+    static std::function<bool(Stream&)> jsonParser(JsonDocument& response);
+
+    // Send one request through the transport (see bot_transport.h)
+    // while the stall watchdog watches, and measure the parse
+    //
+    // via: pollTransport (getUpdates) or sendTransport (the rest);
+    //      a held long poll on it is resumed instead
+    // method: "GET" or "POST"
+    // params: URL parameters (GET), empty for POST
+    // jsonBody: Request body (POST), empty for GET
+    // parseBody: Reads the body Stream, returns false if invalid
+    // waitMs: Long poll wait (see requestUpdates)
+    // RETURNS: true if a complete, valid answer arrived, false if
+    //          failed, interrupted or refused by the circuit breaker
+    bool sendRequest(BotTransport& via, const char* method, const String& endpoint,
+                     const String& params, const String& jsonBody,
+                     std::function<bool(Stream&)> parseBody,
+                     unsigned long waitMs);
+
+    // Remember body size and heap used by the parsed answer
+    // freeHeapBefore: ESP.getFreeHeap() before the answer was read
+    void recordResponseMemory(uint32_t freeHeapBefore, size_t bodyBytes);
+
+    // Load lastUpdateId for the current token: from RTC memory
+    // (restart), else from flash (power-on), else 0
+    void restoreOffset();
+
+    // Keep lastUpdateId: in RTC memory right away, in flash at most
+    // every TELEGRAM_OFFSET_SAVE_MS (write-behind)
+    void saveOffset();
 
     // Get bot info from Telegram (username, etc.)
-    // Called once during initialization
+    // Called once per bot token - result is cached in flash
     // RETURNS: true if successful
     bool getBotInfo();
 
-    // Parse JSON response from Telegram API
-    // Handles error checking and result extraction
+    // Open the Preferences namespace (read-write)
+    // RETURNS: true if flash storage is usable
+    bool openStorage();
+
+    // Check the "ok" field of a parsed Telegram API answer
+    // Logs Telegram's error description if the call failed, and
+    // stops sending for "retry_after" if it was a 429
     //
-    // response: JSON string from Telegram
-    // doc: JsonDocument to store parsed data
-    // RETURNS: true if parsing successful and result is OK
-    bool parseResponse(const String& response, JsonDocument& doc);
+    // doc: Parsed answer (from makeRequest/makePostRequest)
+    // RETURNS: true if the API call succeeded
+    bool checkResponse(const JsonDocument& doc);
+
+    // Send a message (sendMessage API)
+    // messageId: Receives the new message_id (nullptr = not needed)
+    // button: Inline button under the message (nullptr = none)
+    bool postMessage(int64_t chatId, const String& text, int32_t* messageId,
+                     const TelegramButton* button);
+
+    // Put one inline button (or an empty keyboard) into a request
+    static void addButton(JsonDocument& doc, const TelegramButton* button);
+
+    // Handle a tapped inline button: authorize, run the command in
+    // its data, then answer it (stops the spinner on the phone)
+    void processCallbackQuery(const TelegramUpdate& update);
+
+    // Acknowledge a callback_query (answerCallbackQuery)
+    // text: Short note shown on the phone, "" for none
+    // RETURNS: true if Telegram accepted it
+    bool answerCallbackQuery(const char* callbackId, const char* text);
+
+    // Take a token for one outgoing message
+    // RETURNS: false if we must wait (see getSendWaitMs)
+    bool takeSendToken();
 
-    // Add message to processing queue
-    void queueMessage(const TelegramMessage& message);
+    // Telegram answered 429: wait retryAfterS seconds
+    // until: sendRetryUntil or pollRetryUntil
+    void applyRetryAfter(int retryAfterS, unsigned long& until);
+
+    // Switch between BOT_ONLINE and BOT_RATE_LIMITED while online
+    void updateRateLimitStatus();
+
+    // Time left until a retry_after deadline (0 if passed or none)
+    static unsigned long remainingUntil(unsigned long until);
 
     // Check if message is from authorized user
     bool isAuthorized(int64_t userId) const;
@@ -344,24 +517,24 @@ extern TelegramBot telegramBot;
  * // In main.cpp:
  * #include "telegram_bot.h"
  *
+ * void handleWakeCommand(const TelegramMessage& msg, const CommandArgs& args) {
+ *     Serial.println("Wake command received!");
+ *     alarmController.start();  // Start alarm
+ *     telegramBot.sendMessage("Alarm starting in 3 seconds...");
+ * }
+ *
+ * static constexpr TelegramCommand COMMANDS[] = {
+ *     TELEGRAM_COMMAND("/wake", "", "Start alarm", handleWakeCommand),
+ * };
+ * static const size_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+ *
  * void setup() {
  *     // Initialize with bot token and user ID
  *     // Get these from @BotFather and @userinfobot on Telegram
  *     telegramBot.begin("123456789:ABCdef...", 987654321);
  *
- *     // Register command handlers
- *     telegramBot.onCommand("/wake", [](TelegramMessage msg) {
- *         Serial.println("Wake command received!");
- *         alarmController.start();  // Start alarm
- *         telegramBot.sendMessage("Alarm starting in 3 seconds...");
- *     });
- *
- *     telegramBot.onCommand("/status", [](TelegramMessage msg) {
- *         String status = "Device: Online\n";
- *         status += "WiFi: " + wifiMgr.getSSID() + "\n";
- *         status += "Alarm: " + alarmController.getStateString();
- *         telegramBot.sendMessage(status);
- *     });
+ *     // Register command handlers (the table lives in flash)
+ *     telegramBot.setCommandTable(COMMANDS, COMMAND_COUNT);
  *
  *     // Set up status callbacks
  *     telegramBot.onOnline([]() {
@@ -395,8 +568,12 @@ extern TelegramBot telegramBot;
  *    Prevents abuse if token is leaked.
  *    /wake limited to once per 5 minutes.
  *
- * 4. HTTPS ONLY:
- *    All communication uses TLS/SSL encryption.
+ * 4. HTTPS BY DEFAULT:
+ *    Communication with Telegram uses TLS/SSL encryption.
+ *    TELEGRAM_API_TLS false (or setApiServer(..., false)) sends
+ *    everything in plain HTTP, bot token and chat included - only
+ *    for a local mock server (tools/mock_telegram_api.py), never
+ *    for api.telegram.org.
  *
  * ===============================================================
  * TELEGRAM BOT SETUP INSTRUCTIONS:
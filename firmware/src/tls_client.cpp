@@ -0,0 +1,521 @@
+/*
+ * ===============================================================
+ * WakeAssist - TLS Client Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the session-caching TLS client declared in
+ * tls_client.h
+ *
+ * KEY CONCEPTS:
+ * - mbedtls: The TLS library built into the ESP32 Arduino core
+ *   (WiFiClientSecure uses it too)
+ * - Session resumption: The server gives us a session ticket (or
+ *   session ID) after a full handshake. Offering it on the next
+ *   connect lets both sides skip the certificate and key exchange
+ * - BIO callbacks: mbedtls does not know about sockets - it calls
+ *   bioSend()/bioRecv(), which use a plain WiFiClient
+ *
+ * ===============================================================
+ */
+
+#include "tls_client.h"
+#include <mbedtls/net_sockets.h>   // MBEDTLS_ERR_NET_* error codes
+
+// ===============================================================
+// RTC-RETAINED SESSION
+// ===============================================================
+// Serialized session (mbedtls_ssl_session_save). Survives software
+// and watchdog restarts, garbage after power-on - hence the magic
+// number and checksum.
+
+#define TLS_SESSION_MAGIC  0x544C5353UL   // "TLSS"
+
+struct RtcSessionRecord {
+    uint32_t magic;                        // TLS_SESSION_MAGIC if valid
+    uint32_t length;                       // Bytes used in data[]
+    uint32_t checksum;                     // Over data[0..length)
+    uint8_t data[TLS_SESSION_RTC_BYTES];   // Serialized session
+};
+
+RTC_NOINIT_ATTR static RtcSessionRecord rtcSession;
+
+static uint32_t rtcSessionChecksum(const uint8_t* data, size_t length) {
+    uint32_t sum = 0x12345678;
+
+    for (size_t i = 0; i < length; i++) {
+        sum = (sum << 5) + sum + data[i];  // djb2-style hash
+    }
+
+    return sum;
+}
+
+// ===============================================================
+// CONSTRUCTOR / DESTRUCTOR
+// ===============================================================
+
+TlsClient::TlsClient() {
+    tlsReady = false;
+    sessionValid = false;
+    rtcCacheEnabled = false;
+    rtcCacheLoaded = false;
+    connectedFlag = false;
+    peekedByte = -1;
+    resumed = false;
+
+    fullCount = 0;
+    resumedCount = 0;
+    fullTotalMs = 0;
+    resumedTotalMs = 0;
+
+    mbedtls_ssl_session_init(&cachedSession);
+}
+
+TlsClient::~TlsClient() {
+    stop();
+    mbedtls_ssl_session_free(&cachedSession);
+
+    if (tlsReady) {
+        mbedtls_ssl_free(&ssl);
+        mbedtls_ssl_config_free(&sslConfig);
+    }
+}
+
+// ===============================================================
+// CONNECTION
+// ===============================================================
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+    // Session tickets are tied to a host name, so only the host name
+    // version is supported
+    DEBUG_PRINTLN("[TLS] ERROR: connect() needs a host name");
+    return 0;
+}
+
+int TlsClient::connect(const char* host, uint16_t port) {
+    stop();
+
+    if (!setupTls()) {
+        return 0;
+    }
+
+    // First connect after a restart: pick up the session from RTC
+    if (rtcCacheEnabled && !rtcCacheLoaded) {
+        rtcCacheLoaded = true;
+        loadRtcSession();
+    }
+
+    unsigned long startTime = millis();
+
+    // ---------------------------------------------------------------
+    // 1. TCP connection
+    // ---------------------------------------------------------------
+    if (!tcp.connect(host, port)) {
+        DEBUG_PRINTF("[TLS] ERROR: TCP connect to %s failed\n", host);
+        return 0;
+    }
+
+    // ---------------------------------------------------------------
+    // 2. Prepare TLS context for a new connection
+    // ---------------------------------------------------------------
+    mbedtls_ssl_session_reset(&ssl);
+    mbedtls_ssl_set_hostname(&ssl, host);  // SNI, and tickets are per host
+    mbedtls_ssl_set_bio(&ssl, &tcp, bioSend, bioRecv, nullptr);
+
+    if (sessionValid && mbedtls_ssl_set_session(&ssl, &cachedSession) != 0) {
+        DEBUG_PRINTLN("[TLS] Cached session rejected - full handshake");
+        clearSession();
+    }
+
+    // ---------------------------------------------------------------
+    // 3. Handshake
+    // ---------------------------------------------------------------
+    if (!runHandshake()) {
+        tcp.stop();
+
+        // A session the server choked on should not be offered again
+        clearSession();
+        return 0;
+    }
+
+    unsigned long handshakeMs = millis() - startTime;
+    connectedFlag = true;
+
+    if (resumed) {
+        resumedCount++;
+        resumedTotalMs += handshakeMs;
+    } else {
+        fullCount++;
+        fullTotalMs += handshakeMs;
+    }
+
+    DEBUG_PRINTF("[TLS] Connected to %s (%s handshake, %lums)\n",
+                 host, resumed ? "resumed" : "full", handshakeMs);
+
+    // Keep the (possibly new) ticket for next time
+    saveSession();
+
+    return 1;
+}
+
+size_t TlsClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t TlsClient::write(const uint8_t* buf, size_t size) {
+    if (!connectedFlag) {
+        return 0;
+    }
+
+    size_t written = 0;
+    unsigned long startTime = millis();
+
+    while (written < size) {
+        int ret = mbedtls_ssl_write(&ssl, buf + written, size - written);
+
+        if (ret > 0) {
+            written += ret;
+        } else if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            if (millis() - startTime > TLS_HANDSHAKE_TIMEOUT_MS) {
+                break;
+            }
+            delay(1);
+        } else {
+            DEBUG_PRINTF("[TLS] Write error -0x%04X\n", -ret);
+            markClosed();
+            break;
+        }
+    }
+
+    return written;
+}
+
+int TlsClient::available() {
+    if (!connectedFlag) {
+        return (peekedByte >= 0) ? 1 : 0;
+    }
+
+    // Let mbedtls process whatever arrived on the socket
+    // (a zero-length read decrypts the next record, if complete)
+    int ret = mbedtls_ssl_read(&ssl, nullptr, 0);
+
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        markClosed();
+    }
+
+    int count = connectedFlag ? (int)mbedtls_ssl_get_bytes_avail(&ssl) : 0;
+    return count + ((peekedByte >= 0) ? 1 : 0);
+}
+
+int TlsClient::read() {
+    uint8_t b;
+    return (read(&b, 1) == 1) ? b : -1;
+}
+
+int TlsClient::read(uint8_t* buf, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t offset = 0;
+
+    if (peekedByte >= 0) {
+        buf[0] = (uint8_t)peekedByte;
+        peekedByte = -1;
+        offset = 1;
+
+        if (size == 1) {
+            return 1;
+        }
+    }
+
+    if (!connectedFlag) {
+        return (offset > 0) ? (int)offset : -1;
+    }
+
+    int ret = mbedtls_ssl_read(&ssl, buf + offset, size - offset);
+
+    if (ret > 0) {
+        return offset + ret;
+    }
+
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        // 0 / PEER_CLOSE_NOTIFY = server closed, anything else = error
+        markClosed();
+    }
+
+    return (offset > 0) ? (int)offset : -1;
+}
+
+int TlsClient::peek() {
+    if (peekedByte < 0) {
+        uint8_t b;
+        if (read(&b, 1) == 1) {
+            peekedByte = b;
+        }
+    }
+
+    return peekedByte;
+}
+
+void TlsClient::flush() {
+    // Writes go out immediately
+}
+
+void TlsClient::stop() {
+    if (connectedFlag) {
+        mbedtls_ssl_close_notify(&ssl);  // Best effort, don't wait
+    }
+
+    connectedFlag = false;
+    peekedByte = -1;
+    tcp.stop();
+}
+
+uint8_t TlsClient::connected() {
+    if (peekedByte >= 0) {
+        return 1;
+    }
+
+    if (!connectedFlag) {
+        return 0;
+    }
+
+    // Server may have closed the socket with data still to read
+    return (tcp.connected() || mbedtls_ssl_get_bytes_avail(&ssl) > 0) ? 1 : 0;
+}
+
+TlsClient::operator bool() {
+    return connected();
+}
+
+// ===============================================================
+// SESSION CACHE
+// ===============================================================
+
+void TlsClient::setRtcSessionCache(bool enabled) {
+    rtcCacheEnabled = enabled && (TLS_SESSION_RTC_BYTES > 0);
+}
+
+void TlsClient::clearSession() {
+    mbedtls_ssl_session_free(&cachedSession);
+    mbedtls_ssl_session_init(&cachedSession);
+    sessionValid = false;
+
+    if (rtcCacheEnabled) {
+        rtcSession.magic = 0;
+    }
+}
+
+bool TlsClient::lastHandshakeResumed() const {
+    return resumed;
+}
+
+// ===============================================================
+// STATISTICS
+// ===============================================================
+
+uint32_t TlsClient::getFullHandshakeCount() const {
+    return fullCount;
+}
+
+uint32_t TlsClient::getResumedHandshakeCount() const {
+    return resumedCount;
+}
+
+unsigned long TlsClient::getAverageFullHandshakeMs() const {
+    return (fullCount > 0) ? fullTotalMs / fullCount : 0;
+}
+
+unsigned long TlsClient::getAverageResumedHandshakeMs() const {
+    return (resumedCount > 0) ? resumedTotalMs / resumedCount : 0;
+}
+
+String TlsClient::getStatusString() const {
+    return "TLS: " + String(fullCount) + " full (avg " +
+           String(getAverageFullHandshakeMs()) + "ms), " +
+           String(resumedCount) + " resumed (avg " +
+           String(getAverageResumedHandshakeMs()) + "ms)";
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+bool TlsClient::setupTls() {
+    if (tlsReady) {
+        return true;
+    }
+
+    // Random numbers for the handshake
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&ctrDrbg);
+
+    const char* personalization = "wakeassist";
+    if (mbedtls_ctr_drbg_seed(&ctrDrbg, mbedtls_entropy_func, &entropy,
+                              (const unsigned char*)personalization,
+                              strlen(personalization)) != 0) {
+        DEBUG_PRINTLN("[TLS] ERROR: Random generator setup failed");
+        return false;
+    }
+
+    // Client, TLS over TCP, default cipher suites
+    mbedtls_ssl_config_init(&sslConfig);
+    if (mbedtls_ssl_config_defaults(&sslConfig, MBEDTLS_SSL_IS_CLIENT,
+                                    MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+        DEBUG_PRINTLN("[TLS] ERROR: Config setup failed");
+        mbedtls_ssl_config_free(&sslConfig);
+        return false;
+    }
+
+    mbedtls_ssl_conf_authmode(&sslConfig, MBEDTLS_SSL_VERIFY_NONE);  // See tls_client.h
+    mbedtls_ssl_conf_rng(&sslConfig, mbedtls_ctr_drbg_random, &ctrDrbg);
+    mbedtls_ssl_conf_session_tickets(&sslConfig, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+
+    // The SSL context (and its ~32KB of record buffers) is allocated
+    // once here and reset for each connection - no heap churn
+    mbedtls_ssl_init(&ssl);
+    if (mbedtls_ssl_setup(&ssl, &sslConfig) != 0) {
+        DEBUG_PRINTLN("[TLS] ERROR: Not enough memory for TLS");
+        mbedtls_ssl_free(&ssl);
+        mbedtls_ssl_config_free(&sslConfig);
+        return false;
+    }
+
+    tlsReady = true;
+    return true;
+}
+
+bool TlsClient::runHandshake() {
+    unsigned long startTime = millis();
+    bool sawCertificate = false;
+
+    // Step through the handshake ourselves, so we can see which
+    // messages the server sent: a resumed handshake jumps from
+    // ServerHello straight to ChangeCipherSpec (no Certificate)
+    while (ssl.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+        if (ssl.state == MBEDTLS_SSL_SERVER_CERTIFICATE) {
+            sawCertificate = true;
+        }
+
+        int ret = mbedtls_ssl_handshake_step(&ssl);
+
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            if (millis() - startTime > TLS_HANDSHAKE_TIMEOUT_MS) {
+                DEBUG_PRINTLN("[TLS] ERROR: Handshake timeout");
+                return false;
+            }
+            delay(1);
+            continue;
+        }
+
+        if (ret != 0) {
+            DEBUG_PRINTF("[TLS] ERROR: Handshake failed (-0x%04X)\n", -ret);
+            return false;
+        }
+    }
+
+    resumed = sessionValid && !sawCertificate;
+    return true;
+}
+
+void TlsClient::saveSession() {
+    mbedtls_ssl_session_free(&cachedSession);
+    mbedtls_ssl_session_init(&cachedSession);
+
+    sessionValid = (mbedtls_ssl_get_session(&ssl, &cachedSession) == 0);
+
+    if (sessionValid && rtcCacheEnabled) {
+        saveRtcSession();
+    }
+}
+
+void TlsClient::loadRtcSession() {
+    if (rtcSession.magic != TLS_SESSION_MAGIC ||
+        rtcSession.length == 0 || rtcSession.length > TLS_SESSION_RTC_BYTES ||
+        rtcSession.checksum != rtcSessionChecksum(rtcSession.data, rtcSession.length)) {
+        return;  // Power-on, or never saved
+    }
+
+    mbedtls_ssl_session_free(&cachedSession);
+    mbedtls_ssl_session_init(&cachedSession);
+
+    sessionValid = (mbedtls_ssl_session_load(&cachedSession, rtcSession.data,
+                                             rtcSession.length) == 0);
+
+    DEBUG_PRINTF("[TLS] Session from before restart: %s\n",
+                 sessionValid ? "loaded" : "unusable");
+}
+
+void TlsClient::saveRtcSession() {
+    size_t length = 0;
+    int ret = mbedtls_ssl_session_save(&cachedSession, rtcSession.data,
+                                       TLS_SESSION_RTC_BYTES, &length);
+
+    if (ret != 0) {
+        // Usually BUFFER_TOO_SMALL: session includes the server
+        // certificate. RAM cache still works, RTC copy is skipped
+        rtcSession.magic = 0;
+        DEBUG_PRINTF("[TLS] Session not saved to RTC (-0x%04X)\n", -ret);
+        return;
+    }
+
+    rtcSession.length = length;
+    rtcSession.checksum = rtcSessionChecksum(rtcSession.data, length);
+    rtcSession.magic = TLS_SESSION_MAGIC;
+}
+
+void TlsClient::markClosed() {
+    connectedFlag = false;
+}
+
+int TlsClient::bioSend(void* ctx, const unsigned char* buf, size_t len) {
+    WiFiClient* socket = static_cast<WiFiClient*>(ctx);
+
+    int written = socket->write(buf, len);
+
+    if (written <= 0) {
+        return socket->connected() ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+    return written;
+}
+
+int TlsClient::bioRecv(void* ctx, unsigned char* buf, size_t len) {
+    WiFiClient* socket = static_cast<WiFiClient*>(ctx);
+
+    if (socket->available() <= 0) {
+        return socket->connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    }
+
+    int got = socket->read(buf, len);
+
+    return (got > 0) ? got : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * HOW DO WE KNOW A HANDSHAKE WAS RESUMED?
+ * mbedtls does not tell us directly. In a full handshake the server
+ * sends its Certificate after ServerHello. In a resumed one it skips
+ * straight to ChangeCipherSpec. runHandshake() steps through the
+ * handshake state by state and watches for the certificate state.
+ *
+ * WHEN IS THE SESSION CLEARED?
+ * Only when a handshake fails. A server that no longer knows our
+ * session simply does a full handshake, which gives us a new one.
+ *
+ * RTC COPY:
+ * A serialized session is a few hundred bytes, but if mbedtls keeps
+ * the peer certificate in the session it can exceed
+ * TLS_SESSION_RTC_BYTES. Then only the RAM cache is used.
+ *
+ * mbedtls VERSION:
+ * Written for mbedtls 2.28 (ESP32 Arduino core 2.x), where
+ * ssl.state is a public field.
+ *
+ * ===============================================================
+ */
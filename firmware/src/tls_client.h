@@ -0,0 +1,196 @@
+/*
+ * ===============================================================
+ * WakeAssist - TLS Client Module (Header File)
+ * ===============================================================
+ *
+ * This module is a small HTTPS client connection (like
+ * WiFiClientSecure) that remembers its TLS session:
+ * - After a full handshake the session (ticket or session ID) is
+ *   kept in RAM, and optionally in RTC memory
+ * - The next connect offers that session to the server. If the
+ *   server accepts, the handshake is "resumed": no certificate, no
+ *   key exchange, one round-trip less
+ *
+ * WHY NOT WiFiClientSecure?
+ * WiFiClientSecure creates a fresh TLS context on every connect and
+ * has no way to save or restore a session, so every reconnect (after
+ * a WiFi blip or when the server closed the keep-alive connection)
+ * costs a full handshake: ~1 second of CPU and several KB of heap
+ * churn on the ESP32.
+ *
+ * SECURITY:
+ * Like WiFiClientSecure::setInsecure() before, the server
+ * certificate is NOT validated (no CA certificates in flash). The
+ * connection is encrypted, but not protected against an active
+ * man-in-the-middle.
+ *
+ * ===============================================================
+ */
+
+#ifndef TLS_CLIENT_H
+#define TLS_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include "config.h"
+
+// ===============================================================
+// TLS CLIENT CLASS
+// ===============================================================
+// Drop-in Client for HTTPS: connect(), print(), read(), stop()
+
+class TlsClient : public Client {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR / DESTRUCTOR
+    // ---------------------------------------------------------------
+    TlsClient();
+    ~TlsClient();
+
+    // ---------------------------------------------------------------
+    // CONNECTION (Arduino Client interface)
+    // ---------------------------------------------------------------
+
+    // Open TCP connection and do the TLS handshake
+    // Offers the cached session, so the handshake is resumed if the
+    // server still knows it
+    //
+    // RETURNS: 1 if connected, 0 if failed
+    int connect(const char* host, uint16_t port) override;
+    int connect(IPAddress ip, uint16_t port) override;
+
+    // Send data (encrypted)
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+
+    // Number of decrypted bytes that can be read without waiting
+    int available() override;
+
+    // Read decrypted data (never waits)
+    // RETURNS: Byte / number of bytes, -1 if nothing available
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+
+    void flush() override;
+
+    // Close the connection (the cached session is kept)
+    void stop() override;
+
+    // RETURNS: true while connected or unread data is left
+    uint8_t connected() override;
+    operator bool() override;
+
+    // ---------------------------------------------------------------
+    // SESSION CACHE
+    // ---------------------------------------------------------------
+
+    // Also keep the session in RTC memory, so it survives a software
+    // or watchdog restart (not power loss). Only ONE TlsClient may
+    // enable this. Call before the first connect()
+    void setRtcSessionCache(bool enabled);
+
+    // Forget the cached session (next handshake is a full one)
+    void clearSession();
+
+    // Check if the last successful handshake was resumed
+    bool lastHandshakeResumed() const;
+
+    // ---------------------------------------------------------------
+    // STATISTICS
+    // ---------------------------------------------------------------
+
+    uint32_t getFullHandshakeCount() const;
+    uint32_t getResumedHandshakeCount() const;
+
+    // Average handshake duration (milliseconds), 0 if none yet
+    unsigned long getAverageFullHandshakeMs() const;
+    unsigned long getAverageResumedHandshakeMs() const;
+
+    // Get human-readable handshake statistics
+    // RETURNS: String like "TLS: 3 full (avg 1180ms), 41 resumed (avg 240ms)"
+    String getStatusString() const;
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    WiFiClient tcp;                   // Underlying TCP connection
+
+    // mbedtls state (set up once, reused for every connection)
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context ctrDrbg;
+    mbedtls_ssl_config sslConfig;
+    mbedtls_ssl_context ssl;
+    bool tlsReady;                    // Contexts above are set up
+
+    // Session cache
+    mbedtls_ssl_session cachedSession;
+    bool sessionValid;                // cachedSession can be offered
+    bool rtcCacheEnabled;             // Mirror session in RTC memory
+    bool rtcCacheLoaded;              // RTC copy already checked
+
+    // Connection state
+    bool connectedFlag;               // Handshake done, not closed
+    int peekedByte;                   // Byte returned by peek(), -1 = none
+    bool resumed;                     // Last handshake was resumed
+
+    // Statistics
+    uint32_t fullCount;
+    uint32_t resumedCount;
+    uint32_t fullTotalMs;
+    uint32_t resumedTotalMs;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Set up random generator, config and SSL context (first connect)
+    // RETURNS: true if mbedtls is ready
+    bool setupTls();
+
+    // Run the handshake until done, failed or TLS_HANDSHAKE_TIMEOUT_MS
+    // RETURNS: true if handshake finished
+    bool runHandshake();
+
+    // Copy the session of the current connection into the cache
+    void saveSession();
+
+    // Load/save the RTC copy of the session
+    void loadRtcSession();
+    void saveRtcSession();
+
+    // Mark connection closed after an error or close_notify
+    void markClosed();
+
+    // mbedtls I/O callbacks (ctx = WiFiClient*)
+    static int bioSend(void* ctx, const unsigned char* buf, size_t len);
+    static int bioRecv(void* ctx, unsigned char* buf, size_t len);
+};
+
+#endif // TLS_CLIENT_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * TlsClient client;
+ *
+ * if (client.connect("api.telegram.org", 443)) {
+ *     client.print("GET /... HTTP/1.1\r\n...");
+ *     ...
+ *     client.stop();
+ * }
+ *
+ * // Some time later (e.g. after a WiFi drop)
+ * client.connect("api.telegram.org", 443);   // Resumed handshake
+ * Serial.println(client.lastHandshakeResumed() ? "resumed" : "full");
+ *
+ * ===============================================================
+ */
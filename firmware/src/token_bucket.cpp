@@ -0,0 +1,117 @@
+/*
+ * ===============================================================
+ * WakeAssist - Token Bucket (Implementation)
+ * ===============================================================
+ *
+ * This file implements the token bucket declared in
+ * token_bucket.h
+ *
+ * NOTE: The caller passes the time in, so the host tests can step
+ * through refills without waiting (test/test_token_bucket).
+ *
+ * ===============================================================
+ */
+
+#include "token_bucket.h"
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+TokenBucket::TokenBucket() {
+    capacity = 1;
+    refillInterval = 0;
+    tokens = 1;
+    lastRefill = 0;
+    takenCount = 0;
+    deniedCount = 0;
+}
+
+void TokenBucket::configure(uint8_t capacity, unsigned long refillMs) {
+    this->capacity = (capacity > 0) ? capacity : 1;
+    refillInterval = refillMs;
+    tokens = this->capacity;
+    lastRefill = 0;
+}
+
+// ===============================================================
+// TOKENS
+// ===============================================================
+
+bool TokenBucket::tryTake(unsigned long now) {
+    refill(now);
+
+    if (tokens == 0) {
+        deniedCount++;
+        return false;
+    }
+
+    tokens--;
+    takenCount++;
+    return true;
+}
+
+unsigned long TokenBucket::getWaitMs(unsigned long now) const {
+    if (getTokens(now) > 0) {
+        return 0;
+    }
+
+    // Empty means less than one interval passed since lastRefill
+    return refillInterval - (now - lastRefill);
+}
+
+uint8_t TokenBucket::getTokens(unsigned long now) const {
+    if (refillInterval == 0) {
+        return capacity;
+    }
+
+    unsigned long cameBack = (now - lastRefill) / refillInterval;
+    if (cameBack >= (unsigned long)(capacity - tokens)) {
+        return capacity;
+    }
+    return tokens + cameBack;
+}
+
+uint32_t TokenBucket::getTakenCount() const {
+    return takenCount;
+}
+
+uint32_t TokenBucket::getDeniedCount() const {
+    return deniedCount;
+}
+
+// ===============================================================
+// PRIVATE HELPER FUNCTIONS
+// ===============================================================
+
+void TokenBucket::refill(unsigned long now) {
+    uint8_t available = getTokens(now);
+
+    if (available == capacity) {
+        // Full: the next token starts counting from now
+        lastRefill = now;
+    } else if (available > tokens) {
+        // Keep the part of an interval that already passed
+        lastRefill += (unsigned long)(available - tokens) * refillInterval;
+    }
+
+    tokens = available;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. WHY NOT A SIMPLE "ONE MESSAGE PER SECOND" GAP?
+ *    A stop confirmation and a reply often go out together. A bucket
+ *    lets a small burst through at once and only slows down a longer
+ *    run of messages - which the server tolerates the same way.
+ *
+ * 2. WHY NO TIMER?
+ *    Tokens are counted from the elapsed time when asked, so an idle
+ *    bucket costs nothing. millis() overflow is harmless: only
+ *    differences of two times are used.
+ *
+ * ===============================================================
+ */
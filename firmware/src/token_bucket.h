@@ -0,0 +1,106 @@
+/*
+ * ===============================================================
+ * WakeAssist - Token Bucket (Header File)
+ * ===============================================================
+ *
+ * Keeps a sender under a rate limit without ever waiting:
+ *
+ *   - The bucket holds up to `capacity` tokens (starts full)
+ *   - Every request takes one token
+ *   - One token comes back every `refillMs`
+ *   - No token left = don't send now; getWaitMs() says how long
+ *     until the next one
+ *
+ * So a short burst of `capacity` messages goes out at once, and
+ * after that at most one message per `refillMs` - which is exactly
+ * the rate the server allows, instead of sending too fast, getting
+ * refused and retrying.
+ *
+ * HOST TESTING:
+ * Like circuit_breaker.h, this class does no I/O and never reads the
+ * clock - the caller passes the time in.
+ *
+ * ===============================================================
+ */
+
+#ifndef TOKEN_BUCKET_H
+#define TOKEN_BUCKET_H
+
+#include <stdint.h>
+
+// ===============================================================
+// TOKEN BUCKET CLASS
+// ===============================================================
+
+class TokenBucket {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    TokenBucket();
+
+    // Set the limits (fills the bucket)
+    // capacity: Largest burst
+    // refillMs: Time for one token to come back
+    void configure(uint8_t capacity, unsigned long refillMs);
+
+    // ---------------------------------------------------------------
+    // TOKENS
+    // ---------------------------------------------------------------
+
+    // Take one token if there is one
+    // now: Current time (ms)
+    // RETURNS: true if the request may go out now
+    bool tryTake(unsigned long now);
+
+    // Time until a token is available (0 = one is there now)
+    unsigned long getWaitMs(unsigned long now) const;
+
+    // Tokens available now
+    uint8_t getTokens(unsigned long now) const;
+
+    // Statistics
+    uint32_t getTakenCount() const;         // Requests let through
+    uint32_t getDeniedCount() const;        // Requests told to wait
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    uint8_t capacity;
+    unsigned long refillInterval;
+
+    uint8_t tokens;                   // As of lastRefill
+    unsigned long lastRefill;         // When tokens was last brought up to date
+
+    uint32_t takenCount;
+    uint32_t deniedCount;
+
+    // ---------------------------------------------------------------
+    // PRIVATE HELPER FUNCTIONS
+    // ---------------------------------------------------------------
+
+    // Add the tokens that came back since lastRefill
+    void refill(unsigned long now);
+};
+
+#endif // TOKEN_BUCKET_H
+
+/*
+ * ===============================================================
+ * HOST SIMULATION EXAMPLE:
+ * ===============================================================
+ *
+ * TokenBucket bucket;
+ * bucket.configure(3, 1000);       // Burst of 3, then 1 per second
+ *
+ * bucket.tryTake(0);               // -> true  (2 left)
+ * bucket.tryTake(0);               // -> true  (1 left)
+ * bucket.tryTake(0);               // -> true  (0 left)
+ * bucket.tryTake(100);             // -> false
+ * bucket.getWaitMs(100);           // -> 900
+ * bucket.tryTake(1000);            // -> true  (one came back)
+ *
+ * ===============================================================
+ */
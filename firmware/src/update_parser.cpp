@@ -0,0 +1,626 @@
+/*
+ * ===============================================================
+ * WakeAssist - Update Parser Module (Implementation)
+ * ===============================================================
+ *
+ * This file implements the getUpdates parser declared in
+ * update_parser.h
+ *
+ * KEY CONCEPTS:
+ * - Pull parser: We ask for the next key or element when we need
+ *   it, instead of building a tree of the whole document
+ * - current: One character of lookahead (like a tokenizer's "peek")
+ * - Schema functions (parseUpdate, parseMessage, ...) walk the keys
+ *   of one object, read what they know and skipValue() the rest
+ * - error: Once set, every function returns right away, so a broken
+ *   answer ends the parse without extra checks after each call
+ *
+ * ===============================================================
+ */
+
+#include "update_parser.h"
+
+// Longest key we compare against ("callback_query" + margin)
+#define UPDATE_PARSER_KEY_BYTES 24
+
+// ===============================================================
+// CONSTRUCTOR
+// ===============================================================
+
+UpdateParser::UpdateParser(Stream& input) : input(input) {
+    current = -1;
+    error = false;
+}
+
+// ===============================================================
+// PARSING
+// ===============================================================
+
+bool UpdateParser::parse(TelegramUpdateBatch& batch) {
+    batch.ok = false;
+    batch.errorCode = 0;
+    batch.retryAfter = 0;
+    batch.description[0] = '\0';
+    batch.count = 0;
+    batch.overflow = false;
+
+    error = false;
+    advance();  // Load first character
+
+    if (!enterObject()) {
+        fail();
+        return false;
+    }
+
+    char key[UPDATE_PARSER_KEY_BYTES];
+
+    while (nextKey(key, sizeof(key))) {
+        if (strcmp(key, "ok") == 0) {
+            readBool(batch.ok);
+        } else if (strcmp(key, "error_code") == 0) {
+            int32_t code = 0;
+            readInt32(code);
+            batch.errorCode = code;
+        } else if (strcmp(key, "description") == 0) {
+            readString(batch.description, sizeof(batch.description));
+        } else if (strcmp(key, "parameters") == 0) {
+            if (enterObject()) {
+                while (nextKey(key, sizeof(key))) {
+                    if (strcmp(key, "retry_after") == 0) {
+                        int32_t seconds = 0;
+                        readInt32(seconds);
+                        batch.retryAfter = seconds;
+                    } else {
+                        skipValue();
+                    }
+                }
+            }
+        } else if (strcmp(key, "result") == 0) {
+            if (enterArray()) {
+                while (nextElement()) {
+                    if (batch.count >= TELEGRAM_UPDATE_SLOTS) {
+                        skipValue();
+                        batch.overflow = true;
+                        continue;
+                    }
+
+                    TelegramUpdate& update = batch.updates[batch.count];
+                    parseUpdate(update);
+
+                    // An update without an ID can't be acknowledged
+                    if (update.updateId > 0) {
+                        batch.count++;
+                    }
+                }
+            }
+        } else {
+            skipValue();
+        }
+    }
+
+    return !error;
+}
+
+// ===============================================================
+// SCHEMA
+// ===============================================================
+
+void UpdateParser::parseUpdate(TelegramUpdate& update) {
+    update.updateId = 0;
+    update.kind = UPDATE_OTHER;
+    update.chatId = 0;
+    update.messageId = 0;
+    update.date = 0;
+    update.text[0] = '\0';
+    update.username[0] = '\0';
+    update.callbackId[0] = '\0';
+    update.truncated = false;
+
+    if (!enterObject()) {
+        return;
+    }
+
+    char key[UPDATE_PARSER_KEY_BYTES];
+
+    while (nextKey(key, sizeof(key))) {
+        if (strcmp(key, "update_id") == 0) {
+            readInt32(update.updateId);
+        } else if (strcmp(key, "message") == 0) {
+            update.kind = UPDATE_MESSAGE;
+            parseMessage(update);
+        } else if (strcmp(key, "callback_query") == 0) {
+            update.kind = UPDATE_CALLBACK_QUERY;
+            parseCallbackQuery(update);
+        } else {
+            skipValue();
+        }
+    }
+}
+
+void UpdateParser::parseMessage(TelegramUpdate& update) {
+    if (!enterObject()) {
+        return;
+    }
+
+    char key[UPDATE_PARSER_KEY_BYTES];
+
+    while (nextKey(key, sizeof(key))) {
+        if (strcmp(key, "message_id") == 0) {
+            readInt32(update.messageId);
+        } else if (strcmp(key, "date") == 0) {
+            int64_t date = 0;
+            readInt64(date);
+            update.date = (unsigned long)date;
+        } else if (strcmp(key, "text") == 0) {
+            readString(update.text, sizeof(update.text), &update.truncated);
+        } else if (strcmp(key, "chat") == 0) {
+            parseIdObject(&update.chatId, nullptr);
+        } else if (strcmp(key, "from") == 0) {
+            parseIdObject(nullptr, update.username);
+        } else {
+            skipValue();
+        }
+    }
+}
+
+void UpdateParser::parseCallbackQuery(TelegramUpdate& update) {
+    if (!enterObject()) {
+        return;
+    }
+
+    char key[UPDATE_PARSER_KEY_BYTES];
+
+    while (nextKey(key, sizeof(key))) {
+        if (strcmp(key, "id") == 0) {
+            readString(update.callbackId, sizeof(update.callbackId));
+        } else if (strcmp(key, "data") == 0) {
+            readString(update.text, sizeof(update.text), &update.truncated);
+        } else if (strcmp(key, "from") == 0) {
+            // The user who pressed the button - that's who must be
+            // authorized (same as the chat in a private chat)
+            parseIdObject(&update.chatId, update.username);
+        } else if (strcmp(key, "message") == 0) {
+            parseCallbackMessage(update);
+        } else {
+            skipValue();
+        }
+    }
+}
+
+void UpdateParser::parseCallbackMessage(TelegramUpdate& update) {
+    if (!enterObject()) {
+        return;
+    }
+
+    char key[UPDATE_PARSER_KEY_BYTES];
+
+    // Only the ID of the message with the keyboard (to edit it later)
+    while (nextKey(key, sizeof(key))) {
+        if (strcmp(key, "message_id") == 0) {
+            readInt32(update.messageId);
+        } else {
+            skipValue();
+        }
+    }
+}
+
+void UpdateParser::parseIdObject(int64_t* id, char* username) {
+    if (!enterObject()) {
+        return;
+    }
+
+    char key[UPDATE_PARSER_KEY_BYTES];
+
+    while (nextKey(key, sizeof(key))) {
+        if (id != nullptr && strcmp(key, "id") == 0) {
+            readInt64(*id);
+        } else if (username != nullptr && strcmp(key, "username") == 0) {
+            readString(username, TELEGRAM_USERNAME_MAX_BYTES);
+        } else {
+            skipValue();
+        }
+    }
+}
+
+// ===============================================================
+// JSON READING
+// ===============================================================
+
+void UpdateParser::advance() {
+    current = input.read();
+}
+
+void UpdateParser::skipWhitespace() {
+    while (current == ' ' || current == '\t' || current == '\n' || current == '\r') {
+        advance();
+    }
+}
+
+bool UpdateParser::expect(char c) {
+    skipWhitespace();
+
+    if (current != c) {
+        fail();
+        return false;
+    }
+
+    advance();
+    return true;
+}
+
+bool UpdateParser::enterObject() {
+    if (error) {
+        return false;
+    }
+
+    skipWhitespace();
+
+    if (current != '{') {
+        skipValue();  // Not what we expected - ignore it
+        return false;
+    }
+
+    advance();
+    return true;
+}
+
+bool UpdateParser::nextKey(char* key, size_t size) {
+    if (error) {
+        return false;
+    }
+
+    skipWhitespace();
+
+    if (current == '}') {
+        advance();
+        return false;  // End of object
+    }
+
+    if (current == ',') {
+        advance();
+        skipWhitespace();
+    }
+
+    if (current != '"') {
+        fail();
+        return false;
+    }
+
+    readString(key, size);
+    return expect(':') && !error;
+}
+
+bool UpdateParser::enterArray() {
+    if (error) {
+        return false;
+    }
+
+    skipWhitespace();
+
+    if (current != '[') {
+        skipValue();
+        return false;
+    }
+
+    advance();
+    return true;
+}
+
+bool UpdateParser::nextElement() {
+    if (error) {
+        return false;
+    }
+
+    skipWhitespace();
+
+    if (current == ']') {
+        advance();
+        return false;  // End of array
+    }
+
+    if (current == ',') {
+        advance();
+    }
+
+    if (current < 0) {
+        fail();
+        return false;
+    }
+
+    return true;
+}
+
+void UpdateParser::readString(char* out, size_t size, bool* truncated) {
+    skipWhitespace();
+
+    if (current != '"') {
+        skipValue();
+        return;
+    }
+    advance();
+
+    bool store = (out != nullptr && size > 0);
+    size_t length = 0;
+    bool full = false;
+
+    while (true) {
+        if (current < 0) {
+            fail();
+            return;
+        }
+
+        if (current == '"') {
+            advance();
+            break;
+        }
+
+        if (current != '\\') {
+            // Plain byte (UTF-8 is copied as it is)
+            if (store && !full) {
+                if (length < size - 1) {
+                    out[length++] = (char)current;
+                } else {
+                    full = true;
+                }
+            }
+            advance();
+            continue;
+        }
+
+        // Escape sequence
+        advance();
+        uint32_t codePoint;
+
+        switch (current) {
+            case '"':  codePoint = '"';  break;
+            case '\\': codePoint = '\\'; break;
+            case '/':  codePoint = '/';  break;
+            case 'b':  codePoint = '\b'; break;
+            case 'f':  codePoint = '\f'; break;
+            case 'n':  codePoint = '\n'; break;
+            case 'r':  codePoint = '\r'; break;
+            case 't':  codePoint = '\t'; break;
+            case 'u':
+                advance();
+                codePoint = readHex4();
+
+                // Emoji etc. come as two escapes (surrogate pair)
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF && current == '\\') {
+                    advance();
+                    if (current != 'u') {
+                        fail();
+                        return;
+                    }
+                    advance();
+                    uint32_t low = readHex4();
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        codePoint = 0xFFFD;  // Replacement character
+                    }
+                } else if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+                    codePoint = 0xFFFD;
+                }
+
+                if (store && !full && !appendUtf8(out, size, length, codePoint)) {
+                    full = true;
+                }
+                continue;  // readHex4() already moved past the digits
+            default:
+                fail();
+                return;
+        }
+
+        if (store && !full && !appendUtf8(out, size, length, codePoint)) {
+            full = true;
+        }
+        advance();
+    }
+
+    if (!store) {
+        return;
+    }
+
+    // Don't leave half a UTF-8 character at the cut
+    if (full && length > 0) {
+        size_t start = length - 1;
+        while (start > 0 && ((uint8_t)out[start] & 0xC0) == 0x80) {
+            start--;
+        }
+
+        uint8_t lead = (uint8_t)out[start];
+        size_t needed = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 1;
+
+        if (length - start < needed) {
+            length = start;
+        }
+    }
+
+    out[length] = '\0';
+
+    if (truncated != nullptr) {
+        *truncated = full;
+    }
+}
+
+void UpdateParser::readInt64(int64_t& value) {
+    skipWhitespace();
+
+    if (current != '-' && !(current >= '0' && current <= '9')) {
+        skipValue();
+        return;
+    }
+
+    bool negative = (current == '-');
+    if (negative) {
+        advance();
+    }
+
+    int64_t result = 0;
+    while (current >= '0' && current <= '9') {
+        result = result * 10 + (current - '0');
+        advance();
+    }
+
+    // Fraction or exponent (not used by the fields we read)
+    skipScalar();
+
+    value = negative ? -result : result;
+}
+
+void UpdateParser::readInt32(int32_t& value) {
+    int64_t wide = value;
+    readInt64(wide);
+    value = (int32_t)wide;
+}
+
+void UpdateParser::readBool(bool& value) {
+    skipWhitespace();
+
+    if (current == 't') {
+        value = true;
+    } else if (current == 'f') {
+        value = false;
+    }
+
+    skipValue();
+}
+
+void UpdateParser::skipValue() {
+    int depth = 0;
+
+    do {
+        if (error) {
+            return;
+        }
+
+        skipWhitespace();
+
+        switch (current) {
+            case '{':
+            case '[':
+                depth++;
+                advance();
+                break;
+            case '}':
+            case ']':
+                depth--;
+                advance();
+                break;
+            case ',':
+            case ':':
+                if (depth == 0) {
+                    fail();  // No value where one should be
+                    return;
+                }
+                advance();
+                break;
+            case '"':
+                readString(nullptr, 0);
+                break;
+            case -1:
+                fail();
+                return;
+            default:
+                skipScalar();
+                break;
+        }
+    } while (depth > 0);
+
+    if (depth < 0) {
+        fail();
+    }
+}
+
+void UpdateParser::skipScalar() {
+    while (current >= 0 &&
+           current != ',' && current != ':' && current != '"' &&
+           current != '{' && current != '}' && current != '[' && current != ']' &&
+           current != ' ' && current != '\t' && current != '\n' && current != '\r') {
+        advance();
+    }
+}
+
+bool UpdateParser::appendUtf8(char* out, size_t size, size_t& length, uint32_t codePoint) {
+    size_t needed = (codePoint < 0x80) ? 1 : (codePoint < 0x800) ? 2 :
+                    (codePoint < 0x10000) ? 3 : 4;
+
+    if (length + needed > size - 1) {
+        return false;
+    }
+
+    if (needed == 1) {
+        out[length++] = (char)codePoint;
+    } else if (needed == 2) {
+        out[length++] = (char)(0xC0 | (codePoint >> 6));
+        out[length++] = (char)(0x80 | (codePoint & 0x3F));
+    } else if (needed == 3) {
+        out[length++] = (char)(0xE0 | (codePoint >> 12));
+        out[length++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        out[length++] = (char)(0x80 | (codePoint & 0x3F));
+    } else {
+        out[length++] = (char)(0xF0 | (codePoint >> 18));
+        out[length++] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        out[length++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        out[length++] = (char)(0x80 | (codePoint & 0x3F));
+    }
+
+    return true;
+}
+
+uint32_t UpdateParser::readHex4() {
+    uint32_t value = 0;
+
+    for (int i = 0; i < 4; i++) {
+        int digit;
+
+        if (current >= '0' && current <= '9') {
+            digit = current - '0';
+        } else if (current >= 'a' && current <= 'f') {
+            digit = current - 'a' + 10;
+        } else if (current >= 'A' && current <= 'F') {
+            digit = current - 'A' + 10;
+        } else {
+            fail();
+            return 0;
+        }
+
+        value = (value << 4) | digit;
+        advance();
+    }
+
+    return value;
+}
+
+void UpdateParser::fail() {
+    if (!error) {
+        DEBUG_PRINTLN("[Telegram] ERROR: Invalid getUpdates answer");
+    }
+    error = true;
+}
+
+/*
+ * ===============================================================
+ * IMPLEMENTATION NOTES:
+ * ===============================================================
+ *
+ * 1. HOW LENIENT IS IT?
+ *    The parser checks what it needs to find its way (quotes,
+ *    brackets, colons, escapes) and treats anything broken there as
+ *    an invalid answer. It does not check everything a full JSON
+ *    validator would (e.g. a missing comma between two keys, or
+ *    "tru" instead of "true"). Telegram always sends valid JSON, so
+ *    that's fine for us.
+ *
+ * 2. WHY NO RECURSION IN skipValue()?
+ *    Skipped values can be nested deeply (message entities, photo
+ *    sizes, reply_to_message with its own message inside). Counting
+ *    brackets needs no stack, so a deep answer can't overflow it.
+ *
+ * 3. WHAT IF AN ANSWER IS CUT OFF?
+ *    The Stream returns -1, every function sees current < 0, and
+ *    parse() returns false. Slots filled so far are not used, and
+ *    the offset is not moved - the next getUpdates gets them again.
+ *
+ * ===============================================================
+ */
@@ -0,0 +1,196 @@
+/*
+ * ===============================================================
+ * WakeAssist - Update Parser Module (Header File)
+ * ===============================================================
+ *
+ * This module parses the answer of Telegram's getUpdates call:
+ * - Reads the JSON one character at a time from a Stream
+ * - Knows exactly which fields we need and writes them straight
+ *   into fixed update slots
+ * - Skips everything else (photos, entities, language codes, ...)
+ *   without storing it
+ *
+ * WHY NOT ArduinoJson?
+ * deserializeJson() builds the whole answer as a tree in heap first,
+ * and the fields are copied out of it afterwards. A getUpdates answer
+ * is mostly fields we never look at. This parser uses no heap at all:
+ * the slots are allocated once, and the only other memory is a few
+ * bytes of stack.
+ *
+ * FIELDS READ:
+ * {
+ *   "ok": true,
+ *   "error_code": 429, "description": "...",
+ *   "parameters": { "retry_after": 5 },
+ *   "result": [
+ *     { "update_id": 123,
+ *       "message": { "message_id": 1, "date": 1700000000, "text": "/wake",
+ *                    "chat": { "id": 42 }, "from": { "username": "me" } } },
+ *     { "update_id": 124,
+ *       "callback_query": { "id": "9876", "data": "STOP",
+ *                           "from": { "id": 42, "username": "me" },
+ *                           "message": { "message_id": 7,
+ *                                        "chat": { "id": 42 } } } }
+ *   ]
+ * }
+ *
+ * ===============================================================
+ */
+
+#ifndef UPDATE_PARSER_H
+#define UPDATE_PARSER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===============================================================
+// UPDATE TYPES
+// ===============================================================
+
+enum TelegramUpdateKind {
+    UPDATE_OTHER,            // Something we don't handle (edits, ...)
+    UPDATE_MESSAGE,          // New text message
+    UPDATE_CALLBACK_QUERY    // Inline keyboard button pressed
+};
+
+// ===============================================================
+// UPDATE SLOT
+// ===============================================================
+// One update, fixed size (no heap)
+
+struct TelegramUpdate {
+    int32_t updateId;               // Telegram update ID
+    TelegramUpdateKind kind;        // What kind of update this is
+    int64_t chatId;                 // Chat the message is in
+    int32_t messageId;              // Message (or message with the button)
+    unsigned long date;             // Unix timestamp (messages only)
+    char text[TELEGRAM_TEXT_MAX_BYTES];          // Text, or button data
+    char username[TELEGRAM_USERNAME_MAX_BYTES];  // Sender, "" if none
+    char callbackId[TELEGRAM_CALLBACK_ID_BYTES]; // callback_query id
+    bool truncated;                 // text was cut off
+};
+
+// ===============================================================
+// PARSED getUpdates ANSWER
+// ===============================================================
+
+struct TelegramUpdateBatch {
+    bool ok;                        // "ok" field
+    int errorCode;                  // "error_code", 0 if none
+    int retryAfter;                 // "parameters.retry_after" (s), 0 if none
+    char description[TELEGRAM_ERROR_TEXT_BYTES];  // Error text, "" if none
+
+    TelegramUpdate updates[TELEGRAM_UPDATE_SLOTS];
+    int count;                      // Slots filled
+    bool overflow;                  // More updates than slots (rest skipped,
+                                    // Telegram sends them again)
+};
+
+// ===============================================================
+// UPDATE PARSER CLASS
+// ===============================================================
+// One object per answer (cheap: lives on the stack)
+
+class UpdateParser {
+public:
+    // ---------------------------------------------------------------
+    // CONSTRUCTOR
+    // ---------------------------------------------------------------
+    // input: Body of the getUpdates answer (e.g. an HttpResponse)
+    explicit UpdateParser(Stream& input);
+
+    // ---------------------------------------------------------------
+    // PARSING
+    // ---------------------------------------------------------------
+
+    // Parse the whole answer into batch (all fields are reset first)
+    // RETURNS: true if the answer was complete, valid JSON
+    bool parse(TelegramUpdateBatch& batch);
+
+private:
+    // ---------------------------------------------------------------
+    // PRIVATE MEMBER VARIABLES
+    // ---------------------------------------------------------------
+
+    Stream& input;
+    int current;              // Next unread character, -1 = end of input
+    bool error;               // Invalid or incomplete JSON seen
+
+    // ---------------------------------------------------------------
+    // SCHEMA (one function per JSON object we look into)
+    // ---------------------------------------------------------------
+
+    void parseUpdate(TelegramUpdate& update);
+    void parseMessage(TelegramUpdate& update);
+    void parseCallbackQuery(TelegramUpdate& update);
+    void parseCallbackMessage(TelegramUpdate& update);
+
+    // "chat": { "id": ... } / "from": { "id": ..., "username": ... }
+    // id/username may be nullptr if not needed
+    void parseIdObject(int64_t* id, char* username);
+
+    // ---------------------------------------------------------------
+    // JSON READING
+    // ---------------------------------------------------------------
+
+    // Move to the next character
+    void advance();
+
+    // Skip spaces, tabs and line breaks
+    void skipWhitespace();
+
+    // Expect a character (after whitespace) and consume it
+    bool expect(char c);
+
+    // Object: enterObject(), then nextKey() until it returns false
+    // Array: enterArray(), then nextElement() until it returns false
+    bool enterObject();
+    bool nextKey(char* key, size_t size);
+    bool enterArray();
+    bool nextElement();
+
+    // Read values. On a type mismatch the value is skipped
+    void readString(char* out, size_t size, bool* truncated = nullptr);
+    void readInt64(int64_t& value);
+    void readInt32(int32_t& value);
+    void readBool(bool& value);
+
+    // Skip any value (objects and arrays included)
+    void skipValue();
+
+    // Skip a number or literal (true/false/null)
+    void skipScalar();
+
+    // Append one Unicode code point as UTF-8
+    // RETURNS: false if it did not fit (nothing appended)
+    static bool appendUtf8(char* out, size_t size, size_t& length, uint32_t codePoint);
+
+    // Read 4 hex digits of a \uXXXX escape
+    uint32_t readHex4();
+
+    // Mark the answer invalid
+    void fail();
+};
+
+#endif // UPDATE_PARSER_H
+
+/*
+ * ===============================================================
+ * USAGE EXAMPLE:
+ * ===============================================================
+ *
+ * static TelegramUpdateBatch batch;      // Slots allocated once
+ *
+ * HttpResponse response(client, 10000, 16384);
+ * if (response.begin()) {
+ *     UpdateParser parser(response);
+ *     if (parser.parse(batch) && batch.ok) {
+ *         for (int i = 0; i < batch.count; i++) {
+ *             Serial.println(batch.updates[i].text);
+ *         }
+ *     }
+ *     response.finish();
+ * }
+ *
+ * ===============================================================
+ */
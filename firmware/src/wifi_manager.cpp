@@ -15,6 +15,10 @@
  */
 
 #include "wifi_manager.h"
+#include "stall_watchdog.h"
+#include <esp_netif.h>
+#include <esp_netif_net_stack.h>   // esp_netif_get_netif_impl()
+#include <lwip/dhcp.h>             // Lease time of the DHCP client
 
 // ===============================================================
 // GLOBAL INSTANCE
@@ -36,6 +40,11 @@ WiFiMgr::WiFiMgr() {
     lastReconnectAttempt = 0;
     storedSSID = "";
     storedPassword = "";
+    memset(&fastConnect, 0, sizeof(fastConnect));
+    fastConnectValid = false;
+    leaseObtainedAt = 0;
+    lastConnectTime = 0;
+    lastConnectFast = false;
 
     // Callbacks are null by default (no functions assigned)
     callbackConfigPortalStart = nullptr;
@@ -65,6 +74,9 @@ bool WiFiMgr::begin() {
 
     if (storedSSID.length() > 0) {
         DEBUG_PRINTF("[WiFi] Found stored credentials for: %s\n", storedSSID.c_str());
+
+        // Access point and IP lease from the last connect
+        loadFastConnectInfo();
     } else {
         DEBUG_PRINTLN("[WiFi] No stored credentials found - will need setup");
     }
@@ -140,7 +152,9 @@ bool WiFiMgr::maintainConnection() {
         }
 
         reconnectAttempts = 0;  // Reset retry counter
-        return true;
+
+        checkLease();
+        return isConnected();
 
     } else {
         // We're NOT connected
@@ -232,6 +246,9 @@ bool WiFiMgr::startConfigPortal(unsigned long timeout) {
 
         saveCredentials(newSSID, newPassword);
 
+        // Next boot can connect straight to this access point
+        saveFastConnectInfo();
+
         updateStatus(WIFI_CONNECTED);
         return true;
 
@@ -321,6 +338,9 @@ bool WiFiMgr::clearCredentials() {
     // Remove password
     preferences.remove(KEY_WIFI_PASSWORD);
 
+    // Remove access point and IP lease
+    clearFastConnectInfo();
+
     // Clear cached values
     storedSSID = "";
     storedPassword = "";
@@ -375,6 +395,10 @@ String WiFiMgr::getStatusString() const {
         case WIFI_CONNECTED:
             result += "Connected to '" + getSSID() + "' (" + getIPAddress() + ")";
             result += " RSSI: " + String(getRSSI()) + " dBm";
+            if (lastConnectTime > 0) {
+                result += ", connect took " + String(lastConnectTime) + "ms";
+                result += lastConnectFast ? " (fast)" : " (scan)";
+            }
             break;
         case WIFI_DISCONNECTED:
             result += "Disconnected";
@@ -392,6 +416,10 @@ String WiFiMgr::getStatusString() const {
     return result;
 }
 
+unsigned long WiFiMgr::getLastConnectTime() const {
+    return lastConnectTime;
+}
+
 // ===============================================================
 // CALLBACK FUNCTIONS
 // ===============================================================
@@ -422,26 +450,201 @@ bool WiFiMgr::connectToStoredNetwork() {
 
     DEBUG_PRINTF("[WiFi] Connecting to: %s\n", storedSSID.c_str());
 
-    // Start WiFi connection
-    WiFi.begin(storedSSID.c_str(), storedPassword.c_str());
+    // Report to the stall watchdog if connecting hangs
+    WatchdogSection section(WD_WIFI_CONNECT, "connectToStoredNetwork");
+
+    unsigned long startTime = millis();
+
+    // ---------------------------------------------------------------
+    // 1. Fast connect: same access point, same channel, same IP
+    // ---------------------------------------------------------------
+    bool connected = false;
+    lastConnectFast = false;
+
+    if (fastConnectValid && isLeaseStale()) {
+        // The router may have given this IP to someone else by now
+        DEBUG_PRINTLN("[WiFi] Cached IP lease is too old - using scan and DHCP");
+    } else if (fastConnectValid) {
+        connected = attemptConnect(true, WIFI_FAST_CONNECT_TIMEOUT_MS);
+
+        if (connected) {
+            lastConnectFast = true;
+        } else {
+            // Router moved channel, was replaced, or the lease is gone
+            DEBUG_PRINTLN("[WiFi] Fast connect failed - falling back to scan");
+            WiFi.disconnect();
+        }
+    }
+
+    // ---------------------------------------------------------------
+    // 2. Normal connect: full scan and DHCP
+    // ---------------------------------------------------------------
+    if (!connected) {
+        connected = attemptConnect(false, WIFI_CONNECT_TIMEOUT_MS);
+    }
+
+    if (!connected) {
+        return false;
+    }
+
+    lastConnectTime = millis() - startTime;
+    DEBUG_PRINTF("[WiFi] Connected successfully in %lums (%s)\n",
+                 lastConnectTime, lastConnectFast ? "fast" : "scan");
+
+    // Remember this access point and lease (no flash write if the
+    // fast connect just used the very same values)
+    if (!lastConnectFast) {
+        saveFastConnectInfo();
+    }
+
+    return true;
+}
+
+bool WiFiMgr::attemptConnect(bool fast, unsigned long timeoutMs) {
+    if (fast) {
+        // Static IP = the lease we got last time, so no DHCP round-trip
+        WiFi.config(IPAddress(fastConnect.localIP), IPAddress(fastConnect.gateway),
+                    IPAddress(fastConnect.subnet), IPAddress(fastConnect.dns));
+
+        // Known channel and BSSID = no scan
+        WiFi.begin(storedSSID.c_str(), storedPassword.c_str(),
+                   fastConnect.channel, fastConnect.bssid);
+    } else {
+        // Back to DHCP (undo a static IP from a failed fast connect)
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+
+        WiFi.begin(storedSSID.c_str(), storedPassword.c_str());
+    }
 
     // Wait for connection (with timeout)
+    // Short poll interval - a fast connect is done in a few hundred ms
     unsigned long startTime = millis();
     while (WiFi.status() != WL_CONNECTED) {
-        delay(500);
-        DEBUG_PRINT(".");
+        delay(WIFI_CONNECT_POLL_MS);
 
         // Check timeout
-        if (millis() - startTime > WIFI_CONNECT_TIMEOUT_MS) {
-            DEBUG_PRINTLN("\n[WiFi] Connection timeout!");
+        if (millis() - startTime > timeoutMs) {
+            DEBUG_PRINTF("[WiFi] Connection timeout (%s)!\n", fast ? "fast" : "scan");
             return false;
         }
     }
 
-    DEBUG_PRINTLN("\n[WiFi] Connected successfully!");
     return true;
 }
 
+// Fast connect information (flash)
+
+void WiFiMgr::loadFastConnectInfo() {
+    fastConnectValid = false;
+
+    if (preferences.getBytesLength(KEY_WIFI_FAST_CONNECT) != sizeof(fastConnect)) {
+        return;  // Never saved, or saved by a different firmware
+    }
+
+    preferences.getBytes(KEY_WIFI_FAST_CONNECT, &fastConnect, sizeof(fastConnect));
+
+    // A zero IP or channel would make WiFi.config()/begin() do
+    // something else entirely
+    fastConnectValid = (fastConnect.localIP != 0 && fastConnect.channel > 0);
+
+    if (fastConnectValid) {
+        DEBUG_PRINTF("[WiFi] Fast connect: channel %d, IP %s\n",
+                     (int)fastConnect.channel,
+                     IPAddress(fastConnect.localIP).toString().c_str());
+    }
+}
+
+void WiFiMgr::saveFastConnectInfo() {
+    const uint8_t* bssid = WiFi.BSSID();
+
+    if (bssid == nullptr) {
+        return;
+    }
+
+    memcpy(fastConnect.bssid, bssid, sizeof(fastConnect.bssid));
+    fastConnect.channel = WiFi.channel();
+    fastConnect.localIP = (uint32_t)WiFi.localIP();
+    fastConnect.gateway = (uint32_t)WiFi.gatewayIP();
+    fastConnect.subnet = (uint32_t)WiFi.subnetMask();
+    fastConnect.dns = (uint32_t)WiFi.dnsIP();
+
+    // Dated now if the clock is set, else later by checkLease()
+    time_t now = time(nullptr);
+    leaseObtainedAt = millis();
+    fastConnect.leaseStart = ((unsigned long)now >= NTP_VALID_AFTER) ? (uint32_t)now : 0;
+    fastConnect.leaseSeconds = readLeaseSeconds();
+
+    preferences.putBytes(KEY_WIFI_FAST_CONNECT, &fastConnect, sizeof(fastConnect));
+    fastConnectValid = (fastConnect.localIP != 0 && fastConnect.channel > 0);
+
+    DEBUG_PRINTF("[WiFi] Saved fast connect info (channel %d)\n", (int)fastConnect.channel);
+}
+
+void WiFiMgr::clearFastConnectInfo() {
+    preferences.remove(KEY_WIFI_FAST_CONNECT);
+    memset(&fastConnect, 0, sizeof(fastConnect));
+    fastConnectValid = false;
+}
+
+// DHCP lease of the fast connect
+
+bool WiFiMgr::isLeaseStale() const {
+    time_t now = time(nullptr);
+
+    if ((unsigned long)now < NTP_VALID_AFTER) {
+        return false;
+    }
+
+    if (fastConnect.leaseStart == 0) {
+        return true;
+    }
+
+    // Half the lease time is when a DHCP client would renew (T1)
+    return (uint32_t)now - fastConnect.leaseStart >= fastConnect.leaseSeconds / 2;
+}
+
+void WiFiMgr::checkLease() {
+    if (!fastConnectValid || (unsigned long)time(nullptr) < NTP_VALID_AFTER) {
+        return;
+    }
+
+    // Lease from DHCP before NTP had set the clock: date it now
+    if (!lastConnectFast && fastConnect.leaseStart == 0) {
+        fastConnect.leaseStart = (uint32_t)time(nullptr) - (millis() - leaseObtainedAt) / 1000;
+        preferences.putBytes(KEY_WIFI_FAST_CONNECT, &fastConnect, sizeof(fastConnect));
+        return;
+    }
+
+    // Our IP is a static copy of an old lease, and the DHCP client is
+    // not running: get a real lease before the router hands it out
+    if (lastConnectFast && isLeaseStale()) {
+        DEBUG_PRINTLN("[WiFi] Cached IP lease is due - reconnecting with DHCP");
+
+        WatchdogSection section(WD_WIFI_CONNECT, "checkLease");
+        WiFi.disconnect();
+
+        if (attemptConnect(false, WIFI_CONNECT_TIMEOUT_MS)) {
+            lastConnectFast = false;
+            saveFastConnectInfo();
+        }
+        // Else: maintainConnection() sees the lost connection next
+        // time and reconnects (the stale lease is skipped)
+    }
+}
+
+uint32_t WiFiMgr::readLeaseSeconds() {
+    esp_netif_t* staNetif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    struct netif* lwipNetif = (staNetif != nullptr) ?
+        (struct netif*)esp_netif_get_netif_impl(staNetif) : nullptr;
+    struct dhcp* dhcpClient = (lwipNetif != nullptr) ? netif_dhcp_data(lwipNetif) : nullptr;
+
+    if (dhcpClient != nullptr && dhcpClient->offered_t0_lease > 0) {
+        return dhcpClient->offered_t0_lease;
+    }
+
+    return WIFI_LEASE_DEFAULT_S;
+}
+
 // Generate unique AP name from chip ID
 
 String WiFiMgr::generateAPName() {
@@ -510,7 +713,7 @@ void WiFiMgr::updateStatus(WiFiConnectionStatus newStatus) {
  * pair is stored under a "namespace" (like a folder).
  *
  * Our namespace: "wakeassist"
- * Our keys:      "wifi_ssid", "wifi_pass"
+ * Our keys:      "wifi_ssid", "wifi_pass", "wifi_fast"
  *
  * IMPORTANT: Flash memory has limited write cycles (~100,000).
  * Don't write to flash in a loop! Only write when values change.
@@ -529,4 +732,28 @@ void WiFiMgr::updateStatus(WiFiConnectionStatus newStatus) {
  * reconfigure it (hold RESET button 10 seconds).
  *
  * ===============================================================
+ *
+ * FAST CONNECT:
+ * A normal connect scans all channels (~2s) and asks the router for
+ * an IP address via DHCP (~0.5-2s). After a successful connect we
+ * save the access point's BSSID and channel plus the IP lease, and
+ * next time connect straight to that access point with that IP.
+ *
+ * If the router changed (new channel, new hardware) the fast connect
+ * times out after WIFI_FAST_CONNECT_TIMEOUT_MS and we fall back to
+ * scan + DHCP, which saves the new values. Flash is only written
+ * after a scan connect, never on a successful fast connect.
+ *
+ * THE LEASE RUNS OUT:
+ * A fast connect uses the old lease as a static IP, so no DHCP client
+ * runs and nobody renews it. Association still works when the router
+ * has given that IP to another device - we would just run with a
+ * duplicate address. So the lease is dated (Unix time, once NTP set
+ * the clock) together with its lease time. Past half of it, the
+ * fast path is skipped at boot, and a running device reconnects with
+ * DHCP (checkLease(), every WIFI_CHECK_INTERVAL_MS). After power-on
+ * the clock is not set yet, so the first connect may still be fast;
+ * checkLease() catches it once NTP answers.
+ *
+ * ===============================================================
  */
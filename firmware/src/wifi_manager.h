@@ -168,6 +168,10 @@ public:
     // RETURNS: String like "Connected to 'MyWiFi' (192.168.1.100)"
     String getStatusString() const;
 
+    // How long the last successful connect took (milliseconds)
+    // RETURNS: 0 if never connected
+    unsigned long getLastConnectTime() const;
+
     // ---------------------------------------------------------------
     // CONFIGURATION PORTAL CALLBACKS
     // ---------------------------------------------------------------
@@ -207,6 +211,28 @@ private:
     String storedSSID;                // Cached WiFi network name
     String storedPassword;            // Cached WiFi password
 
+    // Everything needed to skip the scan and DHCP on the next connect
+    // Saved in flash after every connect that went through DHCP (a
+    // fast connect reuses the saved values and writes nothing)
+    struct FastConnectInfo {
+        uint8_t bssid[6];             // MAC address of the access point
+        int32_t channel;              // WiFi channel of the access point
+        uint32_t localIP;             // DHCP lease: our address
+        uint32_t gateway;             // DHCP lease: router
+        uint32_t subnet;              // DHCP lease: subnet mask
+        uint32_t dns;                 // DHCP lease: DNS server
+        uint32_t leaseStart;          // Unix time the lease was obtained
+                                      // (0 = clock was not set yet)
+        uint32_t leaseSeconds;        // Lease time from the router
+    };
+
+    FastConnectInfo fastConnect;      // Loaded from flash
+    bool fastConnectValid;            // fastConnect can be used
+    unsigned long leaseObtainedAt;    // millis() of the last DHCP connect
+
+    unsigned long lastConnectTime;    // Duration of last connect (ms)
+    bool lastConnectFast;             // Last connect used fastConnect
+
     // Callback functions
     std::function<void()> callbackConfigPortalStart;
     std::function<void()> callbackConnect;
@@ -217,9 +243,35 @@ private:
     // ---------------------------------------------------------------
 
     // Attempt to connect using stored credentials
+    // Tries the fast connect first, then a normal connect with scan
     // RETURNS: true if connection successful
     bool connectToStoredNetwork();
 
+    // One connection attempt
+    // fast: true = known BSSID/channel and static IP from fastConnect
+    //       false = full scan and DHCP
+    // timeoutMs: Give up after this long
+    // RETURNS: true if connected
+    bool attemptConnect(bool fast, unsigned long timeoutMs);
+
+    // Load/save/forget fastConnect in flash
+    void loadFastConnectInfo();
+    void saveFastConnectInfo();
+    void clearFastConnectInfo();
+
+    // Check if the saved lease is too old to reuse (past half of its
+    // lease time, or its age is unknown). False while the clock is
+    // not set - checkLease() looks again once it is
+    bool isLeaseStale() const;
+
+    // Called while connected: dates a fresh lease once the clock is
+    // set, and leaves a reused (static) lease for DHCP before it runs
+    // out - nobody else renews it
+    void checkLease();
+
+    // Lease time of the current DHCP lease (seconds)
+    static uint32_t readLeaseSeconds();
+
     // Generate unique Access Point name based on ESP32 chip ID
     // RETURNS: String like "WakeAssist-A3B5"
     String generateAPName();
@@ -0,0 +1,147 @@
+/*
+ * ===============================================================
+ * WakeAssist - Arduino Shim for Host Tests (Header File)
+ * ===============================================================
+ *
+ * The unit tests run on the PC, not on the ESP32:
+ *
+ *   pio test -e native
+ *
+ * [env:native] in platformio.ini only builds the modules that do no
+ * hardware I/O (see build_src_filter there). This header gives them
+ * the few Arduino pieces they use: millis()/delay(), Stream, Serial.
+ *
+ * NOT AN EMULATOR: anything else from Arduino.h is missing on
+ * purpose, so a module that starts to depend on hardware fails to
+ * build here instead of being tested against a fake.
+ *
+ * ===============================================================
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using std::min;
+using std::max;
+
+#define LOW   0
+#define HIGH  1
+
+// ===============================================================
+// TIME
+// ===============================================================
+// Real time since the first call, like millis() since boot
+
+inline unsigned long millis() {
+    static const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// ===============================================================
+// PRINT / STREAM
+// ===============================================================
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t b) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t written = 0;
+        while (written < size && write(buffer[written]) == 1) {
+            written++;
+        }
+        return written;
+    }
+
+    size_t print(const char* text) {
+        return write((const uint8_t*)text, strlen(text));
+    }
+
+    size_t println(const char* text = "") {
+        return print(text) + print("\n");
+    }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        return print(buffer);
+    }
+};
+
+class Stream : public Print {
+public:
+    Stream() : timeout(1000) {}
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+
+    // Up to length bytes, fewer at the end of the input (ArduinoJson
+    // reads a Stream with this)
+    size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = read();
+            if (c < 0) {
+                break;
+            }
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+
+    // Kept for the modules that set it, nothing here waits on it
+    void setTimeout(unsigned long ms) { timeout = ms; }
+    unsigned long getTimeout() const { return timeout; }
+
+protected:
+    unsigned long timeout;
+};
+
+// ===============================================================
+// SERIAL
+// ===============================================================
+// DEBUG_PRINT* output of the modules under test. Quiet unless built
+// with -D HOST_SERIAL_ECHO (keeps the test report readable)
+
+class HostSerial : public Stream {
+public:
+    size_t write(uint8_t b) override {
+#ifdef HOST_SERIAL_ECHO
+        fputc(b, stderr);
+#endif
+        (void)b;
+        return 1;
+    }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+static HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,28 @@
+/*
+ * ===============================================================
+ * WakeAssist - Client Shim for Host Tests (Header File)
+ * ===============================================================
+ *
+ * Arduino's network client interface, as HttpResponse uses it.
+ * test/host/posix_client.h implements it with a plain TCP socket.
+ *
+ * ===============================================================
+ */
+
+#ifndef HOST_CLIENT_H
+#define HOST_CLIENT_H
+
+#include "Arduino.h"
+
+class Client : public Stream {
+public:
+    virtual int connect(const char* host, uint16_t port) = 0;
+    virtual int read(uint8_t* buffer, size_t size) = 0;
+    virtual uint8_t connected() = 0;
+    virtual void stop() = 0;
+
+    using Print::write;
+    using Stream::read;
+};
+
+#endif // HOST_CLIENT_H
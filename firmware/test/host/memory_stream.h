@@ -0,0 +1,53 @@
+/*
+ * ===============================================================
+ * WakeAssist - Memory Stream for Host Tests (Header File)
+ * ===============================================================
+ *
+ * A Stream that reads from a fixed string, so UpdateParser can be
+ * fed a getUpdates answer without a network connection.
+ *
+ * Anything written to it is thrown away.
+ *
+ * ===============================================================
+ */
+
+#ifndef HOST_MEMORY_STREAM_H
+#define HOST_MEMORY_STREAM_H
+
+#include "Arduino.h"
+
+class MemoryStream : public Stream {
+public:
+    explicit MemoryStream(const char* text)
+        : data(text), length(strlen(text)), position(0) {}
+
+    int available() override {
+        return (int)(length - position);
+    }
+
+    int read() override {
+        if (position >= length) {
+            return -1;
+        }
+        return (uint8_t)data[position++];
+    }
+
+    int peek() override {
+        if (position >= length) {
+            return -1;
+        }
+        return (uint8_t)data[position];
+    }
+
+    size_t write(uint8_t b) override {
+        (void)b;
+        return 0;
+    }
+
+private:
+    const char* data;
+    size_t length;
+    size_t position;
+};
+
+#endif // HOST_MEMORY_STREAM_H
@@ -0,0 +1,148 @@
+/*
+ * ===============================================================
+ * WakeAssist - Mock Bot API Harness for Host Tests (Header File)
+ * ===============================================================
+ *
+ * Talks to tools/mock_telegram_api.py the way TelegramBot talks to
+ * Telegram. Start the mock first:
+ *
+ *   python3 tools/mock_telegram_api.py --port 8081
+ *
+ * WAKEASSIST_MOCK_HOST / WAKEASSIST_MOCK_PORT override where the
+ * tests look for it (default 127.0.0.1:8081). Without a running
+ * mock the tests that need it are reported as ignored.
+ *
+ * The tests drive the firmware's own request path: BotTransport
+ * (src/bot_transport.cpp) over a PosixClient instead of TlsClient,
+ * with the same HttpResponse, UpdateParser and CircuitBreaker.
+ * TelegramBot itself also owns the TLS client, NVS storage and
+ * WiFi, which only exist on the ESP32.
+ *
+ * ===============================================================
+ */
+
+#ifndef HOST_MOCK_API_H
+#define HOST_MOCK_API_H
+
+#include <functional>
+#include "posix_client.h"
+#include "config.h"
+#include "bot_transport.h"
+#include "http_response.h"
+#include "update_parser.h"
+
+// Token the harness sends (the mock accepts any unless --token)
+#define MOCK_BOT_TOKEN  "123456:HOST-TEST"
+
+// ===============================================================
+// WHERE THE MOCK IS
+// ===============================================================
+
+inline const char* mockHost() {
+    const char* host = getenv("WAKEASSIST_MOCK_HOST");
+    return (host != nullptr && host[0] != '\0') ? host : "127.0.0.1";
+}
+
+inline uint16_t mockPort() {
+    const char* port = getenv("WAKEASSIST_MOCK_PORT");
+    return (port != nullptr && port[0] != '\0') ? (uint16_t)atoi(port) : 8081;
+}
+
+// ===============================================================
+// BODY HELPERS
+// ===============================================================
+
+// Parser that copies the whole body into 'out' (cut at size - 1)
+inline std::function<bool(Stream&)> bodyReader(char* out, size_t size) {
+    return [out, size](Stream& body) {
+        size_t length = 0;
+        int c;
+        while ((c = body.read()) >= 0) {
+            if (length < size - 1) {
+                out[length++] = (char)c;
+            }
+        }
+        out[length] = '\0';
+        return true;
+    };
+}
+
+// Parser for getUpdates answers (same as TelegramBot::requestUpdates())
+inline std::function<bool(Stream&)> updatesReader(TelegramUpdateBatch& batch) {
+    return [&batch](Stream& body) {
+        UpdateParser parser(body);
+        return parser.parse(batch);
+    };
+}
+
+// ===============================================================
+// CONTROL ENDPOINTS (/mock/...)
+// ===============================================================
+// One short connection per call, so it never disturbs the kept-alive
+// connection under test. Safe to call from a second thread.
+//
+// RETURNS: true on a 2xx answer, reply body in 'reply' if given
+
+inline bool mockControl(const char* action, const char* json = "",
+                        char* reply = nullptr, size_t replySize = 0) {
+    PosixClient client;
+
+    if (!client.connect(mockHost(), mockPort())) {
+        return false;
+    }
+
+    char head[256];
+    int headLen = snprintf(head, sizeof(head),
+                           "%s /mock/%s HTTP/1.1\r\n"
+                           "Host: %s\r\n"
+                           "Connection: close\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Content-Length: %u\r\n\r\n",
+                           json[0] != '\0' ? "POST" : "GET", action,
+                           mockHost(), (unsigned)strlen(json));
+
+    client.write((const uint8_t*)head, headLen);
+    client.write((const uint8_t*)json, strlen(json));
+
+    char ignored[64];
+    HttpResponse http(client, TELEGRAM_API_TIMEOUT_MS, TELEGRAM_MAX_RESPONSE_BYTES);
+
+    if (!http.begin()) {
+        return false;
+    }
+
+    if (reply != nullptr) {
+        bodyReader(reply, replySize)(http);
+    } else {
+        bodyReader(ignored, sizeof(ignored))(http);
+    }
+
+    return http.finish() && http.getStatusCode() / 100 == 2;
+}
+
+inline bool mockRunning() {
+    return mockControl("stats");
+}
+
+// ===============================================================
+// BOT API TRANSPORT
+// ===============================================================
+
+// Back-off jitter for the breaker (esp_random() on the device)
+inline uint32_t hostRandom() {
+    return (uint32_t)rand();
+}
+
+// Point a transport at the mock, over plain HTTP on 'client'
+inline void connectToMock(BotTransport& transport, Client& client) {
+    transport.setServer(client, mockHost(), mockPort(), false);
+    transport.setToken(MOCK_BOT_TOKEN);
+}
+
+// getUpdates into 'batch' (same as TelegramBot::requestUpdates())
+inline bool getUpdates(BotTransport& transport, const char* params,
+                       TelegramUpdateBatch& batch, unsigned long waitMs = 0) {
+    return transport.request("GET", "getUpdates", params, "", updatesReader(batch), waitMs);
+}
+
+#endif // HOST_MOCK_API_H
@@ -0,0 +1,166 @@
+/*
+ * ===============================================================
+ * WakeAssist - TCP Client for Host Tests (Header File)
+ * ===============================================================
+ *
+ * The Client interface over a plain POSIX socket, so HttpResponse
+ * and the parsers can talk to tools/mock_telegram_api.py on the PC.
+ *
+ * Behaves like WiFiClient where the firmware depends on it:
+ * - read() and available() never wait
+ * - connected() stays true while received data is unread, and
+ *   turns false once the server closed and the data is gone
+ *
+ * ===============================================================
+ */
+
+#ifndef HOST_POSIX_CLIENT_H
+#define HOST_POSIX_CLIENT_H
+
+#include "Client.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class PosixClient : public Client {
+public:
+    PosixClient() : fd(-1), connectCount(0) {}
+    ~PosixClient() { stop(); }
+
+    // ---------------------------------------------------------------
+    // CONNECTION
+    // ---------------------------------------------------------------
+
+    int connect(const char* host, uint16_t port) override {
+        stop();
+
+        char service[8];
+        snprintf(service, sizeof(service), "%u", port);
+
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* found = nullptr;
+        if (getaddrinfo(host, service, &hints, &found) != 0) {
+            return 0;
+        }
+
+        for (struct addrinfo* a = found; a != nullptr && fd < 0; a = a->ai_next) {
+            fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(found);
+
+        if (fd < 0) {
+            return 0;
+        }
+
+        // Small requests go out at once, like lwIP on the ESP32
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        connectCount++;
+        return 1;
+    }
+
+    uint8_t connected() override {
+        if (fd < 0) {
+            return 0;
+        }
+
+        char c;
+        ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+
+        if (n > 0) {
+            return 1;
+        }
+        if (n == 0) {
+            return 0;                   // Closed by the server
+        }
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 1 : 0;
+    }
+
+    void stop() override {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    // New TCP connections made so far (keep-alive checks)
+    uint32_t getConnectCount() const {
+        return connectCount;
+    }
+
+    // ---------------------------------------------------------------
+    // DATA
+    // ---------------------------------------------------------------
+
+    size_t write(uint8_t b) override {
+        return write(&b, 1);
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        size_t sent = 0;
+
+        while (fd >= 0 && sent < size) {
+            ssize_t n = send(fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                break;
+            }
+            sent += n;
+        }
+
+        return sent;
+    }
+
+    int available() override {
+        int waiting = 0;
+
+        if (fd < 0 || ioctl(fd, FIONREAD, &waiting) != 0) {
+            return 0;
+        }
+
+        return waiting;
+    }
+
+    int read() override {
+        uint8_t b;
+        return (read(&b, 1) == 1) ? b : -1;
+    }
+
+    int read(uint8_t* buffer, size_t size) override {
+        if (fd < 0) {
+            return -1;
+        }
+
+        ssize_t n = recv(fd, buffer, size, MSG_DONTWAIT);
+        return (n > 0) ? (int)n : -1;
+    }
+
+    int peek() override {
+        uint8_t b;
+
+        if (fd < 0 || recv(fd, &b, 1, MSG_PEEK | MSG_DONTWAIT) != 1) {
+            return -1;
+        }
+
+        return b;
+    }
+
+private:
+    int fd;
+    uint32_t connectCount;
+};
+
+#endif // HOST_POSIX_CLIENT_H
@@ -0,0 +1,140 @@
+/*
+ * ===============================================================
+ * WakeAssist - Scripted Client for Host Tests (Header File)
+ * ===============================================================
+ *
+ * A Client that plays a server from a script: each request written
+ * to it releases the next canned response. Lets HttpResponse be
+ * tested on one kept-alive connection without a network.
+ *
+ * - setPieceSize(n): the "network" hands out at most n bytes per
+ *   read()/available(), so framing lands across buffer refills
+ * - closeAfterScript(): connected() turns false once the last
+ *   response has been read (server closed the connection)
+ *
+ * ===============================================================
+ */
+
+#ifndef HOST_SCRIPT_CLIENT_H
+#define HOST_SCRIPT_CLIENT_H
+
+#include "Client.h"
+
+class ScriptClient : public Client {
+public:
+    static const int MAX_RESPONSES = 8;
+
+    ScriptClient()
+        : responseCount(0), released(0), current(nullptr), position(0),
+          pieceSize(0), closeAtEnd(false), requestCount(0) {}
+
+    // ---------------------------------------------------------------
+    // SCRIPT
+    // ---------------------------------------------------------------
+
+    // Raw bytes (status line, headers, body) for the next request
+    void addResponse(const char* raw) {
+        if (responseCount < MAX_RESPONSES) {
+            responses[responseCount++] = raw;
+        }
+    }
+
+    // Bytes per read() (0 = everything at once)
+    void setPieceSize(size_t size) {
+        pieceSize = size;
+    }
+
+    void closeAfterScript() {
+        closeAtEnd = true;
+    }
+
+    // Requests written so far (any write() starts one)
+    int getRequestCount() const {
+        return requestCount;
+    }
+
+    // ---------------------------------------------------------------
+    // CLIENT INTERFACE
+    // ---------------------------------------------------------------
+
+    int connect(const char* host, uint16_t port) override {
+        (void)host;
+        (void)port;
+        return 1;
+    }
+
+    uint8_t connected() override {
+        if (unread() > 0) {
+            return 1;
+        }
+        return (closeAtEnd && released >= responseCount) ? 0 : 1;
+    }
+
+    void stop() override {
+        current = nullptr;
+        released = responseCount;
+    }
+
+    size_t write(uint8_t b) override {
+        return write(&b, 1);
+    }
+
+    // The first write after a response was read releases the next one
+    size_t write(const uint8_t* buffer, size_t size) override {
+        (void)buffer;
+
+        if (unread() == 0 && released < responseCount) {
+            current = responses[released++];
+            position = 0;
+            requestCount++;
+        }
+        return size;
+    }
+
+    int available() override {
+        size_t waiting = unread();
+        if (pieceSize > 0 && waiting > pieceSize) {
+            waiting = pieceSize;
+        }
+        return (int)waiting;
+    }
+
+    int read() override {
+        uint8_t b;
+        return (read(&b, 1) == 1) ? b : -1;
+    }
+
+    int read(uint8_t* buffer, size_t size) override {
+        size_t count = (size_t)available();
+        if (count > size) {
+            count = size;
+        }
+        if (count == 0) {
+            return -1;
+        }
+
+        memcpy(buffer, current + position, count);
+        position += count;
+        return (int)count;
+    }
+
+    int peek() override {
+        return (unread() > 0) ? (uint8_t)current[position] : -1;
+    }
+
+private:
+    const char* responses[MAX_RESPONSES];
+    int responseCount;
+    int released;             // Responses handed to a request so far
+    const char* current;      // Response being read
+    size_t position;
+    size_t pieceSize;
+    bool closeAtEnd;
+    int requestCount;
+
+    size_t unread() const {
+        return (current != nullptr) ? strlen(current) - position : 0;
+    }
+};
+
+#endif // HOST_SCRIPT_CLIENT_H
@@ -0,0 +1,162 @@
+/*
+ * ===============================================================
+ * WakeAssist - Button Debouncer Tests (host)
+ * ===============================================================
+ *
+ * Replays edge patterns into ButtonDebouncer and checks the events
+ * and their latency. All times are made up - the debouncer never
+ * reads the clock itself.
+ *
+ * RUN: pio test -e native -f test_button_debouncer
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include "button_debouncer.h"
+
+// Same timing as the real buttons (see config.h)
+#define DEBOUNCE_MS    50
+#define LONG_PRESS_MS  2000
+#define CONFIRM_MS     20
+
+static ButtonDebouncer button;
+static ButtonEvent event;
+
+void setUp(void) {
+    button = ButtonDebouncer();
+    event = ButtonEvent();
+}
+
+void tearDown(void) {}
+
+// ---------------------------------------------------------------
+// Leading edge (TEST button)
+// ---------------------------------------------------------------
+
+// Bouncy press: PRESS at the first edge, zero latency, bounce ignored
+void test_press_reported_on_first_edge(void) {
+    button.configure(DEBOUNCE_MS, LONG_PRESS_MS);
+
+    TEST_ASSERT_TRUE(button.handleEdge(true, 1000, event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESS, event.type);
+    TEST_ASSERT_EQUAL(1000, event.edgeTime);
+
+    TEST_ASSERT_FALSE(button.handleEdge(false, 1002, event));
+    TEST_ASSERT_FALSE(button.handleEdge(true, 1004, event));
+
+    TEST_ASSERT_TRUE(button.hasDeadline());
+    TEST_ASSERT_EQUAL(1050, button.getDeadline());
+    TEST_ASSERT_FALSE(button.handleDeadline(true, 1050, event));
+    TEST_ASSERT_TRUE(button.isPressed());
+}
+
+// Tap shorter than the bounce window: the release is caught by the
+// level check at the end of the window
+void test_short_tap_release_reported_at_window_end(void) {
+    button.configure(DEBOUNCE_MS, LONG_PRESS_MS);
+
+    TEST_ASSERT_TRUE(button.handleEdge(true, 1000, event));
+    TEST_ASSERT_FALSE(button.handleEdge(false, 1030, event));
+
+    TEST_ASSERT_TRUE(button.handleDeadline(false, 1050, event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_RELEASE, event.type);
+    TEST_ASSERT_FALSE(button.isPressed());
+}
+
+void test_long_press_after_hold_time(void) {
+    button.configure(DEBOUNCE_MS, LONG_PRESS_MS);
+
+    button.handleEdge(true, 1000, event);
+    button.handleDeadline(true, 1050, event);
+
+    TEST_ASSERT_EQUAL(3000, button.getDeadline());
+    TEST_ASSERT_FALSE(button.handleDeadline(true, 2999, event));
+    TEST_ASSERT_TRUE(button.handleDeadline(true, 3000, event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_LONG_PRESS, event.type);
+    TEST_ASSERT_EQUAL(3000, event.edgeTime);
+
+    // Only once per press
+    TEST_ASSERT_FALSE(button.hasDeadline());
+}
+
+// millis() wraps after ~49 days: windows must still end on time
+void test_window_across_millis_overflow(void) {
+    button.configure(DEBOUNCE_MS, LONG_PRESS_MS);
+
+    unsigned long start = (unsigned long)-20;
+    TEST_ASSERT_TRUE(button.handleEdge(true, start, event));
+    TEST_ASSERT_FALSE(button.handleDeadline(true, start + 10, event));
+    TEST_ASSERT_FALSE(button.handleDeadline(true, start + 50, event));
+    TEST_ASSERT_TRUE(button.handleDeadline(true, start + LONG_PRESS_MS, event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_LONG_PRESS, event.type);
+}
+
+// ---------------------------------------------------------------
+// Confirmed press (SILENCE, RESET)
+// ---------------------------------------------------------------
+
+// A 1ms spike is not a press
+void test_spike_rejected(void) {
+    button.configure(DEBOUNCE_MS, LONG_PRESS_MS, CONFIRM_MS);
+
+    TEST_ASSERT_FALSE(button.handleEdge(true, 5000, event));
+    TEST_ASSERT_TRUE(button.isConfirming());
+    TEST_ASSERT_FALSE(button.handleEdge(false, 5001, event));
+
+    TEST_ASSERT_EQUAL(5021, button.getDeadline());
+    TEST_ASSERT_FALSE(button.handleDeadline(false, 5021, event));
+    TEST_ASSERT_FALSE(button.isPressed());
+    TEST_ASSERT_FALSE(button.isConfirming());
+    TEST_ASSERT_EQUAL(1, button.getRejectedCount());
+    TEST_ASSERT_FALSE(button.hasDeadline());
+}
+
+// Real press bouncing for 5ms: reported CONFIRM_MS after the last
+// bounce, with the time of the first edge
+void test_bouncy_press_confirmed(void) {
+    button.configure(DEBOUNCE_MS, LONG_PRESS_MS, CONFIRM_MS);
+
+    button.handleEdge(true, 6000, event);
+    button.handleEdge(false, 6002, event);
+    button.handleEdge(true, 6005, event);
+
+    TEST_ASSERT_EQUAL(6025, button.getDeadline());
+    TEST_ASSERT_FALSE(button.handleDeadline(true, 6024, event));
+    TEST_ASSERT_TRUE(button.handleDeadline(true, 6025, event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESS, event.type);
+    TEST_ASSERT_EQUAL(6000, event.edgeTime);
+    TEST_ASSERT_TRUE(button.isPressed());
+    TEST_ASSERT_EQUAL(0, button.getRejectedCount());
+
+    // Latency from the first edge stays well below the old 50ms
+    TEST_ASSERT_LESS_OR_EQUAL(DEBOUNCE_MS, 6025 - 6000);
+
+    // Release is leading edge again
+    TEST_ASSERT_TRUE(button.handleEdge(false, 6100, event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_RELEASE, event.type);
+}
+
+// Long press is timed from the first edge of a confirmed press
+void test_confirmed_long_press(void) {
+    button.configure(DEBOUNCE_MS, 10000, CONFIRM_MS);
+
+    button.handleEdge(true, 1000, event);
+    TEST_ASSERT_TRUE(button.handleDeadline(true, 1020, event));
+
+    TEST_ASSERT_EQUAL(11000, button.getDeadline());
+    TEST_ASSERT_TRUE(button.handleDeadline(true, 11000, event));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_LONG_PRESS, event.type);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_press_reported_on_first_edge);
+    RUN_TEST(test_short_tap_release_reported_at_window_end);
+    RUN_TEST(test_long_press_after_hold_time);
+    RUN_TEST(test_window_across_millis_overflow);
+    RUN_TEST(test_spike_rejected);
+    RUN_TEST(test_bouncy_press_confirmed);
+    RUN_TEST(test_confirmed_long_press);
+    return UNITY_END();
+}
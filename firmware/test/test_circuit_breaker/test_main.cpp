@@ -0,0 +1,147 @@
+/*
+ * ===============================================================
+ * WakeAssist - Circuit Breaker Tests (host)
+ * ===============================================================
+ *
+ * Drives CircuitBreaker through an outage with made-up times:
+ * CLOSED -> OPEN after the threshold, fast-fail while OPEN, one
+ * trial in HALF_OPEN, doubling back-off up to the cap, jitter range.
+ *
+ * RUN: pio test -e native -f test_circuit_breaker
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include "circuit_breaker.h"
+
+// Same limits as the Telegram breaker (see config.h)
+#define FAILURES     3
+#define BASE_MS      5000
+#define MAX_MS       120000
+#define JITTER       25
+
+static CircuitBreaker breaker;
+
+void setUp(void) {
+    breaker = CircuitBreaker();
+    breaker.configure(FAILURES, BASE_MS, MAX_MS, 0);   // No jitter: exact times
+}
+
+void tearDown(void) {}
+
+// Trip the breaker at 'now' (threshold failures in a row)
+static void trip(unsigned long now) {
+    for (int i = 0; i < FAILURES; i++) {
+        TEST_ASSERT_TRUE(breaker.allowRequest(now));
+        breaker.recordFailure(now, 0);
+    }
+}
+
+// ---------------------------------------------------------------
+// State transitions
+// ---------------------------------------------------------------
+
+void test_stays_closed_below_threshold(void) {
+    breaker.recordFailure(1000, 0);
+    breaker.recordFailure(2000, 0);
+    TEST_ASSERT_EQUAL(CIRCUIT_CLOSED, breaker.getState());
+
+    // A success in between starts the count again
+    breaker.recordSuccess();
+    breaker.recordFailure(3000, 0);
+    breaker.recordFailure(4000, 0);
+    TEST_ASSERT_EQUAL(CIRCUIT_CLOSED, breaker.getState());
+    TEST_ASSERT_EQUAL(2, breaker.getConsecutiveFailures());
+}
+
+void test_opens_at_threshold_and_fails_fast(void) {
+    trip(1000);
+
+    TEST_ASSERT_EQUAL(CIRCUIT_OPEN, breaker.getState());
+    TEST_ASSERT_EQUAL(1, breaker.getTripCount());
+    TEST_ASSERT_EQUAL(BASE_MS, breaker.getRemainingMs(1000));
+
+    TEST_ASSERT_FALSE(breaker.allowRequest(2000));
+    TEST_ASSERT_FALSE(breaker.allowRequest(5999));
+    TEST_ASSERT_EQUAL(2, breaker.getFastFailCount());
+    TEST_ASSERT_EQUAL(1, breaker.getRemainingMs(5999));
+}
+
+void test_half_open_success_closes(void) {
+    trip(1000);
+
+    TEST_ASSERT_TRUE(breaker.allowRequest(6000));
+    TEST_ASSERT_EQUAL(CIRCUIT_HALF_OPEN, breaker.getState());
+
+    breaker.recordSuccess();
+    TEST_ASSERT_EQUAL(CIRCUIT_CLOSED, breaker.getState());
+    TEST_ASSERT_EQUAL(0, breaker.getConsecutiveFailures());
+
+    // Next outage starts from the base back-off again
+    trip(10000);
+    TEST_ASSERT_EQUAL(BASE_MS, breaker.getRemainingMs(10000));
+}
+
+// ---------------------------------------------------------------
+// Back-off
+// ---------------------------------------------------------------
+
+// Each failed trial doubles the wait: 5, 10, 20, 40, 80, 120 (cap)
+void test_backoff_doubles_up_to_cap(void) {
+    const unsigned long expected[] = { 10000, 20000, 40000, 80000, 120000, 120000 };
+    unsigned long now = 1000;
+
+    trip(now);
+    now += BASE_MS;
+
+    for (unsigned i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        TEST_ASSERT_TRUE(breaker.allowRequest(now));
+        breaker.recordFailure(now, 0);
+        TEST_ASSERT_EQUAL(CIRCUIT_OPEN, breaker.getState());
+        TEST_ASSERT_EQUAL(expected[i], breaker.getRemainingMs(now));
+        now += expected[i];
+    }
+
+    TEST_ASSERT_EQUAL(7, breaker.getTripCount());
+}
+
+void test_jitter_stays_in_range(void) {
+    breaker.configure(FAILURES, BASE_MS, MAX_MS, JITTER);
+    unsigned long now = 0;
+
+    // Random values that hit both ends and the middle of the range
+    const uint32_t randoms[] = { 0, 1, 2500, 5000, 0xFFFFFFFFUL, 123456789UL };
+
+    for (unsigned i = 0; i < sizeof(randoms) / sizeof(randoms[0]); i++) {
+        breaker.recordSuccess();
+        for (int f = 0; f < FAILURES; f++) {
+            breaker.recordFailure(now, randoms[i]);
+        }
+        unsigned long wait = breaker.getRemainingMs(now);
+        TEST_ASSERT_GREATER_OR_EQUAL(BASE_MS * 3 / 4, wait);
+        TEST_ASSERT_LESS_OR_EQUAL(BASE_MS * 5 / 4, wait);
+        now += 1000000;
+    }
+}
+
+// millis() wraps after ~49 days: OPEN must still end on time
+void test_open_across_millis_overflow(void) {
+    unsigned long now = (unsigned long)-1000;
+    trip(now);
+
+    TEST_ASSERT_FALSE(breaker.allowRequest(now + 4999));
+    TEST_ASSERT_TRUE(breaker.allowRequest(now + 5000));
+    TEST_ASSERT_EQUAL(CIRCUIT_HALF_OPEN, breaker.getState());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_stays_closed_below_threshold);
+    RUN_TEST(test_opens_at_threshold_and_fails_fast);
+    RUN_TEST(test_half_open_success_closes);
+    RUN_TEST(test_backoff_doubles_up_to_cap);
+    RUN_TEST(test_jitter_stays_in_range);
+    RUN_TEST(test_open_across_millis_overflow);
+    return UNITY_END();
+}
@@ -0,0 +1,255 @@
+/*
+ * ===============================================================
+ * WakeAssist - Command Table Tests (host)
+ * ===============================================================
+ *
+ * Checks the command dispatch used by Telegram and MQTT: splitting
+ * a message into words, the compile-time vs runtime hash, table
+ * lookup (case, @botname, unknown commands, a forged hash), the
+ * argument readers, and a benchmark of the hash lookup against the
+ * string compare over every command it replaced.
+ *
+ * RUN: pio test -e native -f test_command_table -v
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include <chrono>
+#include "config.h"
+#include "command_table.h"
+
+// Handlers are only compared, never called
+static void handleWake(const TelegramMessage&, const CommandArgs&) {}
+static void handleStop(const TelegramMessage&, const CommandArgs&) {}
+static void handleStatus(const TelegramMessage&, const CommandArgs&) {}
+static void handleOther(const TelegramMessage&, const CommandArgs&) {}
+
+// Same shape as COMMAND_TABLE in main.cpp
+static constexpr TelegramCommand TABLE[] = {
+    TELEGRAM_COMMAND("/wake",   "[delay]", "Start alarm",      handleWake),
+    TELEGRAM_COMMAND("/stop",   "",        "Stop alarm",       handleStop),
+    TELEGRAM_COMMAND("/test",   "",        "Test buzzers",     handleOther),
+    TELEGRAM_COMMAND("/status", "",        "Show status",      handleStatus),
+    TELEGRAM_COMMAND("/perf",   "[reset]", "Show timing",      handleOther),
+    TELEGRAM_COMMAND("/boot",   "",        "Show boot timing", handleOther),
+    TELEGRAM_COMMAND("/poll",   "",        "Show polling",     handleOther),
+    TELEGRAM_COMMAND("/start",  "",        "Show help",        handleOther),
+    TELEGRAM_COMMAND("/help",   "",        "Show help",        handleOther),
+};
+
+static const size_t TABLE_COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+
+static_assert(commandTableIsUnique(TABLE, TABLE_COUNT), "Duplicate command");
+static_assert(commandHash("/WAKE") == commandHash("/wake"), "Hash must ignore case");
+
+// Parse text and look it up
+static const TelegramCommand* dispatch(const char* text) {
+    CommandArgs args;
+    if (!args.parse(text)) {
+        return nullptr;
+    }
+    return findCommand(TABLE, TABLE_COUNT, args);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ---------------------------------------------------------------
+// Splitting
+// ---------------------------------------------------------------
+
+void test_parse_command_bot_and_args(void) {
+    CommandArgs args;
+
+    TEST_ASSERT_TRUE(args.parse("/wake@WakeAssistBot  10m\tnow\n"));
+    TEST_ASSERT_EQUAL(5, args.getCommandLength());
+    TEST_ASSERT_TRUE(args.isCommand("/wake"));
+    TEST_ASSERT_EQUAL(13, args.getBotNameLength());
+    TEST_ASSERT_EQUAL(2, args.count());
+    TEST_ASSERT_TRUE(args.is(0, "10M"));
+    TEST_ASSERT_TRUE(args.is(1, "now"));
+    TEST_ASSERT_FALSE(args.is(2, "now"));
+
+    TEST_ASSERT_TRUE(args.isForBot("wakeassistbot"));
+    TEST_ASSERT_FALSE(args.isForBot("OtherBot"));
+    TEST_ASSERT_TRUE(args.isForBot(""));
+}
+
+void test_plain_text_is_not_a_command(void) {
+    CommandArgs args;
+
+    TEST_ASSERT_FALSE(args.parse("wake up"));
+    TEST_ASSERT_FALSE(args.parse(""));
+    TEST_ASSERT_EQUAL(0, args.count());
+}
+
+void test_extra_args_are_ignored(void) {
+    CommandArgs args;
+
+    TEST_ASSERT_TRUE(args.parse("/perf a b c d e f g h i j k l m n o p"));
+    TEST_ASSERT_EQUAL(TELEGRAM_COMMAND_MAX_ARGS, args.count());
+}
+
+// ---------------------------------------------------------------
+// Lookup
+// ---------------------------------------------------------------
+
+void test_runtime_hash_matches_table(void) {
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        TEST_ASSERT_EQUAL(TABLE[i].hash,
+                          commandHash(TABLE[i].name, strlen(TABLE[i].name)));
+    }
+}
+
+void test_dispatch_finds_each_command(void) {
+    TEST_ASSERT_TRUE(dispatch("/wake") == &TABLE[0]);
+    TEST_ASSERT_TRUE(dispatch("/stop now") == &TABLE[1]);
+    TEST_ASSERT_TRUE(dispatch("/STATUS") == &TABLE[3]);
+    TEST_ASSERT_TRUE(dispatch("/help@WakeAssistBot") == &TABLE[8]);
+    TEST_ASSERT_TRUE(dispatch("/wake 10m")->handler == handleWake);
+}
+
+// Prefixes and longer words are different commands
+void test_dispatch_rejects_unknown(void) {
+    TEST_ASSERT_NULL(dispatch("/stopwatch"));
+    TEST_ASSERT_NULL(dispatch("/sto"));
+    TEST_ASSERT_NULL(dispatch("/"));
+    TEST_ASSERT_NULL(dispatch("/reboot"));
+    TEST_ASSERT_NULL(dispatch("stop"));
+}
+
+// A row whose hash matches but whose name doesn't must not run
+// (stands in for a real FNV-1a collision)
+void test_same_hash_different_name_is_not_run(void) {
+    const TelegramCommand forged[] = {
+        { "/other", commandHash("/wake"), handleOther, "", "" },
+        TELEGRAM_COMMAND("/wake", "", "", handleWake),
+    };
+    CommandArgs args;
+    args.parse("/wake");
+
+    const TelegramCommand* found = findCommand(forged, 2, args);
+    TEST_ASSERT_TRUE(found == &forged[1]);
+}
+
+// ---------------------------------------------------------------
+// Argument readers
+// ---------------------------------------------------------------
+
+void test_get_uint(void) {
+    CommandArgs args;
+    uint32_t value = 7;
+
+    args.parse("/x 42 4294967295 4294967296 12a 5");
+    TEST_ASSERT_TRUE(args.getUInt(0, value));
+    TEST_ASSERT_EQUAL(42, value);
+    TEST_ASSERT_TRUE(args.getUInt(1, value));
+    TEST_ASSERT_TRUE(value == UINT32_MAX);
+
+    value = 7;
+    TEST_ASSERT_FALSE(args.getUInt(2, value));      // Overflow
+    TEST_ASSERT_FALSE(args.getUInt(3, value));      // Not a number
+    TEST_ASSERT_FALSE(args.getUInt(4, value, 10, 20));  // Out of range
+    TEST_ASSERT_FALSE(args.getUInt(5, value));      // Missing
+    TEST_ASSERT_EQUAL(7, value);
+}
+
+void test_get_duration(void) {
+    CommandArgs args;
+    unsigned long ms = 1;
+
+    args.parse("/wake 90s 10m 2h 15 m 25h");
+    TEST_ASSERT_TRUE(args.getDuration(0, ms, 60000, 86400000UL));
+    TEST_ASSERT_EQUAL(90000, ms);
+    TEST_ASSERT_TRUE(args.getDuration(1, ms, 60000, 86400000UL));
+    TEST_ASSERT_EQUAL(600000, ms);
+    TEST_ASSERT_TRUE(args.getDuration(2, ms, 60000, 86400000UL));
+    TEST_ASSERT_EQUAL(7200000, ms);
+    TEST_ASSERT_TRUE(args.getDuration(3, ms, 60000, 86400000UL));  // Default unit
+    TEST_ASSERT_EQUAL(900000, ms);
+
+    ms = 1;
+    TEST_ASSERT_FALSE(args.getDuration(4, ms, 60000, 86400000UL));  // Unit only
+    TEST_ASSERT_FALSE(args.getDuration(5, ms, 60000, 86400000UL));  // Too long
+    TEST_ASSERT_EQUAL(1, ms);
+}
+
+// ---------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------
+// The old dispatch: a case-insensitive whole-word compare against
+// every registered command in turn
+
+static const TelegramCommand* dispatchByCompare(const char* text) {
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        size_t length = strlen(TABLE[i].name);
+        if (strncasecmp(text, TABLE[i].name, length) == 0 &&
+            (text[length] == '\0' || text[length] == ' ' || text[length] == '@')) {
+            return &TABLE[i];
+        }
+    }
+    return nullptr;
+}
+
+#define BENCH_ROUNDS  200000
+
+void test_benchmark_hash_vs_compare(void) {
+    // Mix of early, late and unknown commands
+    static const char* const messages[] = {
+        "/wake 10m", "/stop", "/help", "/poll", "/status@WakeAssistBot",
+        "/unknown", "/start", "/perf reset",
+    };
+    const int messageCount = sizeof(messages) / sizeof(messages[0]);
+    CommandArgs parsed[messageCount];
+    volatile uintptr_t sink = 0;
+
+    // Both must agree on every message
+    for (int i = 0; i < messageCount; i++) {
+        TEST_ASSERT_TRUE(dispatch(messages[i]) == dispatchByCompare(messages[i]));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        parsed[r % messageCount].parse(messages[r % messageCount]);
+    }
+    auto parseEnd = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        sink += (uintptr_t)findCommand(TABLE, TABLE_COUNT, parsed[r % messageCount]);
+    }
+    auto lookupEnd = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        sink += (uintptr_t)dispatchByCompare(messages[r % messageCount]);
+    }
+    auto compareEnd = std::chrono::steady_clock::now();
+
+    typedef std::chrono::duration<double, std::nano> Nanos;
+    double parseNs = Nanos(parseEnd - start).count() / BENCH_ROUNDS;
+    double lookupNs = Nanos(lookupEnd - parseEnd).count() / BENCH_ROUNDS;
+    double compareNs = Nanos(compareEnd - lookupEnd).count() / BENCH_ROUNDS;
+
+    // parse() is needed for the arguments either way; the lookup is
+    // what replaced the compare loop
+    char line[128];
+    snprintf(line, sizeof(line),
+             "per message: parse %.0f ns, hash lookup %.0f ns, compare every command %.0f ns",
+             parseNs, lookupNs, compareNs);
+    TEST_MESSAGE(line);
+    (void)sink;
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_command_bot_and_args);
+    RUN_TEST(test_plain_text_is_not_a_command);
+    RUN_TEST(test_extra_args_are_ignored);
+    RUN_TEST(test_runtime_hash_matches_table);
+    RUN_TEST(test_dispatch_finds_each_command);
+    RUN_TEST(test_dispatch_rejects_unknown);
+    RUN_TEST(test_same_hash_different_name_is_not_run);
+    RUN_TEST(test_get_uint);
+    RUN_TEST(test_get_duration);
+    RUN_TEST(test_benchmark_hash_vs_compare);
+    return UNITY_END();
+}
@@ -0,0 +1,373 @@
+/*
+ * ===============================================================
+ * WakeAssist - HTTP Response Reader Tests (host)
+ * ===============================================================
+ *
+ * Feeds HttpResponse canned answers on one kept-alive connection
+ * (test/host/script_client.h): Content-Length and chunked framing,
+ * framing split over many reads, several responses in a row,
+ * finish() draining what the parser left, when the connection may
+ * be reused, and the errors that must close it.
+ *
+ * RUN: pio test -e native -f test_http_response
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include "config.h"
+#include "http_response.h"
+#include "script_client.h"
+
+#define TIMEOUT_MS  200
+#define MAX_BODY    1024
+
+static ScriptClient* client;
+
+void setUp(void) {
+    client = new ScriptClient();
+}
+
+void tearDown(void) {
+    delete client;
+}
+
+// Send a (dummy) request: releases the next scripted response
+static void sendRequest() {
+    client->write((const uint8_t*)"GET / HTTP/1.1\r\n\r\n", 18);
+}
+
+// Read the whole body into out
+static void readBody(HttpResponse& http, char* out, size_t size) {
+    size_t length = 0;
+    int c;
+    while ((c = http.read()) >= 0) {
+        if (length < size - 1) {
+            out[length++] = (char)c;
+        }
+    }
+    out[length] = '\0';
+}
+
+// One request/response on the shared client
+// RETURNS: finish() result, body in out
+static bool exchange(char* out, size_t size, bool* keepAlive = nullptr) {
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+
+    if (!http.begin()) {
+        out[0] = '\0';
+        return false;
+    }
+    readBody(http, out, size);
+
+    bool ok = http.finish();
+    if (keepAlive != nullptr) {
+        *keepAlive = http.isKeepAlive();
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------
+// Content-Length
+// ---------------------------------------------------------------
+
+void test_content_length_body(void) {
+    client->addResponse("HTTP/1.1 200 OK\r\n"
+                        "Content-Type: application/json\r\n"
+                        "Content-Length: 11\r\n\r\n"
+                        "{\"ok\":true}");
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+    char body[64];
+
+    TEST_ASSERT_TRUE(http.begin());
+    TEST_ASSERT_EQUAL(200, http.getStatusCode());
+    TEST_ASSERT_EQUAL(11, http.available());
+    readBody(http, body, sizeof(body));
+
+    TEST_ASSERT_EQUAL_STRING("{\"ok\":true}", body);
+    TEST_ASSERT_TRUE(http.finish());
+    TEST_ASSERT_TRUE(http.isKeepAlive());
+    TEST_ASSERT_EQUAL(11, http.getBodyBytesRead());
+}
+
+// Several answers on one connection, one byte per network read:
+// each must end exactly where the next one starts
+void test_keep_alive_responses_in_a_row(void) {
+    client->setPieceSize(1);
+    client->addResponse("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nfirst");
+    client->addResponse("HTTP/1.1 200 OK\r\n"
+                        "Transfer-Encoding: chunked\r\n\r\n"
+                        "3\r\nsec\r\n3\r\nond\r\n0\r\n\r\n");
+    client->addResponse("HTTP/1.1 429 Too Many Requests\r\nContent-Length: 5\r\n\r\nthird");
+    char body[32];
+    bool keepAlive = false;
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_EQUAL_STRING("first", body);
+    TEST_ASSERT_TRUE(keepAlive);
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_EQUAL_STRING("second", body);
+    TEST_ASSERT_TRUE(keepAlive);
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_EQUAL_STRING("third", body);
+    TEST_ASSERT_TRUE(keepAlive);
+    TEST_ASSERT_EQUAL(3, client->getRequestCount());
+}
+
+// The parser stops at the end of the JSON; finish() reads the rest
+// so the next response starts at its status line
+void test_finish_drains_unread_body(void) {
+    client->addResponse("HTTP/1.1 200 OK\r\nContent-Length: 12\r\n\r\n{\"a\":1}\r\n\r\n ");
+    client->addResponse("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+
+    sendRequest();
+    {
+        HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+        TEST_ASSERT_TRUE(http.begin());
+        for (int i = 0; i < 7; i++) {
+            TEST_ASSERT_TRUE(http.read() >= 0);
+        }
+        TEST_ASSERT_TRUE(http.finish());
+        TEST_ASSERT_TRUE(http.isKeepAlive());
+    }
+
+    char body[8];
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_STRING("ok", body);
+}
+
+void test_empty_body(void) {
+    client->addResponse("HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n");
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+
+    TEST_ASSERT_TRUE(http.begin());
+    TEST_ASSERT_EQUAL(204, http.getStatusCode());
+    TEST_ASSERT_EQUAL(-1, http.read());
+    TEST_ASSERT_TRUE(http.finish());
+    TEST_ASSERT_TRUE(http.isKeepAlive());
+}
+
+// ---------------------------------------------------------------
+// Chunked
+// ---------------------------------------------------------------
+
+// Chunk extensions, upper-case hex, trailers, split every 3 bytes
+void test_chunked_with_extensions_and_trailers(void) {
+    client->setPieceSize(3);
+    client->addResponse("HTTP/1.1 200 OK\r\n"
+                        "transfer-encoding: Chunked\r\n\r\n"
+                        "A;name=value\r\n0123456789\r\n"
+                        "1\r\n!\r\n"
+                        "0\r\n"
+                        "X-Trailer: yes\r\n\r\n");
+    client->addResponse("HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nnext");
+    char body[32];
+    bool keepAlive = false;
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_EQUAL_STRING("0123456789!", body);
+    TEST_ASSERT_TRUE(keepAlive);
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_STRING("next", body);
+}
+
+// available() counts body bytes only, never the next size line
+void test_chunked_available_excludes_framing(void) {
+    client->addResponse("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                        "4\r\nabcd\r\n2\r\nef\r\n0\r\n\r\n");
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+
+    TEST_ASSERT_TRUE(http.begin());
+    TEST_ASSERT_EQUAL('a', http.peek());
+    TEST_ASSERT_EQUAL(4, http.available());     // 'a' peeked + "bcd"
+    TEST_ASSERT_EQUAL('a', http.read());
+    TEST_ASSERT_EQUAL(3, http.available());
+
+    char body[8];
+    readBody(http, body, sizeof(body));
+    TEST_ASSERT_EQUAL_STRING("bcdef", body);
+    TEST_ASSERT_EQUAL(6, http.getBodyBytesRead());
+    TEST_ASSERT_TRUE(http.finish());
+}
+
+// Body larger than HTTP_READ_BUFFER_BYTES in one chunk
+void test_chunk_larger_than_buffer(void) {
+    static char raw[1024];
+    static char expected[HTTP_READ_BUFFER_BYTES * 2 + 1];
+    size_t size = sizeof(expected) - 1;
+
+    for (size_t i = 0; i < size; i++) {
+        expected[i] = 'a' + (i % 26);
+    }
+    expected[size] = '\0';
+    snprintf(raw, sizeof(raw),
+             "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n%zx\r\n%s\r\n0\r\n\r\n",
+             size, expected);
+    client->addResponse(raw);
+
+    static char body[sizeof(expected) + 8];
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_STRING(expected, body);
+}
+
+// ---------------------------------------------------------------
+// When the connection may be reused
+// ---------------------------------------------------------------
+
+void test_connection_close_is_not_kept(void) {
+    client->addResponse("HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: 2\r\n\r\nok");
+    char body[8];
+    bool keepAlive = true;
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_FALSE(keepAlive);
+}
+
+// HTTP/1.0 closes unless it says keep-alive
+void test_http10_keep_alive_rules(void) {
+    client->addResponse("HTTP/1.0 200 OK\r\nContent-Length: 1\r\n\r\na");
+    client->addResponse("HTTP/1.0 200 OK\r\nConnection: Keep-Alive\r\nContent-Length: 1\r\n\r\nb");
+    char body[8];
+    bool keepAlive = true;
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_FALSE(keepAlive);
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_TRUE(keepAlive);
+}
+
+// No length and not chunked: the body ends when the server closes
+void test_body_until_close(void) {
+    client->closeAfterScript();
+    client->addResponse("HTTP/1.1 200 OK\r\n\r\nuntil close");
+    char body[32];
+    bool keepAlive = true;
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_EQUAL_STRING("until close", body);
+    TEST_ASSERT_FALSE(keepAlive);
+}
+
+// More bytes than the body: the connection is out of step
+void test_bytes_after_body_end_keep_alive(void) {
+    client->addResponse("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nokEXTRA");
+    char body[8];
+    bool keepAlive = true;
+
+    TEST_ASSERT_TRUE(exchange(body, sizeof(body), &keepAlive));
+    TEST_ASSERT_EQUAL_STRING("ok", body);
+    TEST_ASSERT_FALSE(keepAlive);
+}
+
+// ---------------------------------------------------------------
+// Errors
+// ---------------------------------------------------------------
+
+// Kept-alive connection the server had already closed: nothing at
+// all arrives (the caller may retry on a new connection)
+void test_dead_connection_has_no_data(void) {
+    client->closeAfterScript();
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+
+    TEST_ASSERT_FALSE(http.begin());
+    TEST_ASSERT_FALSE(http.hasData());
+    TEST_ASSERT_TRUE(http.hasError());
+    TEST_ASSERT_FALSE(http.isKeepAlive());
+}
+
+// Closed halfway through: error, but data did arrive (no retry -
+// the request may have been carried out)
+void test_cut_short_body_is_an_error(void) {
+    client->closeAfterScript();
+    client->addResponse("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabcd");
+    char body[16];
+
+    TEST_ASSERT_FALSE(exchange(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_STRING("abcd", body);
+}
+
+void test_cut_short_chunk_is_an_error(void) {
+    client->closeAfterScript();
+    client->addResponse("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nab");
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+    char body[16];
+
+    TEST_ASSERT_TRUE(http.begin());
+    readBody(http, body, sizeof(body));
+    TEST_ASSERT_FALSE(http.finish());
+    TEST_ASSERT_TRUE(http.hasData());
+    TEST_ASSERT_FALSE(http.isKeepAlive());
+}
+
+void test_bad_chunk_size_is_an_error(void) {
+    client->addResponse("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n-4\r\nabcd\r\n0\r\n\r\n");
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+
+    TEST_ASSERT_TRUE(http.begin());
+    TEST_ASSERT_EQUAL(-1, http.read());
+    TEST_ASSERT_FALSE(http.finish());
+    TEST_ASSERT_TRUE(http.hasError());
+}
+
+void test_too_large_body_is_refused(void) {
+    client->addResponse("HTTP/1.1 200 OK\r\nContent-Length: 5000\r\n\r\n...");
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+
+    TEST_ASSERT_FALSE(http.begin());
+    TEST_ASSERT_TRUE(http.hasError());
+    TEST_ASSERT_FALSE(http.isKeepAlive());
+}
+
+void test_not_http_is_refused(void) {
+    client->addResponse("SSH-2.0-OpenSSH\r\n\r\n");
+    sendRequest();
+    HttpResponse http(*client, TIMEOUT_MS, MAX_BODY);
+
+    TEST_ASSERT_FALSE(http.begin());
+    TEST_ASSERT_TRUE(http.hasData());
+}
+
+// Server keeps the connection open but never answers
+void test_silent_server_times_out(void) {
+    HttpResponse http(*client, 30, MAX_BODY);
+    unsigned long start = millis();
+
+    TEST_ASSERT_FALSE(http.begin());
+    TEST_ASSERT_GREATER_OR_EQUAL(30, millis() - start);
+    TEST_ASSERT_FALSE(http.hasData());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_content_length_body);
+    RUN_TEST(test_keep_alive_responses_in_a_row);
+    RUN_TEST(test_finish_drains_unread_body);
+    RUN_TEST(test_empty_body);
+    RUN_TEST(test_chunked_with_extensions_and_trailers);
+    RUN_TEST(test_chunked_available_excludes_framing);
+    RUN_TEST(test_chunk_larger_than_buffer);
+    RUN_TEST(test_connection_close_is_not_kept);
+    RUN_TEST(test_http10_keep_alive_rules);
+    RUN_TEST(test_body_until_close);
+    RUN_TEST(test_bytes_after_body_end_keep_alive);
+    RUN_TEST(test_dead_connection_has_no_data);
+    RUN_TEST(test_cut_short_body_is_an_error);
+    RUN_TEST(test_cut_short_chunk_is_an_error);
+    RUN_TEST(test_bad_chunk_size_is_an_error);
+    RUN_TEST(test_too_large_body_is_refused);
+    RUN_TEST(test_not_http_is_refused);
+    RUN_TEST(test_silent_server_times_out);
+    return UNITY_END();
+}
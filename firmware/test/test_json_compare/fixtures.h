@@ -0,0 +1,118 @@
+/*
+ * ===============================================================
+ * WakeAssist - getUpdates Answers for the Parser Comparison
+ * ===============================================================
+ *
+ * Bodies of getUpdates answers as api.telegram.org sends them: every
+ * field a bot gets (entities, language_code, the keyboard message
+ * that comes with a button press, photo sizes, ...), compact and with
+ * everything outside ASCII escaped. Names and IDs are made up.
+ *
+ * To compare on your own traffic, record a session through the mock
+ * server and paste the "body" of a getUpdates line here:
+ *
+ *   python3 tools/mock_telegram_api.py --upstream https://api.telegram.org \
+ *                                      --record session.jsonl
+ *
+ * ===============================================================
+ */
+
+#ifndef TEST_JSON_COMPARE_FIXTURES_H
+#define TEST_JSON_COMPARE_FIXTURES_H
+
+// Long poll that ran out without a message (most answers)
+static const char* const ANSWER_EMPTY =
+    "{\"ok\":true,\"result\":[]}";
+
+// One /wake in the private chat
+static const char* const ANSWER_ONE_COMMAND =
+    "{\"ok\":true,\"result\":[{\"update_id\":873201441,\"message\":{\"message_id\":2211,\"from\":{\"id"
+    "\":518342977,\"is_bot\":false,\"first_name\":\"Anna\",\"last_name\":\"K\",\"username\":\"anna_k\",\""
+    "language_code\":\"de\"},\"chat\":{\"id\":518342977,\"first_name\":\"Anna\",\"last_name\":\"K\",\"use"
+    "rname\":\"anna_k\",\"type\":\"private\"},\"date\":1729060210,\"text\":\"/wake 10m\",\"entities\":[{"
+    "\"offset\":0,\"length\":5,\"type\":\"bot_command\"}]}}]}";
+
+// STOP tapped under the live status message (the whole message
+// with its keyboard comes along)
+static const char* const ANSWER_BUTTON =
+    "{\"ok\":true,\"result\":[{\"update_id\":873201442,\"callback_query\":{\"id\":\"2226242394885117"
+    "051\",\"from\":{\"id\":518342977,\"is_bot\":false,\"first_name\":\"Anna\",\"last_name\":\"K\",\"user"
+    "name\":\"anna_k\",\"language_code\":\"de\"},\"message\":{\"message_id\":2213,\"from\":{\"id\":70123"
+    "45678,\"is_bot\":true,\"first_name\":\"WakeAssist\",\"username\":\"WakeAssistBot\"},\"chat\":{\"i"
+    "d\":518342977,\"first_name\":\"Anna\",\"last_name\":\"K\",\"username\":\"anna_k\",\"type\":\"private"
+    "\"},\"date\":1729060811,\"edit_date\":1729060931,\"text\":\"\\u23f0 Alarm running for 2 min\\n"
+    "\\ud83d\\udd0a Buzzers: on\\n\\ud83d\\udca1 LED: blinking\\nSend /stop or tap the button\","
+    "\"entities\":[{\"offset\":58,\"length\":5,\"type\":\"bot_command\"}],\"reply_markup\":{\"inline_k"
+    "eyboard\":[[{\"text\":\"\\u23f9 STOP\",\"callback_data\":\"/stop\"}],[{\"text\":\"\\ud83d\\ude34 Sn"
+    "ooze 5 min\",\"callback_data\":\"/wake 5m\"},{\"text\":\"\\ud83d\\udcca Status\",\"callback_data"
+    "\":\"/status\"}]]}},\"chat_instance\":\"-4915038203387742917\",\"data\":\"/stop\"}}]}";
+
+// A full answer (TELEGRAM_UPDATE_SLOTS updates) from a group chat:
+// commands, chatter, a photo, a sticker, an edit, a reply and a
+// forward
+static const char* const ANSWER_GROUP_BACKLOG =
+    "{\"ok\":true,\"result\":[{\"update_id\":873201450,\"message\":{\"message_id\":2301,\"from\":{\"id"
+    "\":604211953,\"is_bot\":false,\"first_name\":\"Tom\",\"username\":\"tom_b\",\"language_code\":\"en"
+    "\"},\"chat\":{\"id\":-1001876543210,\"title\":\"Family\",\"type\":\"supergroup\"},\"date\":17290584"
+    "61,\"text\":\"/wake@WakeAssistBot 2h\",\"entities\":[{\"offset\":0,\"length\":19,\"type\":\"bot_c"
+    "ommand\"}]}},{\"update_id\":873201451,\"message\":{\"message_id\":2302,\"from\":{\"id\":6118744"
+    "02,\"is_bot\":false,\"first_name\":\"Lea\",\"language_code\":\"de\"},\"chat\":{\"id\":-10018765432"
+    "10,\"title\":\"Family\",\"type\":\"supergroup\"},\"date\":1729058470,\"text\":\"Gute Nacht \\ud83d"
+    "\\ude34\\ud83c\\udf19\"}},{\"update_id\":873201452,\"message\":{\"message_id\":2303,\"from\":{\"i"
+    "d\":604211953,\"is_bot\":false,\"first_name\":\"Tom\",\"username\":\"tom_b\",\"language_code\":\"e"
+    "n\"},\"chat\":{\"id\":-1001876543210,\"title\":\"Family\",\"type\":\"supergroup\"},\"date\":1729058"
+    "502,\"photo\":[{\"file_id\":\"AgACAgIAAxkBAAIJ_2cPq1xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+    "xxx\",\"file_unique_id\":\"AQADqtsxG890\",\"file_size\":8370,\"width\":90,\"height\":67},{\"file"
+    "_id\":\"AgACAgIAAxkBAAIJ_2cPq1xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\",\"file_unique_i"
+    "d\":\"AQADqtsxG8320\",\"file_size\":29760,\"width\":320,\"height\":240},{\"file_id\":\"AgACAgIAA"
+    "xkBAAIJ_2cPq1xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\",\"file_unique_id\":\"AQADqtsxG88"
+    "00\",\"file_size\":74400,\"width\":800,\"height\":600},{\"file_id\":\"AgACAgIAAxkBAAIJ_2cPq1xx"
+    "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\",\"file_unique_id\":\"AQADqtsxG81280\",\"file_size"
+    "\":119040,\"width\":1280,\"height\":960}],\"caption\":\"Sunrise tomorrow at 07:41\"}},{\"updat"
+    "e_id\":873201453,\"message\":{\"message_id\":2304,\"from\":{\"id\":611874402,\"is_bot\":false,\""
+    "first_name\":\"Lea\",\"language_code\":\"de\"},\"chat\":{\"id\":-1001876543210,\"title\":\"Family\""
+    ",\"type\":\"supergroup\"},\"date\":1729058530,\"text\":\"/status@WakeAssistBot\",\"entities\":[{"
+    "\"offset\":0,\"length\":21,\"type\":\"bot_command\"}],\"reply_to_message\":{\"message_id\":2290,"
+    "\"from\":{\"id\":7012345678,\"is_bot\":true,\"first_name\":\"WakeAssist\",\"username\":\"WakeAssi"
+    "stBot\"},\"chat\":{\"id\":-1001876543210,\"title\":\"Family\",\"type\":\"supergroup\"},\"date\":172"
+    "9058400,\"text\":\"\\u2705 Alarm set for 06:30\",\"reply_markup\":{\"inline_keyboard\":[[{\"te"
+    "xt\":\"\\u23f9 STOP\",\"callback_data\":\"/stop\"}],[{\"text\":\"\\ud83d\\ude34 Snooze 5 min\",\"ca"
+    "llback_data\":\"/wake 5m\"},{\"text\":\"\\ud83d\\udcca Status\",\"callback_data\":\"/status\"}]]}"
+    "}}},{\"update_id\":873201454,\"edited_message\":{\"message_id\":2302,\"from\":{\"id\":61187440"
+    "2,\"is_bot\":false,\"first_name\":\"Lea\",\"language_code\":\"de\"},\"chat\":{\"id\":-100187654321"
+    "0,\"title\":\"Family\",\"type\":\"supergroup\"},\"date\":1729058470,\"edit_date\":1729058541,\"te"
+    "xt\":\"Gute Nacht alle \\ud83d\\ude34\\ud83c\\udf19\"}},{\"update_id\":873201455,\"message\":{\""
+    "message_id\":2305,\"from\":{\"id\":604211953,\"is_bot\":false,\"first_name\":\"Tom\",\"username\""
+    ":\"tom_b\",\"language_code\":\"en\"},\"chat\":{\"id\":-1001876543210,\"title\":\"Family\",\"type\":\""
+    "supergroup\"},\"date\":1729058600,\"text\":\"/wake@OtherAlarmBot\",\"entities\":[{\"offset\":0,"
+    "\"length\":19,\"type\":\"bot_command\"}]}},{\"update_id\":873201456,\"message\":{\"message_id\":"
+    "2306,\"from\":{\"id\":611874402,\"is_bot\":false,\"first_name\":\"Lea\",\"language_code\":\"de\"},"
+    "\"chat\":{\"id\":-1001876543210,\"title\":\"Family\",\"type\":\"supergroup\"},\"date\":1729058633,"
+    "\"sticker\":{\"width\":512,\"height\":512,\"emoji\":\"\\ud83d\\udc4d\",\"set_name\":\"HotCherry\",\"i"
+    "s_animated\":true,\"is_video\":false,\"type\":\"regular\",\"thumbnail\":{\"file_id\":\"AAMCAgADG"
+    "QEAAgnyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy\",\"file_unique_id\":\"AQADNg8AAk\",\"file_"
+    "size\":4890,\"width\":128,\"height\":128},\"file_id\":\"CAACAgIAAxkBAAIJzzzzzzzzzzzzzzzzzzzz"
+    "zzzzzzzzzzzzzzzzzzzz\",\"file_unique_id\":\"AgADNg8AAk\",\"file_size\":28671}}},{\"update_id"
+    "\":873201457,\"message\":{\"message_id\":2307,\"from\":{\"id\":604211953,\"is_bot\":false,\"firs"
+    "t_name\":\"Tom\",\"username\":\"tom_b\",\"language_code\":\"en\"},\"chat\":{\"id\":-1001876543210,\""
+    "title\":\"Family\",\"type\":\"supergroup\"},\"date\":1729058702,\"text\":\"Can someone check the"
+    " buzzer? It was really quiet this morning, I almost slept through it. Maybe the batt"
+    "ery again \\ud83d\\udd0b\"}},{\"update_id\":873201458,\"message\":{\"message_id\":2308,\"from\""
+    ":{\"id\":518342977,\"is_bot\":false,\"first_name\":\"Anna\",\"last_name\":\"K\",\"username\":\"anna"
+    "_k\",\"language_code\":\"de\"},\"chat\":{\"id\":-1001876543210,\"title\":\"Family\",\"type\":\"super"
+    "group\"},\"date\":1729058790,\"text\":\"/stop@WakeAssistBot\",\"entities\":[{\"offset\":0,\"leng"
+    "th\":19,\"type\":\"bot_command\"}],\"forward_origin\":{\"type\":\"user\",\"sender_user\":{\"id\":51"
+    "8342977,\"is_bot\":false,\"first_name\":\"Anna\",\"last_name\":\"K\",\"username\":\"anna_k\",\"lang"
+    "uage_code\":\"de\"},\"date\":1729058780},\"forward_from\":{\"id\":518342977,\"is_bot\":false,\"f"
+    "irst_name\":\"Anna\",\"last_name\":\"K\",\"username\":\"anna_k\",\"language_code\":\"de\"},\"forward"
+    "_date\":1729058780}},{\"update_id\":873201459,\"message\":{\"message_id\":2309,\"from\":{\"id\""
+    ":611874402,\"is_bot\":false,\"first_name\":\"Lea\",\"language_code\":\"de\"},\"chat\":{\"id\":-100"
+    "1876543210,\"title\":\"Family\",\"type\":\"supergroup\"},\"date\":1729058811,\"text\":\"/help\",\"e"
+    "ntities\":[{\"offset\":0,\"length\":5,\"type\":\"bot_command\"}]}}]}";
+
+// 429 answer
+static const char* const ANSWER_RATE_LIMITED =
+    "{\"ok\":false,\"error_code\":429,\"description\":\"Too Many Requests: retry after 7\",\"param"
+    "eters\":{\"retry_after\":7}}";
+
+#endif // TEST_JSON_COMPARE_FIXTURES_H
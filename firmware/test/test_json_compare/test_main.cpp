@@ -0,0 +1,388 @@
+/*
+ * ===============================================================
+ * WakeAssist - UpdateParser vs ArduinoJson (host)
+ * ===============================================================
+ *
+ * Parses the getUpdates answers in fixtures.h three ways and fills
+ * the same TelegramUpdateBatch each time:
+ *
+ *   UpdateParser   what TelegramBot::poll() uses (update_parser.h)
+ *   ArduinoJson    a full JsonDocument, then the fields copied out
+ *                  (what poll() did before)
+ *   + filter       the same with a filter document, so only the
+ *                  fields we use are kept
+ *
+ * All three read the body from a Stream, like the HttpResponse on
+ * the device. Checks that they agree on every field, and reports
+ * parse time and peak heap of each (ArduinoJson's through a metered
+ * Allocator, UpdateParser's through a counting operator new).
+ *
+ * RUN: pio test -e native -f test_json_compare -v
+ *
+ * ===============================================================
+ */
+
+// Read a Stream like on the device (test/host/Arduino.h)
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 1
+
+#include <unity.h>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <ArduinoJson.h>
+#include "memory_stream.h"
+#include "update_parser.h"
+#include "fixtures.h"
+
+// Parses of each answer per parser for the timing
+#define BENCH_ROUNDS  2000
+
+// ---------------------------------------------------------------
+// Heap metering
+// ---------------------------------------------------------------
+
+// operator new calls (UpdateParser must make none)
+static size_t newCalls = 0;
+
+void* operator new(size_t size) {
+    newCalls++;
+    void* block = malloc(size > 0 ? size : 1);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+// Every JsonDocument of this test allocates through one of these.
+// Each block carries its size in front, so frees can be counted too
+class MeteredAllocator : public ArduinoJson::Allocator {
+public:
+    MeteredAllocator() : current(0), peak(0) {}
+
+    void* allocate(size_t size) override {
+        char* block = (char*)malloc(HEADER_BYTES + size);
+        if (block == nullptr) {
+            return nullptr;
+        }
+        *(size_t*)block = size;
+        grow(size);
+        return block + HEADER_BYTES;
+    }
+
+    void deallocate(void* pointer) override {
+        if (pointer == nullptr) {
+            return;
+        }
+        char* block = (char*)pointer - HEADER_BYTES;
+        current -= *(size_t*)block;
+        free(block);
+    }
+
+    void* reallocate(void* pointer, size_t size) override {
+        if (pointer == nullptr) {
+            return allocate(size);
+        }
+        char* block = (char*)pointer - HEADER_BYTES;
+        size_t oldSize = *(size_t*)block;
+
+        char* moved = (char*)realloc(block, HEADER_BYTES + size);
+        if (moved == nullptr) {
+            return nullptr;
+        }
+        *(size_t*)moved = size;
+        current -= oldSize;
+        grow(size);
+        return moved + HEADER_BYTES;
+    }
+
+    // Start a new peak from what is allocated now
+    void resetPeak() { peak = current; }
+
+    size_t getCurrent() const { return current; }
+    size_t getPeak() const { return peak; }
+
+private:
+    static const size_t HEADER_BYTES = alignof(std::max_align_t);
+
+    size_t current;     // Bytes allocated now (without the headers)
+    size_t peak;        // Most bytes allocated at once
+
+    void grow(size_t size) {
+        current += size;
+        if (current > peak) {
+            peak = current;
+        }
+    }
+};
+
+// ---------------------------------------------------------------
+// The three ways to parse
+// ---------------------------------------------------------------
+
+static MeteredAllocator documentHeap;
+static MeteredAllocator filterHeap;
+static JsonDocument filter(&filterHeap);
+
+// Only the fields UpdateParser reads
+static void buildFilter() {
+    filter["ok"] = true;
+    filter["error_code"] = true;
+    filter["description"] = true;
+    filter["parameters"]["retry_after"] = true;
+
+    JsonObject update = filter["result"].add<JsonObject>();
+    update["update_id"] = true;
+
+    JsonObject message = update["message"].to<JsonObject>();
+    message["message_id"] = true;
+    message["date"] = true;
+    message["text"] = true;
+    message["chat"]["id"] = true;
+    message["from"]["username"] = true;
+
+    JsonObject query = update["callback_query"].to<JsonObject>();
+    query["id"] = true;
+    query["data"] = true;
+    query["from"]["id"] = true;
+    query["from"]["username"] = true;
+    query["message"]["message_id"] = true;
+}
+
+// Copy a string field into a fixed slot ("" if missing)
+static void copyText(char* out, size_t size, const char* text, bool* truncated = nullptr) {
+    if (text == nullptr) {
+        text = "";
+    }
+    int length = snprintf(out, size, "%s", text);
+    if (truncated != nullptr) {
+        *truncated = (length >= (int)size);
+    }
+}
+
+// The fields of a parsed document, like UpdateParser fills them
+static void copyFromDocument(const JsonDocument& doc, TelegramUpdateBatch& batch) {
+    memset(&batch, 0, sizeof(batch));
+    batch.ok = doc["ok"].as<bool>();
+    batch.errorCode = doc["error_code"].as<int>();
+    batch.retryAfter = doc["parameters"]["retry_after"].as<int>();
+    copyText(batch.description, sizeof(batch.description),
+             doc["description"].as<const char*>());
+
+    for (JsonObjectConst item : doc["result"].as<JsonArrayConst>()) {
+        if (batch.count >= TELEGRAM_UPDATE_SLOTS) {
+            batch.overflow = true;
+            break;
+        }
+        TelegramUpdate& update = batch.updates[batch.count++];
+        update.updateId = item["update_id"].as<int32_t>();
+        update.kind = UPDATE_OTHER;
+
+        JsonObjectConst message = item["message"].as<JsonObjectConst>();
+        JsonObjectConst query = item["callback_query"].as<JsonObjectConst>();
+
+        if (!message.isNull()) {
+            update.kind = UPDATE_MESSAGE;
+            update.messageId = message["message_id"].as<int32_t>();
+            update.date = message["date"].as<unsigned long>();
+            update.chatId = message["chat"]["id"].as<int64_t>();
+            copyText(update.text, sizeof(update.text),
+                     message["text"].as<const char*>(), &update.truncated);
+            copyText(update.username, sizeof(update.username),
+                     message["from"]["username"].as<const char*>());
+        } else if (!query.isNull()) {
+            update.kind = UPDATE_CALLBACK_QUERY;
+            update.messageId = query["message"]["message_id"].as<int32_t>();
+            update.chatId = query["from"]["id"].as<int64_t>();
+            copyText(update.callbackId, sizeof(update.callbackId),
+                     query["id"].as<const char*>());
+            copyText(update.text, sizeof(update.text),
+                     query["data"].as<const char*>(), &update.truncated);
+            copyText(update.username, sizeof(update.username),
+                     query["from"]["username"].as<const char*>());
+        }
+    }
+}
+
+static bool parseWithUpdateParser(const char* body, TelegramUpdateBatch& batch) {
+    MemoryStream input(body);
+    UpdateParser parser(input);
+    return parser.parse(batch);
+}
+
+static bool parseWithArduinoJson(const char* body, TelegramUpdateBatch& batch, bool filtered) {
+    MemoryStream input(body);
+    JsonDocument doc(&documentHeap);
+
+    DeserializationError error = filtered ?
+        deserializeJson(doc, input, DeserializationOption::Filter(filter)) :
+        deserializeJson(doc, input);
+    if (error) {
+        return false;
+    }
+
+    copyFromDocument(doc, batch);
+    return true;
+}
+
+// ---------------------------------------------------------------
+// Comparison
+// ---------------------------------------------------------------
+
+struct Fixture {
+    const char* name;
+    const char* body;
+};
+
+static const Fixture FIXTURES[] = {
+    { "empty",         ANSWER_EMPTY },
+    { "one command",   ANSWER_ONE_COMMAND },
+    { "button",        ANSWER_BUTTON },
+    { "group backlog", ANSWER_GROUP_BACKLOG },
+    { "429",           ANSWER_RATE_LIMITED },
+};
+
+static const int FIXTURE_COUNT = sizeof(FIXTURES) / sizeof(FIXTURES[0]);
+
+struct Measurement {
+    double parseUs;         // Mean time per answer
+    size_t peakHeapBytes;   // Most heap in use during one answer
+};
+
+static TelegramUpdateBatch expected;
+static TelegramUpdateBatch actual;
+
+static void assertSameBatch(const TelegramUpdateBatch& a, const TelegramUpdateBatch& b) {
+    TEST_ASSERT_EQUAL(a.ok, b.ok);
+    TEST_ASSERT_EQUAL(a.errorCode, b.errorCode);
+    TEST_ASSERT_EQUAL(a.retryAfter, b.retryAfter);
+    TEST_ASSERT_EQUAL_STRING(a.description, b.description);
+    TEST_ASSERT_EQUAL(a.count, b.count);
+    TEST_ASSERT_EQUAL(a.overflow, b.overflow);
+
+    for (int i = 0; i < a.count; i++) {
+        const TelegramUpdate& x = a.updates[i];
+        const TelegramUpdate& y = b.updates[i];
+        TEST_ASSERT_EQUAL(x.updateId, y.updateId);
+        TEST_ASSERT_EQUAL(x.kind, y.kind);
+        TEST_ASSERT_TRUE(x.chatId == y.chatId);
+        TEST_ASSERT_EQUAL(x.messageId, y.messageId);
+        TEST_ASSERT_EQUAL(x.date, y.date);
+        TEST_ASSERT_EQUAL_STRING(x.text, y.text);
+        TEST_ASSERT_EQUAL_STRING(x.username, y.username);
+        TEST_ASSERT_EQUAL_STRING(x.callbackId, y.callbackId);
+        TEST_ASSERT_EQUAL(x.truncated, y.truncated);
+    }
+}
+
+static Measurement measureUpdateParser(const char* body) {
+    size_t before = newCalls;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        parseWithUpdateParser(body, actual);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Only the slots (allocated once, not counted): no heap at all
+    TEST_ASSERT_EQUAL(0, newCalls - before);
+
+    typedef std::chrono::duration<double, std::micro> Micros;
+    Measurement result = { Micros(end - start).count() / BENCH_ROUNDS, 0 };
+    return result;
+}
+
+static Measurement measureArduinoJson(const char* body, bool filtered) {
+    documentHeap.resetPeak();
+    size_t base = documentHeap.getCurrent();
+    TEST_ASSERT_TRUE(parseWithArduinoJson(body, actual, filtered));
+    size_t peak = documentHeap.getPeak() - base;
+
+    // Everything given back when the document goes
+    TEST_ASSERT_EQUAL(base, documentHeap.getCurrent());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        parseWithArduinoJson(body, actual, filtered);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    typedef std::chrono::duration<double, std::micro> Micros;
+    Measurement result = { Micros(end - start).count() / BENCH_ROUNDS, peak };
+    return result;
+}
+
+void setUp(void) {
+    memset(&expected, 0, sizeof(expected));
+    memset(&actual, 0, sizeof(actual));
+}
+
+void tearDown(void) {}
+
+// ---------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------
+
+void test_all_parsers_agree(void) {
+    for (int i = 0; i < FIXTURE_COUNT; i++) {
+        TEST_ASSERT_TRUE(parseWithUpdateParser(FIXTURES[i].body, expected));
+
+        TEST_ASSERT_TRUE(parseWithArduinoJson(FIXTURES[i].body, actual, false));
+        assertSameBatch(expected, actual);
+
+        TEST_ASSERT_TRUE(parseWithArduinoJson(FIXTURES[i].body, actual, true));
+        assertSameBatch(expected, actual);
+    }
+
+    // The fixtures cover what poll() handles
+    TEST_ASSERT_TRUE(parseWithUpdateParser(ANSWER_GROUP_BACKLOG, expected));
+    TEST_ASSERT_EQUAL(TELEGRAM_UPDATE_SLOTS, expected.count);
+    TEST_ASSERT_TRUE(parseWithUpdateParser(ANSWER_BUTTON, expected));
+    TEST_ASSERT_EQUAL(UPDATE_CALLBACK_QUERY, expected.updates[0].kind);
+}
+
+void test_benchmark_parse_time_and_heap(void) {
+    char line[160];
+    snprintf(line, sizeof(line), "%-14s %6s | %-17s | %-17s | %-17s",
+             "answer", "bytes", "UpdateParser", "ArduinoJson", "+ filter");
+    TEST_MESSAGE(line);
+
+    for (int i = 0; i < FIXTURE_COUNT; i++) {
+        const char* body = FIXTURES[i].body;
+        Measurement own = measureUpdateParser(body);
+        Measurement full = measureArduinoJson(body, false);
+        Measurement filtered = measureArduinoJson(body, true);
+
+        snprintf(line, sizeof(line),
+                 "%-14s %6u | %6.1f us %6u B | %6.1f us %6u B | %6.1f us %6u B",
+                 FIXTURES[i].name, (unsigned)strlen(body),
+                 own.parseUs, (unsigned)own.peakHeapBytes,
+                 full.parseUs, (unsigned)full.peakHeapBytes,
+                 filtered.parseUs, (unsigned)filtered.peakHeapBytes);
+        TEST_MESSAGE(line);
+
+        // The filter only ever keeps less
+        TEST_ASSERT_LESS_OR_EQUAL(full.peakHeapBytes, filtered.peakHeapBytes);
+    }
+
+    // Fixed memory instead: the slots, the filter document
+    snprintf(line, sizeof(line),
+             "fixed: UpdateParser slots %u B (allocated once), filter document %u B",
+             (unsigned)sizeof(TelegramUpdateBatch), (unsigned)filterHeap.getCurrent());
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    buildFilter();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_all_parsers_agree);
+    RUN_TEST(test_benchmark_parse_time_and_heap);
+    return UNITY_END();
+}
@@ -0,0 +1,267 @@
+/*
+ * ===============================================================
+ * WakeAssist - Long Poll vs Interval Polling (host, needs the mock)
+ * ===============================================================
+ *
+ * Benchmark against tools/mock_telegram_api.py. A second thread
+ * plays the user and sends the same commands at the same times to
+ * both modes:
+ *
+ *   INTERVAL   getUpdates with timeout=0 every TELEGRAM_POLL_INTERVAL_MS
+ *   LONG POLL  getUpdates with timeout=TELEGRAM_LONG_POLL_TIMEOUT_S,
+ *              the next one right after each answer (TelegramBot::poll())
+ *
+ * and reports requests and command latency (sent -> parsed) of each.
+ * Two more tests measure how fast a queued notification gets out
+ * while a long poll is waiting (the interrupt callback), and check
+ * that the interrupted request is resumed on the same connection.
+ *
+ * Takes about 30 seconds. Add round-trip time with the mock's
+ * --latency-ms option.
+ *
+ * RUN:
+ *   python3 tools/mock_telegram_api.py --port 8081 &
+ *   pio test -e native -f test_long_poll -v
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include "mock_api.h"
+
+// When the user sends a command (ms after the start of a run).
+// Not multiples of the poll interval, like a real user
+#define COMMANDS  4
+static const unsigned long commandAtMs[COMMANDS] = {1300, 4100, 7700, 11200};
+
+// A run that takes longer than this has lost a command
+#define RUN_LIMIT_MS  30000
+
+// Long poll delivers within one round-trip: generous bound for a
+// local mock with some --latency-ms
+#define LONG_POLL_MAX_LATENCY_MS  1000
+
+struct RunResult {
+    uint32_t requests;              // getUpdates calls
+    unsigned long meanLatencyMs;    // Command sent -> parsed
+    unsigned long maxLatencyMs;
+};
+
+static std::atomic<unsigned long> sentAt[COMMANDS];
+static RunResult intervalResult;
+
+void setUp(void) {
+    if (!mockRunning()) {
+        TEST_IGNORE_MESSAGE("mock not running (python3 tools/mock_telegram_api.py)");
+    }
+
+    mockControl("reset", "{}");
+}
+
+void tearDown(void) {}
+
+static void report(const char* mode, const RunResult& result) {
+    char line[128];
+    snprintf(line, sizeof(line), "%-9s %2u requests, latency mean %5lu ms, max %5lu ms",
+             mode, (unsigned)result.requests, result.meanLatencyMs, result.maxLatencyMs);
+    TEST_MESSAGE(line);
+}
+
+// Poll until every command arrived and measure each one's latency
+static RunResult run(bool longPoll) {
+    PosixClient client;
+    BotTransport transport(hostRandom);
+    TelegramUpdateBatch batch;
+    RunResult result = {0, 0, 0};
+    connectToMock(transport, client);
+
+    int received = 0;
+    int32_t lastUpdateId = 0;
+    unsigned long totalLatency = 0;
+    unsigned long start = millis();
+    unsigned long nextPoll = start;
+
+    // The user
+    std::thread user([start]() {
+        for (int i = 0; i < COMMANDS; i++) {
+            while (millis() - start < commandAtMs[i]) {
+                delay(1);
+            }
+            sentAt[i] = millis();
+            mockControl("update", "{\"text\":\"/wake\"}");
+        }
+    });
+
+    while (received < COMMANDS && millis() - start < RUN_LIMIT_MS) {
+        if (!longPoll) {
+            if ((long)(millis() - nextPoll) < 0) {
+                delay(1);
+                continue;
+            }
+            nextPoll += TELEGRAM_POLL_INTERVAL_MS;
+        }
+
+        char params[64];
+        snprintf(params, sizeof(params), "offset=%ld&limit=%d&timeout=%d",
+                 (long)lastUpdateId + 1, TELEGRAM_UPDATE_SLOTS,
+                 longPoll ? TELEGRAM_LONG_POLL_TIMEOUT_S : 0);
+
+        result.requests++;
+        unsigned long waitMs = longPoll ? TELEGRAM_LONG_POLL_TIMEOUT_S * 1000UL : 0;
+
+        if (!getUpdates(transport, params, batch, waitMs)) {
+            continue;
+        }
+
+        unsigned long now = millis();
+
+        for (uint8_t i = 0; i < batch.count && received < COMMANDS; i++) {
+            unsigned long latency = now - sentAt[received];
+            totalLatency += latency;
+            result.maxLatencyMs = max(result.maxLatencyMs, latency);
+            lastUpdateId = batch.updates[i].updateId;
+            received++;
+        }
+    }
+
+    user.join();
+
+    TEST_ASSERT_EQUAL(COMMANDS, received);
+    result.meanLatencyMs = totalLatency / COMMANDS;
+    return result;
+}
+
+// ---------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------
+
+void test_interval_polling(void) {
+    intervalResult = run(false);
+    report("interval", intervalResult);
+
+    // Each command waits for the next poll
+    TEST_ASSERT_LESS_OR_EQUAL(TELEGRAM_POLL_INTERVAL_MS + LONG_POLL_MAX_LATENCY_MS,
+                              intervalResult.maxLatencyMs);
+}
+
+void test_long_polling(void) {
+    RunResult result = run(true);
+    report("long poll", result);
+
+    // One request per command, each answered within a round-trip
+    TEST_ASSERT_LESS_OR_EQUAL(COMMANDS + 1, result.requests);
+    TEST_ASSERT_LESS_OR_EQUAL(LONG_POLL_MAX_LATENCY_MS, result.maxLatencyMs);
+
+    if (intervalResult.requests > 0) {
+        TEST_ASSERT_TRUE(result.meanLatencyMs < intervalResult.meanLatencyMs);
+    }
+}
+
+// While the long poll waits, a notification from the alarm task is
+// queued: the poll is cut short and the message goes out at once on
+// the second connection. The poll's request stays open, and resuming
+// it brings the command that arrived in the meantime - without a
+// new connection (on the device: a TLS handshake)
+void test_long_poll_interrupt_for_notification(void) {
+    PosixClient pollClient;
+    PosixClient sendClient;
+    BotTransport pollTransport(hostRandom);
+    BotTransport sendTransport(hostRandom);
+    TelegramUpdateBatch batch;
+    std::atomic<bool> pending(false);
+    std::atomic<unsigned long> queuedAt(0);
+
+    connectToMock(pollTransport, pollClient);
+    connectToMock(sendTransport, sendClient);
+    sendTransport.shareBreaker(pollTransport);
+    pollTransport.onLongPollInterrupt([&pending]() {
+        return pending.load();
+    });
+
+    std::thread alarm([&pending, &queuedAt]() {
+        delay(500);
+        queuedAt = millis();
+        pending = true;
+    });
+
+    char params[64];
+    snprintf(params, sizeof(params), "offset=1&timeout=%d", TELEGRAM_LONG_POLL_TIMEOUT_S);
+    unsigned long waitMs = TELEGRAM_LONG_POLL_TIMEOUT_S * 1000UL;
+    bool answered = getUpdates(pollTransport, params, batch, waitMs);
+    alarm.join();
+
+    TEST_ASSERT_FALSE(answered);
+    TEST_ASSERT_TRUE(pollTransport.wasInterrupted());
+    TEST_ASSERT_TRUE(pollTransport.isHolding());
+    TEST_ASSERT_EQUAL(1, pollTransport.getLongPollInterrupts());
+    TEST_ASSERT_EQUAL(0, pollTransport.getBreaker().getConsecutiveFailures());
+
+    char body[512];
+    TEST_ASSERT_TRUE(sendTransport.request("POST", "sendMessage", "",
+                                           "{\"chat_id\":42,\"text\":\"Alarm started\"}",
+                                           bodyReader(body, sizeof(body)), 0));
+    unsigned long latency = millis() - queuedAt;
+    pending = false;
+
+    char line[96];
+    snprintf(line, sizeof(line), "notification during long poll sent after %lu ms", latency);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_LESS_OR_EQUAL(LONG_POLL_MAX_LATENCY_MS, latency);
+
+    // The user answers while the poll is held
+    mockControl("update", "{\"text\":\"/stop\"}");
+
+    TEST_ASSERT_TRUE(pollTransport.resume(updatesReader(batch)));
+    TEST_ASSERT_FALSE(pollTransport.isHolding());
+    TEST_ASSERT_TRUE(batch.ok);
+    TEST_ASSERT_EQUAL(1, batch.count);
+    TEST_ASSERT_EQUAL_STRING("/stop", batch.updates[0].text);
+    TEST_ASSERT_EQUAL(1, pollClient.getConnectCount());
+}
+
+// Interrupted again and again (e.g. a timer due every 20 ms): the
+// same request is resumed each time, one connection in total
+void test_repeated_interrupts_keep_one_connection(void) {
+    PosixClient client;
+    BotTransport transport(hostRandom);
+    TelegramUpdateBatch batch;
+
+    connectToMock(transport, client);
+    transport.onLongPollInterrupt([]() {
+        return true;
+    });
+
+    std::thread user([]() {
+        delay(300);
+        mockControl("update", "{\"text\":\"/wake\"}");
+    });
+
+    char params[64];
+    snprintf(params, sizeof(params), "offset=1&timeout=%d", TELEGRAM_LONG_POLL_TIMEOUT_S);
+    bool answered = getUpdates(transport, params, batch, TELEGRAM_LONG_POLL_TIMEOUT_S * 1000UL);
+
+    unsigned long start = millis();
+    while (!answered && transport.isHolding() && millis() - start < RUN_LIMIT_MS) {
+        delay(20);
+        answered = transport.resume(updatesReader(batch));
+    }
+    user.join();
+
+    TEST_ASSERT_TRUE(answered);
+    TEST_ASSERT_EQUAL(1, batch.count);
+    TEST_ASSERT_EQUAL(1, client.getConnectCount());
+    TEST_ASSERT_GREATER_THAN(1, transport.getLongPollInterrupts());
+    TEST_ASSERT_EQUAL(0, transport.getBreaker().getConsecutiveFailures());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_interval_polling);
+    RUN_TEST(test_long_polling);
+    RUN_TEST(test_long_poll_interrupt_for_notification);
+    RUN_TEST(test_repeated_interrupts_keep_one_connection);
+    return UNITY_END();
+}
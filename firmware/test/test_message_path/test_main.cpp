@@ -0,0 +1,254 @@
+/*
+ * ===============================================================
+ * WakeAssist - Received Message Path Tests (host)
+ * ===============================================================
+ *
+ * The way a command goes from a getUpdates answer to its handler,
+ * as TelegramBot::poll() runs it: UpdateParser fills the update
+ * slots, messageFromUpdate() makes a view of each slot and
+ * dispatchCommand() runs the handler. A counting allocator replaces
+ * operator new (and malloc, with glibc) to check that none of it
+ * touches the heap, message after message - on the device that is
+ * what keeps a flood of commands from fragmenting it.
+ *
+ * RUN: pio test -e native -f test_message_path -v
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <new>
+#include <stdlib.h>
+#include "memory_stream.h"
+#include "update_parser.h"
+#include "command_table.h"
+
+// ---------------------------------------------------------------
+// Counting allocator
+// ---------------------------------------------------------------
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* block = malloc(size > 0 ? size : 1);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    free(block);
+}
+
+#ifdef __GLIBC__
+// strdup() and friends skip operator new: count malloc() itself
+extern "C" void* __libc_malloc(size_t size);
+
+extern "C" void* malloc(size_t size) {
+    allocations++;
+    return __libc_malloc(size);
+}
+#endif
+
+// ---------------------------------------------------------------
+// Commands
+// ---------------------------------------------------------------
+
+static int wakeCount;
+static int stopCount;
+static unsigned long lastDelayMs;
+static const char* lastUsername;
+
+static void handleWake(const TelegramMessage& msg, const CommandArgs& args) {
+    (void)msg;
+    unsigned long delayMs = 0;
+    if (args.count() > 0) {
+        args.getDuration(0, delayMs, 60000, 3600000UL);
+    }
+    lastDelayMs = delayMs;
+    wakeCount++;
+}
+
+static void handleStop(const TelegramMessage& msg, const CommandArgs& args) {
+    (void)args;
+    lastUsername = msg.username;
+    stopCount++;
+}
+
+static constexpr TelegramCommand TABLE[] = {
+    TELEGRAM_COMMAND("/wake", "[delay]", "Start alarm", handleWake),
+    TELEGRAM_COMMAND("/stop", "",        "Stop alarm",  handleStop),
+};
+
+static const size_t TABLE_COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+
+// A full getUpdates answer (TELEGRAM_UPDATE_SLOTS updates), shaped
+// like the ones recorded from api.telegram.org
+static const char* const FULL_ANSWER =
+    "{\"ok\":true,\"result\":["
+    "{\"update_id\":101,\"message\":{\"message_id\":1,\"from\":{\"id\":42,\"is_bot\":false,"
+        "\"first_name\":\"A\",\"username\":\"sleeper\"},\"chat\":{\"id\":42,\"type\":\"private\"},"
+        "\"date\":1700000000,\"text\":\"/wake 10m\",\"entities\":[{\"offset\":0,\"length\":5,"
+        "\"type\":\"bot_command\"}]}},"
+    "{\"update_id\":102,\"message\":{\"message_id\":2,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000001,\"text\":\"/stop\"}},"
+    "{\"update_id\":103,\"message\":{\"message_id\":3,\"from\":{\"id\":42},"
+        "\"chat\":{\"id\":42},\"date\":1700000002,\"text\":\"/wake@WakeAssistBot 2h\"}},"
+    "{\"update_id\":104,\"message\":{\"message_id\":4,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000003,\"text\":\"good morning \\ud83d\\ude00\"}},"
+    "{\"update_id\":105,\"message\":{\"message_id\":5,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000004,\"text\":\"/reboot\"}},"
+    "{\"update_id\":106,\"message\":{\"message_id\":6,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000005,\"text\":\"/wake@OtherBot\"}},"
+    "{\"update_id\":107,\"message\":{\"message_id\":7,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000006,\"text\":\"/STOP\"}},"
+    "{\"update_id\":108,\"message\":{\"message_id\":8,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000007,\"text\":\"/wake 90s\"}},"
+    "{\"update_id\":109,\"message\":{\"message_id\":9,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000008,\"text\":\"/stop now please\"}},"
+    "{\"update_id\":110,\"message\":{\"message_id\":10,\"from\":{\"id\":42,\"username\":\"sleeper\"},"
+        "\"chat\":{\"id\":42},\"date\":1700000009,\"text\":\"/wake\"}}"
+    "]}";
+
+// Per answer: 4x /wake, 3x /stop, 1 plain text, 1 unknown, 1 other bot
+#define WAKES_PER_ANSWER   4
+#define STOPS_PER_ANSWER   3
+
+static TelegramUpdateBatch batch;
+static int results[4];
+
+void setUp(void) {
+    memset(&batch, 0, sizeof(batch));
+    memset(results, 0, sizeof(results));
+    wakeCount = 0;
+    stopCount = 0;
+    lastDelayMs = 0;
+    lastUsername = nullptr;
+}
+
+void tearDown(void) {}
+
+// What poll() does with one answer
+static void runAnswer(const char* json) {
+    MemoryStream input(json);
+    UpdateParser parser(input);
+    TEST_ASSERT_TRUE(parser.parse(batch));
+
+    for (uint8_t i = 0; i < batch.count; i++) {
+        TelegramMessage message = messageFromUpdate(batch.updates[i], MESSAGE_FROM_TELEGRAM);
+        results[dispatchCommand(TABLE, TABLE_COUNT, message, "WakeAssistBot")]++;
+    }
+}
+
+// ---------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------
+
+void test_view_points_into_slot(void) {
+    MemoryStream input(FULL_ANSWER);
+    UpdateParser parser(input);
+    TEST_ASSERT_TRUE(parser.parse(batch));
+
+    TelegramMessage message = messageFromUpdate(batch.updates[0], MESSAGE_FROM_TELEGRAM);
+    TEST_ASSERT_TRUE(message.text == batch.updates[0].text);
+    TEST_ASSERT_TRUE(message.username == batch.updates[0].username);
+    TEST_ASSERT_TRUE(message.chatId == 42);
+    TEST_ASSERT_EQUAL(1, message.messageId);
+    TEST_ASSERT_EQUAL(1700000000UL, message.timestamp);
+    TEST_ASSERT_EQUAL(MESSAGE_FROM_TELEGRAM, message.source);
+
+    // No username in the update
+    message = messageFromUpdate(batch.updates[2], MESSAGE_FROM_BUTTON);
+    TEST_ASSERT_EQUAL_STRING("unknown", message.username);
+    TEST_ASSERT_EQUAL(MESSAGE_FROM_BUTTON, message.source);
+}
+
+void test_dispatch_results(void) {
+    runAnswer(FULL_ANSWER);
+
+    TEST_ASSERT_EQUAL(TELEGRAM_UPDATE_SLOTS, batch.count);
+    TEST_ASSERT_EQUAL(WAKES_PER_ANSWER + STOPS_PER_ANSWER, results[DISPATCH_RAN]);
+    TEST_ASSERT_EQUAL(1, results[DISPATCH_NOT_COMMAND]);
+    TEST_ASSERT_EQUAL(1, results[DISPATCH_UNKNOWN]);
+    TEST_ASSERT_EQUAL(1, results[DISPATCH_OTHER_BOT]);
+    TEST_ASSERT_EQUAL(WAKES_PER_ANSWER, wakeCount);
+    TEST_ASSERT_EQUAL(STOPS_PER_ANSWER, stopCount);
+    TEST_ASSERT_EQUAL_STRING("sleeper", lastUsername);
+    TEST_ASSERT_EQUAL(0, lastDelayMs);
+}
+
+// Without a bot name (MQTT) "/wake@OtherBot" runs too
+void test_dispatch_without_bot_name(void) {
+    TelegramMessage message;
+    memset(&message, 0, sizeof(message));
+    message.text = "/wake@OtherBot 5";
+    message.username = "mqtt";
+    message.source = MESSAGE_FROM_MQTT;
+
+    TEST_ASSERT_EQUAL(DISPATCH_RAN, dispatchCommand(TABLE, TABLE_COUNT, message, ""));
+    TEST_ASSERT_EQUAL(5 * 60000UL, lastDelayMs);
+}
+
+#define ALLOC_ROUNDS  10000
+
+void test_no_allocation_per_message(void) {
+    // Warm up (lazy init in the C library)
+    runAnswer(FULL_ANSWER);
+
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ALLOC_ROUNDS; r++) {
+        runAnswer(FULL_ANSWER);
+    }
+    auto end = std::chrono::steady_clock::now();
+    size_t used = allocations - before;
+
+    typedef std::chrono::duration<double, std::nano> Nanos;
+    unsigned long messages = (unsigned long)ALLOC_ROUNDS * TELEGRAM_UPDATE_SLOTS;
+    char line[128];
+    snprintf(line, sizeof(line),
+             "%lu messages: %u allocations, %.0f ns per message (parse + dispatch)",
+             messages, (unsigned)used, Nanos(end - start).count() / messages);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL(0, used);
+    TEST_ASSERT_EQUAL((ALLOC_ROUNDS + 1) * WAKES_PER_ANSWER, wakeCount);
+    TEST_ASSERT_EQUAL((ALLOC_ROUNDS + 1) * STOPS_PER_ANSWER, stopCount);
+}
+
+// The allocator does count (a test that can't fail proves nothing)
+void test_allocator_counts(void) {
+    size_t before = allocations;
+    int* block = new int(1);
+    delete block;
+    TEST_ASSERT_GREATER_THAN(0, allocations - before);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_view_points_into_slot);
+    RUN_TEST(test_dispatch_results);
+    RUN_TEST(test_dispatch_without_bot_name);
+    RUN_TEST(test_no_allocation_per_message);
+    RUN_TEST(test_allocator_counts);
+    return UNITY_END();
+}
@@ -0,0 +1,324 @@
+/*
+ * ===============================================================
+ * WakeAssist - Deadline Scheduler Tests (host)
+ * ===============================================================
+ *
+ * Runs the timer heap on a virtual clock: firing order, re-arming
+ * (from the callback and while armed), cancel, the sleep cap, the
+ * per-call callback budget, lateness reports, and deadlines across
+ * the millis() wrap.
+ *
+ * RUN: pio test -e native -f test_scheduler
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include "config.h"
+#include "scheduler.h"
+
+static unsigned long fakeNow;
+
+static unsigned long fakeClock() {
+    return fakeNow;
+}
+
+// Order in which timers fired (their IDs)
+static int fired[64];
+static int firedCount;
+
+static void record(int timerId) {
+    if (firedCount < (int)(sizeof(fired) / sizeof(fired[0]))) {
+        fired[firedCount] = timerId;
+    }
+    firedCount++;
+}
+
+static unsigned long lastLateMs;
+static int latenessReports;
+
+static void recordLateness(unsigned long lateMs) {
+    lastLateMs = lateMs;
+    latenessReports++;
+}
+
+static Scheduler* scheduler;
+
+void setUp(void) {
+    fakeNow = 1000;
+    firedCount = 0;
+    lastLateMs = 0;
+    latenessReports = 0;
+    scheduler = new Scheduler(fakeClock);
+}
+
+void tearDown(void) {
+    delete scheduler;
+}
+
+// Timer that records its own ID when it fires
+// (IDs are handed out in order, so the next one is the count)
+static int recordingTimer(const char* name) {
+    int id = scheduler->getTimerCount();
+    return scheduler->createTimer(name, [id]() { record(id); });
+}
+
+// ---------------------------------------------------------------
+// Ordering
+// ---------------------------------------------------------------
+
+void test_timers_fire_in_deadline_order(void) {
+    int a = recordingTimer("a");
+    int b = recordingTimer("b");
+    int c = recordingTimer("c");
+    int d = recordingTimer("d");
+
+    scheduler->schedule(a, 300);
+    scheduler->schedule(b, 100);
+    scheduler->schedule(c, 400);
+    scheduler->schedule(d, 200);
+    TEST_ASSERT_EQUAL_STRING("b", scheduler->getNextTimerName());
+    TEST_ASSERT_EQUAL(100, scheduler->getTimeUntilNext());
+
+    fakeNow += 99;
+    scheduler->runDueTimers();
+    TEST_ASSERT_EQUAL(0, firedCount);
+
+    fakeNow += 1;
+    TEST_ASSERT_EQUAL(100, scheduler->runDueTimers());
+    TEST_ASSERT_EQUAL(1, firedCount);
+
+    // Oversleeping runs everything that is due, earliest first
+    fakeNow += 1000;
+    scheduler->runDueTimers();
+    TEST_ASSERT_EQUAL(4, firedCount);
+    TEST_ASSERT_EQUAL(b, fired[0]);
+    TEST_ASSERT_EQUAL(d, fired[1]);
+    TEST_ASSERT_EQUAL(a, fired[2]);
+    TEST_ASSERT_EQUAL(c, fired[3]);
+    TEST_ASSERT_EQUAL(0, scheduler->getArmedCount());
+    TEST_ASSERT_NULL(scheduler->getNextTimerName());
+}
+
+// One-shot: a timer that is not re-armed fires exactly once
+void test_timer_is_one_shot(void) {
+    int a = recordingTimer("a");
+    scheduler->schedule(a, 10);
+
+    fakeNow += 10;
+    scheduler->runDueTimers();
+    fakeNow += 10000;
+    scheduler->runDueTimers();
+
+    TEST_ASSERT_EQUAL(1, firedCount);
+    TEST_ASSERT_FALSE(scheduler->isScheduled(a));
+}
+
+// Nothing armed: sleep the maximum; far deadline: capped too
+void test_sleep_is_capped(void) {
+    int a = recordingTimer("a");
+
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_SLEEP_MS, scheduler->runDueTimers());
+
+    scheduler->schedule(a, SCHEDULER_MAX_SLEEP_MS * 10);
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_SLEEP_MS, scheduler->getTimeUntilNext());
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_SLEEP_MS * 10, scheduler->getTimeUntil(a));
+}
+
+// ---------------------------------------------------------------
+// Re-arm
+// ---------------------------------------------------------------
+
+void test_callback_rearms_itself(void) {
+    static int ticks;
+    static int tick;
+    ticks = 0;
+    tick = scheduler->createTimer("tick", []() {
+        ticks++;
+        scheduler->schedule(tick, 250);
+    });
+    scheduler->schedule(tick, 250);
+
+    for (int i = 0; i < 8; i++) {
+        fakeNow += 250;
+        TEST_ASSERT_EQUAL(250, scheduler->runDueTimers());
+    }
+
+    TEST_ASSERT_EQUAL(8, ticks);
+    TEST_ASSERT_TRUE(scheduler->isScheduled(tick));
+}
+
+void test_rearm_while_armed_moves_deadline(void) {
+    int a = recordingTimer("a");
+    int b = recordingTimer("b");
+    scheduler->schedule(a, 100);
+    scheduler->schedule(b, 200);
+
+    // Later: b is now first
+    scheduler->schedule(a, 300);
+    TEST_ASSERT_EQUAL_STRING("b", scheduler->getNextTimerName());
+
+    // Earlier again: a is first
+    scheduler->schedule(a, 50);
+    TEST_ASSERT_EQUAL_STRING("a", scheduler->getNextTimerName());
+    TEST_ASSERT_EQUAL(2, scheduler->getArmedCount());
+
+    fakeNow += 300;
+    scheduler->runDueTimers();
+    TEST_ASSERT_EQUAL(2, firedCount);
+    TEST_ASSERT_EQUAL(a, fired[0]);
+    TEST_ASSERT_EQUAL(b, fired[1]);
+}
+
+// A timer re-arming itself with zero delay must not lock up the task
+void test_zero_delay_loop_is_bounded(void) {
+    static int spins;
+    static int spinner;
+    spins = 0;
+    spinner = scheduler->createTimer("spin", []() {
+        spins++;
+        scheduler->schedule(spinner, 0);
+    });
+    scheduler->schedule(spinner, 0);
+
+    TEST_ASSERT_EQUAL(0, scheduler->runDueTimers());
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_TIMERS, spins);
+}
+
+// ---------------------------------------------------------------
+// Cancel
+// ---------------------------------------------------------------
+
+void test_cancel_head_and_middle(void) {
+    int ids[6];
+    for (int i = 0; i < 6; i++) {
+        ids[i] = recordingTimer("t");
+        scheduler->schedule(ids[i], 100 * (i + 1));
+    }
+
+    scheduler->cancel(ids[0]);      // Earliest
+    scheduler->cancel(ids[3]);      // Somewhere in the heap
+    scheduler->cancel(ids[3]);      // Twice does nothing
+    TEST_ASSERT_FALSE(scheduler->isScheduled(ids[0]));
+    TEST_ASSERT_EQUAL(0, scheduler->getTimeUntil(ids[0]));
+    TEST_ASSERT_EQUAL(4, scheduler->getArmedCount());
+    TEST_ASSERT_EQUAL(200, scheduler->getTimeUntilNext());
+
+    fakeNow += 1000;
+    scheduler->runDueTimers();
+    TEST_ASSERT_EQUAL(4, firedCount);
+    TEST_ASSERT_EQUAL(ids[1], fired[0]);
+    TEST_ASSERT_EQUAL(ids[2], fired[1]);
+    TEST_ASSERT_EQUAL(ids[4], fired[2]);
+    TEST_ASSERT_EQUAL(ids[5], fired[3]);
+}
+
+// Cancelling another timer from a callback (e.g. /stop cancels the
+// delayed wake) keeps the heap intact
+void test_cancel_from_callback(void) {
+    static int victim;
+    int killer = scheduler->createTimer("killer", []() {
+        scheduler->cancel(victim);
+    });
+    victim = recordingTimer("victim");
+    int other = recordingTimer("other");
+
+    scheduler->schedule(killer, 10);
+    scheduler->schedule(victim, 15);
+    scheduler->schedule(other, 20);
+
+    // One late wakeup: all three are due, the killer runs first
+    fakeNow += 20;
+    scheduler->runDueTimers();
+
+    TEST_ASSERT_FALSE(scheduler->isScheduled(victim));
+    TEST_ASSERT_EQUAL(1, firedCount);
+    TEST_ASSERT_EQUAL(other, fired[0]);
+    TEST_ASSERT_EQUAL(0, scheduler->getArmedCount());
+}
+
+void test_invalid_timer_ids_are_ignored(void) {
+    scheduler->schedule(Scheduler::INVALID_TIMER, 10);
+    scheduler->schedule(5, 10);
+    scheduler->cancel(7);
+
+    TEST_ASSERT_FALSE(scheduler->isScheduled(5));
+    TEST_ASSERT_EQUAL(0, scheduler->getArmedCount());
+}
+
+void test_timer_slots_run_out(void) {
+    for (int i = 0; i < SCHEDULER_MAX_TIMERS; i++) {
+        TEST_ASSERT_NOT_EQUAL(Scheduler::INVALID_TIMER,
+                              scheduler->createTimer("t", nullptr));
+    }
+
+    TEST_ASSERT_EQUAL(Scheduler::INVALID_TIMER, scheduler->createTimer("t", nullptr));
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_TIMERS, scheduler->getTimerCount());
+}
+
+// ---------------------------------------------------------------
+// Lateness and millis() wrap
+// ---------------------------------------------------------------
+
+void test_lateness_is_reported(void) {
+    int a = recordingTimer("a");
+    scheduler->setLatenessRecorder(recordLateness);
+    scheduler->schedule(a, 100);
+
+    fakeNow += 137;
+    scheduler->runDueTimers();
+
+    TEST_ASSERT_EQUAL(1, latenessReports);
+    TEST_ASSERT_EQUAL(37, lastLateMs);
+    TEST_ASSERT_EQUAL(1, scheduler->getWakeupCount());
+    TEST_ASSERT_EQUAL(1, scheduler->getCallbackCount());
+}
+
+// millis() wraps after ~49 days: a deadline past the wrap is still
+// in the future, and order is kept across it
+void test_deadlines_across_millis_wrap(void) {
+    fakeNow = (unsigned long)-150;
+    int a = recordingTimer("a");
+    int b = recordingTimer("b");
+    int c = recordingTimer("c");
+
+    scheduler->schedule(a, 300);    // After the wrap (150)
+    scheduler->schedule(b, 100);    // Before it
+    scheduler->schedule(c, 200);    // Just after it (50)
+
+    TEST_ASSERT_EQUAL(100, scheduler->getTimeUntilNext());
+    TEST_ASSERT_EQUAL(300, scheduler->getTimeUntil(a));
+
+    fakeNow += 100;
+    scheduler->runDueTimers();
+    TEST_ASSERT_EQUAL(1, firedCount);
+
+    fakeNow += 99;                  // 49: c due in 1ms
+    scheduler->runDueTimers();
+    TEST_ASSERT_EQUAL(1, firedCount);
+    TEST_ASSERT_EQUAL(1, scheduler->getTimeUntilNext());
+
+    fakeNow += 101;                 // 150
+    scheduler->runDueTimers();
+    TEST_ASSERT_EQUAL(3, firedCount);
+    TEST_ASSERT_EQUAL(b, fired[0]);
+    TEST_ASSERT_EQUAL(c, fired[1]);
+    TEST_ASSERT_EQUAL(a, fired[2]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_timers_fire_in_deadline_order);
+    RUN_TEST(test_timer_is_one_shot);
+    RUN_TEST(test_sleep_is_capped);
+    RUN_TEST(test_callback_rearms_itself);
+    RUN_TEST(test_rearm_while_armed_moves_deadline);
+    RUN_TEST(test_zero_delay_loop_is_bounded);
+    RUN_TEST(test_cancel_head_and_middle);
+    RUN_TEST(test_cancel_from_callback);
+    RUN_TEST(test_invalid_timer_ids_are_ignored);
+    RUN_TEST(test_timer_slots_run_out);
+    RUN_TEST(test_lateness_is_reported);
+    RUN_TEST(test_deadlines_across_millis_wrap);
+    return UNITY_END();
+}
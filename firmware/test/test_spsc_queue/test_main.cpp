@@ -0,0 +1,199 @@
+/*
+ * ===============================================================
+ * WakeAssist - SPSC Queue Tests (host)
+ * ===============================================================
+ *
+ * Checks the lock-free hand-off between the network and alarm
+ * tasks: FIFO order, full/empty, size() across the wrap, and a
+ * stress run with two std::thread instances standing in for the
+ * FreeRTOS tasks on the two cores.
+ *
+ * RUN: pio test -e native -f test_spsc_queue
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include <thread>
+#include "spsc_queue.h"
+
+// Item larger than a word, so a torn copy would show up
+struct Item {
+    uint32_t sequence;
+    uint32_t check;           // ~sequence
+    uint8_t payload[24];      // sequence & 0xFF in every byte
+};
+
+static Item makeItem(uint32_t sequence) {
+    Item item;
+    item.sequence = sequence;
+    item.check = ~sequence;
+    memset(item.payload, (int)(sequence & 0xFF), sizeof(item.payload));
+    return item;
+}
+
+static bool itemIntact(const Item& item) {
+    if (item.check != ~item.sequence) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(item.payload); i++) {
+        if (item.payload[i] != (uint8_t)(item.sequence & 0xFF)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ---------------------------------------------------------------
+// Single thread
+// ---------------------------------------------------------------
+
+void test_empty_queue_pops_nothing(void) {
+    SpscQueue<int, 4> queue;
+    int value = -1;
+
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    TEST_ASSERT_EQUAL(0, queue.size());
+    TEST_ASSERT_FALSE(queue.pop(value));
+    TEST_ASSERT_EQUAL(-1, value);
+}
+
+void test_fifo_order_and_full(void) {
+    SpscQueue<int, 4> queue;
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(queue.push(i));
+    }
+    TEST_ASSERT_FALSE(queue.push(99));
+    TEST_ASSERT_EQUAL(4, queue.size());
+
+    int value;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+    TEST_ASSERT_FALSE(queue.pop(value));
+}
+
+// head/tail wrap many times; size() must stay right on both sides
+void test_size_across_wraparound(void) {
+    SpscQueue<int, 3> queue;
+    int next = 0;
+    int expected = 0;
+    int value;
+
+    for (int round = 0; round < 20; round++) {
+        TEST_ASSERT_TRUE(queue.push(next++));
+        TEST_ASSERT_TRUE(queue.push(next++));
+        TEST_ASSERT_EQUAL(2, queue.size());
+
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL(expected++, value);
+        TEST_ASSERT_EQUAL(1, queue.size());
+
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL(expected++, value);
+        TEST_ASSERT_TRUE(queue.isEmpty());
+    }
+}
+
+// ---------------------------------------------------------------
+// Two threads
+// ---------------------------------------------------------------
+
+#define STRESS_ITEMS  1000000UL
+
+// Producer and consumer run flat out on their own threads; every
+// item must arrive once, in order and intact. The small queue keeps
+// it full or empty most of the time, where a race would show.
+void test_threads_hand_off_every_item_in_order(void) {
+    static SpscQueue<Item, 8> queue;
+    uint32_t fullRetries = 0;
+
+    std::thread producer([&fullRetries]() {
+        for (uint32_t i = 0; i < STRESS_ITEMS; i++) {
+            Item item = makeItem(i);
+            while (!queue.push(item)) {
+                fullRetries++;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t received = 0;
+    uint32_t outOfOrder = 0;
+    uint32_t torn = 0;
+    Item item;
+
+    while (received < STRESS_ITEMS) {
+        if (!queue.pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item.sequence != received) {
+            outOfOrder++;
+        }
+        if (!itemIntact(item)) {
+            torn++;
+        }
+        received++;
+    }
+
+    producer.join();
+
+    TEST_ASSERT_EQUAL(0, outOfOrder);
+    TEST_ASSERT_EQUAL(0, torn);
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    TEST_ASSERT_FALSE(queue.pop(item));
+
+    char line[96];
+    snprintf(line, sizeof(line), "%lu items, producer found the queue full %lu times",
+             STRESS_ITEMS, (unsigned long)fullRetries);
+    TEST_MESSAGE(line);
+}
+
+// Consumer drains in bursts (like the alarm task waking up once per
+// loop) while the producer keeps pushing; nothing may be lost
+void test_bursty_consumer_loses_nothing(void) {
+    static SpscQueue<uint32_t, 16> queue;
+    const uint32_t count = 200000;
+
+    std::thread producer([count]() {
+        for (uint32_t i = 1; i <= count; i++) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t sum = 0;
+    uint32_t received = 0;
+    uint32_t value;
+
+    while (received < count) {
+        while (queue.pop(value)) {
+            sum += value;
+            received++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    producer.join();
+
+    TEST_ASSERT_EQUAL(count, received);
+    TEST_ASSERT_TRUE(sum == (uint64_t)count * (count + 1) / 2);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_queue_pops_nothing);
+    RUN_TEST(test_fifo_order_and_full);
+    RUN_TEST(test_size_across_wraparound);
+    RUN_TEST(test_threads_hand_off_every_item_in_order);
+    RUN_TEST(test_bursty_consumer_loses_nothing);
+    return UNITY_END();
+}
@@ -0,0 +1,228 @@
+/*
+ * ===============================================================
+ * WakeAssist - Stale Command Filter Tests (host)
+ * ===============================================================
+ *
+ * Replays the backlog a device finds after a night off: more
+ * commands than one getUpdates answer holds, read in answers of
+ * TELEGRAM_UPDATE_SLOTS through UpdateParser (like TelegramBot::
+ * poll()). Checks that old commands are skipped in every answer of
+ * the backlog, fresh ones and /stop run, and the filter is off once
+ * an answer has a free slot. Also without a set clock.
+ *
+ * RUN: pio test -e native -f test_stale_filter
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "memory_stream.h"
+#include "stale_filter.h"
+
+// Morning the device comes back (Unix time, 2023-11-14 22:13:20)
+#define BOOT_TIME   1700000000UL
+#define HOUR        3600UL
+
+struct SentCommand {
+    const char* text;
+    unsigned long date;
+};
+
+static std::vector<SentCommand> sent;    // Waiting at Telegram
+static TelegramUpdateBatch batch;
+static StaleFilter* filter;
+
+void setUp(void) {
+    sent.clear();
+    memset(&batch, 0, sizeof(batch));
+    filter = new StaleFilter();
+}
+
+void tearDown(void) {
+    delete filter;
+    filter = nullptr;
+}
+
+// getUpdates answer for offset (update IDs are index + 1), at most
+// TELEGRAM_UPDATE_SLOTS updates, parsed into 'batch'
+static void fetch(size_t offset) {
+    std::string json = "{\"ok\":true,\"result\":[";
+
+    for (size_t i = offset - 1; i < sent.size() && i < offset - 1 + TELEGRAM_UPDATE_SLOTS; i++) {
+        if (i != offset - 1) {
+            json += ",";
+        }
+        json += "{\"update_id\":" + std::to_string(i + 1) +
+                ",\"message\":{\"message_id\":" + std::to_string(i + 100) +
+                ",\"date\":" + std::to_string(sent[i].date) +
+                ",\"chat\":{\"id\":42},\"text\":\"" + sent[i].text + "\"}}";
+    }
+    json += "]}";
+
+    MemoryStream input(json.c_str());
+    UpdateParser parser(input);
+    TEST_ASSERT_TRUE(parser.parse(batch));
+    TEST_ASSERT_TRUE(batch.ok);
+}
+
+// Read everything waiting, like poll() does until an answer is not
+// full. RETURNS: Commands that would run
+static int drain(unsigned long now, int* answers = nullptr) {
+    size_t offset = 1;
+    int run = 0;
+    int count = 0;
+
+    do {
+        fetch(offset);
+        filter->beginBatch(batch, now);
+        count++;
+
+        for (int i = 0; i < batch.count; i++) {
+            if (!filter->isStale(batch.updates[i])) {
+                run++;
+            }
+            offset = batch.updates[i].updateId + 1;
+        }
+    } while (batch.count == TELEGRAM_UPDATE_SLOTS);
+
+    if (answers != nullptr) {
+        *answers = count;
+    }
+    return run;
+}
+
+// ---------------------------------------------------------------
+// Backlog longer than one answer
+// ---------------------------------------------------------------
+
+// 25 /wake commands through the night: none of them rings, in any
+// of the three answers
+void test_night_backlog_skipped_in_every_answer(void) {
+    for (int i = 0; i < 25; i++) {
+        sent.push_back({"/wake", BOOT_TIME - 8 * HOUR + i * 600});
+    }
+
+    int answers = 0;
+    TEST_ASSERT_EQUAL(0, drain(BOOT_TIME, &answers));
+    TEST_ASSERT_EQUAL(3, answers);
+    TEST_ASSERT_FALSE(filter->isActive());
+}
+
+// The newest commands were sent just now: only they run
+void test_fresh_commands_after_backlog_run(void) {
+    for (int i = 0; i < 23; i++) {
+        sent.push_back({"/wake", BOOT_TIME - 8 * HOUR + i * 600});
+    }
+    sent.push_back({"/status", BOOT_TIME - 30});
+    sent.push_back({"/wake", BOOT_TIME - 5});
+
+    TEST_ASSERT_EQUAL(2, drain(BOOT_TIME));
+}
+
+// Exactly one full answer: the filter waits for the next (empty)
+// answer before it turns off
+void test_full_answer_keeps_filter_on(void) {
+    for (int i = 0; i < TELEGRAM_UPDATE_SLOTS; i++) {
+        sent.push_back({"/wake", BOOT_TIME - HOUR});
+    }
+
+    fetch(1);
+    filter->beginBatch(batch, BOOT_TIME);
+    TEST_ASSERT_TRUE(filter->isActive());
+
+    fetch(TELEGRAM_UPDATE_SLOTS + 1);
+    TEST_ASSERT_EQUAL(0, batch.count);
+    filter->beginBatch(batch, BOOT_TIME);
+    TEST_ASSERT_FALSE(filter->isActive());
+}
+
+// /stop is never too late, in any answer of the backlog
+void test_stop_is_never_stale(void) {
+    for (int i = 0; i < 15; i++) {
+        sent.push_back({i == 12 ? "/STOP now" : "/wake", BOOT_TIME - 2 * HOUR});
+    }
+
+    TEST_ASSERT_EQUAL(1, drain(BOOT_TIME));
+}
+
+// ---------------------------------------------------------------
+// After the backlog
+// ---------------------------------------------------------------
+
+// A command that waited out a 429 or breaker back-off was sent while
+// the device was running: it runs, however old
+void test_late_answer_after_backlog_runs(void) {
+    sent.push_back({"/wake", BOOT_TIME - HOUR});
+    TEST_ASSERT_EQUAL(0, drain(BOOT_TIME));
+
+    sent.clear();
+    sent.push_back({"/wake", BOOT_TIME + 10});
+    fetch(1);
+    filter->beginBatch(batch, BOOT_TIME + 10 * HOUR);
+
+    TEST_ASSERT_EQUAL(0, filter->getStaleBefore());
+    TEST_ASSERT_FALSE(filter->isStale(batch.updates[0]));
+}
+
+// An error answer (429 before the backlog was read) keeps the filter on
+void test_error_answer_keeps_filter_on(void) {
+    const char* json = "{\"ok\":false,\"error_code\":429,"
+                       "\"description\":\"Too Many Requests\","
+                       "\"parameters\":{\"retry_after\":5}}";
+    MemoryStream input(json);
+    UpdateParser parser(input);
+    TEST_ASSERT_TRUE(parser.parse(batch));
+
+    filter->beginBatch(batch, BOOT_TIME);
+    TEST_ASSERT_TRUE(filter->isActive());
+}
+
+// ---------------------------------------------------------------
+// No clock (NTP not answered yet)
+// ---------------------------------------------------------------
+
+// "Now" is the newest message seen so far and moves forward with
+// every answer of the backlog
+void test_without_clock_newest_message_is_now(void) {
+    for (int i = 0; i < 12; i++) {
+        sent.push_back({"/wake", BOOT_TIME - 8 * HOUR + i * 600});
+    }
+    sent.push_back({"/wake", BOOT_TIME});
+
+    fetch(1);
+    filter->beginBatch(batch, 0);
+    TEST_ASSERT_EQUAL(sent[9].date - TELEGRAM_STALE_COMMAND_S, filter->getStaleBefore());
+
+    fetch(11);
+    filter->beginBatch(batch, 0);
+    TEST_ASSERT_EQUAL(BOOT_TIME - TELEGRAM_STALE_COMMAND_S, filter->getStaleBefore());
+    TEST_ASSERT_TRUE(filter->isStale(batch.updates[0]));
+    TEST_ASSERT_TRUE(filter->isStale(batch.updates[1]));
+    TEST_ASSERT_FALSE(filter->isStale(batch.updates[2]));
+}
+
+// ---------------------------------------------------------------
+// Command matching
+// ---------------------------------------------------------------
+
+void test_command_matches_whole_word(void) {
+    TEST_ASSERT_TRUE(StaleFilter::commandMatches("/stop", "/stop"));
+    TEST_ASSERT_TRUE(StaleFilter::commandMatches("/Stop now", "/stop"));
+    TEST_ASSERT_FALSE(StaleFilter::commandMatches("/stopwatch", "/stop"));
+    TEST_ASSERT_FALSE(StaleFilter::commandMatches("/sto", "/stop"));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_night_backlog_skipped_in_every_answer);
+    RUN_TEST(test_fresh_commands_after_backlog_run);
+    RUN_TEST(test_full_answer_keeps_filter_on);
+    RUN_TEST(test_stop_is_never_stale);
+    RUN_TEST(test_late_answer_after_backlog_runs);
+    RUN_TEST(test_error_answer_keeps_filter_on);
+    RUN_TEST(test_without_clock_newest_message_is_now);
+    RUN_TEST(test_command_matches_whole_word);
+    return UNITY_END();
+}
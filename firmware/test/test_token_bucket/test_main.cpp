@@ -0,0 +1,128 @@
+/*
+ * ===============================================================
+ * WakeAssist - Token Bucket Tests (host)
+ * ===============================================================
+ *
+ * Runs the Telegram send limiter with made-up times: the first
+ * burst, one token per refill interval, getWaitMs(), the cap after
+ * a long idle time, and millis() overflow.
+ *
+ * RUN: pio test -e native -f test_token_bucket
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include "config.h"
+#include "token_bucket.h"
+
+#define BURST      TELEGRAM_SEND_BURST
+#define REFILL_MS  TELEGRAM_SEND_REFILL_MS
+
+static TokenBucket bucket;
+
+void setUp(void) {
+    bucket = TokenBucket();
+    bucket.configure(BURST, REFILL_MS);
+}
+
+void tearDown(void) {}
+
+// Empty the bucket at 'now'
+static void drain(unsigned long now) {
+    for (int i = 0; i < BURST; i++) {
+        TEST_ASSERT_TRUE(bucket.tryTake(now));
+    }
+}
+
+// ---------------------------------------------------------------
+// Burst and refill
+// ---------------------------------------------------------------
+
+void test_burst_goes_out_at_once(void) {
+    TEST_ASSERT_EQUAL(BURST, bucket.getTokens(1000));
+    TEST_ASSERT_EQUAL(0, bucket.getWaitMs(1000));
+
+    drain(1000);
+
+    TEST_ASSERT_FALSE(bucket.tryTake(1000));
+    TEST_ASSERT_EQUAL(BURST, bucket.getTakenCount());
+    TEST_ASSERT_EQUAL(1, bucket.getDeniedCount());
+}
+
+void test_wait_counts_down_to_next_token(void) {
+    drain(1000);
+
+    TEST_ASSERT_EQUAL(REFILL_MS, bucket.getWaitMs(1000));
+    TEST_ASSERT_EQUAL(REFILL_MS - 400, bucket.getWaitMs(1400));
+    TEST_ASSERT_EQUAL(1, bucket.getWaitMs(1000 + REFILL_MS - 1));
+    TEST_ASSERT_FALSE(bucket.tryTake(1000 + REFILL_MS - 1));
+
+    TEST_ASSERT_EQUAL(0, bucket.getWaitMs(1000 + REFILL_MS));
+    TEST_ASSERT_TRUE(bucket.tryTake(1000 + REFILL_MS));
+    TEST_ASSERT_EQUAL(REFILL_MS, bucket.getWaitMs(1000 + REFILL_MS));
+}
+
+// A take in the middle of an interval must not reset the clock
+// of the token that is still on its way
+void test_refill_keeps_partial_interval(void) {
+    drain(1000);
+
+    // Two tokens came back by 1000 + 2.5 intervals, half of the
+    // third interval already passed
+    unsigned long now = 1000 + REFILL_MS * 5 / 2;
+    TEST_ASSERT_EQUAL(2, bucket.getTokens(now));
+    TEST_ASSERT_TRUE(bucket.tryTake(now));
+    TEST_ASSERT_TRUE(bucket.tryTake(now));
+    TEST_ASSERT_FALSE(bucket.tryTake(now));
+
+    TEST_ASSERT_EQUAL(REFILL_MS / 2, bucket.getWaitMs(now));
+    TEST_ASSERT_TRUE(bucket.tryTake(1000 + REFILL_MS * 3));
+}
+
+void test_steady_rate_after_burst(void) {
+    drain(0);
+
+    // One message per interval for a minute: never refused
+    unsigned long now = 0;
+    for (int i = 0; i < 60; i++) {
+        now += REFILL_MS;
+        TEST_ASSERT_TRUE(bucket.tryTake(now));
+        TEST_ASSERT_FALSE(bucket.tryTake(now));
+    }
+    TEST_ASSERT_EQUAL(BURST + 60, bucket.getTakenCount());
+    TEST_ASSERT_EQUAL(60, bucket.getDeniedCount());
+}
+
+// ---------------------------------------------------------------
+// Limits
+// ---------------------------------------------------------------
+
+void test_idle_bucket_never_exceeds_capacity(void) {
+    drain(1000);
+
+    TEST_ASSERT_EQUAL(BURST, bucket.getTokens(1000 + REFILL_MS * 100));
+    drain(1000 + REFILL_MS * 100);
+    TEST_ASSERT_FALSE(bucket.tryTake(1000 + REFILL_MS * 100));
+}
+
+// millis() wraps after ~49 days: the wait must still end on time
+void test_refill_across_millis_overflow(void) {
+    unsigned long now = (unsigned long)-(REFILL_MS / 2);
+    drain(now);
+
+    TEST_ASSERT_EQUAL(REFILL_MS, bucket.getWaitMs(now));
+    TEST_ASSERT_FALSE(bucket.tryTake(now + REFILL_MS - 1));
+    TEST_ASSERT_TRUE(bucket.tryTake(now + REFILL_MS));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_burst_goes_out_at_once);
+    RUN_TEST(test_wait_counts_down_to_next_token);
+    RUN_TEST(test_refill_keeps_partial_interval);
+    RUN_TEST(test_steady_rate_after_burst);
+    RUN_TEST(test_idle_bucket_never_exceeds_capacity);
+    RUN_TEST(test_refill_across_millis_overflow);
+    return UNITY_END();
+}
@@ -0,0 +1,256 @@
+/*
+ * ===============================================================
+ * WakeAssist - Telegram Transport Tests (host, needs the mock)
+ * ===============================================================
+ *
+ * Runs the bot's request path (BotTransport) against
+ * tools/mock_telegram_api.py over plain HTTP: every Bot API method
+ * the firmware uses, a long poll answered as soon as a command
+ * arrives, keep-alive reuse, the injected faults (latency, dropped
+ * connection, 429, malformed body) and the limits of the request
+ * head.
+ *
+ * RUN:
+ *   python3 tools/mock_telegram_api.py --port 8081 &
+ *   pio test -e native -f test_transport
+ *
+ * Without the mock every test here is reported as ignored.
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include <thread>
+#include "mock_api.h"
+
+static PosixClient* client;
+static BotTransport* transport;
+static TelegramUpdateBatch batch;
+static char body[2048];
+
+void setUp(void) {
+    if (!mockRunning()) {
+        TEST_IGNORE_MESSAGE("mock not running (python3 tools/mock_telegram_api.py)");
+    }
+
+    mockControl("reset", "{}");
+    client = new PosixClient();
+    transport = new BotTransport(hostRandom);
+    connectToMock(*transport, *client);
+    memset(&batch, 0, sizeof(batch));
+    body[0] = '\0';
+}
+
+// getMe, answer body into 'body'
+static bool getMe() {
+    return transport->request("GET", "getMe", "", "", bodyReader(body, sizeof(body)), 0);
+}
+
+void tearDown(void) {
+    delete transport;
+    delete client;
+    transport = nullptr;
+    client = nullptr;
+}
+
+// ---------------------------------------------------------------
+// Bot API methods
+// ---------------------------------------------------------------
+
+void test_get_me(void) {
+    TEST_ASSERT_TRUE(getMe());
+    TEST_ASSERT_EQUAL(200, transport->getLastStatusCode());
+    TEST_ASSERT_TRUE(strstr(body, "\"is_bot\": true") != nullptr);
+}
+
+void test_send_and_edit_message(void) {
+    TEST_ASSERT_TRUE(transport->request("POST", "sendMessage", "",
+                                        "{\"chat_id\":42,\"text\":\"Alarm started\"}",
+                                        bodyReader(body, sizeof(body)), 0));
+    TEST_ASSERT_TRUE(strstr(body, "\"message_id\": 1") != nullptr);
+
+    TEST_ASSERT_TRUE(transport->request("POST", "editMessageText", "",
+                                        "{\"chat_id\":42,\"message_id\":1,\"text\":\"Stopped\"}",
+                                        bodyReader(body, sizeof(body)), 0));
+    TEST_ASSERT_TRUE(transport->request("POST", "answerCallbackQuery", "",
+                                        "{\"callback_query_id\":\"900001\"}",
+                                        bodyReader(body, sizeof(body)), 0));
+
+    TEST_ASSERT_TRUE(mockControl("sent", "", body, sizeof(body)));
+    TEST_ASSERT_TRUE(strstr(body, "Alarm started") != nullptr);
+    TEST_ASSERT_TRUE(strstr(body, "Stopped") != nullptr);
+    TEST_ASSERT_TRUE(strstr(body, "900001") != nullptr);
+}
+
+void test_get_updates_message_and_button(void) {
+    mockControl("update", "{\"text\":\"/wake\"}");
+    mockControl("update", "{\"callback_data\":\"STOP\",\"message_id\":7}");
+
+    TEST_ASSERT_TRUE(getUpdates(*transport, "timeout=0", batch));
+    TEST_ASSERT_TRUE(batch.ok);
+    TEST_ASSERT_EQUAL(2, batch.count);
+    TEST_ASSERT_EQUAL(UPDATE_MESSAGE, batch.updates[0].kind);
+    TEST_ASSERT_EQUAL_STRING("/wake", batch.updates[0].text);
+    TEST_ASSERT_EQUAL(UPDATE_CALLBACK_QUERY, batch.updates[1].kind);
+    TEST_ASSERT_EQUAL_STRING("STOP", batch.updates[1].text);
+    TEST_ASSERT_EQUAL(7, batch.updates[1].messageId);
+
+    // The offset confirms them
+    TEST_ASSERT_TRUE(getUpdates(*transport, "offset=3&timeout=0", batch));
+    TEST_ASSERT_EQUAL(0, batch.count);
+}
+
+// A command sent during the long poll comes back at once, not when
+// the poll times out
+void test_long_poll_answers_when_command_arrives(void) {
+    std::thread user([]() {
+        delay(300);
+        mockControl("update", "{\"text\":\"/stop\"}");
+    });
+
+    unsigned long start = millis();
+    bool ok = getUpdates(*transport, "timeout=10", batch, 10000);
+    unsigned long elapsed = millis() - start;
+    user.join();
+
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL(1, batch.count);
+    TEST_ASSERT_EQUAL_STRING("/stop", batch.updates[0].text);
+    TEST_ASSERT_GREATER_OR_EQUAL(300, elapsed);
+    TEST_ASSERT_LESS_OR_EQUAL(1000, elapsed);
+}
+
+void test_long_poll_times_out_empty(void) {
+    unsigned long start = millis();
+    TEST_ASSERT_TRUE(getUpdates(*transport, "timeout=1", batch, 1000));
+    TEST_ASSERT_EQUAL(0, batch.count);
+    TEST_ASSERT_UINT32_WITHIN(500, 1000, millis() - start);
+}
+
+void test_keep_alive_reuses_connection(void) {
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(getMe());
+    }
+
+    TEST_ASSERT_EQUAL(1, client->getConnectCount());
+    TEST_ASSERT_EQUAL(2, transport->getReusedCount());
+}
+
+// ---------------------------------------------------------------
+// Injected faults
+// ---------------------------------------------------------------
+
+void test_latency(void) {
+    mockControl("inject", "{\"fault\":\"latency\",\"ms\":400}");
+
+    unsigned long start = millis();
+    TEST_ASSERT_TRUE(getMe());
+    TEST_ASSERT_GREATER_OR_EQUAL(400, millis() - start);
+}
+
+void test_429_carries_retry_after(void) {
+    mockControl("inject", "{\"fault\":\"429\",\"method\":\"getUpdates\",\"retry_after\":3}");
+
+    // A complete answer: the transport worked, the API said no
+    TEST_ASSERT_TRUE(getUpdates(*transport, "timeout=0", batch));
+    TEST_ASSERT_EQUAL(429, transport->getLastStatusCode());
+    TEST_ASSERT_FALSE(batch.ok);
+    TEST_ASSERT_EQUAL(429, batch.errorCode);
+    TEST_ASSERT_EQUAL(3, batch.retryAfter);
+    TEST_ASSERT_EQUAL(CIRCUIT_CLOSED, transport->getBreaker().getState());
+}
+
+void test_malformed_body_fails_request(void) {
+    mockControl("inject", "{\"fault\":\"malformed\",\"method\":\"getUpdates\"}");
+
+    TEST_ASSERT_FALSE(getUpdates(*transport, "timeout=0", batch));
+    TEST_ASSERT_EQUAL(1, transport->getBreaker().getConsecutiveFailures());
+
+    // The next answer is fine again
+    TEST_ASSERT_TRUE(getUpdates(*transport, "timeout=0", batch));
+    TEST_ASSERT_EQUAL(0, transport->getBreaker().getConsecutiveFailures());
+}
+
+// Dropped connections open the breaker, which then fails fast
+// without reaching the server
+void test_drops_open_the_breaker(void) {
+    mockControl("inject", "{\"fault\":\"drop\",\"method\":\"getMe\",\"count\":3}");
+
+    for (int i = 0; i < TELEGRAM_BREAKER_FAILURES; i++) {
+        TEST_ASSERT_FALSE(getMe());
+    }
+    TEST_ASSERT_EQUAL(CIRCUIT_OPEN, transport->getBreaker().getState());
+
+    uint32_t connects = client->getConnectCount();
+    TEST_ASSERT_FALSE(getMe());
+    TEST_ASSERT_EQUAL(connects, client->getConnectCount());
+    TEST_ASSERT_EQUAL(1, transport->getBreaker().getFastFailCount());
+}
+
+// A kept-alive connection the server closed while idle is retried
+// once on a new one (nothing was processed)
+void test_dead_kept_alive_connection_is_retried(void) {
+    TEST_ASSERT_TRUE(getMe());
+
+    mockControl("inject", "{\"fault\":\"drop\",\"method\":\"getMe\"}");
+    TEST_ASSERT_TRUE(getMe());
+    TEST_ASSERT_EQUAL(2, client->getConnectCount());
+}
+
+// A request line that does not fit TELEGRAM_REQUEST_HEAD_BYTES is
+// never sent, and a server name or token that does not fit is refused
+void test_oversized_request_is_not_sent(void) {
+    char params[TELEGRAM_REQUEST_HEAD_BYTES + 1];
+    memset(params, 'x', sizeof(params) - 1);
+    params[sizeof(params) - 1] = '\0';
+
+    TEST_ASSERT_FALSE(transport->request("GET", "getUpdates", params, "",
+                                         bodyReader(body, sizeof(body)), 0));
+    TEST_ASSERT_EQUAL(0, client->getConnectCount());
+
+    char name[TELEGRAM_API_HOST_MAX_BYTES + 1];
+    memset(name, 'a', sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    TEST_ASSERT_FALSE(transport->setServer(*client, name, 443, true));
+    TEST_ASSERT_FALSE(transport->setToken(name));
+
+    // Still talks to the mock with the old settings
+    TEST_ASSERT_TRUE(getMe());
+}
+
+// Any other request on a transport that holds a long poll drops it:
+// the held answer would otherwise be read as this request's
+void test_request_drops_held_long_poll(void) {
+    transport->onLongPollInterrupt([]() {
+        return true;
+    });
+
+    TEST_ASSERT_FALSE(getUpdates(*transport, "timeout=10", batch, 10000));
+    TEST_ASSERT_TRUE(transport->isHolding());
+
+    TEST_ASSERT_TRUE(getMe());
+    TEST_ASSERT_FALSE(transport->isHolding());
+    TEST_ASSERT_TRUE(strstr(body, "\"is_bot\": true") != nullptr);
+    TEST_ASSERT_EQUAL(2, client->getConnectCount());
+
+    // Nothing held any more
+    TEST_ASSERT_FALSE(transport->resume(updatesReader(batch)));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_get_me);
+    RUN_TEST(test_send_and_edit_message);
+    RUN_TEST(test_get_updates_message_and_button);
+    RUN_TEST(test_long_poll_answers_when_command_arrives);
+    RUN_TEST(test_long_poll_times_out_empty);
+    RUN_TEST(test_keep_alive_reuses_connection);
+    RUN_TEST(test_latency);
+    RUN_TEST(test_429_carries_retry_after);
+    RUN_TEST(test_malformed_body_fails_request);
+    RUN_TEST(test_drops_open_the_breaker);
+    RUN_TEST(test_dead_kept_alive_connection_is_retried);
+    RUN_TEST(test_oversized_request_is_not_sent);
+    RUN_TEST(test_request_drops_held_long_poll);
+    return UNITY_END();
+}
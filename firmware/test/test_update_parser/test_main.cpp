@@ -0,0 +1,237 @@
+/*
+ * ===============================================================
+ * WakeAssist - Update Parser Tests (host)
+ * ===============================================================
+ *
+ * Feeds UpdateParser getUpdates answers from memory: a normal batch,
+ * a button press, text that doesn't fit its slot, emoji sent as
+ * surrogate pairs, a 429 answer with retry_after, more updates than
+ * slots, and bodies that aren't valid JSON.
+ *
+ * RUN: pio test -e native -f test_update_parser
+ *
+ * ===============================================================
+ */
+
+#include <unity.h>
+#include <string>
+#include "memory_stream.h"
+#include "update_parser.h"
+
+static TelegramUpdateBatch batch;
+
+void setUp(void) {
+    memset(&batch, 0, sizeof(batch));
+}
+
+void tearDown(void) {}
+
+static bool parse(const char* json) {
+    MemoryStream input(json);
+    UpdateParser parser(input);
+    return parser.parse(batch);
+}
+
+// getUpdates answer with one message update
+static std::string messageAnswer(const std::string& text) {
+    return "{\"ok\":true,\"result\":[{\"update_id\":5,\"message\":{"
+           "\"message_id\":9,\"date\":1700000000,\"chat\":{\"id\":42},"
+           "\"text\":\"" + text + "\"}}]}";
+}
+
+// ---------------------------------------------------------------
+// Normal answers
+// ---------------------------------------------------------------
+
+void test_message_fields(void) {
+    TEST_ASSERT_TRUE(parse(
+        "{\"ok\":true,\"result\":[{\"update_id\":123,\"message\":{"
+        "\"message_id\":1,\"from\":{\"id\":42,\"is_bot\":false,\"username\":\"me\"},"
+        "\"chat\":{\"id\":-100123456789,\"type\":\"private\"},"
+        "\"date\":1700000000,\"text\":\"/wake\","
+        "\"entities\":[{\"offset\":0,\"length\":5,\"type\":\"bot_command\"}]}}]}"));
+
+    TEST_ASSERT_TRUE(batch.ok);
+    TEST_ASSERT_EQUAL(1, batch.count);
+    TEST_ASSERT_FALSE(batch.overflow);
+
+    const TelegramUpdate& update = batch.updates[0];
+    TEST_ASSERT_EQUAL(123, update.updateId);
+    TEST_ASSERT_EQUAL(UPDATE_MESSAGE, update.kind);
+    TEST_ASSERT_TRUE(update.chatId == -100123456789LL);
+    TEST_ASSERT_EQUAL(1, update.messageId);
+    TEST_ASSERT_EQUAL(1700000000UL, update.date);
+    TEST_ASSERT_EQUAL_STRING("/wake", update.text);
+    TEST_ASSERT_EQUAL_STRING("me", update.username);
+    TEST_ASSERT_FALSE(update.truncated);
+}
+
+void test_callback_query_fields(void) {
+    TEST_ASSERT_TRUE(parse(
+        "{\"ok\":true,\"result\":[{\"update_id\":124,\"callback_query\":{"
+        "\"id\":\"9876\",\"from\":{\"id\":42,\"username\":\"me\"},"
+        "\"message\":{\"message_id\":7,\"chat\":{\"id\":42},\"text\":\"Alarm\"},"
+        "\"chat_instance\":\"-1\",\"data\":\"STOP\"}}]}"));
+
+    TEST_ASSERT_EQUAL(1, batch.count);
+
+    const TelegramUpdate& update = batch.updates[0];
+    TEST_ASSERT_EQUAL(UPDATE_CALLBACK_QUERY, update.kind);
+    TEST_ASSERT_EQUAL_STRING("9876", update.callbackId);
+    TEST_ASSERT_EQUAL_STRING("STOP", update.text);
+    TEST_ASSERT_TRUE(update.chatId == 42);
+    TEST_ASSERT_EQUAL(7, update.messageId);
+}
+
+void test_empty_result_and_unknown_updates(void) {
+    TEST_ASSERT_TRUE(parse("{\"ok\":true,\"result\":[]}"));
+    TEST_ASSERT_TRUE(batch.ok);
+    TEST_ASSERT_EQUAL(0, batch.count);
+
+    // An edit is kept (it must be acknowledged), one without an ID isn't
+    TEST_ASSERT_TRUE(parse(
+        "{\"ok\":true,\"result\":["
+        "{\"update_id\":7,\"edited_message\":{\"text\":\"x\",\"photo\":[{},{}]}},"
+        "{\"message\":{\"text\":\"/wake\"}}]}"));
+    TEST_ASSERT_EQUAL(1, batch.count);
+    TEST_ASSERT_EQUAL(7, batch.updates[0].updateId);
+    TEST_ASSERT_EQUAL(UPDATE_OTHER, batch.updates[0].kind);
+}
+
+// ---------------------------------------------------------------
+// Text that doesn't fit
+// ---------------------------------------------------------------
+
+void test_long_text_is_truncated(void) {
+    std::string json = messageAnswer(std::string(TELEGRAM_TEXT_MAX_BYTES + 50, 'a'));
+    TEST_ASSERT_TRUE(parse(json.c_str()));
+
+    const TelegramUpdate& update = batch.updates[0];
+    TEST_ASSERT_TRUE(update.truncated);
+    TEST_ASSERT_EQUAL(TELEGRAM_TEXT_MAX_BYTES - 1, strlen(update.text));
+
+    // Fields after the long text are still read
+    TEST_ASSERT_EQUAL(9, update.messageId);
+    TEST_ASSERT_TRUE(update.chatId == 42);
+}
+
+void test_text_that_just_fits_is_not_truncated(void) {
+    std::string json = messageAnswer(std::string(TELEGRAM_TEXT_MAX_BYTES - 1, 'a'));
+    TEST_ASSERT_TRUE(parse(json.c_str()));
+    TEST_ASSERT_FALSE(batch.updates[0].truncated);
+    TEST_ASSERT_EQUAL(TELEGRAM_TEXT_MAX_BYTES - 1, strlen(batch.updates[0].text));
+}
+
+// The cut must not leave half a UTF-8 character behind
+void test_truncation_keeps_whole_characters(void) {
+    // Raw UTF-8: "é" is 2 bytes, only its first byte would fit
+    std::string raw = messageAnswer(std::string(TELEGRAM_TEXT_MAX_BYTES - 2, 'a') + "\xC3\xA9");
+    TEST_ASSERT_TRUE(parse(raw.c_str()));
+    TEST_ASSERT_TRUE(batch.updates[0].truncated);
+    TEST_ASSERT_EQUAL(TELEGRAM_TEXT_MAX_BYTES - 2, strlen(batch.updates[0].text));
+
+    // Escaped emoji: 4 bytes, only 2 would fit
+    std::string escaped = messageAnswer(std::string(TELEGRAM_TEXT_MAX_BYTES - 3, 'a') +
+                                        "\\ud83d\\ude00");
+    TEST_ASSERT_TRUE(parse(escaped.c_str()));
+    TEST_ASSERT_TRUE(batch.updates[0].truncated);
+    TEST_ASSERT_EQUAL(TELEGRAM_TEXT_MAX_BYTES - 3, strlen(batch.updates[0].text));
+}
+
+// ---------------------------------------------------------------
+// Escapes
+// ---------------------------------------------------------------
+
+void test_surrogate_pair_becomes_utf8(void) {
+    // U+1F600 (grinning face) = F0 9F 98 80
+    std::string json = messageAnswer("hi \\ud83d\\ude00!");
+    TEST_ASSERT_TRUE(parse(json.c_str()));
+    TEST_ASSERT_EQUAL_STRING("hi \xF0\x9F\x98\x80!", batch.updates[0].text);
+}
+
+void test_lone_surrogates_become_replacement_char(void) {
+    // High surrogate without a low one, then a low one on its own
+    std::string json = messageAnswer("a\\ud83db\\ude00c");
+    TEST_ASSERT_TRUE(parse(json.c_str()));
+    TEST_ASSERT_EQUAL_STRING("a\xEF\xBF\xBD" "b\xEF\xBF\xBD" "c", batch.updates[0].text);
+}
+
+void test_simple_escapes(void) {
+    std::string json = messageAnswer("\\\"q\\\" \\\\ \\/ \\n\\t \\u00e9");
+    TEST_ASSERT_TRUE(parse(json.c_str()));
+    TEST_ASSERT_EQUAL_STRING("\"q\" \\ / \n\t \xC3\xA9", batch.updates[0].text);
+}
+
+// ---------------------------------------------------------------
+// Errors
+// ---------------------------------------------------------------
+
+void test_429_retry_after(void) {
+    TEST_ASSERT_TRUE(parse(
+        "{\"ok\":false,\"error_code\":429,"
+        "\"description\":\"Too Many Requests: retry after 7\","
+        "\"parameters\":{\"retry_after\":7}}"));
+
+    TEST_ASSERT_FALSE(batch.ok);
+    TEST_ASSERT_EQUAL(429, batch.errorCode);
+    TEST_ASSERT_EQUAL(7, batch.retryAfter);
+    TEST_ASSERT_EQUAL_STRING("Too Many Requests: retry after 7", batch.description);
+    TEST_ASSERT_EQUAL(0, batch.count);
+}
+
+void test_parameters_without_retry_after(void) {
+    TEST_ASSERT_TRUE(parse(
+        "{\"ok\":false,\"error_code\":400,\"description\":\"Bad Request\","
+        "\"parameters\":{\"migrate_to_chat_id\":-1001}}"));
+    TEST_ASSERT_EQUAL(400, batch.errorCode);
+    TEST_ASSERT_EQUAL(0, batch.retryAfter);
+}
+
+void test_more_updates_than_slots(void) {
+    std::string json = "{\"ok\":true,\"result\":[";
+    for (int i = 1; i <= TELEGRAM_UPDATE_SLOTS + 2; i++) {
+        if (i > 1) {
+            json += ",";
+        }
+        json += "{\"update_id\":" + std::to_string(i) +
+                ",\"message\":{\"text\":\"/status\",\"chat\":{\"id\":42}}}";
+    }
+    json += "]}";
+
+    TEST_ASSERT_TRUE(parse(json.c_str()));
+    TEST_ASSERT_TRUE(batch.overflow);
+    TEST_ASSERT_EQUAL(TELEGRAM_UPDATE_SLOTS, batch.count);
+    TEST_ASSERT_EQUAL(TELEGRAM_UPDATE_SLOTS, batch.updates[TELEGRAM_UPDATE_SLOTS - 1].updateId);
+}
+
+void test_malformed_bodies_fail(void) {
+    // Cut off in the middle of a string (connection dropped)
+    TEST_ASSERT_FALSE(parse("{\"ok\":true,\"result\":[{\"update_id\":1,\"message\":{\"text\":\"/wa"));
+
+    // A proxy's error page instead of JSON
+    TEST_ASSERT_FALSE(parse("<html><body>502 Bad Gateway</body></html>"));
+
+    // Nothing at all
+    TEST_ASSERT_FALSE(parse(""));
+
+    // Bad escape
+    TEST_ASSERT_FALSE(parse("{\"ok\":true,\"description\":\"\\x\"}"));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_message_fields);
+    RUN_TEST(test_callback_query_fields);
+    RUN_TEST(test_empty_result_and_unknown_updates);
+    RUN_TEST(test_long_text_is_truncated);
+    RUN_TEST(test_text_that_just_fits_is_not_truncated);
+    RUN_TEST(test_truncation_keeps_whole_characters);
+    RUN_TEST(test_surrogate_pair_becomes_utf8);
+    RUN_TEST(test_lone_surrogates_become_replacement_char);
+    RUN_TEST(test_simple_escapes);
+    RUN_TEST(test_429_retry_after);
+    RUN_TEST(test_parameters_without_retry_after);
+    RUN_TEST(test_more_updates_than_slots);
+    RUN_TEST(test_malformed_bodies_fail);
+    return UNITY_END();
+}
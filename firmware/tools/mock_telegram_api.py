@@ -0,0 +1,459 @@
+#!/usr/bin/env python3
+"""
+===============================================================
+WakeAssist - Mock Telegram Bot API Server
+===============================================================
+
+A local stand-in for api.telegram.org, so TelegramBot (and the host
+tests in test/test_transport) can run without the real server or
+any internet access.
+
+BOT API METHODS (at /bot<token>/<method>, GET query or POST JSON):
+- getMe
+- getUpdates           offset, limit, timeout (real long poll)
+- sendMessage          chat_id, text, reply_markup
+- editMessageText      chat_id, message_id, text, reply_markup
+- answerCallbackQuery  callback_query_id, text
+
+FAULT INJECTION (from the command line, or per request via /mock/inject):
+- latency    answer after a delay
+- drop       close the connection without an answer
+- 429        "Too Many Requests" with parameters.retry_after
+- malformed  200 OK with a body that is not valid JSON
+
+CONTROL ENDPOINTS (for test scripts, JSON in and out):
+- POST /mock/update   {"text": "/wake"} or {"callback_data": "STOP"}
+                      queues an update from the user
+- POST /mock/inject   {"fault": "429", "method": "sendMessage",
+                       "count": 1, "retry_after": 3, "ms": 500}
+- GET  /mock/sent     messages, edits and callback answers so far
+- GET  /mock/stats    connections and requests per method
+- POST /mock/reset    forget updates, messages, faults and stats
+
+RECORD / REPLAY:
+  --record FILE           write every Bot API exchange as one JSON line
+  --upstream URL          forward to a real server (and record it)
+  --replay FILE           answer each method with its next recorded
+                          answer, in order (falls back to the mock
+                          once a method's recording runs out)
+
+EXAMPLES:
+  python3 tools/mock_telegram_api.py --port 8081
+  python3 tools/mock_telegram_api.py --latency-ms 300 --drop-rate 0.1
+  python3 tools/mock_telegram_api.py --upstream https://api.telegram.org \\
+                                     --record session.jsonl
+  python3 tools/mock_telegram_api.py --replay session.jsonl
+
+Point the firmware at it with TELEGRAM_API_HOST / TELEGRAM_API_PORT
+and TELEGRAM_API_TLS false in config.h, or setApiServer() at runtime.
+
+Only the Python standard library is used.
+
+===============================================================
+"""
+
+import argparse
+import collections
+import json
+import random
+import sys
+import threading
+import time
+import urllib.error
+import urllib.parse
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+FAULTS = ("latency", "drop", "429", "malformed")
+
+# Longest long poll we hold open (Telegram allows up to 50 s)
+MAX_LONG_POLL_S = 50
+
+# Body sent for the "malformed" fault: cut off in the middle
+MALFORMED_BODY = b'{"ok":true,"result":[{"update_id":'
+
+
+# ===============================================================
+# SERVER STATE
+# ===============================================================
+
+class MockState:
+    """Everything the bot can see or change, behind one lock."""
+
+    def __init__(self, args):
+        self.args = args
+        self.lock = threading.Condition()
+        self.random = random.Random(args.seed)
+        self.reset()
+
+        self.recordFile = open(args.record, "a", encoding="utf-8") if args.record else None
+        self.replay = collections.defaultdict(collections.deque)
+        if args.replay:
+            self.loadReplay(args.replay)
+
+    def reset(self):
+        with self.lock:
+            self.updates = []              # Not confirmed yet (offset)
+            self.nextUpdateId = 1
+            self.nextMessageId = 1
+            self.sent = []                 # sendMessage / edits / answers
+            self.faults = []               # Injected by /mock/inject
+            self.connections = 0
+            self.requests = collections.Counter()
+            self.lock.notify_all()
+
+    # ---------------------------------------------------------------
+    # Updates from the "user"
+    # ---------------------------------------------------------------
+
+    def addUpdate(self, spec):
+        chatId = int(spec.get("chat_id", self.args.chat_id))
+        sender = {"id": chatId, "is_bot": False, "first_name": "Mock",
+                  "username": spec.get("username", "mock_user")}
+
+        with self.lock:
+            update = {"update_id": self.nextUpdateId}
+            self.nextUpdateId += 1
+
+            if "callback_data" in spec:
+                update["callback_query"] = {
+                    "id": str(900000 + update["update_id"]),
+                    "from": sender,
+                    "message": {"message_id": int(spec.get("message_id", 1)),
+                                "chat": {"id": chatId, "type": "private"}},
+                    "chat_instance": "1",
+                    "data": spec["callback_data"],
+                }
+            else:
+                update["message"] = {
+                    "message_id": self.nextMessageId,
+                    "from": sender,
+                    "chat": {"id": chatId, "type": "private"},
+                    "date": int(spec.get("date", time.time())),
+                    "text": spec.get("text", ""),
+                }
+                self.nextMessageId += 1
+
+            self.updates.append(update)
+            self.lock.notify_all()
+            return update["update_id"]
+
+    def waitForUpdates(self, offset, limit, timeoutS):
+        deadline = time.monotonic() + min(timeoutS, MAX_LONG_POLL_S)
+
+        with self.lock:
+            # getUpdates with an offset confirms everything before it
+            if offset:
+                self.updates = [u for u in self.updates if u["update_id"] >= offset]
+
+            while not self.updates:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    break
+                self.lock.wait(remaining)
+
+            return self.updates[:limit]
+
+    # ---------------------------------------------------------------
+    # Faults
+    # ---------------------------------------------------------------
+
+    def takeFault(self, method):
+        """Next fault for this request: injected ones first, then the
+        random rates from the command line. None = answer normally."""
+        with self.lock:
+            for fault in self.faults:
+                if fault.get("method") in (None, method):
+                    fault["count"] -= 1
+                    if fault["count"] <= 0:
+                        self.faults.remove(fault)
+                    return dict(fault)
+
+            args = self.args
+            roll = self.random.random()
+            for kind, rate in (("drop", args.drop_rate), ("429", args.rate_limit_rate),
+                               ("malformed", args.malformed_rate)):
+                if roll < rate:
+                    return {"fault": kind, "retry_after": args.retry_after}
+                roll -= rate
+
+        return None
+
+    # ---------------------------------------------------------------
+    # Record / replay
+    # ---------------------------------------------------------------
+
+    def record(self, method, params, status, body, latencyMs):
+        if self.recordFile is None:
+            return
+        line = json.dumps({"method": method, "params": params, "status": status,
+                           "body": body.decode("utf-8", "replace"),
+                           "latency_ms": round(latencyMs)})
+        with self.lock:
+            self.recordFile.write(line + "\n")
+            self.recordFile.flush()
+
+    def loadReplay(self, path):
+        with open(path, encoding="utf-8") as f:
+            for line in f:
+                if line.strip():
+                    entry = json.loads(line)
+                    self.replay[entry["method"]].append(entry)
+
+    def takeReplay(self, method):
+        with self.lock:
+            if self.replay[method]:
+                return self.replay[method].popleft()
+        return None
+
+
+# ===============================================================
+# REQUEST HANDLER
+# ===============================================================
+
+class MockHandler(BaseHTTPRequestHandler):
+    # Keep-alive, like the real server (TelegramBot reuses connections)
+    protocol_version = "HTTP/1.1"
+    server_version = "MockTelegramBotAPI/1.0"
+
+    def setup(self):
+        super().setup()
+        with self.server.state.lock:
+            self.server.state.connections += 1
+
+    def log_message(self, format, *args):
+        if self.server.state.args.verbose:
+            sys.stderr.write("[mock] " + (format % args) + "\n")
+
+    def do_GET(self):
+        self.dispatch()
+
+    def do_POST(self):
+        self.dispatch()
+
+    # ---------------------------------------------------------------
+    # Routing
+    # ---------------------------------------------------------------
+
+    def dispatch(self):
+        url = urllib.parse.urlsplit(self.path)
+        params = {k: v[-1] for k, v in urllib.parse.parse_qs(url.query).items()}
+        rawBody = self.readBody()
+
+        if rawBody:
+            try:
+                params.update(json.loads(rawBody))
+            except ValueError:
+                params.update({k: v[-1] for k, v in
+                               urllib.parse.parse_qs(rawBody.decode("utf-8", "replace")).items()})
+
+        parts = url.path.strip("/").split("/")
+
+        if parts[0] == "mock" and len(parts) == 2:
+            self.handleControl(parts[1], params)
+        elif len(parts) == 2 and parts[0].startswith("bot"):
+            self.handleBotMethod(parts[0][3:], parts[1], params, rawBody)
+        else:
+            self.sendJson(404, {"ok": False, "error_code": 404, "description": "Not Found"})
+
+    def readBody(self):
+        length = int(self.headers.get("Content-Length") or 0)
+        return self.rfile.read(length) if length > 0 else b""
+
+    # ---------------------------------------------------------------
+    # Bot API
+    # ---------------------------------------------------------------
+
+    def handleBotMethod(self, token, method, params, rawBody):
+        state = self.server.state
+        args = state.args
+        started = time.monotonic()
+
+        with state.lock:
+            state.requests[method] += 1
+
+        if args.token and token != args.token:
+            self.sendJson(401, {"ok": False, "error_code": 401, "description": "Unauthorized"})
+            return
+
+        fault = state.takeFault(method)
+        delayMs = args.latency_ms
+        if fault and fault["fault"] == "latency":
+            delayMs = int(fault.get("ms", delayMs))
+        if delayMs > 0:
+            time.sleep(delayMs / 1000.0)
+
+        if fault and fault["fault"] == "drop":
+            self.log_message("%s: dropping connection", method)
+            self.close_connection = True
+            return
+
+        if fault and fault["fault"] == "429":
+            retryAfter = int(fault.get("retry_after", args.retry_after))
+            status, body = 429, {"ok": False, "error_code": 429,
+                                 "description": "Too Many Requests: retry after %d" % retryAfter,
+                                 "parameters": {"retry_after": retryAfter}}
+        elif fault and fault["fault"] == "malformed":
+            status, body = 200, MALFORMED_BODY
+        else:
+            status, body = self.answer(token, method, params, rawBody)
+
+        encoded = body if isinstance(body, bytes) else json.dumps(body).encode()
+        self.sendRaw(status, encoded)
+        state.record(method, params, status, encoded, (time.monotonic() - started) * 1000)
+
+    def answer(self, token, method, params, rawBody):
+        state = self.server.state
+        args = state.args
+
+        replayed = state.takeReplay(method)
+        if replayed is not None:
+            if args.replay_timing:
+                time.sleep(replayed.get("latency_ms", 0) / 1000.0)
+            return replayed["status"], replayed["body"].encode()
+
+        if args.upstream:
+            return self.forward(token, method, params, rawBody)
+
+        if method == "getMe":
+            return 200, {"ok": True, "result": {"id": 100000001, "is_bot": True,
+                                                "first_name": "WakeAssist Mock",
+                                                "username": "wakeassist_mock_bot"}}
+
+        if method == "getUpdates":
+            updates = state.waitForUpdates(int(params.get("offset", 0)),
+                                           int(params.get("limit", 100)),
+                                           float(params.get("timeout", 0)))
+            return 200, {"ok": True, "result": updates}
+
+        if method in ("sendMessage", "editMessageText"):
+            with state.lock:
+                if method == "sendMessage":
+                    messageId = state.nextMessageId
+                    state.nextMessageId += 1
+                else:
+                    messageId = int(params.get("message_id", 0))
+                state.sent.append({"method": method, "chat_id": params.get("chat_id"),
+                                   "message_id": messageId, "text": params.get("text", ""),
+                                   "reply_markup": params.get("reply_markup")})
+            return 200, {"ok": True, "result": {
+                "message_id": messageId, "date": int(time.time()),
+                "chat": {"id": int(params.get("chat_id", args.chat_id)), "type": "private"},
+                "text": params.get("text", "")}}
+
+        if method == "answerCallbackQuery":
+            with state.lock:
+                state.sent.append({"method": method,
+                                   "callback_query_id": params.get("callback_query_id"),
+                                   "text": params.get("text", "")})
+            return 200, {"ok": True, "result": True}
+
+        return 404, {"ok": False, "error_code": 404, "description": "Not Found: method not found"}
+
+    def forward(self, token, method, params, rawBody):
+        url = "%s/bot%s/%s" % (self.server.state.args.upstream.rstrip("/"), token, method)
+        request = urllib.request.Request(url, data=rawBody or None, method=self.command)
+        if rawBody:
+            request.add_header("Content-Type", self.headers.get("Content-Type", "application/json"))
+        elif params:
+            request.full_url = url + "?" + urllib.parse.urlencode(params)
+
+        timeoutS = float(params.get("timeout", 0)) + 15
+        try:
+            with urllib.request.urlopen(request, timeout=timeoutS) as reply:
+                return reply.status, reply.read()
+        except urllib.error.HTTPError as error:
+            return error.code, error.read()
+
+    # ---------------------------------------------------------------
+    # Control endpoints
+    # ---------------------------------------------------------------
+
+    def handleControl(self, action, params):
+        state = self.server.state
+
+        if action == "update":
+            self.sendJson(200, {"ok": True, "update_id": state.addUpdate(params)})
+        elif action == "inject":
+            if params.get("fault") not in FAULTS:
+                self.sendJson(400, {"ok": False, "description": "fault must be one of %s" % (FAULTS,)})
+                return
+            fault = dict(params)
+            fault["count"] = int(fault.get("count", 1))
+            with state.lock:
+                state.faults.append(fault)
+            self.sendJson(200, {"ok": True})
+        elif action == "sent":
+            with state.lock:
+                self.sendJson(200, {"ok": True, "result": list(state.sent)})
+        elif action == "stats":
+            with state.lock:
+                self.sendJson(200, {"ok": True, "connections": state.connections,
+                                    "requests": dict(state.requests)})
+        elif action == "reset":
+            state.reset()
+            self.sendJson(200, {"ok": True})
+        else:
+            self.sendJson(404, {"ok": False, "description": "Unknown control endpoint"})
+
+    # ---------------------------------------------------------------
+    # Output
+    # ---------------------------------------------------------------
+
+    def sendJson(self, status, body):
+        self.sendRaw(status, json.dumps(body).encode())
+
+    def sendRaw(self, status, body):
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+
+# ===============================================================
+# MAIN
+# ===============================================================
+
+def parseArguments():
+    parser = argparse.ArgumentParser(description="Mock Telegram Bot API server")
+    parser.add_argument("--host", default="127.0.0.1", help="address to listen on")
+    parser.add_argument("--port", type=int, default=8081)
+    parser.add_argument("--token", default="", help="only accept this bot token (default: any)")
+    parser.add_argument("--chat-id", type=int, default=42, help="user/chat ID of queued updates")
+    parser.add_argument("--latency-ms", type=int, default=0, help="delay before every answer")
+    parser.add_argument("--drop-rate", type=float, default=0.0, help="share of requests dropped")
+    parser.add_argument("--429-rate", dest="rate_limit_rate", type=float, default=0.0,
+                        help="share of requests answered with 429")
+    parser.add_argument("--malformed-rate", type=float, default=0.0,
+                        help="share of requests answered with broken JSON")
+    parser.add_argument("--retry-after", type=int, default=5, help="retry_after of 429 answers (s)")
+    parser.add_argument("--seed", type=int, default=1, help="random seed for the fault rates")
+    parser.add_argument("--record", metavar="FILE", help="append every exchange to FILE (JSON lines)")
+    parser.add_argument("--replay", metavar="FILE", help="answer from a recording")
+    parser.add_argument("--replay-timing", action="store_true",
+                        help="wait as long as the recorded answer took")
+    parser.add_argument("--upstream", metavar="URL", help="forward to a real Bot API server")
+    parser.add_argument("-v", "--verbose", action="store_true", help="log every request")
+    return parser.parse_args()
+
+
+def main():
+    args = parseArguments()
+
+    server = ThreadingHTTPServer((args.host, args.port), MockHandler)
+    server.daemon_threads = True
+    server.state = MockState(args)
+
+    print("Mock Telegram Bot API on http://%s:%d" % (args.host, server.server_address[1]),
+          flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+
+
+if __name__ == "__main__":
+    main()